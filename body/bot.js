@@ -37,43 +37,99 @@ bot.on('chat', (username, message) => {
 bot.on('kicked', console.log)
 bot.on('error', console.log)
 
-// ── Percept Publisher (100 ms interval) ─────────────────────────
+// ── Percept Publisher (keyframes + deltas) ─────────────────────
+// Every tick sends either a keyframe (the whole percept) or a delta
+// against the previous tick: changed top-level fields, new or moved
+// entities keyed by entity id, and ids that left. The Head patches its
+// world state with deltas and asks for a keyframe ({"action":"resync"})
+// when it sees a gap in `seq`; keyframes also go out every KEYFRAME_MS.
+const PERCEPT_HZ = Number(process.env.PROMETHEUS_PERCEPT_HZ || 20)
+const KEYFRAME_MS = Number(process.env.PROMETHEUS_KEYFRAME_MS || 2000)
+
+let perceptSeq = 0
+let lastPercept = null
+let lastKeyframeAt = 0
+let keyframeRequested = true
+
+function round1 (v) {
+  return Math.round(v * 10) / 10
+}
+
+function snapshotPercept () {
+  const nearbyEntities = []
+  for (const entity of Object.values(bot.entities)) {
+    if (entity === bot.entity) continue
+    if (!entity.position) continue
+    const dist = bot.entity.position.distanceTo(entity.position)
+    if (dist > 32) continue // only within 32 blocks
+    nearbyEntities.push({
+      id: String(entity.id),
+      name: entity.name || entity.username || 'unknown',
+      distance: round1(dist),
+      hostile: isHostile(entity)
+    })
+  }
+
+  // Nearest 10, keyed by id
+  nearbyEntities.sort((a, b) => a.distance - b.distance)
+  const entities = {}
+  for (const { id, ...e } of nearbyEntities.slice(0, 10)) entities[id] = e
+
+  return {
+    health: bot.health,
+    food: bot.food,
+    position: {
+      x: round1(bot.entity.position.x),
+      y: round1(bot.entity.position.y),
+      z: round1(bot.entity.position.z)
+    },
+    entities,
+    ground: bot.entity.onGround ? 'safe' : 'airborne',
+    biome: bot.blockAt(bot.entity.position)?.biome?.name ?? ''
+  }
+}
+
+function diffPercept (prev, cur) {
+  const delta = {}
+  for (const key of ['health', 'food', 'ground', 'biome']) {
+    if (cur[key] !== prev[key]) delta[key] = cur[key]
+  }
+  const position = {}
+  for (const axis of ['x', 'y', 'z']) {
+    if (cur.position[axis] !== prev.position[axis]) position[axis] = cur.position[axis]
+  }
+  if (Object.keys(position).length) delta.position = position
+
+  const entities = {}
+  for (const [id, e] of Object.entries(cur.entities)) {
+    const old = prev.entities[id]
+    if (!old) entities[id] = e
+    else if (old.distance !== e.distance) entities[id] = { distance: e.distance }
+  }
+  if (Object.keys(entities).length) delta.entities = entities
+  const gone = Object.keys(prev.entities).filter(id => !(id in cur.entities))
+  if (gone.length) delta.gone = gone
+  return delta
+}
+
 function startPerceptPublisher () {
   setInterval(() => {
     if (!bot.entity) return // not spawned yet
 
-    const nearbyEntities = []
-    for (const entity of Object.values(bot.entities)) {
-      if (entity === bot.entity) continue
-      if (!entity.position) continue
-      const dist = bot.entity.position.distanceTo(entity.position)
-      if (dist > 32) continue // only within 32 blocks
-      nearbyEntities.push({
-        name: entity.name || entity.username || 'unknown',
-        distance: Math.round(dist * 10) / 10,
-        hostile: isHostile(entity)
-      })
+    const cur = snapshotPercept()
+    const now = Date.now()
+    let msg
+    if (!lastPercept || keyframeRequested || now - lastKeyframeAt >= KEYFRAME_MS) {
+      msg = { type: 'keyframe', seq: ++perceptSeq, ...cur }
+      lastKeyframeAt = now
+      keyframeRequested = false
+    } else {
+      msg = { type: 'delta', seq: ++perceptSeq, ...diffPercept(lastPercept, cur) }
     }
+    lastPercept = cur
 
-    // Sort by distance
-    nearbyEntities.sort((a, b) => a.distance - b.distance)
-
-    const percept = {
-      type: 'percept',
-      health: bot.health,
-      food: bot.food,
-      position: {
-        x: Math.round(bot.entity.position.x * 10) / 10,
-        y: Math.round(bot.entity.position.y * 10) / 10,
-        z: Math.round(bot.entity.position.z * 10) / 10
-      },
-      nearby_entities: nearbyEntities.slice(0, 10), // cap at 10
-      ground: bot.entity.onGround ? 'safe' : 'airborne'
-    }
-
-    const msg = JSON.stringify(percept)
-    pubSock.send(msg).catch(() => {}) // fire-and-forget
-  }, 100)
+    pubSock.send(JSON.stringify(msg)).catch(() => {}) // fire-and-forget
+  }, 1000 / PERCEPT_HZ)
 }
 
 // ── Hostile Mob Detection ───────────────────────────────────────
@@ -92,10 +148,12 @@ function isHostile (entity) {
 }
 
 // ── Action Receiver (async PULL loop) ───────────────────────────
+const RESYNC = '{"action":"resync"}'
+
 async function startActionReceiver () {
   for await (const [msg] of pullSock) {
     const text = msg.toString()
-    console.log('[HEAD] <<', text)
+    if (text !== RESYNC) console.log('[HEAD] <<', text)
 
     let action
     try {
@@ -123,6 +181,9 @@ function dispatchAction (action) {
     case 'explore':
       actionExplore(action)
       break
+    case 'resync':
+      keyframeRequested = true
+      break
     default:
       console.warn(`[HEAD] Unknown action: ${action.action}`)
   }
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <string>
+
+namespace prometheus::bench {
+
+// Minimal benchmark harness for prometheus_bench.
+// Each benchmark registers itself with PROMETHEUS_BENCH(name) and reports
+// results as one JSON object per line on stdout, so runs can be diffed
+// and tracked across releases. Human-readable progress goes to stderr.
+
+using BenchFn = void (*)();
+
+// Register a benchmark (used by PROMETHEUS_BENCH).
+bool register_bench(const char* name, BenchFn fn);
+
+// One result record: {"bench": <name>, <key>: <value>, ...}
+class Report {
+public:
+    explicit Report(const std::string& bench) { j_["bench"] = bench; }
+
+    template <typename T>
+    Report& set(const std::string& key, const T& value) {
+        j_[key] = value;
+        return *this;
+    }
+
+    // Print the record as a single JSON line.
+    void emit() const;
+
+private:
+    nlohmann::json j_;
+};
+
+// Seconds elapsed since `t0`.
+inline double seconds_since(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// Environment override with a fallback.
+std::string env_or(const char* name, const std::string& fallback);
+
+// Mark the run as failed (prometheus_bench exits non-zero) — for
+// benchmarks that also guard an invariant, e.g. hot_loop_alloc.
+void fail(const std::string& why);
+
+} // namespace prometheus::bench
+
+#define PROMETHEUS_BENCH(name)                                              \
+    static void bench_##name();                                             \
+    [[maybe_unused]] static const bool bench_##name##_registered =          \
+        ::prometheus::bench::register_bench(#name, bench_##name);           \
+    static void bench_##name()
@@ -0,0 +1,141 @@
+// Sleep-cycle consolidation of a simulated day.
+//
+//   PROMETHEUS_EMBED_MODEL=model.gguf ./build/prometheus_bench memory_consolidate
+//
+// Flushes a synthetic 20-minute log (one line per 100 ms percept, with
+// the heavy repetition real logs have) into a scratch store, then flushes
+// it again to show the already-indexed path. Uses HashEmbedder unless
+// PROMETHEUS_EMBED_MODEL names a model llama.cpp can load.
+//
+//   ./build/prometheus_bench awake_consolidate
+//
+// Awake-phase consolidation cursor. Two threads log markers while slices
+// run back to back; then the day is finalized, more markers arrive
+// before the next begin_day(), and that day is finalized too. Every
+// marker logged must be read by exactly one slice; otherwise the run
+// fails (exit code 2).
+
+#include "bench.h"
+
+#include "circadian/consolidator.h"
+#include "memory/event_log.h"
+#include "memory/memory.h"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <filesystem>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace prometheus;
+
+PROMETHEUS_BENCH(memory_consolidate) {
+    const int lines = std::stoi(bench::env_or("PROMETHEUS_BENCH_LOG_LINES", "12000"));
+    const std::string model = bench::env_or("PROMETHEUS_EMBED_MODEL", "");
+    const std::string dir = (std::filesystem::temp_directory_path() /
+        ("prometheus_consolidate_" + std::to_string(::getpid()))).string();
+    std::filesystem::remove_all(dir);
+
+    // Two thirds of the day is routine, repeated verbatim.
+    static const char* kRoutine[] = {
+        "[MEM:IDLE] nothing nearby, standing in the meadow",
+        "[MEM:EXPLORE] walking north along the river",
+        "[MEM:EAT] ate bread, food back to 20",
+        "[MEM:FLEE] zombie approached, ran toward the village",
+        "[MEM:NEAR_DEATH] health at 3 after falling",
+        "[MEM:MINE] mining stone in the quarry",
+    };
+    std::mt19937 rng(7);
+    std::string log;
+    for (int i = 0; i < lines; ++i) {
+        if (rng() % 3) {
+            log += kRoutine[rng() % std::size(kRoutine)];
+        } else {
+            log += "[MEM:EVENT] at " + std::to_string(rng() % 2000) + "," +
+                   std::to_string(rng() % 2000) + " saw " +
+                   std::to_string(rng() % 8) + " entities, health " +
+                   std::to_string(rng() % 21);
+        }
+        log += '\n';
+    }
+
+    Memory memory;
+    memory.init(dir, model);
+
+    for (const char* pass : {"first", "repeat"}) {
+        auto t0 = std::chrono::steady_clock::now();
+        memory.flush_log(log);
+        double wall = bench::seconds_since(t0);
+        bench::Report("memory_consolidate")
+            .set("pass", pass)
+            .set("lines", lines)
+            .set("bytes", log.size())
+            .set("wall_s", wall)
+            .set("lines_per_s", lines / wall)
+            .emit();
+    }
+
+    std::filesystem::remove_all(dir);
+}
+
+PROMETHEUS_BENCH(awake_consolidate) {
+    constexpr int kProducers = 2;
+    const int per_thread = std::stoi(bench::env_or("PROMETHEUS_BENCH_RECORDS", "20000"));
+    const std::string dir = (std::filesystem::temp_directory_path() /
+        ("prometheus_awake_" + std::to_string(::getpid()))).string();
+    std::filesystem::remove_all(dir);
+
+    EventLog log;
+    if (!log.open(dir)) {
+        bench::fail("awake_consolidate: cannot open " + dir);
+        return;
+    }
+    Memory       memory;            // no long-term store: slices only read
+    Consolidator consolidator(log, memory);
+
+    std::atomic<int> running{kProducers};
+    std::vector<std::thread> producers;
+    for (int t = 0; t < kProducers; ++t) {
+        producers.emplace_back([&, t] {
+            for (int i = 0; i < per_thread; ++i) {
+                log.marker("[MEM:EVENT] " + std::to_string(t) + "." + std::to_string(i));
+                if (i % 50 == 49) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            running.fetch_sub(1);
+        });
+    }
+    size_t slices = 0;
+    while (running.load()) {
+        consolidator.catch_up();
+        ++slices;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    for (auto& t : producers) t.join();
+    consolidator.finalize();
+
+    // Between the end of one day and the start of the next.
+    constexpr int kOvernight = 100;
+    for (int i = 0; i < kOvernight; ++i) log.marker("[MEM:EVENT] overnight " + std::to_string(i));
+    consolidator.begin_day();
+    std::this_thread::sleep_for(Consolidator::kSettle + std::chrono::milliseconds(20));
+    consolidator.finalize();
+
+    const auto   st      = consolidator.stats();
+    const size_t written = static_cast<size_t>(kProducers * per_thread + kOvernight) -
+                           log.stats().dropped;
+    if (st.events != written) {
+        bench::fail("awake_consolidate: slices read " + std::to_string(st.events) + " of " +
+                    std::to_string(written) + " events");
+    }
+    log.close();
+    std::filesystem::remove_all(dir);
+
+    bench::Report("awake_consolidate")
+        .set("written", written)
+        .set("read", st.events)
+        .set("catch_ups", slices)
+        .set("slices", st.slices)
+        .emit();
+}
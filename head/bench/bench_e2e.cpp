@@ -0,0 +1,345 @@
+// End to end: the real prometheus_head against a fake body and a mock
+// llama-server.
+//
+//   python3 scripts/mock_llama_server.py --port 8090 --parallel 4 &
+//   ./build/prometheus_bench head_e2e
+//
+// PROMETHEUS_MOCK_SOUL_URL (default http://127.0.0.1:8090) names the mock
+// server, PROMETHEUS_BENCH_HEAD the head binary (prometheus_head next to
+// this one), PROMETHEUS_BENCH_SECONDS (30) and PROMETHEUS_PERCEPT_HZ (20)
+// the stream.
+//
+// Starts the head as a child process with a scratch PROMETHEUS_ROOT, then
+// plays the body in-process over ZMQ, as body/bot.js does: a keyframe
+// every 2 s, deltas in between, and a hostile zombie walking in for the
+// last half-second of each 2 s episode. Reports the percept → action
+// latency at each threat onset, actions by kind, the head's CPU and RSS,
+// and what it says about itself on /metrics (react() latency, Soul
+// deliberations, dispatched decisions) once the stream stops. A threat
+// the head does not flee from within a second fails the run (exit
+// code 2).
+
+#include "bench.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#if HAS_ZMQ
+#include <zmq.h>
+#endif
+
+using namespace prometheus;
+
+#if HAS_ZMQ
+namespace {
+
+// GET `path` from 127.0.0.1:port; the whole reply, or empty on failure.
+std::string http_get(int port, const std::string& path) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in sa{};
+    sa.sin_family      = AF_INET;
+    sa.sin_port        = htons(static_cast<uint16_t>(port));
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    std::string reply;
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&sa), sizeof sa) == 0) {
+        std::string req = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+        (void)::send(fd, req.data(), req.size(), MSG_NOSIGNAL);
+        char buf[4096];
+        for (ssize_t n; (n = ::recv(fd, buf, sizeof buf, 0)) > 0;) reply.append(buf, static_cast<size_t>(n));
+    }
+    ::close(fd);
+    return reply;
+}
+
+// A loopback port nothing is listening on right now.
+int free_port() {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in sa{};
+    sa.sin_family      = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof sa;
+    int port = 0;
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&sa), sizeof sa) == 0 &&
+        ::getsockname(fd, reinterpret_cast<sockaddr*>(&sa), &len) == 0) {
+        port = ntohs(sa.sin_port);
+    }
+    ::close(fd);
+    return port;
+}
+
+// Sum of every sample of `name` (all label sets) in Prometheus text.
+double scrape_sum(const std::string& text, const std::string& name) {
+    double total = 0;
+    std::istringstream in(text);
+    for (std::string line; std::getline(in, line);) {
+        if (!line.starts_with(name)) continue;
+        const char next = line.size() > name.size() ? line[name.size()] : '\0';
+        if (next != ' ' && next != '{') continue;
+        total += std::strtod(line.c_str() + line.rfind(' ') + 1, nullptr);
+    }
+    return total;
+}
+
+// utime + stime of `pid`, in seconds.
+double process_cpu_seconds(pid_t pid) {
+    std::ifstream in("/proc/" + std::to_string(pid) + "/stat");
+    std::string stat((std::istreambuf_iterator<char>(in)), {});
+    auto close = stat.rfind(')');
+    if (close == std::string::npos) return 0;
+    std::istringstream fields(stat.substr(close + 2));
+    std::string skip;
+    for (int i = 0; i < 11; ++i) fields >> skip;      // state … cmajflt
+    double utime = 0, stime = 0;
+    fields >> utime >> stime;
+    return (utime + stime) / static_cast<double>(::sysconf(_SC_CLK_TCK));
+}
+
+double process_rss_mb(pid_t pid) {
+    std::ifstream in("/proc/" + std::to_string(pid) + "/status");
+    for (std::string line; std::getline(in, line);) {
+        if (line.starts_with("VmRSS:")) return std::strtod(line.c_str() + 6, nullptr) / 1024.0;
+    }
+    return 0;
+}
+
+// Wait up to `timeout` for the child; true if it exited cleanly.
+bool reap(pid_t pid, std::chrono::milliseconds timeout) {
+    const auto until = std::chrono::steady_clock::now() + timeout;
+    int status = 0;
+    while (std::chrono::steady_clock::now() < until) {
+        if (::waitpid(pid, &status, WNOHANG) == pid) return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    ::kill(pid, SIGKILL);
+    ::waitpid(pid, &status, 0);
+    return false;
+}
+
+} // namespace
+#endif
+
+PROMETHEUS_BENCH(head_e2e) {
+#if !HAS_ZMQ
+    bench::Report("head_e2e").set("skipped", "built without ZeroMQ").emit();
+#else
+    using clock = std::chrono::steady_clock;
+    const std::string url = bench::env_or("PROMETHEUS_MOCK_SOUL_URL", "http://127.0.0.1:8090");
+    const double seconds  = std::stod(bench::env_or("PROMETHEUS_BENCH_SECONDS", "30"));
+    const int    hz       = std::max(1, std::stoi(bench::env_or("PROMETHEUS_PERCEPT_HZ", "20")));
+    const std::string head_bin = bench::env_or("PROMETHEUS_BENCH_HEAD",
+        (std::filesystem::read_symlink("/proc/self/exe").parent_path() / "prometheus_head").string());
+
+    const int soul_port = std::atoi(url.c_str() + url.rfind(':') + 1);
+    if (http_get(soul_port, "/health").find("\"ok\"") == std::string::npos) {
+        bench::Report("head_e2e").set("skipped", "no server at " + url).emit();
+        return;
+    }
+    if (!std::filesystem::exists(head_bin)) {
+        bench::Report("head_e2e").set("skipped", "no head binary at " + head_bin).emit();
+        return;
+    }
+
+    // ── Fake body ───────────────────────────────────────────────
+    // The head derives its PUSH endpoint as SUB port + 1.
+    void* ctx  = zmq_ctx_new();
+    void* pub  = zmq_socket(ctx, ZMQ_PUB);
+    void* pull = zmq_socket(ctx, ZMQ_PULL);
+    int body_port = 0;
+    for (int port = 20000 + static_cast<int>(::getpid() % 20000); port < 65000; port += 2) {
+        if (zmq_bind(pub, ("tcp://127.0.0.1:" + std::to_string(port)).c_str()) != 0) continue;
+        if (zmq_bind(pull, ("tcp://127.0.0.1:" + std::to_string(port + 1)).c_str()) == 0) {
+            body_port = port;
+            break;
+        }
+        zmq_unbind(pub, ("tcp://127.0.0.1:" + std::to_string(port)).c_str());
+    }
+    const int metrics_port = free_port();
+
+    // ── Head ────────────────────────────────────────────────────
+    const auto root = std::filesystem::temp_directory_path() /
+                      ("prometheus_e2e_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(root);
+    const std::string log_path = (root / "head.log").string();
+
+    const auto spawned = clock::now();
+    pid_t pid = ::fork();
+    if (pid == 0) {
+        ::setenv("PROMETHEUS_ROOT", root.c_str(), 1);
+        ::setenv("LLAMA_SERVER_BIN", "", 1);
+        ::setenv("PROMETHEUS_SOUL_PORT", std::to_string(soul_port).c_str(), 1);
+        ::setenv("PROMETHEUS_BODY_ENDPOINT", ("tcp://127.0.0.1:" + std::to_string(body_port)).c_str(), 1);
+        ::setenv("PROMETHEUS_METRICS_ADDR", ("127.0.0.1:" + std::to_string(metrics_port)).c_str(), 1);
+        if (std::freopen(log_path.c_str(), "w", stdout) && std::freopen(log_path.c_str(), "a", stderr)) {
+            ::execl(head_bin.c_str(), head_bin.c_str(), static_cast<char*>(nullptr));
+        }
+        std::_Exit(127);
+    }
+
+    // ── Stream ──────────────────────────────────────────────────
+    // Episodes of 2 s: a keyframe, deltas with a cow drifting, and a
+    // zombie from 1.5 s on.
+    const int episode = 2 * hz, onset = episode * 3 / 4;
+    uint64_t seq = 0;
+    char buf[512];
+    auto percept = [&](int tick) {
+        const int   i   = tick % episode;
+        const float cow = 12.0f + static_cast<float>(i % 7) * 0.1f;
+        const float mob = 8.0f - static_cast<float>(i - onset) * 0.3f;
+        int n;
+        if (i == 0) {
+            n = std::snprintf(buf, sizeof buf,
+                R"({"type":"keyframe","seq":%llu,"health":18,"food":18,"position":{"x":%.1f,"y":64,"z":-3.5},)"
+                R"("entities":{"701":{"name":"cow","distance":%.1f,"hostile":false}},"ground":"safe","biome":"plains"})",
+                static_cast<unsigned long long>(++seq), 10.0f + static_cast<float>(tick % 40) * 0.2f, cow);
+        } else if (i >= onset) {
+            n = std::snprintf(buf, sizeof buf,
+                R"({"type":"delta","seq":%llu,"entities":{"701":{"distance":%.1f},)"
+                R"("702":{"name":"zombie","distance":%.1f,"hostile":true}}})",
+                static_cast<unsigned long long>(++seq), cow, mob);
+        } else {
+            n = std::snprintf(buf, sizeof buf,
+                R"({"type":"delta","seq":%llu,"position":{"x":%.1f},"entities":{"701":{"distance":%.1f}}})",
+                static_cast<unsigned long long>(++seq), 10.0f + static_cast<float>(tick % 40) * 0.2f, cow);
+        }
+        zmq_send(pub, buf, static_cast<size_t>(n), 0);
+    };
+
+    std::map<std::string, uint64_t> actions;
+    auto receive = [&](std::vector<std::pair<clock::time_point, std::string>>& out) {
+        char msg[1024];
+        for (int n; (n = zmq_recv(pull, msg, sizeof msg, ZMQ_DONTWAIT)) >= 0;) {
+            std::string a(msg, static_cast<size_t>(std::min<int>(n, sizeof msg)));
+            // Soul plans pass the model's reply through, which may nest
+            // the action one level: {"action":{"action":"explore",...}}.
+            auto j = nlohmann::json::parse(a, nullptr, false);
+            for (int depth = 0; depth < 2 && j.is_object() && j.contains("action"); ++depth) {
+                j = nlohmann::json(j["action"]);
+            }
+            ++actions[j.is_string() ? j.get<std::string>() : "?"];
+            out.emplace_back(clock::now(), std::move(a));
+        }
+    };
+
+    // Until the head is up and answering: keyframes, then wait for the
+    // first action back.
+    std::vector<std::pair<clock::time_point, std::string>> received;
+    const auto period = std::chrono::microseconds(1000000 / hz);
+    bool up = false, died = false;
+    while (!up && !died && clock::now() - spawned < std::chrono::seconds(30)) {
+        percept(0);
+        std::this_thread::sleep_for(period);
+        receive(received);
+        up   = !received.empty();
+        died = ::waitpid(pid, nullptr, WNOHANG) == pid;
+    }
+    const double ready_ms = std::chrono::duration<double, std::milli>(clock::now() - spawned).count();
+    if (!up) {
+        if (!died) {
+            ::kill(pid, SIGINT);
+            reap(pid, std::chrono::seconds(5));
+        }
+        bench::Report("head_e2e").set("ready", false).set("log", log_path).emit();
+        bench::fail("head_e2e: the head never answered the fake body (see " + log_path + ")");
+        zmq_close(pub);
+        zmq_close(pull);
+        zmq_ctx_destroy(ctx);
+        return;
+    }
+
+    // Measured run, at a fixed rate; actions are read between ticks.
+    received.clear();
+    actions.clear();
+    const double cpu0  = process_cpu_seconds(pid);
+    const auto   start = clock::now();
+    const int    ticks = static_cast<int>(seconds * hz);
+    std::vector<clock::time_point> onsets;
+    for (int tick = 0; tick < ticks; ++tick) {
+        while (clock::now() < start + period * tick) {
+            receive(received);
+            std::this_thread::sleep_for(std::chrono::microseconds(250));
+        }
+        if (tick % episode == onset) onsets.push_back(clock::now());
+        percept(tick);
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    receive(received);
+    const double wall = bench::seconds_since(start);
+    const double cpu  = process_cpu_seconds(pid) - cpu0;
+    const double rss  = process_rss_mb(pid);
+
+    // Each onset: the first flee for the hostile mob before the next
+    // episode's keyframe clears it (plus a second of grace for the last).
+    std::vector<double> latency_ms;
+    uint64_t missed = 0;
+    for (auto t : onsets) {
+        auto it = std::find_if(received.begin(), received.end(), [&](const auto& r) {
+            return r.first >= t && r.second.find("hostile_nearby") != std::string::npos;
+        });
+        if (it == received.end() || it->first - t > std::chrono::seconds(1)) {
+            ++missed;
+            continue;
+        }
+        latency_ms.push_back(std::chrono::duration<double, std::milli>(it->first - t).count());
+    }
+    std::sort(latency_ms.begin(), latency_ms.end());
+    auto pct = [&](double q) {
+        return latency_ms.empty() ? 0.0
+             : latency_ms[static_cast<size_t>(q * static_cast<double>(latency_ms.size() - 1))];
+    };
+
+    const std::string text = http_get(metrics_port, "/metrics");
+    const double reacts    = scrape_sum(text, "head_lizard_react_seconds_count");
+    const double react_s   = scrape_sum(text, "head_lizard_react_seconds_sum");
+
+    ::kill(pid, SIGINT);
+    const bool clean_exit = reap(pid, std::chrono::seconds(15));
+    zmq_close(pub);
+    zmq_close(pull);
+    zmq_ctx_destroy(ctx);
+    std::filesystem::remove_all(root);
+
+    nlohmann::json by_kind(actions);
+    bench::Report("head_e2e")
+        .set("seconds", wall)
+        .set("percept_hz", hz)
+        .set("percepts", ticks)
+        .set("ready_ms", ready_ms)
+        .set("threats", onsets.size())
+        .set("missed", missed)
+        .set("reflex_p50_ms", pct(0.5))
+        .set("reflex_p99_ms", pct(0.99))
+        .set("reflex_max_ms", pct(1.0))
+        .set("actions", received.size())
+        .set("actions_by_kind", by_kind)
+        .set("head_cpu_pct", cpu / wall * 100.0)
+        .set("head_rss_mb", rss)
+        .set("react_count", reacts)
+        .set("react_mean_us", reacts > 0 ? react_s / reacts * 1e6 : 0.0)
+        .set("deliberations", scrape_sum(text, "head_soul_deliberations_total"))
+        .set("soul_errors", scrape_sum(text, "head_soul_errors_total"))
+        .set("dispatched", scrape_sum(text, "head_arbiter_dispatched_total"))
+        .set("vetoes", scrape_sum(text, "head_arbiter_vetoes_total"))
+        .set("body_messages", scrape_sum(text, "head_body_messages_total"))
+        .set("scraped", !text.empty())
+        .set("clean_exit", clean_exit)
+        .emit();
+
+    if (missed) bench::fail("head_e2e: " + std::to_string(missed) + " threats not fled within 1 s");
+    if (!clean_exit) bench::fail("head_e2e: the head did not shut down cleanly on SIGINT");
+#endif
+}
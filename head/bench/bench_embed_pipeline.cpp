@@ -0,0 +1,96 @@
+// Embedding-pipeline cache hits while another caller embeds.
+//
+//   ./build/prometheus_bench embed_pipeline
+//
+// One thread embeds PROMETHEUS_BENCH_BATCHES (default 32) batches of
+// passages the cache has never seen, through an embedder that takes
+// PROMETHEUS_BENCH_EMBED_MS (default 5) per batch — roughly a small GGUF
+// model on the CPU. Meanwhile a second thread embeds a passage that is
+// already cached, once a millisecond, as Memory::recall does for a known
+// marker. Reports that lookup's latency; fails (exit code 2) if its p99
+// reaches one batch time, i.e. cache hits queue behind the embedder.
+
+#include "bench.h"
+
+#include "memory/embed_pipeline.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace prometheus;
+
+namespace {
+
+class SlowEmbedder : public TextEmbedder {
+public:
+    explicit SlowEmbedder(std::chrono::milliseconds per_batch) : per_batch_(per_batch) {}
+
+    int dim() const override { return inner_.dim(); }
+    std::string name() const override { return inner_.name(); }
+    std::vector<std::vector<float>> embed_batch(
+            const std::vector<std::string_view>& texts) override {
+        std::this_thread::sleep_for(per_batch_);
+        return inner_.embed_batch(texts);
+    }
+
+private:
+    HashEmbedder              inner_;
+    std::chrono::milliseconds per_batch_;
+};
+
+} // namespace
+
+PROMETHEUS_BENCH(embed_pipeline) {
+    const int batches  = std::stoi(bench::env_or("PROMETHEUS_BENCH_BATCHES", "32"));
+    const int batch_ms = std::stoi(bench::env_or("PROMETHEUS_BENCH_EMBED_MS", "5"));
+
+    SlowEmbedder      embedder{std::chrono::milliseconds(batch_ms)};
+    EmbeddingPipeline pipeline(embedder, EmbeddingPipeline::Config{});
+    const size_t batch = EmbeddingPipeline::Config{}.batch_size;
+
+    const std::string marker = "[MEM:NEAR_DEATH]";
+    (void)pipeline.embed({marker});
+
+    std::vector<std::string> day;
+    for (size_t i = 0; i < static_cast<size_t>(batches) * batch; ++i) {
+        day.push_back("[MEM:EVENT] passage " + std::to_string(i));
+    }
+    std::vector<std::string_view> passages(day.begin(), day.end());
+
+    std::atomic<bool>   embedding{true};
+    std::vector<double> hit_us;
+    std::thread reader([&] {
+        while (embedding.load()) {
+            auto t0 = std::chrono::steady_clock::now();
+            (void)pipeline.embed({marker});
+            hit_us.push_back(bench::seconds_since(t0) * 1e6);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    auto t0 = std::chrono::steady_clock::now();
+    (void)pipeline.embed(passages);
+    const double wall = bench::seconds_since(t0);
+    embedding.store(false);
+    reader.join();
+
+    std::sort(hit_us.begin(), hit_us.end());
+    auto pct = [&](double p) {
+        return hit_us.empty() ? 0.0
+                              : hit_us[static_cast<size_t>(p * static_cast<double>(hit_us.size() - 1))];
+    };
+    if (pct(0.99) >= batch_ms * 1000.0) {
+        bench::fail("embed_pipeline: cache-hit p99 " + std::to_string(pct(0.99)) +
+                    " us; hits wait behind the embedder");
+    }
+    bench::Report("embed_pipeline")
+        .set("batches", batches)
+        .set("batch_ms", batch_ms)
+        .set("embed_wall_s", wall)
+        .set("hits", hit_us.size())
+        .set("hit_p50_us", pct(0.50))
+        .set("hit_p99_us", pct(0.99))
+        .set("hit_max_us", hit_us.empty() ? 0.0 : hit_us.back())
+        .emit();
+}
@@ -0,0 +1,149 @@
+// Session event log under concurrent producers and readers.
+//
+//   ./build/prometheus_bench event_log
+//
+// PROMETHEUS_BENCH_RECORDS (default 20000) sets the records written, split
+// across 4 producer threads (percepts, with a NEAR_DEATH marker every
+// 1000th record) in bursts of 50 a millisecond apart. While they run, a reader issues the queries Circadian
+// makes — the last second of events and last(Marker, "NEAR_DEATH") — as
+// fast as it can. Reports producer cost per record, query latency,
+// blocks written and the compression ratio.
+//
+// Then checks the log: the records a full-range query returns must equal
+// those written minus those dropped (before and after a reopen), and
+// queries must not seal the block being filled — every sealed block holds
+// at least block_bytes. Otherwise the run fails (exit code 2).
+
+#include "bench.h"
+
+#include "lizard/lizard.h"
+#include "memory/event_log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace prometheus;
+
+PROMETHEUS_BENCH(event_log) {
+    using clock = std::chrono::steady_clock;
+    constexpr int kProducers = 4;
+    const size_t  records    = std::stoul(bench::env_or("PROMETHEUS_BENCH_RECORDS", "20000"));
+    const size_t  per_thread = records / kProducers;
+
+    const std::string dir = (std::filesystem::temp_directory_path() /
+        ("prometheus_event_log_" + std::to_string(::getpid()))).string();
+    std::filesystem::remove_all(dir);
+
+    // Only full blocks are written while the bench runs; the writer's age
+    // limit would otherwise seal partial blocks on a slow host.
+    EventLog::Config cfg;
+    cfg.flush_interval = std::chrono::hours(1);
+
+    const uint64_t t_begin = EventLog::now_us();
+    EventLog::Stats st;
+    std::vector<double> query_us, last_us;
+    double produce_ns = 0;
+    {
+        EventLog log(cfg);
+        if (!log.open(dir)) {
+            bench::fail("event_log: cannot open " + dir);
+            return;
+        }
+
+        std::atomic<bool>     producing{true};
+        std::atomic<uint64_t> produce_total_ns{0};
+        std::vector<std::thread> producers;
+        for (int t = 0; t < kProducers; ++t) {
+            producers.emplace_back([&, t] {
+                Percept p;
+                p.health = 20.0f;
+                p.hunger = 18.0f;
+                double ns = 0;
+                for (size_t i = 0; i < per_thread;) {
+                    // Bursts of 50 a millisecond apart, so the reader's
+                    // queries land while the log is being written.
+                    auto t0 = clock::now();
+                    for (size_t end = std::min(per_thread, i + 50); i < end; ++i) {
+                        p.x = static_cast<float>(i);
+                        p.z = static_cast<float>(t);
+                        if (i % 1000 == 999) log.marker("[MEM:NEAR_DEATH]");
+                        else                 log.percept(p);
+                    }
+                    ns += std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                produce_total_ns.fetch_add(static_cast<uint64_t>(ns));
+            });
+        }
+        std::thread reader([&] {
+            while (producing.load()) {
+                auto t0 = clock::now();
+                (void)log.query(EventLog::now_us() - 1000000, UINT64_MAX);
+                query_us.push_back(
+                    std::chrono::duration<double, std::micro>(clock::now() - t0).count());
+                t0 = clock::now();
+                (void)log.last(EventKind::Marker, "NEAR_DEATH");
+                last_us.push_back(
+                    std::chrono::duration<double, std::micro>(clock::now() - t0).count());
+                std::this_thread::yield();
+            }
+        });
+        for (auto& t : producers) t.join();
+        producing.store(false);
+        reader.join();
+        produce_ns = static_cast<double>(produce_total_ns.load()) /
+                     static_cast<double>(per_thread * kProducers);
+
+        // Everything is in the rings or the open block; nothing is sealed
+        // short.
+        const auto   found   = log.query(t_begin, UINT64_MAX).size();
+        const auto   sealed  = log.stats();
+        const size_t written = per_thread * kProducers - sealed.dropped;
+        if (found != written) {
+            bench::fail("event_log: query returned " + std::to_string(found) + " of " +
+                        std::to_string(written) + " records");
+        }
+        if (sealed.blocks * cfg.block_bytes > sealed.raw_bytes) {
+            bench::fail("event_log: " + std::to_string(sealed.blocks) + " blocks hold only " +
+                        std::to_string(sealed.raw_bytes) + " bytes; a query sealed a partial block");
+        }
+        log.close();
+        st = log.stats();
+    }
+    {
+        EventLog reopened(cfg);
+        reopened.open(dir);
+        const auto found = reopened.query(t_begin, UINT64_MAX).size();
+        if (found != st.records) {
+            bench::fail("event_log: " + std::to_string(found) + " records after reopen, " +
+                        std::to_string(st.records) + " written");
+        }
+    }
+    std::filesystem::remove_all(dir);
+
+    auto pct = [](std::vector<double> v, double p) {
+        if (v.empty()) return 0.0;
+        std::sort(v.begin(), v.end());
+        return v[static_cast<size_t>(p * static_cast<double>(v.size() - 1))];
+    };
+    bench::Report("event_log")
+        .set("producers", kProducers)
+        .set("records", st.records)
+        .set("dropped", st.dropped)
+        .set("produce_ns", produce_ns)
+        .set("queries", query_us.size())
+        .set("query_p50_us", pct(query_us, 0.50))
+        .set("query_p99_us", pct(query_us, 0.99))
+        .set("last_p50_us", pct(last_us, 0.50))
+        .set("last_p99_us", pct(last_us, 0.99))
+        .set("blocks", st.blocks)
+        .set("compression", st.stored_bytes ? static_cast<double>(st.raw_bytes) /
+                                                  static_cast<double>(st.stored_bytes)
+                                            : 0.0)
+        .emit();
+}
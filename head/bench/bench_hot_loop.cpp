@@ -0,0 +1,140 @@
+// Steady-state heap allocations on the percept → reflex → dispatch path.
+//
+//   ./build/prometheus_bench hot_loop_alloc
+//
+// PROMETHEUS_BENCH_TICKS (default 20000) sets the measured ticks.
+//
+// Replays a 20 Hz keyframe/delta stream through what the lizard thread
+// and the dispatch tick do per percept — WorldState apply and
+// materialise, event log, frame gate, situation signature, react() with
+// a learned rule installed, novelty, submit_reflex, dispatch_tick — with
+// the event log open. The stream cycles through idle, hungry, a creeper
+// (learned rule), a zombie (Layer 0) and the zombie at critical health
+// (Layer 0, tagging the NEAR_DEATH marker every tick) so every reflex
+// path runs — the last phase again with a growing crowd of long-named
+// entities.
+//
+// After a short warm-up (buffers reach their working size), counts
+// allocations on this thread per tick (src/diag/alloc_counter.h). Any
+// allocation fails the run (exit code 2) when the counter is built in;
+// for contrast it also counts what parsing the same messages into a
+// nlohmann DOM would allocate.
+
+#include "bench.h"
+#include "percept_fixture.h"
+
+#include "arbiter/arbiter.h"
+#include "diag/alloc_counter.h"
+#include "ipc/body_link.h"
+#include "ipc/world_state.h"
+#include "lizard/lizard.h"
+#include "lizard/novelty.h"
+#include "lizard/reflex_rules.h"
+#include "memory/event_log.h"
+#include "soul/response_cache.h"
+#include "vision/frame_gate.h"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <unistd.h>
+
+using namespace prometheus;
+
+PROMETHEUS_BENCH(hot_loop_alloc) {
+    using clock = std::chrono::steady_clock;
+    const size_t ticks  = std::stoul(bench::env_or("PROMETHEUS_BENCH_TICKS", "20000"));
+    const size_t warmup = 1800;                 // three stream cycles: buffers reach size
+
+    const std::string dir = (std::filesystem::temp_directory_path() /
+        ("prometheus_hot_loop_" + std::to_string(::getpid()))).string();
+    std::filesystem::remove_all(dir);
+
+    Memory    memory;
+    Lizard    lizard(memory);
+    Soul      soul("http://127.0.0.1:9", memory);
+    BodyLink  body("tcp://127.0.0.1:5555");     // never connected: send_action is a no-op
+    Arbiter   arbiter(lizard, soul, body);
+    EventLog  event_log;
+    FrameGate frame_gate;
+    NoveltyDetector novelty;
+    event_log.open(dir);
+    arbiter.set_event_log(&event_log);
+    if (auto rule = LessonCompiler().compile("Flee creepers at under 6 blocks.")) {
+        lizard.install_rules(std::make_shared<const RuleSet>(RuleSet().merged({*rule}, 32)));
+    }
+
+    // Restarting the cycle restarts seq at 1 under a keyframe, which
+    // WorldState accepts like a body restart.
+    const auto cycle = bench::stream_cycle();
+    WorldState world;
+    Percept    percept;
+    size_t     novel = 0;
+    auto tick = [&](const std::string& msg) {
+        world.apply(msg);
+        world.percept(percept);
+        percept.raw_json.assign(msg);
+        event_log.percept(percept);
+        frame_gate.note_percept(percept);
+        arbiter.note_situation(situation_signature(percept));
+        auto reflex = lizard.react(percept);
+        event_log.reflex(reflex);
+        if (novelty.observe(percept)) ++novel;
+        arbiter.submit_reflex(reflex);
+        arbiter.dispatch_tick();
+    };
+
+    for (size_t i = 0; i < warmup; ++i) tick(cycle[i % cycle.size()]);
+    const size_t novel_warm = novel;
+
+    uint64_t allocs = 0, allocating_ticks = 0;
+    auto t0 = clock::now();
+    for (size_t i = 0; i < ticks; ++i) {
+        AllocScope scope;
+        tick(cycle[i % cycle.size()]);
+        allocs += scope.count();
+        allocating_ticks += scope.count() > 0;
+    }
+    double tick_ns = bench::seconds_since(t0) * 1e9 / static_cast<double>(ticks);
+
+    // The old path: a DOM per message.
+    uint64_t dom_allocs = 0;
+    for (auto& msg : cycle) {
+        AllocScope scope;
+        auto j = nlohmann::json::parse(msg);
+        dom_allocs += scope.count();
+    }
+
+    auto ws  = world.stats();
+    auto dec = arbiter.decisions();
+    event_log.close();
+    std::filesystem::remove_all(dir);
+
+    bench::Report("hot_loop_alloc")
+        .set("alloc_counter", AllocCounter::enabled())
+        .set("ticks", ticks)
+        .set("allocs", allocs)
+        .set("allocating_ticks", allocating_ticks)
+        .set("allocs_per_tick", static_cast<double>(allocs) / static_cast<double>(ticks))
+        .set("tick_ns", tick_ns)
+        .set("json_dom_allocs_per_msg", static_cast<double>(dom_allocs) / static_cast<double>(cycle.size()))
+        .set("keyframes", ws.keyframes)
+        .set("deltas", ws.deltas)
+        .set("gaps", ws.gaps)
+        .set("novelty_fired_warmup", novel_warm)
+        .set("novelty_fired_measured", novel - novel_warm)
+        .set("learned_reflexes", lizard.learned_reflexes())
+        .set("decisions", dec.reflex + dec.learned + dec.soul)
+        .emit();
+
+    if (!AllocCounter::enabled()) {
+        std::cerr << "hot_loop_alloc: allocation counter not built in "
+                  << "(-DPROMETHEUS_ALLOC_COUNTER=ON); counts are zero.\n";
+    } else if (allocs) {
+        bench::fail("hot_loop_alloc: " + std::to_string(allocs) + " allocations in " +
+                    std::to_string(allocating_ticks) + " of " + std::to_string(ticks) +
+                    " steady-state ticks");
+    }
+}
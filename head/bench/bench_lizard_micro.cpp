@@ -0,0 +1,106 @@
+// Distilled Layer 1 micro-model: agreement and evaluation latency.
+//
+//   python3 scripts/train_micro_model.py --synthetic 30000
+//       --out /tmp/lizard-micro.pmm --holdout-csv /tmp/holdout.csv
+//   ./build/prometheus_bench lizard_micro
+//
+// PROMETHEUS_MICRO_MODEL and PROMETHEUS_MICRO_HOLDOUT override those paths.
+//
+// Scores the model on the trainer's held-out rows — overall agreement
+// with the logged action, and coverage/agreement at the confidence gate
+// (the rest would go to the LLM) — which should match the trainer's own
+// report. Then times predict() per call and in a tight loop.
+
+#include "bench.h"
+
+#include "lizard/micro_model.h"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace prometheus;
+
+PROMETHEUS_BENCH(lizard_micro) {
+    using clock = std::chrono::steady_clock;
+    const std::string model_path = bench::env_or("PROMETHEUS_MICRO_MODEL", "/tmp/lizard-micro.pmm");
+    const std::string csv_path   = bench::env_or("PROMETHEUS_MICRO_HOLDOUT", "/tmp/holdout.csv");
+    const float gate = std::stof(bench::env_or("PROMETHEUS_MICRO_CONFIDENCE", "0.8"));
+
+    MicroModel model;
+    std::string error;
+    if (!model.load(model_path, &error)) {
+        std::cerr << "lizard_micro: cannot load " << model_path << " (" << error
+                  << "); train one with scripts/train_micro_model.py\n";
+        return;
+    }
+
+    // Held-out rows: features..., label
+    std::vector<std::array<float, MicroModel::kFeatures>> rows;
+    std::vector<int> labels;
+    std::ifstream in(csv_path);
+    std::string line;
+    std::getline(in, line);     // header
+    while (std::getline(in, line)) {
+        std::stringstream ss(line);
+        std::array<float, MicroModel::kFeatures> x{};
+        std::string cell;
+        for (auto& v : x) {
+            std::getline(ss, cell, ',');
+            v = std::stof(cell);
+        }
+        std::getline(ss, cell);
+        int label = -1;
+        for (size_t c = 0; c < model.classes(); ++c) {
+            if (model.class_name(static_cast<int>(c)) == cell) label = static_cast<int>(c);
+        }
+        rows.push_back(x);
+        labels.push_back(label);
+    }
+    if (rows.empty()) {
+        std::cerr << "lizard_micro: no held-out rows in " << csv_path << "\n";
+        return;
+    }
+
+    size_t agree = 0, confident = 0, confident_agree = 0;
+    std::vector<double> ns;
+    ns.reserve(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        auto t = clock::now();
+        auto p = model.predict(rows[i].data());
+        ns.push_back(std::chrono::duration<double, std::nano>(clock::now() - t).count());
+        agree += p.cls == labels[i];
+        if (p.confidence >= gate) {
+            ++confident;
+            confident_agree += p.cls == labels[i];
+        }
+    }
+    std::sort(ns.begin(), ns.end());
+
+    // Throughput without per-call clock reads.
+    const size_t reps = std::max<size_t>(1, 2000000 / rows.size());
+    int sink = 0;
+    auto t0 = clock::now();
+    for (size_t r = 0; r < reps; ++r) {
+        for (auto& x : rows) sink += model.predict(x.data()).cls;
+    }
+    double loop_ns = bench::seconds_since(t0) * 1e9 / static_cast<double>(reps * rows.size());
+
+    const double n = static_cast<double>(rows.size());
+    bench::Report("lizard_micro")
+        .set("model_bytes", model.bytes())
+        .set("trees", model.trees())
+        .set("held_out", rows.size())
+        .set("agreement", static_cast<double>(agree) / n)
+        .set("confidence_gate", gate)
+        .set("coverage", static_cast<double>(confident) / n)
+        .set("agreement_when_confident",
+             confident ? static_cast<double>(confident_agree) / static_cast<double>(confident) : 0.0)
+        .set("predict_p50_ns", ns[ns.size() / 2])
+        .set("predict_p99_ns", ns[ns.size() * 99 / 100])
+        .set("predict_loop_ns", loop_ns)
+        .set("sink", sink & 1)
+        .emit();
+}
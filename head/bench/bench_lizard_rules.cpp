@@ -0,0 +1,125 @@
+// Teacher lessons compiled into Lizard reflex rules.
+//
+//   ./build/prometheus_bench lizard_rules
+//
+// Compiles a day's worth of typical lessons against a synthetic 20-minute
+// percept stream (10 Hz; health and food drift, mobs wander in and out),
+// installs the rules, and replays the stream through Lizard::react with
+// and without them. Reports how many lessons compiled, react() latency,
+// and how many percepts that fell through to Layer 1 (the Soul's turf)
+// a learned rule now handles.
+
+#include "bench.h"
+
+#include "lizard/lizard.h"
+#include "lizard/reflex_rules.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+using namespace prometheus;
+
+namespace {
+
+std::vector<Percept> synthetic_day(size_t n) {
+    static const char* kNames[] = {"creeper", "zombie", "skeleton", "cow", "sheep", "spider"};
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> step(-0.3f, 0.3f);
+    float health = 20, food = 20;
+    std::vector<Percept> out;
+    out.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        health = std::clamp(health + step(rng), 4.0f, 20.0f);
+        food   = std::clamp(food - 0.004f + (rng() % 600 == 0 ? 12.0f : 0.0f), 0.0f, 20.0f);
+        Percept p;
+        p.health = health;
+        p.hunger = food;
+        for (int e = static_cast<int>(rng() % 4); e > 0; --e) {
+            const char* name = kNames[rng() % std::size(kNames)];
+            // Sighted but not yet flagged: the body marks a mob hostile once it targets us.
+            p.entities.push_back({name, 2.0f + static_cast<float>(rng() % 300) / 10.0f, false});
+        }
+        std::sort(p.entities.begin(), p.entities.end(),
+                  [](const NearbyEntity& a, const NearbyEntity& b) { return a.distance < b.distance; });
+        p.entity_count = static_cast<int>(p.entities.size());
+        out.push_back(std::move(p));
+    }
+    return out;
+}
+
+double percentile(std::vector<double> v, double q) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, static_cast<size_t>(q * static_cast<double>(v.size())))];
+}
+
+} // namespace
+
+PROMETHEUS_BENCH(lizard_rules) {
+    using clock = std::chrono::steady_clock;
+    const size_t n = std::stoul(bench::env_or("PROMETHEUS_BENCH_PERCEPTS", "12000"));
+
+    static const std::vector<std::string> kLessons = {
+        "Flee creepers at under 6 blocks.",
+        "Eat at food < 10.",
+        "Retreat from skeletons within 8 blocks when health is below 12.",
+        "Run away from zombies closer than 3 blocks.",
+        "Eat when hunger drops to 19.",              // fires nearly always → rejected
+        "Retreat before health gets critical.",      // no threshold → context
+        "Keep explore short when nothing threatens.",
+    };
+
+    Memory memory;
+    Lizard lizard(memory);
+    auto day = synthetic_day(n);
+
+    // The Lizard samples what it sees; compile against that.
+    for (auto& p : day) lizard.react(p);
+    auto t0 = clock::now();
+    auto result = LessonCompiler().compile_all(kLessons, lizard.recent_percepts());
+    double compile_ms = bench::seconds_since(t0) * 1000;
+
+    auto replay = [&](std::vector<Reflex>& out) {
+        std::vector<double> ns;
+        ns.reserve(day.size());
+        out.clear();
+        for (auto& p : day) {
+            auto t = clock::now();
+            out.push_back(lizard.react(p));
+            ns.push_back(std::chrono::duration<double, std::nano>(clock::now() - t).count());
+        }
+        return ns;
+    };
+
+    std::vector<Reflex> before, after;
+    auto ns_before = replay(before);
+    lizard.install_rules(std::make_shared<const RuleSet>(RuleSet().merged(result.rules, 32)));
+    auto ns_after = replay(after);
+
+    size_t layer1_before = 0, moved = 0;
+    for (size_t i = 0; i < day.size(); ++i) {
+        bool layer1 = before[i].action_json.find("no_threat") != std::string::npos;
+        layer1_before += layer1;
+        moved += layer1 && after[i].learned;
+    }
+
+    for (auto& r : result.rules) std::cerr << "  rule " << r.id << "  ← " << r.lesson << "\n";
+    for (auto& r : result.rejected) std::cerr << "  rejected (" << r.reason << ")  " << r.lesson << "\n";
+
+    bench::Report("lizard_rules")
+        .set("lessons", kLessons.size())
+        .set("compiled", result.rules.size())
+        .set("rejected", result.rejected.size())
+        .set("uncompiled", result.uncompiled.size())
+        .set("compile_ms", compile_ms)
+        .set("percepts", day.size())
+        .set("react_p50_ns_before", percentile(ns_before, 0.5))
+        .set("react_p99_ns_before", percentile(ns_before, 0.99))
+        .set("react_p50_ns_after", percentile(ns_after, 0.5))
+        .set("react_p99_ns_after", percentile(ns_after, 0.99))
+        .set("layer1_percepts", layer1_before)
+        .set("moved_to_rules", moved)
+        .set("moved_share", layer1_before ? static_cast<double>(moved) / static_cast<double>(layer1_before) : 0.0)
+        .emit();
+}
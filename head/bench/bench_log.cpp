@@ -0,0 +1,210 @@
+// Asynchronous logger cost and correctness.
+//
+//   ./build/prometheus_bench log_overhead
+//
+// PROMETHEUS_BENCH_OPS (default 1000000) sets the calls per measurement.
+//
+// Times a PROMETHEUS_LOG call on the producer side — an integer, a double
+// and a short string, the shape of the Lizard and BodyLink lines — with
+// the logger writing to a file and not the console. Calls run in bursts
+// that fit the thread's ring, flushed between bursts outside the timing,
+// so the number is the producer's cost and not the ring-full drop path.
+// Alongside: a line below the level, a rate-limited line that is
+// suppressed, the clock read every call pays, and a mutex-guarded
+// fprintf to /dev/null for contrast.
+//
+// Then checks that a warm call does not allocate, that four threads
+// logging at once lose nothing they were not told about (written +
+// dropped == logged, and the file holds every written line), that a long
+// string is cut short and says so, and that the file rotates and keeps
+// only keep_files old copies.
+//
+// In optimised builds (NDEBUG) the run fails (exit code 2) if a line
+// costs more than 40 ns on top of its clock read, or a filtered line more
+// than 2 ns.
+
+#include "bench.h"
+
+#include "diag/alloc_counter.h"
+#include "log/log.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace prometheus;
+
+namespace {
+
+template <typename F>
+double ns_per_op(size_t ops, F&& op) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ops; ++i) op(i);
+    return bench::seconds_since(t0) * 1e9 / static_cast<double>(ops);
+}
+
+// Like ns_per_op, but flushes the logger every `burst` calls outside the
+// timed region.
+template <typename F>
+double ns_per_logged_op(size_t ops, size_t burst, F&& op) {
+    double total_s = 0;
+    for (size_t done = 0; done < ops;) {
+        const size_t n = std::min(burst, ops - done);
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < n; ++i) op(done + i);
+        total_s += bench::seconds_since(t0);
+        done += n;
+        Logger::flush();
+    }
+    return total_s * 1e9 / static_cast<double>(ops);
+}
+
+size_t count_lines(const std::string& path, const std::string& needle) {
+    std::ifstream in(path);
+    size_t n = 0;
+    for (std::string line; std::getline(in, line);) {
+        if (line.find(needle) != std::string::npos) ++n;
+    }
+    return n;
+}
+
+} // namespace
+
+PROMETHEUS_BENCH(log_overhead) {
+    const size_t ops = std::stoul(bench::env_or("PROMETHEUS_BENCH_OPS", "1000000"));
+    constexpr double kRecordBudgetNs = 40.0, kFilteredBudgetNs = 2.0;
+    constexpr size_t kBurst = 512;      // ~40 KiB of records: inside the default ring
+
+    const std::string dir = "/tmp/prometheus-bench-log-" + std::to_string(::getpid());
+    std::filesystem::create_directories(dir);
+    const std::string path = dir + "/head.log";
+
+    Logger::Config cfg;
+    cfg.console = false;
+    cfg.path    = path;
+    if (!Logger::start(cfg)) bench::fail("log_overhead: cannot open " + path);
+
+    // ── Producer cost ───────────────────────────────────────────
+    const std::string mob = "zombie";
+    uint64_t sink = 0;
+    double clock_ns = ns_per_op(ops, [&](size_t) { sink += detail::log_now_ns(); });
+    double log_ns   = ns_per_logged_op(ops, kBurst, [&](size_t i) {
+        PROMETHEUS_LOG(Info, "[BENCH] tick {} hp {} near {}", i, 17.5, mob);
+    });
+    double filtered_ns = ns_per_op(ops, [&](size_t i) {
+        PROMETHEUS_LOG(Debug, "[BENCH] filtered {} {}", i, mob);
+    });
+    double suppressed_ns = ns_per_op(ops, [&](size_t i) {
+        PROMETHEUS_LOG_EVERY(60000, Warn, "[BENCH] suppressed {}", i);
+    });
+    const double record_ns = log_ns - clock_ns;
+
+    std::mutex   fprintf_mu;
+    std::FILE*   devnull     = std::fopen("/dev/null", "w");
+    const double fprintf_ns  = ns_per_op(ops, [&](size_t i) {
+        std::lock_guard lock(fprintf_mu);
+        std::fprintf(devnull, "[BENCH] tick %zu hp %g near %s\n", i, 17.5, mob.c_str());
+    });
+    std::fclose(devnull);
+
+    uint64_t allocs = 0;
+    {
+        AllocScope scope;
+        for (size_t i = 0; i < 256; ++i) {
+            PROMETHEUS_LOG(Info, "[BENCH] alloc {} {} {}", i, 0.5, mob);
+        }
+        allocs = scope.count();
+    }
+    Logger::flush();
+
+    // ── Four producers ──────────────────────────────────────────
+    constexpr size_t kThreads = 4, kPerThread = 20000;
+    const auto before = Logger::stats();
+    std::vector<std::thread> producers;
+    for (size_t t = 0; t < kThreads; ++t) {
+        producers.emplace_back([t] {
+            for (size_t i = 0; i < kPerThread; ++i) {
+                PROMETHEUS_LOG(Info, "[BENCH] thread {} line {}", t, i);
+                if (i % 256 == 255) std::this_thread::yield();
+            }
+        });
+    }
+    for (auto& p : producers) p.join();
+    Logger::flush();
+    const auto after       = Logger::stats();
+    const uint64_t written = after.lines - before.lines;
+    const uint64_t dropped = after.dropped - before.dropped;
+    const bool threads_ok  = written + dropped == kThreads * kPerThread &&
+                             count_lines(path, "[BENCH] thread ") == written;
+
+    // ── Truncation ──────────────────────────────────────────────
+    const std::string huge(10000, 'x');
+    PROMETHEUS_LOG(Info, "[BENCH] huge {}", huge);
+    Logger::stop();
+    const bool truncated_ok = count_lines(path, "bytes)") == 1;
+
+    // ── Rotation ────────────────────────────────────────────────
+    Logger::Config rot = cfg;
+    rot.path       = dir + "/rotate.log";
+    rot.file_bytes = 16 * 1024;
+    rot.keep_files = 2;
+    const uint64_t rotations_before = Logger::stats().rotations;
+    Logger::start(rot);
+    for (size_t i = 0; i < 4000; ++i) {
+        PROMETHEUS_LOG(Info, "[BENCH] rotate {}", i);
+        if (i % 256 == 255) Logger::flush();
+    }
+    Logger::stop();
+    const uint64_t rotations = Logger::stats().rotations - rotations_before;
+    namespace fs = std::filesystem;
+    const bool rotation_ok = rotations > 0 && fs::exists(rot.path + ".1") &&
+                             fs::exists(rot.path + ".2") && !fs::exists(rot.path + ".3") &&
+                             fs::file_size(rot.path + ".1") <= rot.file_bytes + 256;
+
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+    (void)sink;
+
+    bench::Report("log_overhead")
+        .set("ops", ops)
+        .set("clock_ns", clock_ns)
+        .set("log_ns", log_ns)
+        .set("record_ns", record_ns)
+        .set("filtered_ns", filtered_ns)
+        .set("suppressed_ns", suppressed_ns)
+        .set("locked_fprintf_ns", fprintf_ns)
+        .set("log_allocs", allocs)
+        .set("threads", kThreads)
+        .set("thread_lines", written)
+        .set("thread_dropped", dropped)
+        .set("threads_ok", threads_ok)
+        .set("truncated_ok", truncated_ok)
+        .set("rotations", rotations)
+        .set("rotation_ok", rotation_ok)
+        .emit();
+
+    if (!threads_ok) bench::fail("log_overhead: lines lost without being counted as dropped");
+    if (!truncated_ok) bench::fail("log_overhead: long string not cut short with a note");
+    if (!rotation_ok) bench::fail("log_overhead: log file did not rotate as configured");
+    if (AllocCounter::enabled() && allocs) {
+        bench::fail("log_overhead: " + std::to_string(allocs) + " allocations while logging");
+    }
+#ifdef NDEBUG
+    if (record_ns > kRecordBudgetNs || filtered_ns > kFilteredBudgetNs) {
+        bench::fail("log_overhead: " + std::to_string(record_ns) + " ns per line / " +
+                    std::to_string(filtered_ns) + " ns filtered (budget " +
+                    std::to_string(kRecordBudgetNs) + " / " + std::to_string(kFilteredBudgetNs) +
+                    " ns)");
+    }
+#else
+    (void)kRecordBudgetNs;
+    (void)kFilteredBudgetNs;
+    std::cerr << "log_overhead: unoptimised build; the budgets are checked only with NDEBUG.\n";
+#endif
+}
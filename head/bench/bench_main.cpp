@@ -0,0 +1,80 @@
+#include "bench.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+
+namespace prometheus::bench {
+
+// Results stream: the real stdout. std::cout itself is redirected to
+// stderr in main() so subsystem log lines don't interleave with records.
+static std::ostream& results() {
+    static std::ostream out(std::cout.rdbuf());
+    return out;
+}
+
+static std::map<std::string, BenchFn>& registry() {
+    static std::map<std::string, BenchFn> benches;
+    return benches;
+}
+
+bool register_bench(const char* name, BenchFn fn) {
+    registry()[name] = fn;
+    return true;
+}
+
+void Report::emit() const {
+    results() << j_.dump() << std::endl;
+}
+
+static int& failures() {
+    static int n = 0;
+    return n;
+}
+
+void fail(const std::string& why) {
+    std::cerr << "[BENCH] FAILED: " << why << "\n";
+    ++failures();
+}
+
+std::string env_or(const char* name, const std::string& fallback) {
+    const char* v = std::getenv(name);
+    return v ? v : fallback;
+}
+
+} // namespace prometheus::bench
+
+// Usage: prometheus_bench [--list] [filter...]
+// With no filter every benchmark runs; otherwise those whose name
+// contains any filter substring.
+int main(int argc, char* argv[]) {
+    auto& benches = prometheus::bench::registry();
+
+    if (argc > 1 && std::strcmp(argv[1], "--list") == 0) {
+        for (auto& [name, fn] : benches) std::cout << name << "\n";
+        return 0;
+    }
+
+    prometheus::bench::results();           // bind to the real stdout first
+    std::cout.rdbuf(std::cerr.rdbuf());
+
+    int ran = 0;
+    for (auto& [name, fn] : benches) {
+        bool selected = argc <= 1;
+        for (int i = 1; i < argc && !selected; ++i) {
+            selected = name.find(argv[i]) != std::string::npos;
+        }
+        if (!selected) continue;
+
+        std::cerr << "[BENCH] " << name << "\n";
+        fn();
+        ++ran;
+    }
+
+    if (!ran) {
+        std::cerr << "[BENCH] No benchmark matched.\n";
+        return 1;
+    }
+    return prometheus::bench::failures() ? 2 : 0;
+}
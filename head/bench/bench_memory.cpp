@@ -0,0 +1,83 @@
+// Concurrent short-term marker traffic.
+//
+//   ./build/prometheus_bench memory_tag_read
+//
+// One writer tags markers at full speed (as the Lizard does under
+// pressure) while reader threads render the marker context (as the Soul
+// and Circadian threads do). Reports tag and read throughput plus read
+// latency percentiles for 1, 2 and 4 readers.
+
+#include "bench.h"
+
+#include "memory/memory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace prometheus;
+
+PROMETHEUS_BENCH(memory_tag_read) {
+    using clock = std::chrono::steady_clock;
+    const double seconds = std::stod(bench::env_or("PROMETHEUS_BENCH_SECONDS", "1"));
+
+    // A realistic vocabulary: a few dozen distinct markers, heavily repeated.
+    std::vector<std::string> vocab;
+    for (int i = 0; i < 48; ++i) vocab.push_back("[MEM:EVENT_" + std::to_string(i) + "]");
+
+    for (int readers : {1, 2, 4}) {
+        Memory memory;
+        std::atomic<bool>     running{true};
+        std::atomic<uint64_t> tags{0};
+        std::vector<std::vector<double>> latencies(readers);
+        std::vector<size_t> bytes(readers, 0);
+
+        std::thread writer([&] {
+            uint64_t n = 0;
+            while (running.load(std::memory_order_relaxed)) {
+                memory.tag(vocab[(n * 7) % vocab.size()]);
+                ++n;
+            }
+            tags.store(n);
+        });
+
+        std::vector<std::thread> pool;
+        for (int r = 0; r < readers; ++r) {
+            pool.emplace_back([&, r] {
+                auto& lat = latencies[r];
+                lat.reserve(1 << 20);
+                while (running.load(std::memory_order_relaxed)) {
+                    auto t0 = clock::now();
+                    auto s  = memory.active_markers();
+                    lat.push_back(std::chrono::duration<double, std::nano>(
+                        clock::now() - t0).count());
+                    bytes[r] += s.size();
+                }
+            });
+        }
+
+        auto t0 = clock::now();
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        running.store(false);
+        writer.join();
+        for (auto& t : pool) t.join();
+        double wall = bench::seconds_since(t0);
+
+        std::vector<double> all;
+        for (auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+        std::sort(all.begin(), all.end());
+        auto pct = [&](double p) {
+            return all.empty() ? 0.0 : all[static_cast<size_t>(p * (all.size() - 1))];
+        };
+
+        bench::Report("memory_tag_read")
+            .set("readers", readers)
+            .set("tags_per_s", tags.load() / wall)
+            .set("reads_per_s", all.size() / wall)
+            .set("read_p50_ns", pct(0.50))
+            .set("read_p99_ns", pct(0.99))
+            .set("read_max_ns", all.empty() ? 0.0 : all.back())
+            .emit();
+    }
+}
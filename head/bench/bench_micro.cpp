@@ -0,0 +1,357 @@
+// Microbenchmarks for the per-call cost of the Head's hot paths.
+//
+//   ./build/prometheus_bench poll_percept
+//   ./build/prometheus_bench lizard_react
+//   ./build/prometheus_bench arbiter_contention
+//   ./build/prometheus_bench soul_prompt
+//
+// poll_percept       BodyLink::poll_percept over a real loopback ZMQ socket
+//                    pair, per message (receive, WorldState patch, Percept
+//                    refill), against a nlohmann DOM parse of the same
+//                    messages. PROMETHEUS_BENCH_PERCEPTS names recorded
+//                    body messages (one per line); the synthetic stream
+//                    otherwise. PROMETHEUS_BENCH_MESSAGES (20000) sets the
+//                    count.
+// lizard_react       Lizard::react per decision path: critical health,
+//                    hostile, learned rule, hungry, and the Layer 1
+//                    fallthrough. PROMETHEUS_BENCH_OPS (200000) per path.
+// arbiter_contention submit_reflex from PROMETHEUS_BENCH_THREADS (4)
+//                    threads while another runs dispatch_tick flat out:
+//                    submit cost alone and contended (thread CPU time),
+//                    and dispatch_tick latency quantiles.
+// soul_prompt        file_to_base64 on a screenshot-sized file and
+//                    build_council_messages for a vision query with a full
+//                    marker string and recalled passages. Then truncates an
+//                    oversized multibyte (UTF-8) query at every budget from
+//                    64 to 1024 tokens; the run fails (exit code 2) if a
+//                    cut leaves invalid UTF-8 that the JSON encoder rejects.
+//
+// Memory::tag / active_markers are covered by memory_tag_read.
+
+#include "bench.h"
+#include "percept_fixture.h"
+
+#include "arbiter/arbiter.h"
+#include "ipc/body_link.h"
+#include "lizard/lizard.h"
+#include "lizard/reflex_rules.h"
+#include "metrics/metrics.h"
+#include "soul/prompt.h"
+#include "soul/soul.h"
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#if HAS_ZMQ
+#include <zmq.h>
+#endif
+
+using namespace prometheus;
+
+namespace {
+
+template <typename F>
+double ns_per_op(size_t ops, F&& op) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ops; ++i) op(i);
+    return bench::seconds_since(t0) * 1e9 / static_cast<double>(ops);
+}
+
+double thread_cpu_ns() {
+    timespec ts{};
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) * 1e9 + static_cast<double>(ts.tv_nsec);
+}
+
+} // namespace
+
+// ── poll_percept ────────────────────────────────────────────────
+
+PROMETHEUS_BENCH(poll_percept) {
+#if !HAS_ZMQ
+    bench::Report("poll_percept").set("skipped", "built without ZeroMQ").emit();
+#else
+    const size_t total = std::stoul(bench::env_or("PROMETHEUS_BENCH_MESSAGES", "20000"));
+    constexpr size_t kBatch = 64;       // BodyLink drains at most this many per call
+
+    std::string source;
+    const auto msgs = bench::recorded_percepts(&source);
+
+    // The fake body binds, as body/bot.js does; BodyLink connects.
+    void* ctx  = zmq_ctx_new();
+    void* pub  = zmq_socket(ctx, ZMQ_PUB);
+    void* pull = zmq_socket(ctx, ZMQ_PULL);
+    zmq_bind(pub, "tcp://127.0.0.1:*");
+    zmq_bind(pull, "tcp://127.0.0.1:*");
+    char sub_ep[256], push_ep[256];
+    size_t len = sizeof sub_ep;
+    zmq_getsockopt(pub, ZMQ_LAST_ENDPOINT, sub_ep, &len);
+    len = sizeof push_ep;
+    zmq_getsockopt(pull, ZMQ_LAST_ENDPOINT, push_ep, &len);
+
+    BodyLink body(sub_ep, push_ep);
+    body.connect();
+    Percept percept;
+
+    size_t next = 0;
+    auto publish = [&](size_t n) {
+        for (size_t i = 0; i < n; ++i, ++next) {
+            const auto& m = msgs[next % msgs.size()];
+            zmq_send(pub, m.data(), m.size(), 0);
+        }
+    };
+
+    // Subscriptions propagate asynchronously: publish until one lands,
+    // then one full pass so the state and buffers are warm.
+    for (int i = 0; i < 500 && !body.poll_percept(percept); ++i) {
+        publish(1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    for (size_t done = 0; done < msgs.size(); done += kBatch) {
+        publish(kBatch);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        while (body.poll_percept(percept)) {}
+    }
+
+    // Publish a batch, let it queue, then time the drain.
+    const auto before = body.stream_stats();
+    double   poll_ns  = 0;
+    size_t   measured = 0, updates = 0;
+    while (measured < total) {
+        publish(kBatch);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        auto t0 = std::chrono::steady_clock::now();
+        while (body.poll_percept(percept)) ++updates;
+        poll_ns  += bench::seconds_since(t0) * 1e9;
+        measured += kBatch;
+    }
+    const auto after = body.stream_stats();
+    const uint64_t received = (after.keyframes + after.deltas) - (before.keyframes + before.deltas);
+
+    // Contrast: a DOM parse of the same messages, which poll_percept avoids.
+    size_t keys = 0;
+    double dom_ns = ns_per_op(total, [&](size_t i) {
+        keys += nlohmann::json::parse(msgs[i % msgs.size()]).size();
+    });
+
+    body.disconnect();
+    zmq_close(pub);
+    zmq_close(pull);
+    zmq_ctx_destroy(ctx);
+
+    bench::Report("poll_percept")
+        .set("source", source)
+        .set("messages", measured)
+        .set("received", received)
+        .set("updates", updates)
+        .set("gaps", after.gaps - before.gaps)
+        .set("errors", after.errors - before.errors)
+        .set("poll_ns_per_msg", poll_ns / static_cast<double>(std::max<uint64_t>(received, 1)))
+        .set("dom_parse_ns", dom_ns)
+        .set("dom_keys", keys)
+        .emit();
+
+    if (after.errors != before.errors) bench::fail("poll_percept: messages failed to parse");
+#endif
+}
+
+// ── lizard_react ────────────────────────────────────────────────
+
+PROMETHEUS_BENCH(lizard_react) {
+    const size_t ops = std::stoul(bench::env_or("PROMETHEUS_BENCH_OPS", "200000"));
+
+    Memory memory;
+    Lizard lizard(memory);
+    if (auto rule = LessonCompiler().compile("Flee creepers at under 6 blocks.")) {
+        lizard.install_rules(std::make_shared<const RuleSet>(RuleSet().merged({*rule}, 32)));
+    }
+
+    auto base = [] {
+        Percept p;
+        p.health = 18;
+        p.hunger = 18;
+        p.entities.push_back({"cow", 12.0f, false});
+        p.entity_count = 1;
+        return p;
+    };
+    Percept critical = base(), hostile = base(), learned = base(), hungry = base(), idle = base();
+    critical.health = 3;
+    hostile.hostile_nearby = true;
+    hostile.entities.insert(hostile.entities.begin(), {"zombie", 5.0f, true});
+    learned.entities.insert(learned.entities.begin(), {"creeper", 4.0f, false});
+    hungry.hunger = 4;
+    for (auto* p : {&hostile, &learned}) p->entity_count = static_cast<int>(p->entities.size());
+
+    bench::Report report("lizard_react");
+    report.set("ops", ops);
+    struct Path { const char* name; const Percept* p; const char* expect; };
+    bool paths_ok = true;
+    for (const Path& path : {Path{"critical", &critical, "critical_health"},
+                             Path{"hostile", &hostile, "hostile_nearby"},
+                             Path{"learned", &learned, "flee"},
+                             Path{"hungry", &hungry, "hungry"},
+                             Path{"layer1", &idle, "no_threat"}}) {
+        paths_ok &= lizard.react(*path.p).action_json.find(path.expect) != std::string_view::npos;
+        // Critical health tags a memory marker per call; keep the ring bounded.
+        const size_t n = path.p == &critical ? std::min<size_t>(ops, 20000) : ops;
+        report.set(std::string(path.name) + "_ns",
+                   ns_per_op(n, [&](size_t) { (void)lizard.react(*path.p); }));
+    }
+    report.set("paths_ok", paths_ok).emit();
+
+    if (!paths_ok) bench::fail("lizard_react: a percept took the wrong decision path");
+}
+
+// ── arbiter_contention ──────────────────────────────────────────
+
+PROMETHEUS_BENCH(arbiter_contention) {
+    const size_t ops     = std::stoul(bench::env_or("PROMETHEUS_BENCH_OPS", "200000"));
+    const size_t threads = std::stoul(bench::env_or("PROMETHEUS_BENCH_THREADS", "4"));
+
+    Memory   memory;
+    Lizard   lizard(memory);
+    Soul     soul("http://127.0.0.1:9", memory);
+    BodyLink body("tcp://127.0.0.1:5555");     // never connected: send_action is a no-op
+    Arbiter  arbiter(lizard, soul, body);
+
+    auto reflex = [](size_t i) {
+        Reflex r{};
+        const bool threat = i % 8 == 0;
+        r.layer       = threat ? Reflex::Layer::Avoid : Reflex::Layer::Tactic;
+        r.action_json = threat ? R"({"action":"flee","reason":"hostile_nearby"})"
+                               : R"({"action":"idle","reason":"no_threat"})";
+        r.urgency     = threat ? 0.9f : 0.0f;
+        r.vetoes_soul = threat;
+        r.percept_seq = i;
+        return r;
+    };
+
+    // ── Alone ───────────────────────────────────────────────────
+    double submit_ns   = ns_per_op(ops, [&](size_t i) { arbiter.submit_reflex(reflex(i)); });
+    double dispatch_ns = ns_per_op(ops, [&](size_t i) {
+        arbiter.submit_reflex(reflex(i));
+        arbiter.dispatch_tick();
+    }) - submit_ns;
+
+    // ── Contended ───────────────────────────────────────────────
+    auto ticks = std::make_unique<Histogram>();
+    std::atomic<bool>   stop{false};
+    std::vector<double> cpu(threads);
+    std::thread dispatcher([&] {
+        while (!stop.load(std::memory_order_relaxed)) {
+            auto t0 = std::chrono::steady_clock::now();
+            arbiter.dispatch_tick();
+            ticks->record(std::chrono::steady_clock::now() - t0);
+        }
+    });
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            double c0 = thread_cpu_ns();
+            for (size_t i = 0; i < ops; ++i) arbiter.submit_reflex(reflex(i));
+            cpu[t] = thread_cpu_ns() - c0;
+        });
+    }
+    for (auto& th : pool) th.join();
+    stop.store(true);
+    dispatcher.join();
+    double submit_mt = 0;
+    for (double c : cpu) submit_mt += c;
+    submit_mt /= static_cast<double>(threads * ops);
+
+    auto snap = ticks->snapshot();
+    bench::Report("arbiter_contention")
+        .set("ops", ops)
+        .set("threads", threads)
+        .set("submit_ns", submit_ns)
+        .set("dispatch_tick_ns", dispatch_ns)
+        .set("submit_mt_ns", submit_mt)
+        .set("dispatch_ticks_mt", snap.count)
+        .set("dispatch_p50_ns", snap.quantile(0.5))
+        .set("dispatch_p99_ns", snap.quantile(0.99))
+        .set("dispatch_max_ns", snap.quantile(1.0))
+        .emit();
+}
+
+// ── soul_prompt ─────────────────────────────────────────────────
+
+PROMETHEUS_BENCH(soul_prompt) {
+    const size_t ops = std::stoul(bench::env_or("PROMETHEUS_BENCH_OPS", "200"));
+
+    // A 1280×720 PNG screenshot is ~1 MB; random bytes do not compress
+    // and give the encoder no easy patterns.
+    const std::string path = (std::filesystem::temp_directory_path() /
+        ("prometheus_soul_prompt_" + std::to_string(::getpid()) + ".png")).string();
+    {
+        std::mt19937_64 rng(42);
+        std::string bytes(1 << 20, '\0');
+        for (auto& c : bytes) c = static_cast<char>(rng());
+        std::ofstream(path, std::ios::binary).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+    std::string b64;
+    double b64_ns = ns_per_op(ops, [&](size_t) { b64 = file_to_base64(path); });
+    std::filesystem::remove(path);
+
+    SoulQuery query;
+    query.prompt = "Something changed: a zombie appeared and health dropped — the scene "
+                   "currently shows: a plains biome at dusk, a zombie approaching from the "
+                   "treeline, two cows grazing nearby.\nDescribe the current situation and "
+                   "suggest what we should do next.";
+    query.image_b64 = b64;
+    std::string markers;
+    for (int i = 0; i < 60; ++i) {
+        static const char* kVocab[] = {"[MEM:HOSTILE zombie]", "[MEM:NEAR_DEATH]", "[MEM:ATE bread]",
+                                       "[MEM:BIOME plains]", "[MEM:FLED creeper]", "[MEM:NIGHTFALL]"};
+        markers += kVocab[i % 6];
+        markers += ' ';
+    }
+    std::vector<std::string> recalled(4, "Last night a zombie cornered us by the river; "
+                                         "sprinting uphill and pillaring up two blocks kept "
+                                         "us out of reach until sunrise.");
+    PromptBudget   budget;
+    TokenEstimator estimator;
+    AssembledPrompt prompt;
+    double council_ns = ns_per_op(ops * 10, [&](size_t) {
+        prompt = build_council_messages(query, markers, budget, estimator, recalled);
+    });
+
+    // Oversized query, mostly 2- and 3-byte sequences: every budget cuts
+    // it somewhere else.
+    SoulQuery wide;
+    for (int i = 0; i < 400; ++i) wide.prompt += "Über die Brücke — 日本語のテキスト ";
+    size_t utf8_cuts = 0;
+    for (int target = 64; target <= 1024; ++target) {
+        PromptBudget tight;
+        tight.target_tokens = target;
+        auto cut = build_council_messages(wide, "", tight, estimator);
+        try {
+            (void)cut.messages.dump();
+        } catch (const nlohmann::json::exception& e) {
+            bench::fail("soul_prompt: truncated query at " + std::to_string(target) +
+                        " tokens is not valid UTF-8: " + e.what());
+            break;
+        }
+        utf8_cuts += cut.query_truncated ? 1 : 0;
+    }
+
+    bench::Report("soul_prompt")
+        .set("ops", ops)
+        .set("image_bytes", size_t{1} << 20)
+        .set("base64_us", b64_ns / 1e3)
+        .set("base64_mb_s", static_cast<double>(1 << 20) / b64_ns * 1e3)
+        .set("council_us", council_ns / 1e3)
+        .set("est_tokens", prompt.est_tokens)
+        .set("markers_kept", prompt.markers_kept)
+        .set("passages_kept", prompt.passages_kept)
+        .set("utf8_cuts", utf8_cuts)
+        .emit();
+}
@@ -0,0 +1,140 @@
+// Novelty-driven vs. fixed-timer Soul escalation.
+//
+//   ./build/prometheus_bench vibe_novelty
+//
+// Simulates PROMETHEUS_BENCH_HOURS of 10 Hz percepts: familiar passive
+// mobs wandering in and out, slow health noise, and every 2–8 minutes a
+// scripted event (a hostile mob type appears, a sharp health drop, a
+// biome change, or a crowd gathers). Compares the old 10 s vibe timer
+// with NoveltyDetector on escalations per hour and on delay from event
+// to trigger; reports events the detector missed (nothing within 10 s),
+// escalations not tied to any event, and observe() cost.
+//
+// The trigger delay is detector lag only, in simulated time. In the Head
+// a novelty trigger is escalated on the next scheduler dispatch, without
+// waiting for the screenshot or the vision model; the timer's vibe check
+// escalated only after both.
+
+#include "bench.h"
+
+#include "lizard/novelty.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace prometheus;
+
+PROMETHEUS_BENCH(vibe_novelty) {
+    using clock = NoveltyDetector::Clock;
+    using std::chrono::milliseconds;
+    const double hours = std::stod(bench::env_or("PROMETHEUS_BENCH_HOURS", "1"));
+    const auto   tick  = milliseconds(100);
+    const size_t n     = static_cast<size_t>(hours * 3600 * 10);
+    const auto   timer = milliseconds(10000);
+
+    static const char* kPassive[] = {"cow", "sheep", "chicken", "pig"};
+    static const char* kHostile[] = {"zombie", "skeleton", "creeper", "spider", "witch"};
+    static const char* kBiomes[]  = {"plains", "forest", "river", "taiga", "desert"};
+
+    std::mt19937 rng(5);
+    auto uniform = [&](int lo, int hi) { return lo + static_cast<int>(rng() % static_cast<unsigned>(hi - lo + 1)); };
+
+    // Scripted events, in ticks.
+    enum Kind { Hostile, Drop, Biome, Crowd };
+    struct Scripted { size_t at; Kind kind; };
+    std::vector<Scripted> events;
+    for (size_t at = static_cast<size_t>(uniform(1200, 4800)); at < n; at += static_cast<size_t>(uniform(1200, 4800))) {
+        events.push_back({at, static_cast<Kind>(rng() % 4)});
+    }
+
+    NoveltyDetector detector;
+    const clock::time_point t0 = clock::now();
+    std::vector<size_t> fires;
+    float  health = 20;
+    size_t biome = 0, next_event = 0, hostile_until = 0, crowd_until = 0, drop_until = 0;
+    const char* hostile = nullptr;
+    size_t hostile_i = 0;
+    double observe_ns = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+        if (next_event < events.size() && events[next_event].at == i) {
+            switch (events[next_event].kind) {
+            case Hostile:
+                hostile = kHostile[hostile_i++ % std::size(kHostile)];
+                hostile_until = i + static_cast<size_t>(uniform(100, 400));
+                break;
+            case Drop:  drop_until  = i + 15; break;
+            case Biome: biome = (biome + 1) % std::size(kBiomes); break;
+            case Crowd: crowd_until = i + static_cast<size_t>(uniform(100, 300)); break;
+            }
+            ++next_event;
+        }
+
+        Percept p;
+        health = i < drop_until ? std::max(2.0f, health - 0.45f)
+                                : std::min(20.0f, health + 0.01f * static_cast<float>(uniform(-2, 5)));
+        p.health = health;
+        p.biome  = kBiomes[biome];
+        for (int k = uniform(0, 2); k > 0; --k) {
+            p.entities.push_back({kPassive[rng() % std::size(kPassive)],
+                                  static_cast<float>(uniform(4, 30)), false});
+        }
+        if (i < crowd_until) {
+            for (int k = 0; k < 8; ++k) p.entities.push_back({kPassive[k % 4], static_cast<float>(uniform(3, 20)), false});
+        }
+        if (i < hostile_until && hostile) {
+            p.entities.push_back({hostile, static_cast<float>(uniform(6, 24)), true});
+            p.hostile_nearby = true;
+        }
+        p.entity_count = static_cast<int>(p.entities.size());
+
+        auto now = t0 + tick * static_cast<long>(i);
+        auto w0 = clock::now();
+        auto fired = detector.observe(p, now);
+        observe_ns += std::chrono::duration<double, std::nano>(clock::now() - w0).count();
+        if (fired) fires.push_back(i);
+    }
+
+    // Event → trigger delays.
+    const size_t window = 100;     // 10 s
+    std::vector<double> novelty_ms, timer_ms;
+    size_t missed = 0;
+    std::vector<bool> explained(fires.size(), false);
+    for (auto& e : events) {
+        auto it = std::lower_bound(fires.begin(), fires.end(), e.at);
+        if (it != fires.end() && *it - e.at <= window) {
+            novelty_ms.push_back(static_cast<double>(*it - e.at) * 100.0);
+            explained[static_cast<size_t>(it - fires.begin())] = true;
+        } else {
+            ++missed;
+        }
+        const size_t period = static_cast<size_t>(timer / tick);
+        timer_ms.push_back(static_cast<double>((period - e.at % period) % period) * 100.0);
+    }
+    auto mean = [](const std::vector<double>& v) {
+        double s = 0;
+        for (double x : v) s += x;
+        return v.empty() ? 0.0 : s / static_cast<double>(v.size());
+    };
+    auto p95 = [](std::vector<double> v) {
+        if (v.empty()) return 0.0;
+        std::sort(v.begin(), v.end());
+        return v[v.size() * 95 / 100];
+    };
+    auto st = detector.stats();
+
+    bench::Report("vibe_novelty")
+        .set("hours", hours)
+        .set("events", events.size())
+        .set("timer_escalations_per_h", 3600.0 / std::chrono::duration<double>(timer).count())
+        .set("timer_trigger_mean_ms", mean(timer_ms))
+        .set("timer_trigger_p95_ms", p95(timer_ms))
+        .set("novelty_escalations_per_h", static_cast<double>(fires.size()) / hours)
+        .set("novelty_trigger_mean_ms", mean(novelty_ms))
+        .set("novelty_trigger_p95_ms", p95(novelty_ms))
+        .set("novelty_missed", missed)
+        .set("novelty_unexplained", std::count(explained.begin(), explained.end(), false))
+        .set("rate_limited", st.rate_limited)
+        .set("observe_ns", observe_ns / static_cast<double>(n))
+        .emit();
+}
@@ -0,0 +1,263 @@
+// Percept stream: full snapshots vs. keyframes + deltas.
+//
+//   ./build/prometheus_bench percept_stream
+//
+// PROMETHEUS_PERCEPT_HZ (default 50), PROMETHEUS_BENCH_SECONDS (600) and
+// PROMETHEUS_BENCH_LOSS (0.01, fraction of messages dropped) tune the run.
+//
+// Simulates a body walking around with up to 10 entities drifting in and
+// out of range, and encodes every tick both ways, mirroring body/bot.js:
+// the old full snapshot and the keyframe (every 2 s) / delta stream.
+// Reports bytes per second and Head cost per message (WorldState::apply
+// plus percept()) for each, checks the rebuilt state against the truth
+// after every message, then replays the delta stream with messages
+// dropped — a gap makes the body send a keyframe on its next tick — and
+// reports the share of ticks the Head spent unsynced.
+
+#include "bench.h"
+
+#include "ipc/world_state.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+
+using namespace prometheus;
+
+namespace {
+
+struct Mob {
+    std::string name;
+    bool        hostile;
+    double      x, z;           // relative to the world origin
+    double      vx, vz;
+};
+
+struct Truth {
+    double health{20}, food{20}, x{0}, y{64}, z{0};
+    std::string ground{"safe"}, biome{"plains"};
+    std::map<std::string, nlohmann::json> entities;     // id → {name, distance, hostile}
+};
+
+double round1(double v) { return std::round(v * 10) / 10; }
+
+nlohmann::json body(const Truth& t) {
+    nlohmann::json j;
+    j["health"]   = t.health;
+    j["food"]     = t.food;
+    j["position"] = {{"x", t.x}, {"y", t.y}, {"z", t.z}};
+    j["entities"] = nlohmann::json::object();
+    for (auto& [id, e] : t.entities) j["entities"][id] = e;
+    j["ground"]   = t.ground;
+    j["biome"]    = t.biome;
+    return j;
+}
+
+std::string legacy(const Truth& t) {
+    nlohmann::json j;
+    j["type"]     = "percept";
+    j["health"]   = t.health;
+    j["food"]     = t.food;
+    j["position"] = {{"x", t.x}, {"y", t.y}, {"z", t.z}};
+    std::vector<nlohmann::json> list;
+    for (auto& [id, e] : t.entities) list.push_back(e);
+    std::sort(list.begin(), list.end(), [](auto& a, auto& b) { return a["distance"] < b["distance"]; });
+    j["nearby_entities"] = list;
+    j["ground"]   = t.ground;
+    j["biome"]    = t.biome;
+    return j.dump();
+}
+
+std::string keyframe(const Truth& t, uint64_t seq) {
+    nlohmann::json j = {{"type", "keyframe"}, {"seq", seq}};
+    j.update(body(t));
+    return j.dump();
+}
+
+// diffPercept() from bot.js.
+std::string delta(const Truth& prev, const Truth& cur, uint64_t seq) {
+    nlohmann::json j = {{"type", "delta"}, {"seq", seq}};
+    if (cur.health != prev.health) j["health"] = cur.health;
+    if (cur.food   != prev.food)   j["food"]   = cur.food;
+    if (cur.ground != prev.ground) j["ground"] = cur.ground;
+    if (cur.biome  != prev.biome)  j["biome"]  = cur.biome;
+    nlohmann::json pos = nlohmann::json::object();
+    if (cur.x != prev.x) pos["x"] = cur.x;
+    if (cur.y != prev.y) pos["y"] = cur.y;
+    if (cur.z != prev.z) pos["z"] = cur.z;
+    if (!pos.empty()) j["position"] = pos;
+    nlohmann::json ents = nlohmann::json::object();
+    for (auto& [id, e] : cur.entities) {
+        auto old = prev.entities.find(id);
+        if (old == prev.entities.end()) ents[id] = e;
+        else if (old->second["distance"] != e["distance"]) ents[id] = {{"distance", e["distance"]}};
+    }
+    if (!ents.empty()) j["entities"] = ents;
+    std::vector<std::string> gone;
+    for (auto& [id, e] : prev.entities) {
+        if (!cur.entities.count(id)) gone.push_back(id);
+    }
+    if (!gone.empty()) j["gone"] = gone;
+    return j.dump();
+}
+
+bool matches(const Percept& p, const Truth& t) {
+    auto near = [](double a, double b) { return std::abs(a - b) < 1e-3; };
+    if (!near(p.health, t.health) || !near(p.hunger, t.food) || !near(p.x, t.x) ||
+        !near(p.y, t.y) || !near(p.z, t.z) || p.biome != t.biome ||
+        p.entities.size() != t.entities.size()) return false;
+    std::vector<double> want;
+    for (auto& [id, e] : t.entities) want.push_back(e["distance"].get<double>());
+    std::sort(want.begin(), want.end());
+    for (size_t i = 0; i < want.size(); ++i) {
+        if (!near(p.entities[i].distance, want[i])) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+PROMETHEUS_BENCH(percept_stream) {
+    using clock = std::chrono::steady_clock;
+    const int    hz      = std::stoi(bench::env_or("PROMETHEUS_PERCEPT_HZ", "50"));
+    const double seconds = std::stod(bench::env_or("PROMETHEUS_BENCH_SECONDS", "600"));
+    const double loss    = std::stod(bench::env_or("PROMETHEUS_BENCH_LOSS", "0.01"));
+    const size_t ticks   = static_cast<size_t>(seconds * hz);
+    const size_t key_every = static_cast<size_t>(2 * hz);     // KEYFRAME_MS = 2000
+
+    static const char* kMobs[] = {"cow", "sheep", "zombie", "skeleton", "chicken", "creeper"};
+
+    // ── Simulated world, one Truth per tick ─────────────────────
+    std::mt19937 rng(44);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::vector<Truth> world;
+    world.reserve(ticks);
+    std::map<int, Mob> mobs;
+    int    next_id = 100;
+    double px = 0, pz = 0, heading = 0;
+    bool   walking = true;
+    Truth  t;
+    for (size_t i = 0; i < ticks; ++i) {
+        const double dt = 1.0 / hz;
+        if (u(rng) < 0.2 * dt) walking = !walking;
+        if (u(rng) < 0.5 * dt) heading += (u(rng) - 0.5) * 2;
+        if (walking) {
+            px += std::cos(heading) * 4.3 * dt;
+            pz += std::sin(heading) * 4.3 * dt;
+        }
+        if (u(rng) < 0.3 * dt && mobs.size() < 14) {
+            double a = u(rng) * 6.283, r = 10 + u(rng) * 20;
+            auto   k = static_cast<size_t>(rng() % std::size(kMobs));
+            mobs[next_id++] = {kMobs[k], k == 2 || k == 3 || k == 5,
+                               px + std::cos(a) * r, pz + std::sin(a) * r,
+                               (u(rng) - 0.5) * 2, (u(rng) - 0.5) * 2};
+        }
+        if (u(rng) < 0.05 * dt) t.health = std::max(1.0, t.health - 1 - static_cast<int>(u(rng) * 5));
+        else if (u(rng) < 0.25 * dt && t.health < 20) t.health += 1;
+        if (u(rng) < 0.02 * dt) t.food = std::max(0.0, t.food - 1);
+        if (u(rng) < 0.003 * dt) t.biome = t.biome == "plains" ? "forest" : "plains";
+        t.ground = walking && u(rng) < 0.05 ? "airborne" : "safe";
+
+        t.x = round1(px);
+        t.z = round1(pz);
+        std::vector<std::pair<double, int>> near;
+        for (auto it = mobs.begin(); it != mobs.end();) {
+            auto& m = it->second;
+            m.x += m.vx * dt;
+            m.z += m.vz * dt;
+            double d = std::hypot(m.x - px, m.z - pz);
+            if (d > 40) { it = mobs.erase(it); continue; }
+            if (d <= 32) near.emplace_back(round1(d), it->first);
+            ++it;
+        }
+        std::sort(near.begin(), near.end());
+        if (near.size() > 10) near.resize(10);
+        t.entities.clear();
+        for (auto& [d, id] : near) {
+            auto& m = mobs[id];
+            t.entities[std::to_string(id)] = {{"name", m.name}, {"distance", d}, {"hostile", m.hostile}};
+        }
+        world.push_back(t);
+    }
+
+    // ── Encode both ways ────────────────────────────────────────
+    std::vector<std::string> full, stream;
+    full.reserve(ticks);
+    stream.reserve(ticks);
+    size_t full_bytes = 0, stream_bytes = 0;
+    for (size_t i = 0; i < ticks; ++i) {
+        full.push_back(legacy(world[i]));
+        stream.push_back(i % key_every == 0 ? keyframe(world[i], i + 1)
+                                            : delta(world[i - 1], world[i], i + 1));
+        full_bytes   += full.back().size();
+        stream_bytes += stream.back().size();
+    }
+
+    // ── Head cost and fidelity, lossless ────────────────────────
+    size_t sink = 0;
+    auto replay = [&](const std::vector<std::string>& msgs, size_t& mismatches) {
+        WorldState ws;
+        mismatches = 0;
+        auto t0 = clock::now();
+        for (auto& m : msgs) {
+            ws.apply(m);
+            sink += ws.percept().entities.size();
+        }
+        double ns = bench::seconds_since(t0) * 1e9 / static_cast<double>(msgs.size());
+        WorldState check;
+        for (size_t i = 0; i < msgs.size(); ++i) {
+            check.apply(msgs[i]);
+            mismatches += !matches(check.percept(), world[i]);
+        }
+        return ns;
+    };
+    size_t full_bad = 0, stream_bad = 0;
+    double full_ns   = replay(full, full_bad);
+    double stream_ns = replay(stream, stream_bad);
+
+    // ── Lossy replay with resync ────────────────────────────────
+    // The body re-encodes on the fly so it can answer a resync request
+    // with a keyframe on its next tick.
+    WorldState ws;
+    std::bernoulli_distribution drop(loss);
+    bool   resync = false;
+    size_t unsynced = 0, lossy_bad = 0, dropped = 0;
+    for (size_t i = 0; i < ticks; ++i) {
+        bool key = i % key_every == 0 || resync;
+        resync = false;
+        std::string msg = key ? keyframe(world[i], i + 1) : delta(world[i - 1], world[i], i + 1);
+        if (drop(rng)) {
+            ++dropped;
+        } else {
+            auto r = ws.apply(msg);
+            resync = r == WorldState::Applied::Gap || r == WorldState::Applied::Dropped;
+        }
+        if (!ws.synced() || ws.seq() != i + 1) {
+            ++unsynced;
+        } else {
+            lossy_bad += !matches(ws.percept(), world[i]);
+        }
+    }
+    auto st = ws.stats();
+
+    bench::Report("percept_stream")
+        .set("hz", hz)
+        .set("ticks", ticks)
+        .set("full_bytes_per_s", static_cast<double>(full_bytes) / seconds)
+        .set("delta_bytes_per_s", static_cast<double>(stream_bytes) / seconds)
+        .set("bytes_ratio", static_cast<double>(stream_bytes) / static_cast<double>(full_bytes))
+        .set("full_head_ns", full_ns)
+        .set("delta_head_ns", stream_ns)
+        .set("full_mismatches", full_bad)
+        .set("delta_mismatches", stream_bad)
+        .set("loss", loss)
+        .set("lossy_dropped", dropped)
+        .set("lossy_gaps", st.gaps)
+        .set("lossy_unsynced_share", static_cast<double>(unsynced) / static_cast<double>(ticks))
+        .set("lossy_mismatches", lossy_bad)
+        .set("sink", sink & 1)
+        .emit();
+}
@@ -0,0 +1,109 @@
+// Long-term recall: HNSW index versus exact search.
+//
+//   ./build/prometheus_bench memory_recall
+//
+// Builds an index of PROMETHEUS_BENCH_VECTORS clustered unit vectors in a
+// scratch directory, reopens it cold, then reports recall@10 against a
+// brute-force scan and query latency for several search widths.
+
+#include "bench.h"
+
+#include "memory/vector_index.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <random>
+#include <unordered_set>
+
+using namespace prometheus;
+
+namespace {
+
+constexpr int    kDim      = 256;
+constexpr size_t kK        = 10;
+constexpr int    kQueries  = 200;
+constexpr int    kClusters = 64;
+
+double percentile(std::vector<double> v, double p) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    return v[static_cast<size_t>(p * (v.size() - 1))];
+}
+
+} // namespace
+
+PROMETHEUS_BENCH(memory_recall) {
+    using clock = std::chrono::steady_clock;
+    const int n = std::stoi(bench::env_or("PROMETHEUS_BENCH_VECTORS", "10000"));
+    const std::string dir = (std::filesystem::temp_directory_path() /
+        ("prometheus_recall_" + std::to_string(::getpid()))).string();
+    std::filesystem::remove_all(dir);
+
+    // Passages cluster by topic; queries come from the same distribution.
+    std::mt19937 rng(42);
+    std::normal_distribution<float> gauss(0.0f, 1.0f);
+    std::vector<std::vector<float>> centres(kClusters, std::vector<float>(kDim));
+    for (auto& c : centres) for (auto& x : c) x = gauss(rng);
+    auto sample = [&] {
+        auto v = centres[rng() % kClusters];
+        for (auto& x : v) x += 0.6f * gauss(rng);
+        return v;
+    };
+
+    double build_s = 0;
+    {
+        VectorIndex index;
+        if (!index.open(dir)) {
+            bench::Report("memory_recall").set("skipped", "cannot open " + dir).emit();
+            return;
+        }
+        auto t0 = clock::now();
+        for (int i = 0; i < n; ++i) index.add(sample(), "passage " + std::to_string(i));
+        build_s = bench::seconds_since(t0);
+    }
+
+    auto t0 = clock::now();
+    VectorIndex index;
+    index.open(dir);
+    double open_ms = bench::seconds_since(t0) * 1e3;
+
+    std::vector<std::vector<float>> queries;
+    for (int i = 0; i < kQueries; ++i) queries.push_back(sample());
+
+    std::vector<std::unordered_set<uint32_t>> truth;
+    std::vector<double> exact_us;
+    for (auto& q : queries) {
+        auto q0 = clock::now();
+        auto hits = index.search_exact(q, kK);
+        exact_us.push_back(bench::seconds_since(q0) * 1e6);
+        std::unordered_set<uint32_t> ids;
+        for (auto& h : hits) ids.insert(h.id);
+        truth.push_back(std::move(ids));
+    }
+
+    for (int ef : {16, 32, 64, 128}) {
+        size_t found = 0;
+        std::vector<double> us;
+        for (size_t i = 0; i < queries.size(); ++i) {
+            auto q0 = clock::now();
+            auto hits = index.search(queries[i], kK, ef);
+            us.push_back(bench::seconds_since(q0) * 1e6);
+            for (auto& h : hits) found += truth[i].count(h.id);
+        }
+        bench::Report("memory_recall")
+            .set("vectors", n)
+            .set("dim", kDim)
+            .set("ef", ef)
+            .set("recall_at_10", static_cast<double>(found) / (kK * queries.size()))
+            .set("query_p50_us", percentile(us, 0.50))
+            .set("query_p99_us", percentile(us, 0.99))
+            .set("exact_p50_us", percentile(exact_us, 0.50))
+            .set("inserts_per_s", n / build_s)
+            .set("cold_open_ms", open_ms)
+            .emit();
+    }
+
+    std::filesystem::remove_all(dir);
+}
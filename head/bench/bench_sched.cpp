@@ -0,0 +1,77 @@
+// Timer-wheel scheduler under the Head's periodic load.
+//
+//   ./build/prometheus_bench sched_timers
+//
+// Registers the Head's task mix — the 16 ms dispatch tick on the timer
+// thread, supervisor/vibe/consolidation periods on the pool — plus a
+// configurable number of idle far-future timers, and runs it for
+// PROMETHEUS_BENCH_SECONDS. Reports timer-thread wakeups per second and
+// the dispatch tick's start lateness and interval jitter.
+
+#include "bench.h"
+
+#include "sched/scheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace prometheus;
+
+PROMETHEUS_BENCH(sched_timers) {
+    using clock = std::chrono::steady_clock;
+    using std::chrono::milliseconds;
+    const double seconds = std::stod(bench::env_or("PROMETHEUS_BENCH_SECONDS", "5"));
+    const int    idle    = std::stoi(bench::env_or("PROMETHEUS_BENCH_IDLE_TIMERS", "1000"));
+
+    Scheduler sched;
+    std::vector<clock::time_point> ticks;
+    ticks.reserve(static_cast<size_t>(seconds * 70));
+
+    Scheduler::Options inline_opts;
+    inline_opts.on_timer_thread = true;
+    sched.every("dispatch", milliseconds(16), [&] { ticks.push_back(clock::now()); }, inline_opts);
+    sched.every("supervise", milliseconds(5000), [] {});
+    sched.every("vibe", milliseconds(10000), [] { std::this_thread::sleep_for(milliseconds(20)); });
+    sched.every("consolidate", milliseconds(30000), [] {});
+    for (int i = 0; i < idle; ++i) {
+        sched.after("idle", milliseconds(3600000 + i), [] {});
+    }
+
+    auto t0 = clock::now();
+    std::thread stopper([&] {
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        sched.stop();
+    });
+    sched.run();
+    stopper.join();
+    double wall = bench::seconds_since(t0);
+    auto st = sched.stats();
+
+    // Interval jitter: deviation of each tick-to-tick gap from 16 ms.
+    std::vector<double> jitter;
+    for (size_t i = 1; i < ticks.size(); ++i) {
+        double gap = std::chrono::duration<double, std::milli>(ticks[i] - ticks[i - 1]).count();
+        jitter.push_back(std::abs(gap - 16.0));
+    }
+    std::sort(jitter.begin(), jitter.end());
+    auto pct = [&](double p) {
+        return jitter.empty() ? 0.0 : jitter[static_cast<size_t>(p * (jitter.size() - 1))];
+    };
+
+    auto& d = st.tasks["dispatch"];
+    bench::Report("sched_timers")
+        .set("idle_timers", idle)
+        .set("wakeups_per_s", st.wakeups / wall)
+        .set("cascades", st.cascades)
+        .set("dispatch_runs", d.runs)
+        .set("dispatch_late_mean_ms", d.mean_late_ms())
+        .set("dispatch_late_max_ms", d.max_late_ms)
+        .set("dispatch_missed", d.missed)
+        .set("jitter_p50_ms", pct(0.50))
+        .set("jitter_p99_ms", pct(0.99))
+        .set("jitter_max_ms", jitter.empty() ? 0.0 : jitter.back())
+        .emit();
+}
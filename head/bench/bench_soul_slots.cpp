@@ -0,0 +1,79 @@
+// Multi-slot deliberation throughput against a mock llama-server.
+//
+//   python3 scripts/mock_llama_server.py --port 8090 --parallel 4 &
+//   ./build/prometheus_bench soul_slots
+//
+// Queues PROMETHEUS_BENCH_QUERIES queries up front and drains them with
+// 1, 2 and 4 scheduler slots, reporting aggregate tokens/s and queueing
+// delay for each.
+
+#include "bench.h"
+
+#include "memory/memory.h"
+#include "soul/soul.h"
+#include "soul/soul_scheduler.h"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+using namespace prometheus;
+
+PROMETHEUS_BENCH(soul_slots) {
+    const std::string url = bench::env_or("PROMETHEUS_MOCK_SOUL_URL", "http://127.0.0.1:8090");
+    const int queries     = std::stoi(bench::env_or("PROMETHEUS_BENCH_QUERIES", "16"));
+
+    Memory memory;
+    Soul   soul(url, memory);
+    if (!soul.connect(4)) {
+        bench::Report("soul_slots").set("skipped", "no server at " + url).emit();
+        return;
+    }
+
+    for (int slots : {1, 2, 4}) {
+        std::mutex            mu;
+        std::deque<SoulQuery> queue;
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < queries; ++i) {
+            SoulQuery q;
+            q.id          = static_cast<uint64_t>(i + 1);
+            q.prompt      = "Benchmark query " + std::to_string(i);
+            q.enqueued_at = t0;
+            queue.push_back(std::move(q));
+        }
+
+        std::atomic<int>  done{0};
+        std::atomic<bool> running{true};
+        SoulScheduler sched(
+            soul, slots,
+            [&]() -> std::optional<SoulQuery> {
+                std::lock_guard lock(mu);
+                if (queue.empty()) return std::nullopt;
+                auto q = std::move(queue.front());
+                queue.pop_front();
+                return q;
+            },
+            [&](SoulPlan) { done.fetch_add(1); });
+
+        sched.start(running);
+        while (done.load() < queries) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        double wall = bench::seconds_since(t0);
+        running.store(false);
+        sched.join();
+
+        auto st = sched.stats();
+        bench::Report("soul_slots")
+            .set("slots", slots)
+            .set("queries", queries)
+            .set("wall_s", wall)
+            .set("tokens", st.completion_tokens)
+            .set("tokens_per_s", st.completion_tokens / wall)
+            .set("mean_queue_delay_ms", st.mean_queue_delay_ms())
+            .set("max_queue_delay_ms", st.queue_delay_ms_max)
+            .set("peak_in_flight", st.peak_in_flight)
+            .emit();
+    }
+}
@@ -0,0 +1,142 @@
+// Map-reduce Teacher grading against a stand-in Gemini server.
+//
+//   python3 scripts/mock_teacher_server.py --port 8091 &
+//   ./build/prometheus_bench teacher_grade
+//
+// Grades a synthetic 20-minute day (compacted event-log lines plus one
+// near-death incident) with 1, 2, 4 and 8 requests in flight and a cold
+// chunk cache, then re-grades the same Teacher after the day grew by two
+// minutes to show the incremental path. Reports wall time per grading
+// run — what one sleep cycle waits for.
+//
+// Then grades a one-minute day with 200-char chunks — reduce groups that
+// hold a single item each — through a 16-entry file cache, and fails
+// (exit code 2) unless the reduce ends with lessons and the cache file
+// stays within twice its bound, and is rewritten to the bound on reload.
+
+#include "bench.h"
+
+#include "teacher/teacher.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include <unistd.h>
+
+using namespace prometheus;
+
+namespace {
+
+std::string clock_at(int t) {
+    char buf[32];
+    std::snprintf(buf, sizeof buf, "%02d:%02d:%02d.%03d", t / 3600 % 24, t / 60 % 60, t % 60,
+                  (t * 37) % 1000);
+    return buf;
+}
+
+// A day from 12:00:00 for `seconds`, about three compacted lines a second.
+std::string synthetic_day(int seconds) {
+    static const char* kActions[] = {"explore", "idle", "flee", "eat", "explore", "idle"};
+    std::mt19937 rng(7);
+    std::string log;
+    const int start = 12 * 3600;
+    for (int s = 0; s < seconds; ++s) {
+        const char* a = kActions[rng() % 6];
+        std::string t = clock_at(start + s);
+        log += t + " REFLEX L1 urgency=0.30 {\"action\":\"" + a + "\"} ×" +
+               std::to_string(1 + rng() % 9) + " until " + t + "\n";
+        log += t + " ACTION reflex {\"action\":\"" + a + "\",\"reason\":\"bench\"}\n";
+        if (s % 4 == 0) log += t + " MARKER [MEM:SEEN_" + std::to_string(rng() % 40) + "]\n";
+        if (s % 30 == 29) log += "DIGEST " + t + ": 30 s of routine\n";
+    }
+    log += "\n── Percepts before " + clock_at(start + seconds / 2) + " MARKER [MEM:NEAR_DEATH] ──\n";
+    for (int s = 0; s < 30; ++s) {
+        log += clock_at(start + seconds / 2 - 30 + s) + " PERCEPT hp=" +
+               std::to_string(20 - s / 2) + ".0 food=12.0 pos=(8.5,64.0,-9.5) hostile=1 entities=3\n";
+    }
+    return log;
+}
+
+} // namespace
+
+PROMETHEUS_BENCH(teacher_grade) {
+    const std::string url = bench::env_or("PROMETHEUS_MOCK_TEACHER_URL", "http://127.0.0.1:8091");
+    const int seconds     = std::stoi(bench::env_or("PROMETHEUS_BENCH_DAY_SECONDS", "1200"));
+    if (!std::getenv("GEMINI_API_KEY")) setenv("GEMINI_API_KEY", "bench", 0);
+
+    const std::string day = synthetic_day(seconds);
+
+    auto report = [&](const char* phase, int parallel, size_t chars, const Teacher::Report& r) {
+        bench::Report("teacher_grade")
+            .set("phase", phase)
+            .set("parallel", parallel)
+            .set("log_chars", chars)
+            .set("chunks", r.chunks)
+            .set("cached", r.cached)
+            .set("failed", r.failed)
+            .set("requests", r.requests)
+            .set("retries", r.retries)
+            .set("map_ms", r.map_ms)
+            .set("reduce_ms", r.reduce_ms)
+            .set("wall_ms", r.wall_ms)
+            .set("lessons", r.lessons.size())
+            .emit();
+    };
+
+    for (int parallel : {1, 2, 4, 8}) {
+        Teacher::Config cfg;
+        cfg.max_parallel = parallel;
+        cfg.retries      = 2;
+        Teacher teacher(url, cfg);
+
+        auto cold = teacher.grade(day);
+        if (cold.chunks && cold.failed == cold.chunks) {
+            bench::Report("teacher_grade").set("skipped", "no server at " + url).emit();
+            return;
+        }
+        report("cold", parallel, day.size(), cold);
+
+        if (parallel == 4) {
+            const std::string longer = synthetic_day(seconds + 120);
+            report("incremental", parallel, longer.size(), teacher.grade(longer));
+        }
+    }
+
+    const std::string path = (std::filesystem::temp_directory_path() /
+        ("prometheus_teacher_" + std::to_string(::getpid()) + ".jsonl")).string();
+    std::filesystem::remove(path);
+    auto file_lines = [&] {
+        std::ifstream in(path);
+        size_t n = 0;
+        for (std::string line; std::getline(in, line);) ++n;
+        return n;
+    };
+    Teacher::Config cfg;
+    cfg.max_parallel    = 4;
+    cfg.retries         = 2;
+    cfg.max_chunk_chars = 200;
+    cfg.cache_path      = path;
+    cfg.cache_entries   = 16;
+    const std::string minute = synthetic_day(60);
+    {
+        Teacher teacher(url, cfg);
+        auto r = teacher.grade(minute);
+        report("small_chunks", cfg.max_parallel, minute.size(), r);
+        if (r.lessons.empty()) bench::fail("teacher_grade: small-chunk reduce gave no lessons");
+        if (file_lines() > 2 * cfg.cache_entries) {
+            bench::fail("teacher_grade: cache file holds " + std::to_string(file_lines()) +
+                        " records for " + std::to_string(cfg.cache_entries) + " entries");
+        }
+    }
+    {
+        Teacher reloaded(url, cfg);
+        if (file_lines() > cfg.cache_entries) {
+            bench::fail("teacher_grade: cache file not rewritten on load (" +
+                        std::to_string(file_lines()) + " records)");
+        }
+    }
+    std::filesystem::remove(path);
+}
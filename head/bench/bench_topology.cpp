@@ -0,0 +1,280 @@
+// Reflex-thread wake-up jitter with and without a thread topology, and the
+// reflex watchdog's attribution.
+//
+//   ./build/prometheus_bench thread_jitter
+//
+// PROMETHEUS_BENCH_SECONDS (default 3) sets the length of each phase.
+//
+// A stand-in Lizard wakes every 2 ms, does ~50 µs of work inside a
+// ReflexWatchdog tick (1 ms budget) and records how late it woke. Against
+// it runs the Head's heavy work: JSON-parsing threads (a Soul response),
+// one per CPU and at least two, and a thread starting short-lived
+// processes (the vibe-check screenshot). Phase "default" leaves every
+// thread as created; phase "topology" applies the Head's roles — the
+// Lizard on the last CPU at SCHED_FIFO 20 where that is permitted, the
+// load on the other CPUs (beside it on a single CPU) at the soul and
+// worker nice values. Reports wake-lateness quantiles, a histogram
+// ([bucket upper bound in µs, wake-ups] pairs) and watchdog overruns per
+// phase.
+//
+// Then checks the watchdog: a tick that blocks while a thread named
+// bench.hog burns the Lizard's CPU must be flagged "blocked" with
+// bench.hog as the thread that held the CPU, and with no tick running for
+// a second the watchdog thread must not wake (at most 2 context switches,
+// from /proc). Otherwise the run fails (exit code 2). Jitter itself is
+// reported, not judged — it depends on the host.
+
+#include "bench.h"
+
+#include "diag/trace.h"
+#include "sched/topology.h"
+#include "sched/watchdog.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+using namespace prometheus;
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+constexpr auto kPeriod = std::chrono::milliseconds(2);
+constexpr auto kWork   = std::chrono::microseconds(50);
+
+void spin_for(clock::duration d) {
+    const auto until = clock::now() + d;
+    while (clock::now() < until) {
+    }
+}
+
+// A Soul-sized response to parse over and over.
+std::string big_json() {
+    nlohmann::json j = nlohmann::json::array();
+    for (int i = 0; i < 2000; ++i) {
+        j.push_back({{"id", i}, {"text", std::string(64, 'a' + i % 26)}, {"score", i * 0.5},
+                     {"tags", {"mob", "biome", "item"}}});
+    }
+    return j.dump();
+}
+
+struct Phase {
+    std::vector<uint64_t> late_ns;
+    uint64_t              overruns{0};
+    uint64_t              parses{0};
+    uint64_t              spawns{0};
+    bool                  lizard_policy_ok{true};   // false: e.g. SCHED_FIFO refused
+};
+
+Phase run_phase(const ThreadTopology* topology, double seconds, const std::string& doc) {
+    Phase                    phase;
+    std::atomic<bool>        stop{false};
+    std::atomic<uint64_t>    parses{0}, spawns{0};
+    std::vector<std::thread> load;
+
+    const size_t parsers = std::max<size_t>(2, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < parsers; ++i) {
+        load.emplace_back([&] {
+            Trace::name_thread("bench.soul");
+            if (topology) topology->apply(ThreadRole::Soul);
+            while (!stop.load(std::memory_order_relaxed)) {
+                auto j = nlohmann::json::parse(doc);
+                parses.fetch_add(j.size() ? 1 : 0, std::memory_order_relaxed);
+            }
+        });
+    }
+    load.emplace_back([&] {
+        Trace::name_thread("bench.vibe");
+        if (topology) topology->apply(ThreadRole::Worker);
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (std::system("exit 0") == 0) spawns.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    ReflexWatchdog::Config cfg;
+    cfg.budget = std::chrono::milliseconds(1);
+    ReflexWatchdog watchdog(cfg);
+    watchdog.start();
+
+    std::thread lizard([&] {
+        Trace::name_thread("bench.lizard");
+        if (topology) phase.lizard_policy_ok = topology->apply(ThreadRole::Lizard);
+        const auto end  = clock::now() + std::chrono::duration_cast<clock::duration>(
+                                             std::chrono::duration<double>(seconds));
+        auto       next = clock::now();
+        for (uint64_t seq = 1; next < end; ++seq) {
+            next += kPeriod;
+            std::this_thread::sleep_until(next);
+            phase.late_ns.push_back(static_cast<uint64_t>(std::max<int64_t>(
+                0, std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - next).count())));
+            watchdog.begin(seq);
+            spin_for(kWork);
+            watchdog.end();
+        }
+    });
+    lizard.join();
+    stop.store(true);
+    for (auto& t : load) t.join();
+    watchdog.stop();
+
+    phase.overruns = watchdog.stats().overruns;
+    phase.parses   = parses.load();
+    phase.spawns   = spawns.load();
+    return phase;
+}
+
+uint64_t quantile_us(std::vector<uint64_t> v, double q) {
+    if (v.empty()) return 0;
+    const size_t i = std::min(v.size() - 1, static_cast<size_t>(q * static_cast<double>(v.size())));
+    std::nth_element(v.begin(), v.begin() + static_cast<ptrdiff_t>(i), v.end());
+    return v[i] / 1000;
+}
+
+// Power-of-two µs buckets as [upper bound, wake-ups] pairs: [[1, n], [2, n], …].
+nlohmann::json histogram_us(const std::vector<uint64_t>& late_ns) {
+    std::vector<uint64_t> counts;
+    for (uint64_t ns : late_ns) {
+        size_t b = 0;
+        for (uint64_t bound = 1000; ns > bound; bound <<= 1) ++b;
+        if (counts.size() <= b) counts.resize(b + 1);
+        ++counts[b];
+    }
+    nlohmann::json out = nlohmann::json::array();
+    for (size_t b = 0; b < counts.size(); ++b) {
+        if (counts[b]) out.push_back({uint64_t{1} << b, counts[b]});
+    }
+    return out;
+}
+
+// Voluntary + involuntary context switches of the thread named `name`
+// (-1 if there is none).
+long context_switches(const std::string& name) {
+    for (auto& task : std::filesystem::directory_iterator("/proc/self/task")) {
+        std::string comm;
+        std::getline(std::ifstream(task.path() / "comm"), comm);
+        if (comm != name) continue;
+        std::ifstream status(task.path() / "status");
+        long total = 0;
+        for (std::string line; std::getline(status, line);) {
+            if (line.find("ctxt_switches:") != std::string::npos) {
+                total += std::atol(line.c_str() + line.find(':') + 1);
+            }
+        }
+        return total;
+    }
+    return -1;
+}
+
+void report_phase(bench::Report& r, const std::string& name, const Phase& p) {
+    r.set(name + "_wakeups", p.late_ns.size())
+        .set(name + "_late_p50_us", quantile_us(p.late_ns, 0.50))
+        .set(name + "_late_p99_us", quantile_us(p.late_ns, 0.99))
+        .set(name + "_late_p999_us", quantile_us(p.late_ns, 0.999))
+        .set(name + "_late_max_us", quantile_us(p.late_ns, 1.0))
+        .set(name + "_late_hist_us", histogram_us(p.late_ns))
+        .set(name + "_overruns", p.overruns)
+        .set(name + "_parses", p.parses)
+        .set(name + "_spawns", p.spawns);
+}
+
+} // namespace
+
+PROMETHEUS_BENCH(thread_jitter) {
+    const double seconds = std::stod(bench::env_or("PROMETHEUS_BENCH_SECONDS", "3"));
+    const std::string doc = big_json();
+
+    // ── Jitter: default vs. topology ────────────────────────────
+    ThreadTopology topology;
+    const auto&    cpus = topology.cpus();
+    {
+        ThreadPolicy lizard;
+        lizard.fifo_priority = 20;
+        if (cpus.size() > 1) lizard.cpus = {cpus.back()};
+        topology.set(ThreadRole::Lizard, lizard);
+        if (cpus.size() > 1) {
+            std::vector<int> rest(cpus.begin(), cpus.end() - 1);
+            for (auto role : {ThreadRole::Soul, ThreadRole::Worker}) {
+                ThreadPolicy p = topology.policy(role);
+                p.cpus         = rest;
+                topology.set(role, p);
+            }
+        }
+    }
+    const Phase before = run_phase(nullptr, seconds, doc);
+    const Phase after  = run_phase(&topology, seconds, doc);
+
+    // ── Watchdog attribution ────────────────────────────────────
+    // Lizard and hog share one CPU at normal priority; the tick waits for
+    // the hog to burn 3 budgets.
+    ThreadTopology shared;
+    for (auto role : {ThreadRole::Lizard, ThreadRole::Worker}) {
+        ThreadPolicy p;
+        p.cpus = {cpus.empty() ? 0 : cpus.front()};
+        shared.set(role, p);
+    }
+    ReflexWatchdog::Config cfg;
+    cfg.budget = std::chrono::milliseconds(20);
+    ReflexWatchdog watchdog(cfg);
+    watchdog.start();
+    std::atomic<bool> hog_done{false};
+    std::thread lizard([&] {
+        Trace::name_thread("bench.lizard");
+        shared.apply(ThreadRole::Lizard);
+        watchdog.begin(1);
+        while (!hog_done.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        watchdog.end();
+    });
+    std::thread hog([&] {
+        Trace::name_thread("bench.hog");
+        shared.apply(ThreadRole::Worker);
+        spin_for(3 * cfg.budget);
+        hog_done.store(true);
+    });
+    lizard.join();
+    hog.join();
+    watchdog.stop();
+    const auto wd = watchdog.stats();
+    const auto flagged    = wd.recent.empty() ? ReflexWatchdog::Overrun{} : wd.recent.back();
+    const bool attributed = wd.overruns == 1 && flagged.verdict == "blocked" &&
+                            flagged.holder == "bench.hog";
+
+    // ── Watchdog at rest ────────────────────────────────────────
+    ReflexWatchdog idle(cfg);
+    idle.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));   // settle after start
+    const long idle_before = context_switches("watchdog");
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    const long idle_wakeups = context_switches("watchdog") - idle_before;
+    idle.stop();
+
+    bench::Report r("thread_jitter");
+    r.set("seconds", seconds)
+        .set("period_ms", kPeriod.count())
+        .set("cpus", cpus.size())
+        .set("topology", topology.describe())
+        .set("lizard_policy_ok", after.lizard_policy_ok);
+    report_phase(r, "default", before);
+    report_phase(r, "topology", after);
+    r.set("watchdog_verdict", flagged.verdict)
+        .set("watchdog_holder", flagged.holder)
+        .set("watchdog_holder_ms", flagged.holder_ms)
+        .set("watchdog_attributed", attributed)
+        .set("watchdog_idle_wakeups", idle_wakeups)
+        .emit();
+
+    if (!attributed) {
+        bench::fail("thread_jitter: watchdog blamed '" + flagged.holder + "' (" + flagged.verdict +
+                    ", " + std::to_string(wd.overruns) + " overruns); expected bench.hog, blocked");
+    }
+    if (idle_before < 0 || idle_wakeups > 2) {
+        bench::fail("thread_jitter: idle watchdog woke " + std::to_string(idle_wakeups) +
+                    " times in 1 s; expected none");
+    }
+}
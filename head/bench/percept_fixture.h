@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace prometheus::bench {
+
+// Percept messages for benchmarks that replay the body's stream.
+
+// One cycle of the body's stream: a keyframe every 40 ticks, deltas in
+// between, 600 ticks long. The last phase adds a crowd of entities whose
+// names are longer than the std::string small buffer, one joining every
+// 13 ticks up to the body's cap of 10; the next cycle's first keyframe
+// drops them again.
+inline std::vector<std::string> stream_cycle() {
+    static const char* kCrowd[] = {"wandering_trader", "zombified_piglin", "furnace_minecart",
+                                   "spawner_minecart", "command_block_minecart"};
+    std::vector<std::string> msgs;
+    char buf[2048];
+    uint64_t seq = 1;
+    for (int i = 0; i < 600; ++i, ++seq) {
+        // 0 idle, 1 hungry, 2 creeper, 3 zombie, 4 zombie at critical
+        // health, 5 the same with a growing crowd
+        const int   phase  = i / 100;
+        const float x      = 10.0f + static_cast<float>(i % 40) * 0.2f;
+        const float cow    = 12.0f + static_cast<float>(i % 7) * 0.1f;
+        const float mob    = 9.0f - static_cast<float>(i % 25) * 0.2f;
+        const float food   = phase == 1 ? 5.0f : 18.0f;
+        const float health = phase >= 4 ? 3.0f : 18.0f;
+        const char* hostile_name = phase == 2 ? "creeper" : "zombie";
+        const bool  hostile_here = phase >= 2;
+        const int   crowd  = phase == 5 ? 1 + (i % 100) / 13 : 0;
+        auto crowd_member = [&](int n, int k) {
+            return n + std::snprintf(buf + n, sizeof buf - static_cast<size_t>(n),
+                R"(,"%d":{"name":"%s","distance":%.1f,"hostile":false})",
+                801 + k, kCrowd[k % 5], 14.0f + static_cast<float>(k));
+        };
+        if (i % 40 == 0) {
+            int n = std::snprintf(buf, sizeof buf,
+                R"({"type":"keyframe","seq":%llu,"health":%.0f,"food":%.0f,)"
+                R"("position":{"x":%.1f,"y":64,"z":-3.5},"entities":{"701":{"name":"cow","distance":%.1f,"hostile":false})",
+                static_cast<unsigned long long>(seq), health, food, x, cow);
+            if (hostile_here) {
+                n += std::snprintf(buf + n, sizeof buf - static_cast<size_t>(n),
+                    R"(,"702":{"name":"%s","distance":%.1f,"hostile":%s})",
+                    hostile_name, mob, phase >= 3 ? "true" : "false");
+            }
+            for (int k = 0; k < crowd; ++k) n = crowd_member(n, k);
+            std::snprintf(buf + n, sizeof buf - static_cast<size_t>(n),
+                          R"(},"ground":"safe","biome":"plains"})");
+        } else {
+            int n = std::snprintf(buf, sizeof buf,
+                R"({"type":"delta","seq":%llu,"position":{"x":%.1f},"entities":{"701":{"distance":%.1f})",
+                static_cast<unsigned long long>(seq), x, cow);
+            if (hostile_here) {
+                n += std::snprintf(buf + n, sizeof buf - static_cast<size_t>(n),
+                    R"(,"702":{"name":"%s","distance":%.1f,"hostile":%s})",
+                    hostile_name, mob, phase >= 3 ? "true" : "false");
+            }
+            if (crowd && (i % 100) % 13 == 0) n = crowd_member(n, crowd - 1);
+            n += std::snprintf(buf + n, sizeof buf - static_cast<size_t>(n), "}");
+            if (i % 100 == 0) {
+                n += std::snprintf(buf + n, sizeof buf - static_cast<size_t>(n),
+                                   R"(,"health":%.0f,"food":%.0f)", health, food);
+            }
+            if (i % 100 == 1 && phase == 0) {
+                n += std::snprintf(buf + n, sizeof buf - static_cast<size_t>(n), R"(,"gone":["702"])");
+            }
+            std::snprintf(buf + n, sizeof buf - static_cast<size_t>(n), "}");
+        }
+        msgs.emplace_back(buf);
+    }
+    return msgs;
+}
+
+
+// Recorded percepts: one body message per line (e.g. captured off the SUB
+// socket), from the file named by PROMETHEUS_BENCH_PERCEPTS; the
+// synthetic cycle above when it is unset or unreadable. `source` says
+// which.
+inline std::vector<std::string> recorded_percepts(std::string* source = nullptr) {
+    std::vector<std::string> msgs;
+    if (const char* path = std::getenv("PROMETHEUS_BENCH_PERCEPTS"); path && *path) {
+        std::ifstream in(path);
+        for (std::string line; std::getline(in, line);) {
+            if (!line.empty()) msgs.push_back(std::move(line));
+        }
+        if (source) *source = path;
+    }
+    if (msgs.empty()) {
+        msgs = stream_cycle();
+        if (source) *source = "synthetic";
+    }
+    return msgs;
+}
+
+} // namespace prometheus::bench
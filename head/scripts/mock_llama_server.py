@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""Stand-in for llama-server's OpenAI-compatible API, for benchmarks.
+
+Serves /health and /v1/chat/completions. Each completion holds one of
+--parallel decode slots and "generates" --tokens tokens at --token-ms per
+token; concurrent sequences slow each other down by --batch-penalty per
+extra active slot, roughly like continuous batching on one GPU.
+Requests beyond --parallel wait for a free slot.
+"""
+
+import argparse
+import json
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+ARGS = None
+SLOTS = None
+ACTIVE = 0
+ACTIVE_LOCK = threading.Lock()
+
+
+class Handler(BaseHTTPRequestHandler):
+    def log_message(self, fmt, *args):  # keep benchmark output quiet
+        pass
+
+    def _reply(self, code, body):
+        data = json.dumps(body).encode()
+        self.send_response(code)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(data)))
+        self.end_headers()
+        self.wfile.write(data)
+
+    def do_GET(self):
+        if self.path == "/health":
+            self._reply(200, {"status": "ok"})
+        else:
+            self._reply(404, {"error": "not found"})
+
+    def do_POST(self):
+        if self.path != "/v1/chat/completions":
+            self._reply(404, {"error": "not found"})
+            return
+
+        length = int(self.headers.get("Content-Length", 0))
+        request = json.loads(self.rfile.read(length) or b"{}")
+        tokens = min(int(request.get("max_tokens", ARGS.tokens)), ARGS.tokens)
+
+        global ACTIVE
+        with SLOTS:
+            with ACTIVE_LOCK:
+                ACTIVE += 1
+            try:
+                time.sleep(ARGS.prompt_ms / 1000.0)
+                for _ in range(tokens):
+                    with ACTIVE_LOCK:
+                        active = ACTIVE
+                    slowdown = 1.0 + ARGS.batch_penalty * (active - 1)
+                    time.sleep(ARGS.token_ms * slowdown / 1000.0)
+            finally:
+                with ACTIVE_LOCK:
+                    ACTIVE -= 1
+
+        content = json.dumps({
+            "action": {"action": "explore", "reason": "mock"},
+            "reasoning": "mock completion",
+            "override_safety": False,
+        })
+        self._reply(200, {
+            "choices": [{"message": {"role": "assistant", "content": content}}],
+            "usage": {"prompt_tokens": 0, "completion_tokens": tokens},
+        })
+
+
+def main():
+    global ARGS, SLOTS
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--port", type=int, default=8090)
+    parser.add_argument("--parallel", type=int, default=4)
+    parser.add_argument("--tokens", type=int, default=64)
+    parser.add_argument("--token-ms", type=float, default=20.0)
+    parser.add_argument("--prompt-ms", type=float, default=50.0)
+    parser.add_argument("--batch-penalty", type=float, default=0.1)
+    ARGS = parser.parse_args()
+    SLOTS = threading.BoundedSemaphore(ARGS.parallel)
+
+    server = ThreadingHTTPServer(("127.0.0.1", ARGS.port), Handler)
+    print(f"Mock llama-server on :{ARGS.port} ({ARGS.parallel} slots)")
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+"""Stand-in for the Gemini generateContent API, for the Teacher.
+
+Serves POST /v1beta/models/<model>:generateContent. Window-grading
+requests get a deterministic grade and summary derived from the window
+(line count and the busiest action); reduce requests get the first few
+distinct lessons they were given. Each request takes --latency-ms, at most
+--parallel run at once, and --fail-rate of them answer 503 so the
+Teacher's retries are exercised. Request counts go to stderr on exit.
+"""
+
+import argparse
+import collections
+import json
+import random
+import re
+import sys
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+ARGS = None
+SLOTS = None
+COUNTS = collections.Counter()
+COUNTS_LOCK = threading.Lock()
+
+
+def grade_window(text):
+    lines = [l for l in text.splitlines() if l.strip()]
+    actions = collections.Counter(re.findall(r'"action":\s*"(\w+)"', text))
+    top = actions.most_common(1)[0][0] if actions else "idle"
+    near_death = "NEAR_DEATH" in text
+    grade = "D" if near_death else ("B" if top in ("flee", "eat") else "A")
+    lesson = ("Retreat when health is below 8." if near_death
+              else f"Keep {top} short when nothing threatens.")
+    return {
+        "grade": grade,
+        "summary": f"{len(lines)} lines, mostly {top}" + ("; nearly died" if near_death else ""),
+        "lessons": [lesson],
+    }
+
+
+def reduce_summaries(text, limit):
+    lessons = []
+    for found in re.findall(r"lessons: (.*)", text) + re.findall(r"^- (.*)$", text, re.M):
+        for lesson in found.split("; "):
+            if lesson and lesson not in lessons:
+                lessons.append(lesson)
+    return {"lessons": lessons[:limit]}
+
+
+class Handler(BaseHTTPRequestHandler):
+    def log_message(self, fmt, *args):  # keep benchmark output quiet
+        pass
+
+    def _reply(self, code, body):
+        data = json.dumps(body).encode()
+        self.send_response(code)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(data)))
+        self.end_headers()
+        self.wfile.write(data)
+
+    def do_POST(self):
+        if not re.match(r"^/v1beta/models/[^/:]+:generateContent", self.path):
+            self._reply(404, {"error": {"code": 404, "message": "not found"}})
+            return
+        length = int(self.headers.get("Content-Length", 0))
+        request = json.loads(self.rfile.read(length) or b"{}")
+        prompt = request["contents"][0]["parts"][0]["text"]
+        kind = "reduce" if "Window summaries:" in prompt else "map"
+
+        with SLOTS:
+            time.sleep(ARGS.latency_ms / 1000.0)
+            if random.random() < ARGS.fail_rate:
+                with COUNTS_LOCK:
+                    COUNTS["503"] += 1
+                self._reply(503, {"error": {"code": 503, "message": "overloaded"}})
+                return
+
+        with COUNTS_LOCK:
+            COUNTS[kind] += 1
+        if kind == "map":
+            body = grade_window(prompt.split("Session window:\n", 1)[-1])
+        else:
+            limit = int((re.search(r"at most (\d+) lessons", prompt) or [0, 3])[1])
+            body = reduce_summaries(prompt.split("Window summaries:\n", 1)[-1], limit)
+        self._reply(200, {
+            "candidates": [{"content": {"role": "model",
+                                        "parts": [{"text": json.dumps(body)}]}}],
+        })
+
+
+def main():
+    global ARGS, SLOTS
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--port", type=int, default=8091)
+    parser.add_argument("--parallel", type=int, default=8)
+    parser.add_argument("--latency-ms", type=float, default=400.0)
+    parser.add_argument("--fail-rate", type=float, default=0.05)
+    ARGS = parser.parse_args()
+    SLOTS = threading.BoundedSemaphore(ARGS.parallel)
+
+    server = ThreadingHTTPServer(("127.0.0.1", ARGS.port), Handler)
+    print(f"Mock Teacher on :{ARGS.port} ({ARGS.parallel} parallel, "
+          f"{ARGS.latency_ms:.0f} ms, {ARGS.fail_rate:.0%} failures)")
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        print(f"Requests: {dict(COUNTS)}", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
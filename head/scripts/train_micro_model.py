@@ -0,0 +1,375 @@
+#!/usr/bin/env python3
+"""Distil the Lizard's Layer 1 decisions into a boosted-tree micro-model.
+
+Reads the head's event log (events-*.evl segments), pairs every percept with
+the action the head settled on for it, and trains a gradient-boosted ensemble
+of oblivious trees: every node at one depth shares a single split, so a tree
+is `depth` comparisons forming a leaf index. The model is written in the .pmm
+format read by src/lizard/micro_model.h.
+
+Labels: the first non-idle reflex dispatched within --window-ms of the
+percept (Layer 0 or a learned rule); otherwise the last Soul plan if it was
+dispatched within --plan-hold-s; otherwise whatever was dispatched next.
+
+  train_micro_model.py --events ~/prometheus/events --out models/lizard-micro.pmm
+  train_micro_model.py --synthetic 30000 --out /tmp/m.pmm --holdout-csv /tmp/holdout.csv
+
+Only the standard library is used; a 30k-row day trains in about a minute.
+"""
+
+import argparse
+import bisect
+import collections
+import glob
+import json
+import math
+import os
+import random
+import struct
+import sys
+import time
+import zlib
+
+# Must match MicroModel::Feature in src/lizard/micro_model.h.
+FEATURES = ["health", "food", "y", "hostile", "entity_count",
+            "nearest_hostile", "nearest", "health_delta"]
+FAR = 32.0
+# Actions the body understands (body/bot.js); anything else is dropped.
+ACTIONS = ["idle", "explore", "eat", "flee"]
+
+MAGIC = b"PMM1"
+BLOCK = struct.Struct("<IIIIQQB7x")     # event_log.cpp BlockHeader
+BLOCK_MAGIC = 0x31425645
+KIND_PERCEPT, KIND_ACTION = 1, 3
+SOURCE_REFLEX = 0
+
+
+# ── Event log ─────────────────────────────────────────────────────
+
+def read_varint(buf, off):
+    v = shift = 0
+    while True:
+        b = buf[off]
+        off += 1
+        v |= (b & 0x7F) << shift
+        if not b & 0x80:
+            return v, off
+        shift += 7
+
+
+def read_events(directory):
+    """Yield (t_us, kind, payload) from every segment, oldest first."""
+    for path in sorted(glob.glob(os.path.join(directory, "events-*.evl"))):
+        with open(path, "rb") as f:
+            data = f.read()
+        off = 0
+        while off + BLOCK.size <= len(data):
+            magic, raw_len, stored_len, count, _, _, codec = BLOCK.unpack_from(data, off)
+            off += BLOCK.size
+            if magic != BLOCK_MAGIC or off + stored_len > len(data):
+                break   # torn tail
+            body = data[off:off + stored_len]
+            off += stored_len
+            if codec == 1:
+                body = zlib.decompress(body)
+            pos = 0
+            while pos + 9 <= len(body):
+                t_us, kind = struct.unpack_from("<QB", body, pos)
+                n, pos = read_varint(body, pos + 9)
+                yield t_us, kind, body[pos:pos + n]
+                pos += n
+
+
+def percept_features(payload, prev_health):
+    hp, food, _x, y, _z, hostile, entities = struct.unpack_from("<5fBH", payload)
+    near_hostile, near = FAR, FAR
+    if len(payload) >= 31:          # records before the distances were logged lack them
+        near_hostile, near = struct.unpack_from("<2f", payload, 23)
+    delta = 0.0 if prev_health is None else hp - prev_health
+    return [hp, food, y, float(hostile), float(entities), near_hostile, near, delta], hp
+
+
+def action_name(payload):
+    try:
+        return json.loads(payload[1:].decode()).get("action", "")
+    except (ValueError, UnicodeDecodeError):
+        return ""
+
+
+def dataset_from_log(directory, window_ms, plan_hold_s):
+    events = sorted(read_events(directory), key=lambda e: e[0])
+    actions = [(t, p[0], action_name(p)) for t, k, p in events if k == KIND_ACTION]
+    action_times = [a[0] for a in actions]
+
+    rows, labels = [], []
+    prev_health = None
+    last_plan = None            # (t_us, action)
+    ai = 0
+    for t, kind, payload in events:
+        if kind != KIND_PERCEPT:
+            continue
+        x, prev_health = percept_features(payload, prev_health)
+        while ai < len(actions) and actions[ai][0] <= t:
+            if actions[ai][1] != SOURCE_REFLEX:
+                last_plan = (actions[ai][0], actions[ai][2])
+            ai += 1
+
+        label = None
+        end = bisect.bisect_left(action_times, t + window_ms * 1000)
+        upcoming = actions[ai:end]
+        for _, source, name in upcoming:
+            if source == SOURCE_REFLEX and name not in ("", "idle"):
+                label = name
+                break
+        if label is None and last_plan and t - last_plan[0] <= plan_hold_s * 1e6:
+            label = last_plan[1]
+        if label is None and upcoming:
+            label = upcoming[0][2]
+        if label in ACTIONS:
+            rows.append(x)
+            labels.append(ACTIONS.index(label))
+    return rows, labels
+
+
+def synthetic_dataset(n, seed):
+    """A scripted policy with noise, for trying the pipeline without a log."""
+    rng = random.Random(seed)
+    rows, labels = [], []
+    prev = 20.0
+    for _ in range(n):
+        hp = max(0.0, min(20.0, prev + rng.gauss(0, 1.5)))
+        food = rng.uniform(0, 20)
+        ents = rng.randint(0, 10)
+        hostile = ents > 0 and rng.random() < 0.3
+        near = rng.uniform(1, FAR) if ents else FAR
+        near_hostile = rng.uniform(near, FAR) if hostile else FAR
+        x = [hp, food, rng.uniform(-20, 120), float(hostile), float(ents),
+             near_hostile, near, hp - prev]
+        prev = hp if rng.random() < 0.9 else 20.0
+        if hp < 4 or (hostile and near_hostile < 8) or x[7] < -3:
+            a = "flee"
+        elif food < 6 or (food < 10 and not ents):
+            a = "eat"
+        elif ents == 0 or (not hostile and near > 16):
+            a = "explore"
+        else:
+            a = "idle"
+        if rng.random() < 0.05:
+            a = rng.choice(ACTIONS)
+        rows.append([f32(v) for v in x])
+        labels.append(ACTIONS.index(a))
+    return rows, labels
+
+
+# ── Training ──────────────────────────────────────────────────────
+
+def f32(v):
+    return struct.unpack("<f", struct.pack("<f", v))[0]
+
+
+def bin_edges(column, bins):
+    """Split thresholds: midpoints between adjacent quantile values."""
+    values = sorted(set(column))
+    if len(values) > bins:
+        values = sorted(set(values[int(i * (len(values) - 1) / (bins - 1))] for i in range(bins)))
+    return [f32((a + b) / 2) for a, b in zip(values, values[1:])]
+
+
+def softmax(z):
+    m = max(z)
+    e = [math.exp(v - m) for v in z]
+    s = sum(e)
+    return [v / s for v in e]
+
+
+def train(rows, labels, k, trees, depth, lr, bins, reg, subsample, seed):
+    rng = random.Random(seed)
+    n, nf = len(rows), len(FEATURES)
+    edges = [bin_edges([r[f] for r in rows], bins) for f in range(nf)]
+    # bisect_left: bin > j  ⇔  x > edges[j], matching the evaluator's `x > threshold`.
+    xb = [[bisect.bisect_left(edges[f], r[f]) for r in rows] for f in range(nf)]
+
+    prior = collections.Counter(labels)
+    base = [math.log((prior[c] + 1) / (n + k)) for c in range(k)]
+    logits = [base[:] for _ in range(n)]
+    model = []
+
+    for t in range(trees):
+        sample = [i for i in range(n) if rng.random() < subsample]
+        g = [[0.0] * n for _ in range(k)]
+        h = [[0.0] * n for _ in range(k)]
+        for i in sample:
+            p = softmax(logits[i])
+            for c in range(k):
+                g[c][i] = p[c] - (1.0 if labels[i] == c else 0.0)
+                h[c][i] = max(p[c] * (1.0 - p[c]), 1e-6)
+
+        node = [0] * n
+        splits = []
+        for d in range(depth):
+            nodes = 1 << d
+            best = None
+            for f in range(nf):
+                nb = len(edges[f]) + 1
+                if nb < 2:
+                    continue
+                col = xb[f]
+                G = [[0.0] * (nodes * nb) for _ in range(k)]
+                H = [[0.0] * (nodes * nb) for _ in range(k)]
+                for c in range(k):
+                    gc, hc, Gc, Hc = g[c], h[c], G[c], H[c]
+                    for i in sample:
+                        idx = node[i] * nb + col[i]
+                        Gc[idx] += gc[i]
+                        Hc[idx] += hc[i]
+                # gain[j] for the split "bin > j", summed over nodes and classes
+                gain = [0.0] * (nb - 1)
+                for c in range(k):
+                    Gc, Hc = G[c], H[c]
+                    for m in range(nodes):
+                        row_g = Gc[m * nb:(m + 1) * nb]
+                        row_h = Hc[m * nb:(m + 1) * nb]
+                        tg, th = sum(row_g), sum(row_h)
+                        lg = lh = 0.0
+                        for j in range(nb - 1):
+                            lg += row_g[j]
+                            lh += row_h[j]
+                            rg, rh = tg - lg, th - lh
+                            gain[j] += lg * lg / (lh + reg) + rg * rg / (rh + reg)
+                j = max(range(nb - 1), key=gain.__getitem__)
+                if best is None or gain[j] > best[0]:
+                    best = (gain[j], f, j)
+            _, f, j = best
+            splits.append((f, edges[f][j]))
+            col = xb[f]
+            for i in range(n):
+                if col[i] > j:
+                    node[i] |= 1 << d
+
+        leaves = 1 << depth
+        G = [[0.0] * k for _ in range(leaves)]
+        H = [[0.0] * k for _ in range(leaves)]
+        for i in sample:
+            for c in range(k):
+                G[node[i]][c] += g[c][i]
+                H[node[i]][c] += h[c][i]
+        values = [[-lr * G[l][c] / (H[l][c] + reg) for c in range(k)] for l in range(leaves)]
+        for i in range(n):
+            v = values[node[i]]
+            li = logits[i]
+            for c in range(k):
+                li[c] += v[c]
+        model.append((splits, values))
+        if (t + 1) % 10 == 0:
+            acc = sum(max(range(k), key=logits[i].__getitem__) == labels[i] for i in range(n)) / n
+            print(f"  tree {t + 1}/{trees}: train agreement {acc:.3f}", file=sys.stderr)
+    return base, model
+
+
+def predict(base, model, depth, x):
+    z = base[:]
+    for splits, values in model:
+        idx = 0
+        for d, (f, thr) in enumerate(splits):
+            if x[f] > thr:
+                idx |= 1 << d
+        for c, v in enumerate(values[idx]):
+            z[c] += v
+    return softmax(z)
+
+
+# ── Export ────────────────────────────────────────────────────────
+
+def write_model(path, base, model, depth, classes):
+    k = len(classes)
+    out = bytearray(MAGIC)
+    out += struct.pack("<HHHBB", len(FEATURES), k, len(model), depth, 0)
+    out += struct.pack(f"<{k}f", *base)
+    for name in classes:
+        out += name.encode()[:15].ljust(16, b"\0")
+    for splits, _ in model:
+        out += bytes(f for f, _ in splits)
+    for splits, _ in model:
+        out += struct.pack(f"<{depth}f", *(thr for _, thr in splits))
+    for _, values in model:
+        for leaf in values:
+            out += struct.pack(f"<{k}f", *leaf)
+    with open(path, "wb") as f:
+        f.write(out)
+    return len(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    src = parser.add_mutually_exclusive_group(required=True)
+    src.add_argument("--events", help="event log directory (PROMETHEUS_EVENT_LOG)")
+    src.add_argument("--synthetic", type=int, metavar="ROWS")
+    parser.add_argument("--out", required=True)
+    parser.add_argument("--holdout-csv", help="write held-out rows for the C++ bench")
+    parser.add_argument("--trees", type=int, default=48)
+    parser.add_argument("--depth", type=int, default=4)
+    parser.add_argument("--lr", type=float, default=0.3)
+    parser.add_argument("--bins", type=int, default=32)
+    parser.add_argument("--reg", type=float, default=1.0)
+    parser.add_argument("--subsample", type=float, default=0.7)
+    parser.add_argument("--holdout", type=float, default=0.2)
+    parser.add_argument("--max-rows", type=int, default=40000)
+    parser.add_argument("--window-ms", type=float, default=500)
+    parser.add_argument("--plan-hold-s", type=float, default=5)
+    parser.add_argument("--confidence", type=float, default=0.8,
+                        help="report coverage/agreement at this gate")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    if args.events:
+        rows, labels = dataset_from_log(args.events, args.window_ms, args.plan_hold_s)
+    else:
+        rows, labels = synthetic_dataset(args.synthetic, args.seed)
+    if len(rows) < 100:
+        sys.exit(f"only {len(rows)} labelled percepts; need at least 100")
+
+    rng = random.Random(args.seed)
+    order = list(range(len(rows)))
+    rng.shuffle(order)
+    order = order[:args.max_rows]
+    cut = int(len(order) * (1 - args.holdout))
+    train_idx, test_idx = order[:cut], order[cut:]
+    counts = collections.Counter(ACTIONS[labels[i]] for i in order)
+    print(f"{len(order)} labelled percepts ({dict(counts)}); "
+          f"{len(train_idx)} train / {len(test_idx)} held out", file=sys.stderr)
+
+    t0 = time.time()
+    base, model = train([rows[i] for i in train_idx], [labels[i] for i in train_idx],
+                        len(ACTIONS), args.trees, args.depth, args.lr, args.bins,
+                        args.reg, args.subsample, args.seed)
+    train_s = time.time() - t0
+    size = write_model(args.out, base, model, args.depth, ACTIONS)
+
+    agree = confident = confident_agree = 0
+    for i in test_idx:
+        p = predict(base, model, args.depth, rows[i])
+        c = max(range(len(p)), key=p.__getitem__)
+        agree += c == labels[i]
+        if p[c] >= args.confidence:
+            confident += 1
+            confident_agree += c == labels[i]
+    n = max(1, len(test_idx))
+    print(json.dumps({
+        "model": args.out, "bytes": size, "trees": len(model), "depth": args.depth,
+        "train_s": round(train_s, 1), "held_out": len(test_idx),
+        "agreement": round(agree / n, 4),
+        "confidence_gate": args.confidence,
+        "coverage": round(confident / n, 4),
+        "agreement_when_confident": round(confident_agree / max(1, confident), 4),
+    }))
+
+    if args.holdout_csv:
+        with open(args.holdout_csv, "w") as f:
+            f.write(",".join(FEATURES + ["label"]) + "\n")
+            for i in test_idx:
+                f.write(",".join(repr(v) for v in rows[i]) + f",{ACTIONS[labels[i]]}\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -1,21 +1,95 @@
 #include "arbiter/arbiter.h"
+#include "diag/trace.h"
+#include "log/log.h"
+#include "metrics/metrics.h"
 
-#include <iostream>
+#include <algorithm>
 
 namespace prometheus {
 
+// Routine questions are worth little once the moment has passed.
+static constexpr auto kRoutineDeadline = std::chrono::seconds(15);
+
+// ── Metrics ─────────────────────────────────────────────────────
+namespace {
+struct ArbiterMetrics {
+    static constexpr const char* kPlans     = "head_arbiter_plans_total";
+    static constexpr const char* kPlansHelp = "Soul plans submitted, by whether they were still wanted.";
+    static constexpr const char* kSent      = "head_arbiter_dispatched_total";
+    static constexpr const char* kSentHelp  = "Actions dispatched to the body, by source.";
+    Gauge&   queue_depth   = metrics().gauge("head_arbiter_soul_queue_depth",
+                                             "Soul queries waiting for a worker.");
+    Gauge&   in_flight     = metrics().gauge("head_arbiter_soul_in_flight",
+                                             "Soul queries being deliberated.");
+    Counter& vetoes        = metrics().counter("head_arbiter_vetoes_total",
+                                               "Layer 0 vetoes begun (routine Soul queries cancelled).");
+    Counter& overrides     = metrics().counter("head_arbiter_overrides_total",
+                                               "Soul plans that overrode a Layer 0 veto.");
+    Counter& superseded    = metrics().counter("head_arbiter_superseded_total",
+                                               "Soul queries superseded by a newer one on the same topic.");
+    Counter& accepted      = metrics().counter(kPlans, kPlansHelp, R"(outcome="accepted")");
+    Counter& discarded     = metrics().counter(kPlans, kPlansHelp, R"(outcome="discarded")");
+    Counter& sent_reflex   = metrics().counter(kSent, kSentHelp, R"(source="reflex")");
+    Counter& sent_learned  = metrics().counter(kSent, kSentHelp, R"(source="learned")");
+    Counter& sent_plan     = metrics().counter(kSent, kSentHelp, R"(source="plan")");
+    Counter& sent_override = metrics().counter(kSent, kSentHelp, R"(source="override")");
+};
+
+ArbiterMetrics& arbiter_metrics() {
+    static ArbiterMetrics m;
+    return m;
+}
+} // namespace
+
 Arbiter::Arbiter(Lizard& lizard, Soul& soul, BodyLink& body)
-    : lizard_(lizard), soul_(soul), body_(body) {}
+    : lizard_(lizard), soul_(soul), body_(body) {
+    arbiter_metrics();      // register the series before the first scrape
+}
 
 void Arbiter::submit_reflex(Reflex reflex) {
-    std::lock_guard lock(reflex_mu_);
-    // Keep the most urgent reflex.
-    if (!pending_reflex_ || reflex.urgency > pending_reflex_->urgency) {
-        pending_reflex_ = std::move(reflex);
+    TraceSpan span("submit_reflex", reflex.percept_seq);
+    bool veto_started = false;
+    {
+        std::lock_guard lock(reflex_mu_);
+        veto_started = reflex.vetoes_soul && !veto_active_;
+        veto_active_ = reflex.vetoes_soul;
+
+        // Keep the most urgent reflex.
+        if (!pending_reflex_ || reflex.urgency > pending_reflex_->urgency) {
+            pending_reflex_ = std::move(reflex);
+        }
+    }
+
+    // Routine questions asked before the threat appeared are moot; Council
+    // deliberations still apply (their answer may override the veto).
+    if (veto_started) {
+        arbiter_metrics().vetoes.inc();
+        cancel_soul_queries("layer0_veto", QueryClass::Routine);
     }
 }
 
 void Arbiter::submit_plan(SoulPlan plan) {
+    bool stale = plan.cancelled;
+    {
+        std::lock_guard lock(query_mu_);
+        auto it = std::find_if(in_flight_.begin(), in_flight_.end(),
+                               [&](const InFlight& f) { return f.id == plan.query_id; });
+        if (it != in_flight_.end()) {
+            stale = stale || it->cancel->cancelled();
+            in_flight_.erase(it);
+        }
+        arbiter_metrics().in_flight.set(static_cast<double>(in_flight_.size()));
+    }
+
+    if (stale) {
+        plans_discarded_.fetch_add(1);
+        arbiter_metrics().discarded.inc();
+        return;
+    }
+    plans_accepted_.fetch_add(1);
+    arbiter_metrics().accepted.inc();
+    if (event_log_) event_log_->plan(plan);
+
     std::lock_guard lock(plan_mu_);
     pending_plan_ = std::move(plan);
 }
@@ -24,20 +98,84 @@ std::optional<SoulQuery> Arbiter::next_soul_query() {
     std::lock_guard lock(query_mu_);
     if (soul_queries_.empty()) return std::nullopt;
     auto q = std::move(soul_queries_.front());
-    soul_queries_.pop();
+    soul_queries_.pop_front();
+    in_flight_.push_back({q.id, q.topic, q.cls, q.cancel});
+    auto& m = arbiter_metrics();
+    m.queue_depth.set(static_cast<double>(soul_queries_.size()));
+    m.in_flight.set(static_cast<double>(in_flight_.size()));
     return q;
 }
 
 void Arbiter::escalate(const std::string& prompt,
-                       std::optional<std::string> image_b64) {
+                       std::optional<std::string> image_b64,
+                       const std::string& topic,
+                       QueryClass cls,
+                       bool cacheable) {
     std::lock_guard lock(query_mu_);
+
+    if (!topic.empty()) {
+        size_t superseded = 0;
+        for (auto it = soul_queries_.begin(); it != soul_queries_.end();) {
+            if (it->topic == topic) {
+                it = soul_queries_.erase(it);
+                ++superseded;
+            } else {
+                ++it;
+            }
+        }
+        for (auto& f : in_flight_) {
+            if (f.topic == topic && !f.cancel->cancelled()) {
+                f.cancel->cancel();
+                ++superseded;
+            }
+        }
+        if (superseded) {
+            arbiter_metrics().superseded.inc(superseded);
+            PROMETHEUS_LOG(Info, "[ARBITER] Superseded {} Soul quer{} on topic '{}'.", superseded,
+                           superseded == 1 ? "y" : "ies", topic);
+        }
+    }
+
     SoulQuery q;
-    q.prompt   = prompt;
-    q.image_b64 = std::move(image_b64);
-    soul_queries_.push(std::move(q));
+    q.id          = next_query_id_++;
+    q.topic       = topic;
+    q.cls         = cls;
+    q.situation   = situation_.load();
+    q.prompt      = prompt;
+    q.image_b64   = std::move(image_b64);
+    q.cacheable   = cacheable;
+    q.cancel      = std::make_shared<CancelToken>();
+    q.enqueued_at = std::chrono::steady_clock::now();
+    if (cls == QueryClass::Routine) q.deadline = q.enqueued_at + kRoutineDeadline;
+    soul_queries_.push_back(std::move(q));
+    arbiter_metrics().queue_depth.set(static_cast<double>(soul_queries_.size()));
+}
+
+void Arbiter::cancel_soul_queries(const char* reason, std::optional<QueryClass> only) {
+    std::lock_guard lock(query_mu_);
+    auto matches = [&](QueryClass cls) { return !only || cls == *only; };
+
+    const size_t queued = soul_queries_.size();
+    soul_queries_.erase(std::remove_if(soul_queries_.begin(), soul_queries_.end(),
+                                       [&](const SoulQuery& q) { return matches(q.cls); }),
+                        soul_queries_.end());
+    size_t cancelled = queued - soul_queries_.size();
+    arbiter_metrics().queue_depth.set(static_cast<double>(soul_queries_.size()));
+    for (auto& f : in_flight_) {
+        if (matches(f.cls) && !f.cancel->cancelled()) {
+            f.cancel->cancel();
+            ++cancelled;
+        }
+    }
+    if (cancelled) {
+        PROMETHEUS_LOG(Info, "[ARBITER] Cancelled {} Soul quer{} ({}).", cancelled,
+                       cancelled == 1 ? "y" : "ies", reason);
+    }
 }
 
 void Arbiter::dispatch_tick() {
+    TraceSpan span("dispatch_tick");
+
     // ── Grab candidates ─────────────────────────────────────────
     std::optional<Reflex>   reflex;
     std::optional<SoulPlan> plan;
@@ -46,6 +184,7 @@ void Arbiter::dispatch_tick() {
         std::lock_guard lock(reflex_mu_);
         reflex.swap(pending_reflex_);
     }
+    if (reflex) span.set_flow(reflex->percept_seq);
     {
         std::lock_guard lock(plan_mu_);
         plan.swap(pending_plan_);
@@ -56,21 +195,46 @@ void Arbiter::dispatch_tick() {
     // explicitly overrides.
     if (reflex && reflex->vetoes_soul) {
         if (plan && plan->override_safety) {
-            std::cout << "[ARBITER] Soul OVERRIDE accepted.\n";
-            body_.send_action(plan->action_json);
+            PROMETHEUS_LOG(Info, "[ARBITER] Soul OVERRIDE accepted.");
+            arbiter_metrics().overrides.inc();
+            send(plan->action_json, ActionSource::Override);
         } else {
-            body_.send_action(reflex->action_json);
+            send(reflex->action_json, ActionSource::Reflex, reflex->learned);
         }
         return;
     }
 
     // Prefer the Soul's plan when available, else fall back to reflex.
     if (plan) {
-        body_.send_action(plan->action_json);
+        send(plan->action_json, ActionSource::Plan);
     } else if (reflex) {
-        body_.send_action(reflex->action_json);
+        send(reflex->action_json, ActionSource::Reflex, reflex->learned);
     }
     // else: nothing to do this tick.
 }
 
+void Arbiter::send(std::string_view action_json, ActionSource source, bool learned) {
+    auto& m = arbiter_metrics();
+    switch (source) {
+    case ActionSource::Reflex:   (learned ? m.sent_learned : m.sent_reflex).inc(); break;
+    case ActionSource::Plan:     m.sent_plan.inc(); break;
+    case ActionSource::Override: m.sent_override.inc(); break;
+    }
+    body_.send_action(action_json);
+    if (event_log_) event_log_->action(action_json, source);
+
+    if (action_json == last_action_ && source == last_source_) return;
+    last_action_.assign(action_json);
+    last_source_ = source;
+    if (source != ActionSource::Reflex) soul_decisions_.fetch_add(1, std::memory_order_relaxed);
+    else if (learned)                   learned_decisions_.fetch_add(1, std::memory_order_relaxed);
+    else                                reflex_decisions_.fetch_add(1, std::memory_order_relaxed);
+}
+
+Arbiter::DecisionStats Arbiter::decisions() const {
+    return {reflex_decisions_.load(std::memory_order_relaxed),
+            learned_decisions_.load(std::memory_order_relaxed),
+            soul_decisions_.load(std::memory_order_relaxed)};
+}
+
 } // namespace prometheus
@@ -3,16 +3,29 @@
 #include "lizard/lizard.h"
 #include "soul/soul.h"
 #include "ipc/body_link.h"
+#include "memory/event_log.h"
 
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
 #include <mutex>
 #include <optional>
-#include <queue>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace prometheus {
 
 // Subsumption Arbiter — resolves conflicts between Lizard and Soul.
 //   Layer 0 (Reflex/Avoid) always wins unless the Soul explicitly
 //   issues an [OVERRIDE: IGNORE_SAFETY] token.
+//
+// Soul queries carry a CancelToken. A query is cancelled when it is
+// superseded by a newer query on the same topic, or — for Routine
+// queries — when a Layer 0 veto begins: "what next" asked before the
+// threat no longer applies. Council queries (safety and ethics) run on,
+// since their answer is what may override the veto.
 class Arbiter {
 public:
     Arbiter(Lizard& lizard, Soul& soul, BodyLink& body);
@@ -26,26 +39,87 @@ public:
     // Returns the next pending query for the Soul (thread-safe).
     std::optional<SoulQuery> next_soul_query();
 
-    // Escalate a percept to the Soul for deeper reasoning.
+    // Escalate a percept to the Soul for deeper reasoning. A non-empty
+    // topic supersedes any queued or in-flight query with the same topic.
+    // Routine queries get a short deadline so the router favours speed.
+    // Uncacheable queries bypass the Soul's response cache.
     void escalate(const std::string& prompt,
-                  std::optional<std::string> image_b64 = std::nullopt);
+                  std::optional<std::string> image_b64 = std::nullopt,
+                  const std::string& topic = "",
+                  QueryClass cls = QueryClass::Council,
+                  bool cacheable = true);
+
+    // Record the current situation (see situation_signature); stamped
+    // onto each escalated query for the Soul's response cache.
+    void note_situation(uint64_t signature) { situation_.store(signature); }
+
+    // Cancel queued and in-flight Soul queries: every one, or only those
+    // of class `only`.
+    void cancel_soul_queries(const char* reason,
+                             std::optional<QueryClass> only = std::nullopt);
+
+    // Plans accepted vs. discarded because their query was cancelled.
+    uint64_t plans_accepted()  const { return plans_accepted_.load(); }
+    uint64_t plans_discarded() const { return plans_discarded_.load(); }
+
+    // Dispatched decisions by who made them. A decision is a change in
+    // what is sent (the same action re-sent every tick counts once).
+    // Built-in reflexes were never the Soul's; learned ones are decisions
+    // the Lizard now makes from the Teacher's lessons instead.
+    struct DecisionStats {
+        uint64_t reflex{0};     // built-in Lizard reflexes
+        uint64_t learned{0};    // rules compiled from lessons
+        uint64_t soul{0};       // plans and overrides
+        // Share of non-built-in decisions the Lizard took over.
+        double moved_to_lizard() const {
+            return learned + soul ? static_cast<double>(learned) / static_cast<double>(learned + soul) : 0.0;
+        }
+    };
+    DecisionStats decisions() const;
 
     // Main-thread tick: pick the highest-priority action and send to body.
     void dispatch_tick();
 
+    // Record accepted plans and dispatched actions in the session log.
+    void set_event_log(EventLog* log) { event_log_ = log; }
+
 private:
+    void send(std::string_view action_json, ActionSource source, bool learned = false);
+
     Lizard&   lizard_;
     Soul&     soul_;
     BodyLink& body_;
+    EventLog* event_log_{nullptr};
 
     std::mutex              reflex_mu_;
     std::optional<Reflex>   pending_reflex_;
+    bool                    veto_active_{false};
 
     std::mutex              plan_mu_;
     std::optional<SoulPlan> pending_plan_;
 
+    struct InFlight {
+        uint64_t                     id;
+        std::string                  topic;
+        QueryClass                   cls;
+        std::shared_ptr<CancelToken> cancel;
+    };
+
     std::mutex              query_mu_;
-    std::queue<SoulQuery>   soul_queries_;
+    std::deque<SoulQuery>   soul_queries_;
+    std::vector<InFlight>   in_flight_;
+    uint64_t                next_query_id_{1};
+
+    std::atomic<uint64_t>   situation_{0};
+    std::atomic<uint64_t>   plans_accepted_{0};
+    std::atomic<uint64_t>   plans_discarded_{0};
+
+    // Decision accounting; last_* are touched only by dispatch_tick().
+    std::string             last_action_;
+    ActionSource            last_source_{ActionSource::Reflex};
+    std::atomic<uint64_t>   reflex_decisions_{0};
+    std::atomic<uint64_t>   learned_decisions_{0};
+    std::atomic<uint64_t>   soul_decisions_{0};
 };
 
 } // namespace prometheus
@@ -1,74 +1,221 @@
 #include "circadian/circadian.h"
+#include "diag/trace.h"
+#include "lizard/reflex_rules.h"
+#include "log/log.h"
+#include "metrics/metrics.h"
 
+#include <algorithm>
 #include <chrono>
-#include <iostream>
-#include <thread>
 
 namespace prometheus {
 
-Circadian::Circadian(Memory& mem, Teacher& teacher)
-    : memory_(mem), teacher_(teacher) {}
-
-void Circadian::run(std::atomic<bool>& running) {
-    using clock = std::chrono::steady_clock;
+// ── Metrics ─────────────────────────────────────────────────────
+namespace {
+struct CircadianMetrics {
+    static constexpr const char* kPhase     = "head_circadian_phase_seconds";
+    static constexpr const char* kPhaseHelp = "Time spent in each circadian phase.";
+    Histogram& awake    = metrics().histogram(kPhase, kPhaseHelp, R"(phase="awake")");
+    Histogram& tired    = metrics().histogram(kPhase, kPhaseHelp, R"(phase="tired")");
+    Histogram& sleeping = metrics().histogram(kPhase, kPhaseHelp, R"(phase="sleeping")");
+    Gauge&     state    = metrics().gauge("head_circadian_state",
+                                          "Current phase: 0 awake, 1 tired, 2 sleeping.");
+};
+
+CircadianMetrics& circadian_metrics() {
+    static CircadianMetrics m;
+    return m;
+}
+} // namespace
 
-    std::cout << "[CIRCADIAN] Cycle started.\n";
-    auto phase_start = clock::now();
+Circadian::Circadian(Memory& mem, Teacher& teacher, EventLog& log)
+    : memory_(mem), teacher_(teacher), log_(log), consolidator_(log, mem),
+      day_start_us_(EventLog::now_us()) {
+    circadian_metrics();    // register the series before the first scrape
+}
 
-    while (running.load()) {
-        auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-            clock::now() - phase_start).count();
+void Circadian::set_busy_probe(std::function<bool()> busy) {
+    consolidator_.set_busy_probe(std::move(busy));
+}
 
-        switch (state_.load()) {
-        case State::Awake:
-            if (elapsed >= awake_duration_s_) {
-                std::cout << "[CIRCADIAN] Transitioning to Tired.\n";
-                state_.store(State::Tired);
-                phase_start = clock::now();
-            }
-            break;
+void Circadian::start(Scheduler& sched) {
+    sched_       = &sched;
+    phase_start_ = std::chrono::steady_clock::now();
+    consolidator_.start(sched);
+    schedule_day();
+    PROMETHEUS_LOG(Info, "[CIRCADIAN] Cycle started.");
+}
 
-        case State::Tired:
-            if (elapsed >= tired_duration_s_) {
-                state_.store(State::Sleeping);
-                enter_sleep();
-                phase_start = clock::now();
-            }
-            break;
+void Circadian::schedule_day() {
+    sched_->after("circadian.tired", awake_duration_, [this] {
+        PROMETHEUS_LOG(Info, "[CIRCADIAN] Transitioning to Tired.");
+        enter_phase(State::Tired);
+        start_grading();
+        sched_->after("circadian.sleep", tired_duration_, [this] {
+            enter_phase(State::Sleeping);
+            enter_sleep();
+            schedule_day();
+        });
+    });
+}
 
-        case State::Sleeping:
-            // enter_sleep() is synchronous; once it returns we wake.
-            break;
+void Circadian::start_grading() {
+    TraceSpan span("start_grading");
+    // The day so far, already compacted by the consolidator — reflexes,
+    // actions, plans and markers. Raw percepts stay in the event log;
+    // only the moments before a near-death are pulled out for the Teacher.
+    // The Tired phase itself is not graded; it is consolidated at sleep.
+    consolidator_.catch_up();
+    const uint64_t now = EventLog::now_us();
+    std::string log = consolidator_.day_log();
+    if (log.empty()) log = memory_.active_markers();   // no event log
+    log += incident_context(day_start_us_, now);
+
+    // The previous day's grading may still be in flight; never wait for it
+    // on a scheduler worker. Absorb it if it is done, else queue today's
+    // behind it — one grading at a time, earlier lessons first.
+    std::lock_guard lock(lesson_mu_);
+    std::future<std::string> previous;
+    if (lesson_.valid()) {
+        if (lesson_.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            absorb(lesson_.get());
+        } else {
+            PROMETHEUS_LOG(Info, "[CIRCADIAN] Previous lesson still grading; queued today's behind it.");
+            previous = std::move(lesson_);
         }
-
-        std::this_thread::sleep_for(std::chrono::seconds(1));
     }
+    lesson_ = std::async(std::launch::async,
+                         [this, log = std::move(log), previous = std::move(previous)]() mutable {
+        std::string lessons = previous.valid() ? previous.get() : std::string{};
+        if (!lessons.empty() && lessons.back() != '\n') lessons += '\n';
+        return lessons + teacher_.grade_log(log);
+    });
 }
 
 void Circadian::enter_sleep() {
-    std::cout << "[CIRCADIAN] Entering Sleep — consolidating...\n";
+    TraceSpan span("enter_sleep");
+    PROMETHEUS_LOG(Info, "[CIRCADIAN] Entering Sleep — finalizing consolidation...");
+    auto t0 = std::chrono::steady_clock::now();
+
+    // 1. Index the last slice and persist. Everything earlier was indexed
+    //    during the day.
+    consolidator_.finalize();
+    auto s = consolidator_.stats();
+    PROMETHEUS_LOG(Info, "[CIRCADIAN] Day consolidated: {} events → {} lines, {} passages over "
+                   "{} slices ({} ms work, max batch {} ms, {} yields).",
+                   s.events, s.lines, s.passages_indexed, s.slices, static_cast<int>(s.work_ms),
+                   static_cast<int>(s.max_batch_ms), s.busy_yields);
+
+    // 2. Collect the lesson if the Teacher has finished; otherwise it is
+    //    absorbed during the day once it arrives.
+    wake_up();
+    std::lock_guard lock(lesson_mu_);
+    if (lesson_.valid()) {
+        auto left = kSleepBudget - (std::chrono::steady_clock::now() - t0);
+        if (lesson_.wait_for(std::max(left, std::chrono::steady_clock::duration::zero())) ==
+            std::future_status::ready) {
+            absorb(lesson_.get());
+        } else {
+            PROMETHEUS_LOG(Info, "[CIRCADIAN] Lesson still grading; will absorb when ready.");
+            sched_->after("circadian.lesson", kLessonPoll, [this] { poll_lesson(); });
+        }
+    }
 
-    // 1. Dump the day's log from memory.
-    std::string log = memory_.active_markers();
-    memory_.flush_log(log);
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+    PROMETHEUS_LOG(Info, "[CIRCADIAN] Sleep finalized in {} ms.", ms);
+    enter_phase(State::Awake);
+    PROMETHEUS_LOG(Info, "[CIRCADIAN] Good morning.");
+}
 
-    // 2. Send to the Teacher (Gemini API) for grading.
-    std::string lesson = teacher_.grade_log(log);
+void Circadian::enter_phase(State next) {
+    auto& m   = circadian_metrics();
+    auto  now = std::chrono::steady_clock::now();
+    const char* phase = nullptr;
+    switch (state_.exchange(next)) {
+    case State::Awake:    m.awake.record(now - phase_start_);    phase = "circadian.awake";    break;
+    case State::Tired:    m.tired.record(now - phase_start_);    phase = "circadian.tired";    break;
+    case State::Sleeping: m.sleeping.record(now - phase_start_); phase = "circadian.sleeping"; break;
+    }
+    Trace::record(phase, Trace::ns(phase_start_), Trace::ns(now));
+    phase_start_ = now;
+    m.state.set(static_cast<double>(next));
+}
 
-    // 3. Wake up and inject the lesson.
-    wake_up(lesson);
+std::string Circadian::incident_context(uint64_t day_start_us, uint64_t now_us) {
+    const uint64_t window = std::chrono::duration_cast<std::chrono::microseconds>(
+        kIncidentWindow).count();
+
+    std::string out;
+    uint64_t before = now_us;
+    for (int i = 0; i < kMaxIncidents; ++i) {
+        auto incident = log_.last(EventKind::Marker, "NEAR_DEATH", before);
+        if (!incident || incident->t_us < day_start_us) break;
+
+        uint64_t from = incident->t_us > window ? incident->t_us - window : 0;
+        out += "\n── Percepts before " + incident->describe() + " ──\n";
+        for (auto& e : log_.query(from, incident->t_us + 1, event_bit(EventKind::Percept))) {
+            out += e.describe() + '\n';
+        }
+        before = incident->t_us;
+    }
+    return out;
 }
 
-void Circadian::wake_up(const std::string& lesson) {
+void Circadian::wake_up() {
+    day_start_us_ = EventLog::now_us();
+    consolidator_.begin_day();
     memory_.clear_short_term();
+}
 
-    if (!lesson.empty()) {
-        memory_.tag("[MEM:LESSON:" + lesson.substr(0, 40) + "]");
-        std::cout << "[CIRCADIAN] Lesson absorbed.\n";
+// A lesson that missed the sleep budget lands during the day.
+void Circadian::poll_lesson() {
+    std::lock_guard lock(lesson_mu_);
+    if (!lesson_.valid()) return;
+    if (lesson_.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        absorb(lesson_.get());
+    } else {
+        sched_->after("circadian.lesson", kLessonPoll, [this] { poll_lesson(); });
     }
+}
 
-    state_.store(State::Awake);
-    std::cout << "[CIRCADIAN] Good morning.\n";
+// Lessons arrive one per line (grade_log). Those that compile are
+// installed into the Lizard as one new rule set; the rest are tagged as
+// markers, one per lesson, for the Soul's context.
+void Circadian::absorb(const std::string& lessons) {
+    std::vector<std::string> lines;
+    for (size_t pos = 0; pos < lessons.size();) {
+        size_t end = std::min(lessons.find('\n', pos), lessons.size());
+        if (end > pos) lines.push_back(lessons.substr(pos, end - pos));
+        pos = end + 1;
+    }
+    if (lines.empty()) return;
+
+    std::vector<std::string> context = lines;
+    if (lizard_) {
+        auto result = LessonCompiler().compile_all(lines, lizard_->recent_percepts());
+        if (!result.rules.empty()) {
+            auto merged = std::make_shared<const RuleSet>(
+                lizard_->rules()->merged(result.rules, kMaxRules));
+            lizard_->install_rules(merged);
+            for (auto& r : result.rules) {
+                PROMETHEUS_LOG(Info, "[CIRCADIAN] Lesson compiled: \"{}\" → {}", r.lesson, r.id);
+            }
+            PROMETHEUS_LOG(Info, "[CIRCADIAN] {} learned reflex rules installed.", merged->size());
+        }
+        context = std::move(result.uncompiled);
+        for (auto& r : result.rejected) {
+            PROMETHEUS_LOG(Info, "[CIRCADIAN] Lesson rejected as a rule ({}): \"{}\"", r.reason,
+                           r.lesson);
+            context.push_back(r.lesson);
+        }
+    }
+
+    for (auto& l : context) {
+        memory_.tag("[MEM:LESSON:" + l.substr(0, std::min<size_t>(40, l.size())) + "]");
+    }
+    size_t n = lines.size();
+    PROMETHEUS_LOG(Info, "[CIRCADIAN] {} {} absorbed ({} as reflexes, {} as context).", n,
+                   n == 1 ? "lesson" : "lessons", n - context.size(), context.size());
 }
 
 } // namespace prometheus
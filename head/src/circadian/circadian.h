@@ -1,14 +1,28 @@
 #pragma once
 
+#include "circadian/consolidator.h"
+#include "lizard/lizard.h"
+#include "memory/event_log.h"
 #include "memory/memory.h"
+#include "sched/scheduler.h"
 #include "teacher/teacher.h"
 
 #include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
 
 namespace prometheus {
 
 // Circadian Rhythm / Sleep Cycle state machine.
 //   Awake → Tired → Sleep (consolidation) → Awake
+//
+// Consolidation runs incrementally through the day (see Consolidator);
+// grading starts when the agent gets Tired, so Sleep only finalizes.
+// Lessons that compile to reflex rules (see LessonCompiler) go to the
+// Lizard's fast path; the rest become markers in the Soul's context.
 class Circadian {
 public:
     enum class State : uint8_t {
@@ -17,24 +31,53 @@ public:
         Sleeping,
     };
 
-    Circadian(Memory& mem, Teacher& teacher);
+    Circadian(Memory& mem, Teacher& teacher, EventLog& log);
 
-    // Blocking run-loop — call from a dedicated thread.
-    void run(std::atomic<bool>& running);
+    // Schedule the day on `sched`: phase transitions are one-shot timers,
+    // consolidation a periodic task.
+    void start(Scheduler& sched);
 
     State state() const { return state_.load(); }
 
+    // While this returns true, background consolidation holds off.
+    void set_busy_probe(std::function<bool()> busy);
+
+    // Install compiled lessons into `lizard` when absorbing them.
+    void attach_lizard(Lizard* lizard) { lizard_ = lizard; }
+
 private:
+    void schedule_day();
+    void start_grading();
     void enter_sleep();
-    void wake_up(const std::string& lesson);
+    void poll_lesson();
+    void wake_up();
+    void absorb(const std::string& lessons);
+    void enter_phase(State next);       // records the phase just ended
 
-    Memory&  memory_;
-    Teacher& teacher_;
+    // Percepts leading up to the day's most recent near-death moments.
+    std::string incident_context(uint64_t day_start_us, uint64_t now_us);
+
+    Memory&   memory_;
+    Teacher&  teacher_;
+    EventLog& log_;
+    Lizard*   lizard_{nullptr};
+    Consolidator consolidator_;
+    Scheduler*   sched_{nullptr};
     std::atomic<State> state_{State::Awake};
+    std::chrono::steady_clock::time_point phase_start_{std::chrono::steady_clock::now()};
+    uint64_t day_start_us_;
+    std::mutex               lesson_mu_;
+    std::future<std::string> lesson_;   // Teacher grading in flight
+
+    static constexpr auto kIncidentWindow = std::chrono::seconds(30);
+    static constexpr auto kSleepBudget    = std::chrono::seconds(1);
+    static constexpr auto kLessonPoll     = std::chrono::seconds(1);
+    static constexpr int  kMaxIncidents   = 3;
+    static constexpr size_t kMaxRules     = 32;
 
     // Configurable cycle length (seconds of game-time).
-    int awake_duration_s_  = 1200;  // 20 min
-    int tired_duration_s_  = 120;   //  2 min
+    std::chrono::seconds awake_duration_{1200};  // 20 min
+    std::chrono::seconds tired_duration_{120};   //  2 min
 };
 
 } // namespace prometheus
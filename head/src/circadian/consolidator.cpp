@@ -0,0 +1,213 @@
+#include "circadian/consolidator.h"
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+namespace prometheus {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double ms_since(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+// One run of identical consecutive events of a kind.
+struct Run {
+    EventKind   kind;
+    std::string first;      // full description of the first event
+    std::string text;       // description without the timestamp
+    std::string last_time;
+    size_t      count{1};
+};
+
+// Collapse repeats: an event identical to the open run of its kind
+// extends that run instead of starting a new line. Reflexes and actions
+// arrive at the percept rate, so a quiet minute becomes a handful of lines.
+std::vector<std::string> compact(const std::vector<Event>& events) {
+    std::vector<Run> runs;
+    size_t open[8];
+    std::fill(std::begin(open), std::end(open), SIZE_MAX);
+
+    for (auto& e : events) {
+        std::string line = e.describe();
+        size_t sp = line.find(' ');
+        std::string time = line.substr(0, sp);
+        std::string text = sp == std::string::npos ? std::string() : line.substr(sp + 1);
+
+        size_t& slot = open[static_cast<uint8_t>(e.kind) & 7];
+        if (slot != SIZE_MAX && runs[slot].text == text) {
+            ++runs[slot].count;
+            runs[slot].last_time = std::move(time);
+            continue;
+        }
+        slot = runs.size();
+        runs.push_back({e.kind, std::move(line), std::move(text), std::move(time)});
+    }
+
+    std::vector<std::string> out;
+    out.reserve(runs.size());
+    for (auto& r : runs) {
+        if (r.count == 1) {
+            out.push_back(std::move(r.first));
+        } else {
+            out.push_back(r.first + " ×" + std::to_string(r.count) + " until " + r.last_time);
+        }
+    }
+    return out;
+}
+
+std::string digest(const std::vector<Event>& events, size_t lines) {
+    size_t reflexes = 0, actions = 0, plans = 0, markers = 0;
+    for (auto& e : events) {
+        switch (e.kind) {
+        case EventKind::Reflex: ++reflexes; break;
+        case EventKind::Action: ++actions;  break;
+        case EventKind::Plan:   ++plans;    break;
+        case EventKind::Marker: ++markers;  break;
+        default: break;
+        }
+    }
+    std::string first = events.front().describe();
+    std::string last  = events.back().describe();
+    return "DIGEST " + first.substr(0, first.find(' ')) + "–" + last.substr(0, last.find(' ')) +
+           ": " + std::to_string(reflexes) + " reflexes, " + std::to_string(actions) +
+           " actions, " + std::to_string(plans) + " plans, " + std::to_string(markers) +
+           " markers in " + std::to_string(lines) + " runs";
+}
+
+constexpr uint32_t kConsolidatedKinds = event_bit(EventKind::Reflex) |
+                                        event_bit(EventKind::Action) |
+                                        event_bit(EventKind::Plan)   |
+                                        event_bit(EventKind::Marker);
+
+} // namespace
+
+Consolidator::Consolidator(EventLog& log, Memory& mem)
+    : Consolidator(log, mem, Config{}) {}
+
+Consolidator::Consolidator(EventLog& log, Memory& mem, Config cfg)
+    : log_(log), memory_(mem), cfg_(cfg),
+      cursor_us_(EventLog::now_us()), batch_size_(cfg.batch_lines) {}
+
+void Consolidator::set_busy_probe(std::function<bool()> busy) {
+    busy_ = std::move(busy);
+}
+
+void Consolidator::start(Scheduler& sched) {
+    sched.every("consolidate", std::chrono::duration_cast<Scheduler::Duration>(cfg_.slice), [this] {
+        std::lock_guard work(work_mu_);
+        run_slice(true);
+    });
+}
+
+void Consolidator::begin_day() {
+    std::lock_guard work(work_mu_);
+    std::lock_guard lock(day_mu_);
+    day_lines_.clear();
+    omitted_ = 0;
+}
+
+size_t Consolidator::catch_up() {
+    hurry_.store(true);
+    wake_cv_.notify_all();
+    std::lock_guard work(work_mu_);
+    hurry_.store(false);
+    return run_slice(false);
+}
+
+size_t Consolidator::finalize() {
+    size_t n = catch_up();
+    memory_.sync_long_term();
+    return n;
+}
+
+std::string Consolidator::day_log() const {
+    std::lock_guard lock(day_mu_);
+    std::string out;
+    for (auto& l : day_lines_) out += l + '\n';
+    if (omitted_) out += "(" + std::to_string(omitted_) + " later lines omitted)\n";
+    return out;
+}
+
+Consolidator::Stats Consolidator::stats() const {
+    std::lock_guard lock(day_mu_);
+    return stats_;
+}
+
+// ── Slices ──────────────────────────────────────────────────────
+
+bool Consolidator::wait_while_busy() {
+    if (!busy_ || !busy_()) return false;
+    auto t0 = Clock::now();
+    while (busy_() && !hurry_.load() && Clock::now() - t0 < cfg_.max_yield) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+size_t Consolidator::run_slice(bool throttled) {
+    const uint64_t settle = std::chrono::duration_cast<std::chrono::microseconds>(kSettle).count();
+    const uint64_t now    = EventLog::now_us();
+    if (now < cursor_us_ + settle) return 0;
+    const uint64_t to = now - settle;
+    auto events = log_.query(cursor_us_, to, kConsolidatedKinds);
+    cursor_us_ = to;
+    if (events.empty()) return 0;
+
+    auto lines = compact(events);
+    lines.push_back(digest(events, lines.size()));
+
+    size_t indexed = 0;
+    double work_ms = 0, max_batch_ms = 0;
+    uint64_t yields = 0;
+    for (size_t b = 0; b < lines.size();) {
+        bool hurry = !throttled || hurry_.load();
+        if (!hurry && wait_while_busy()) ++yields;
+
+        auto t0 = Clock::now();
+        size_t end = std::min(lines.size(), b + batch_size_);
+        std::string text;
+        for (size_t i = b; i < end; ++i) text += lines[i] + '\n';
+        indexed += memory_.consolidate(text);
+        b = end;
+
+        double ms = ms_since(t0);
+        work_ms += ms;
+        max_batch_ms = std::max(max_batch_ms, ms);
+
+        // Size the next batch to the budget: embedding cost per line is
+        // roughly constant, so scale by how far off this one was.
+        double budget = static_cast<double>(cfg_.batch_budget.count());
+        if (ms > budget && batch_size_ > 1) {
+            batch_size_ = std::max<size_t>(1, batch_size_ / 2);
+        } else if (ms < budget / 2) {
+            batch_size_ = std::min(cfg_.batch_lines, batch_size_ * 2);
+        }
+
+        // Hold the duty cycle: idle for ms × (1/duty − 1) after each batch.
+        if (!hurry && b < lines.size() && cfg_.max_duty < 1.0) {
+            auto idle = std::chrono::duration<double, std::milli>(ms * (1.0 / cfg_.max_duty - 1.0));
+            std::unique_lock lock(wake_mu_);
+            wake_cv_.wait_for(lock, idle, [&] { return hurry_.load(); });
+        }
+    }
+
+    std::lock_guard lock(day_mu_);
+    for (auto& l : lines) {
+        if (day_lines_.size() < cfg_.max_day_lines) day_lines_.push_back(std::move(l));
+        else ++omitted_;
+    }
+    ++stats_.slices;
+    stats_.events           += events.size();
+    stats_.lines            += lines.size();
+    stats_.passages_indexed += indexed;
+    stats_.busy_yields      += yields;
+    stats_.work_ms          += work_ms;
+    stats_.max_batch_ms      = std::max(stats_.max_batch_ms, max_batch_ms);
+    return indexed;
+}
+
+} // namespace prometheus
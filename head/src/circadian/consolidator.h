@@ -0,0 +1,106 @@
+#pragma once
+
+#include "memory/event_log.h"
+#include "memory/memory.h"
+#include "sched/scheduler.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace prometheus {
+
+// Incremental consolidation during the Awake phase.
+// Every slice, a scheduled task reads the events logged since the
+// last slice, compacts repeated reflexes/actions into runs, appends a
+// digest line and indexes the result into long-term memory in small
+// batches. The Sleep phase then only has the last slice left to do.
+//
+// Work is bounded two ways: each batch is sized to fit `batch_budget`,
+// and after a batch the task idles long enough to keep its duty cycle
+// under `max_duty`. A batch does not start while the busy probe (the
+// Lizard handling a threat) reports true.
+class Consolidator {
+public:
+    // Slices read up to this long ago. A record is stamped before it
+    // reaches its producer ring; one pushed after a slice's query must
+    // still be ahead of the cursor.
+    static constexpr std::chrono::milliseconds kSettle{100};
+
+    struct Config {
+        std::chrono::seconds      slice{30};
+        std::chrono::milliseconds batch_budget{20};
+        double                    max_duty      = 0.25;
+        size_t                    batch_lines   = 64;     // upper bound per batch
+        size_t                    max_day_lines = 4000;   // kept for the Teacher
+        std::chrono::milliseconds max_yield{500};          // then run anyway
+    };
+
+    struct Stats {
+        uint64_t slices{0};
+        uint64_t events{0};             // read from the event log
+        uint64_t lines{0};              // after compaction
+        uint64_t passages_indexed{0};
+        uint64_t busy_yields{0};        // batches delayed by the busy probe
+        double   work_ms{0};
+        double   max_batch_ms{0};
+    };
+
+    Consolidator(EventLog& log, Memory& mem);
+    Consolidator(EventLog& log, Memory& mem, Config cfg);
+
+    Consolidator(const Consolidator&)            = delete;
+    Consolidator& operator=(const Consolidator&) = delete;
+
+    // Returns true while consolidation should hold off.
+    void set_busy_probe(std::function<bool()> busy);
+
+    // Run a slice every cfg.slice on `sched`.
+    void start(Scheduler& sched);
+
+    // Start a new day: clears the day log. Events not yet consolidated —
+    // those since the last finalize() — belong to the new day.
+    void begin_day();
+
+    // Consolidate everything up to kSettle ago without throttling.
+    // Returns the number of passages indexed.
+    size_t catch_up();
+
+    // catch_up() and persist the index — the whole of the Sleep phase's
+    // consolidation work.
+    size_t finalize();
+
+    // The compacted day so far, one line per run plus digests.
+    std::string day_log() const;
+
+    Stats stats() const;
+
+private:
+    size_t run_slice(bool throttled);
+    bool   wait_while_busy();
+
+    EventLog& log_;
+    Memory&   memory_;
+    Config    cfg_;
+    std::function<bool()> busy_;
+
+    std::mutex work_mu_;                // one slice at a time
+    std::atomic<bool> hurry_{false};    // a caller is waiting on work_mu_
+    uint64_t cursor_us_;                // events before this are consolidated
+    size_t   batch_size_;
+
+    mutable std::mutex day_mu_;
+    std::vector<std::string> day_lines_;
+    uint64_t omitted_{0};               // lines past max_day_lines
+    Stats    stats_;
+
+    std::mutex              wake_mu_;      // duty-cycle idling
+    std::condition_variable wake_cv_;
+};
+
+} // namespace prometheus
@@ -0,0 +1,72 @@
+#include "diag/alloc_counter.h"
+
+#if PROMETHEUS_ALLOC_COUNTER
+#include <cstdlib>
+#include <new>
+
+namespace {
+// Constant-initialised, so it is safe to touch from the very first
+// allocation of any thread.
+thread_local uint64_t t_allocations = 0;
+
+void* counted(std::size_t n) {
+    ++t_allocations;
+    return std::malloc(n ? n : 1);
+}
+
+void* counted_aligned(std::size_t n, std::align_val_t al) {
+    ++t_allocations;
+    auto a = static_cast<std::size_t>(al);
+    return std::aligned_alloc(a, (n + a - 1) / a * a);
+}
+} // namespace
+
+// ── Replacement operator new/delete ─────────────────────────────
+void* operator new(std::size_t n) {
+    if (void* p = counted(n)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t n) {
+    if (void* p = counted(n)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept { return counted(n); }
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept { return counted(n); }
+void* operator new(std::size_t n, std::align_val_t al) {
+    if (void* p = counted_aligned(n, al)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t n, std::align_val_t al) {
+    if (void* p = counted_aligned(n, al)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+#endif
+
+namespace prometheus {
+
+bool AllocCounter::enabled() {
+#if PROMETHEUS_ALLOC_COUNTER
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint64_t AllocCounter::thread_allocations() {
+#if PROMETHEUS_ALLOC_COUNTER
+    return t_allocations;
+#else
+    return 0;
+#endif
+}
+
+} // namespace prometheus
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+namespace prometheus {
+
+// Heap allocation counter for debug builds.
+//
+// With PROMETHEUS_ALLOC_COUNTER (on by default outside Release builds)
+// alloc_counter.cpp replaces the global operator new/delete with versions
+// that count calls per thread. The replacement is linked only into
+// binaries that call into this header, so prometheus_head never pays for
+// it; prometheus_bench uses it to check that the percept → reflex →
+// dispatch path does not allocate once warm.
+//
+//     AllocScope scope;
+//     run_tick();
+//     if (scope.count()) ...   // run_tick() allocated
+struct AllocCounter {
+    // False when the build leaves operator new alone (counts stay 0).
+    static bool enabled();
+
+    // operator new calls made by the calling thread so far.
+    static uint64_t thread_allocations();
+};
+
+// Allocations by this thread since construction.
+class AllocScope {
+public:
+    AllocScope() : start_(AllocCounter::thread_allocations()) {}
+    uint64_t count() const { return AllocCounter::thread_allocations() - start_; }
+
+private:
+    uint64_t start_;
+};
+
+} // namespace prometheus
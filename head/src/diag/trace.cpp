@@ -0,0 +1,196 @@
+#include "diag/trace.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace prometheus {
+
+namespace {
+
+// ── Per-thread rings ────────────────────────────────────────────
+// Written only by the owning thread. The exporter copies a ring while it
+// may still be written: slots are relaxed atomics, and anything the
+// writer could have lapped during the copy is dropped.
+struct Ring {
+    struct Span {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t>    begin{0}, end{0}, flow{0};
+    };
+
+    std::array<Span, Trace::kRingSpans> spans;
+    std::atomic<uint64_t>               head{0};    // spans ever written
+    std::atomic<const char*>            name{nullptr};
+    long                                tid{0};
+};
+
+struct Registry {
+    std::mutex                         mu;
+    std::vector<std::unique_ptr<Ring>> rings;      // never freed: a ring outlives its thread
+    std::atomic<uint64_t>              session_ns{0};
+    std::atomic<uint64_t>              untraced{0};    // spans from threads past kMaxThreads
+};
+
+Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+thread_local const char* t_name = nullptr;
+thread_local Ring*       t_ring = nullptr;
+thread_local bool        t_full = false;        // registry was full when this thread asked
+
+Ring* this_ring() {
+    if (t_ring || t_full) return t_ring;
+    auto& reg = registry();
+    std::lock_guard lock(reg.mu);
+    if (reg.rings.size() >= Trace::kMaxThreads) {
+        t_full = true;
+        return nullptr;
+    }
+    auto ring = std::make_unique<Ring>();
+    ring->tid = static_cast<long>(::syscall(SYS_gettid));
+    ring->name.store(t_name, std::memory_order_relaxed);
+    t_ring = reg.rings.emplace_back(std::move(ring)).get();
+    return t_ring;
+}
+
+struct Copied {
+    const char* name;
+    uint64_t    begin, end, flow;
+    long        tid;
+};
+
+} // namespace
+
+void Trace::start() {
+    registry().session_ns.store(now_ns(), std::memory_order_relaxed);
+    enabled_.store(true, std::memory_order_release);
+    std::cout << "[TRACE] Tracing on.\n";
+}
+
+void Trace::name_thread(const char* name) {
+    t_name = name;
+    if (t_ring) t_ring->name.store(name, std::memory_order_relaxed);
+    // Also the OS name (top -H, /proc, the reflex watchdog). Not for the
+    // main thread, whose name is the process's.
+    if (::syscall(SYS_gettid) != ::getpid()) {
+        char os_name[16];
+        std::snprintf(os_name, sizeof os_name, "%s", name);
+        pthread_setname_np(pthread_self(), os_name);
+    }
+}
+
+void Trace::record(const char* name, uint64_t begin_ns, uint64_t end_ns, uint64_t flow) {
+    if (!enabled()) return;
+    Ring* ring = this_ring();
+    if (!ring) {
+        registry().untraced.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const uint64_t i = ring->head.load(std::memory_order_relaxed);
+    auto& s = ring->spans[i % kRingSpans];
+    s.name.store(name, std::memory_order_relaxed);
+    s.begin.store(begin_ns, std::memory_order_relaxed);
+    s.end.store(end_ns, std::memory_order_relaxed);
+    s.flow.store(flow, std::memory_order_relaxed);
+    ring->head.store(i + 1, std::memory_order_release);
+}
+
+bool Trace::stop_and_write(const std::string& path) {
+    enabled_.store(false, std::memory_order_release);
+    auto& reg = registry();
+    const uint64_t session = reg.session_ns.load(std::memory_order_relaxed);
+
+    // ── Copy the rings ──────────────────────────────────────────
+    std::vector<Copied> spans;
+    std::vector<std::pair<long, const char*>> threads;
+    {
+        std::lock_guard lock(reg.mu);
+        for (auto& r : reg.rings) {
+            const uint64_t head = r->head.load(std::memory_order_acquire);
+            const uint64_t from = head > kRingSpans ? head - kRingSpans : 0;
+            const size_t   mark = spans.size();
+            for (uint64_t i = from; i < head; ++i) {
+                auto& s = r->spans[i % kRingSpans];
+                spans.push_back({s.name.load(std::memory_order_relaxed),
+                                 s.begin.load(std::memory_order_relaxed),
+                                 s.end.load(std::memory_order_relaxed),
+                                 s.flow.load(std::memory_order_relaxed), r->tid});
+            }
+            // A span that ended after stop may have lapped the oldest slots.
+            const uint64_t after = r->head.load(std::memory_order_acquire);
+            const uint64_t lapped = after > from + kRingSpans ? after - from - kRingSpans : 0;
+            spans.erase(spans.begin() + static_cast<std::ptrdiff_t>(mark),
+                        spans.begin() + static_cast<std::ptrdiff_t>(
+                            mark + std::min<uint64_t>(lapped, spans.size() - mark)));
+            threads.emplace_back(r->tid, r->name.load(std::memory_order_relaxed));
+        }
+    }
+    // Spans that began before the session (a long phase) are clipped to it.
+    std::erase_if(spans, [&](const Copied& c) { return !c.name || c.end < session; });
+    for (auto& s : spans) s.begin = std::max(s.begin, session);
+    std::sort(spans.begin(), spans.end(),
+              [](const Copied& a, const Copied& b) { return a.begin < b.begin; });
+
+    // ── Chrome trace-event JSON ─────────────────────────────────
+    // Timestamps are microseconds with nanosecond decimals, relative to
+    // the session start.
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) {
+        std::cerr << "[TRACE] Cannot write " << path << "\n";
+        return false;
+    }
+    const int pid = static_cast<int>(::getpid());
+    auto us = [&](uint64_t ns) { return static_cast<double>(ns - session) / 1000.0; };
+
+    std::fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    std::fprintf(f, "{\"ph\":\"M\",\"pid\":%d,\"name\":\"process_name\",\"args\":{\"name\":\"prometheus_head\"}}", pid);
+    for (auto& [tid, name] : threads) {
+        std::fprintf(f, ",\n{\"ph\":\"M\",\"pid\":%d,\"tid\":%ld,\"name\":\"thread_name\",\"args\":{\"name\":\"%s\"}}",
+                     pid, tid, name ? name : "thread");
+    }
+    std::map<uint64_t, std::vector<const Copied*>> flows;
+    for (auto& s : spans) {
+        std::fprintf(f, ",\n{\"ph\":\"X\",\"pid\":%d,\"tid\":%ld,\"name\":\"%s\",\"ts\":%.3f,\"dur\":%.3f",
+                     pid, s.tid, s.name, us(s.begin),
+                     static_cast<double>(s.end - s.begin) / 1000.0);
+        if (s.flow) {
+            std::fprintf(f, ",\"args\":{\"seq\":%llu}", static_cast<unsigned long long>(s.flow));
+            flows[s.flow].push_back(&s);
+        }
+        std::fprintf(f, "}");
+    }
+    // Flow arrows: start on the first span of each id, a step on each
+    // middle one, finish on the last. Each binds to the span it sits in.
+    for (auto& [id, chain] : flows) {
+        if (chain.size() < 2) continue;
+        for (size_t i = 0; i < chain.size(); ++i) {
+            const char* ph = i == 0 ? "s" : i + 1 == chain.size() ? "f" : "t";
+            std::fprintf(f, ",\n{\"ph\":\"%s\",\"pid\":%d,\"tid\":%ld,\"name\":\"percept\",\"cat\":\"flow\","
+                            "\"id\":%llu,\"ts\":%.3f%s}",
+                         ph, pid, chain[i]->tid, static_cast<unsigned long long>(id),
+                         us(chain[i]->begin), *ph == 'f' ? ",\"bp\":\"e\"" : "");
+        }
+    }
+    std::fprintf(f, "\n]}\n");
+    const bool ok = std::fclose(f) == 0;
+
+    std::cout << "[TRACE] Tracing off — " << spans.size() << " spans from "
+              << threads.size() << " threads, " << flows.size() << " flows written to "
+              << path;
+    if (auto n = reg.untraced.exchange(0)) std::cout << " (" << n << " spans on untraced threads)";
+    std::cout << ".\n";
+    return ok;
+}
+
+} // namespace prometheus
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace prometheus {
+
+// Span tracing for stalls: which thread was doing what, and for how long.
+//
+// Spans go into a per-thread ring (the last kRingSpans per thread, older
+// ones overwritten), timestamped in steady-clock nanoseconds. While
+// tracing is off a span costs one relaxed load. write() exports the
+// rings as Chrome trace-event JSON, which chrome://tracing and
+// ui.perfetto.dev both open.
+//
+//     TraceSpan span("react", percept.seq);
+//
+// Names must be string literals (they are stored as pointers and written
+// unescaped). Spans that share a non-zero flow id — the percept's seq on
+// the reflex path — are chained with flow arrows across threads, so one
+// percept can be followed through poll → react → submit → dispatch.
+class Trace {
+public:
+    static constexpr size_t kRingSpans  = 32768;    // per thread, ~1 MiB
+    static constexpr size_t kMaxThreads = 64;       // later threads are not traced
+
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // Begin a trace session; spans from before it are not exported.
+    static void start();
+
+    // End the session and write its spans to `path`. Returns false and
+    // logs if the file cannot be written.
+    static bool stop_and_write(const std::string& path);
+
+    // Label the calling thread in the trace (a literal, e.g. "lizard"), and
+    // name the OS thread after it (first 15 characters) unless it is main.
+    static void name_thread(const char* name);
+
+    // Record a span that was timed elsewhere, e.g. a whole circadian phase.
+    static void record(const char* name, uint64_t begin_ns, uint64_t end_ns, uint64_t flow = 0);
+
+    static uint64_t now_ns() { return ns(std::chrono::steady_clock::now()); }
+    static uint64_t ns(std::chrono::steady_clock::time_point t) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            t.time_since_epoch()).count());
+    }
+
+private:
+    static inline std::atomic<bool> enabled_{false};
+};
+
+// Times the enclosing scope while tracing is on.
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name, uint64_t flow = 0)
+        : name_(Trace::enabled() ? name : nullptr), flow_(flow),
+          t0_(name_ ? Trace::now_ns() : 0) {}
+    ~TraceSpan() { if (name_) Trace::record(name_, t0_, Trace::now_ns(), flow_); }
+
+    TraceSpan(const TraceSpan&)            = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    // Attach the flow once it is known (e.g. after the message is read).
+    void set_flow(uint64_t flow) { flow_ = flow; }
+
+private:
+    const char* name_;
+    uint64_t    flow_;
+    uint64_t    t0_;
+};
+
+} // namespace prometheus
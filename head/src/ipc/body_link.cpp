@@ -1,12 +1,17 @@
 #include "ipc/body_link.h"
+#include "diag/trace.h"
+#include "log/log.h"
+#include "metrics/metrics.h"
 
+#include <chrono>
 #include <iostream>
 #include <string>
 #include <regex>
+#include <string_view>
+#include <vector>
 
 #if HAS_ZMQ
 #include <zmq.h>
-#include <nlohmann/json.hpp>
 #endif
 
 namespace prometheus {
@@ -26,6 +31,33 @@ static std::string derive_push_endpoint(const std::string& sub_ep) {
     return sub_ep + "1";
 }
 
+// ---------------------------------------------------------------------------
+// Metrics
+// ---------------------------------------------------------------------------
+namespace {
+struct BodyMetrics {
+    static constexpr const char* kMessages = "head_body_messages_total";
+    static constexpr const char* kMessagesHelp = "Percept messages received, by how they applied.";
+    Counter& keyframes = metrics().counter(kMessages, kMessagesHelp, R"(kind="keyframe")");
+    Counter& deltas    = metrics().counter(kMessages, kMessagesHelp, R"(kind="delta")");
+    Counter& gaps      = metrics().counter(kMessages, kMessagesHelp, R"(kind="gap")");
+    Counter& dropped   = metrics().counter(kMessages, kMessagesHelp, R"(kind="dropped")");
+    Counter& errors    = metrics().counter("head_body_parse_errors_total",
+                                           "Percept messages that were unreadable or truncated.");
+    Counter& bytes     = metrics().counter("head_body_received_bytes_total",
+                                           "Percept message bytes received.");
+    Counter& resyncs   = metrics().counter("head_body_resyncs_total",
+                                           "Keyframe requests sent to the body after a gap.");
+    Counter& actions   = metrics().counter("head_body_actions_total",
+                                           "Actions sent to the body.");
+};
+
+BodyMetrics& body_metrics() {
+    static BodyMetrics m;
+    return m;
+}
+} // namespace
+
 // ---------------------------------------------------------------------------
 // Impl
 // ---------------------------------------------------------------------------
@@ -33,6 +65,10 @@ struct BodyLink::Impl {
     std::string sub_endpoint;
     std::string push_endpoint;
     bool        connected{false};
+
+    WorldState  world;
+    std::chrono::steady_clock::time_point last_resync{};
+    std::vector<char> rx = std::vector<char>(64 * 1024);   // one percept message
 #if HAS_ZMQ
     void* zmq_ctx  = nullptr;
     void* zmq_sub  = nullptr;
@@ -48,6 +84,7 @@ BodyLink::BodyLink(const std::string& sub_endpoint, const std::string& push_endp
 {
     impl_->sub_endpoint  = sub_endpoint;
     impl_->push_endpoint = push_endpoint;
+    body_metrics();         // register the series before the first scrape
 }
 
 BodyLink::BodyLink(const std::string& sub_endpoint)
@@ -104,62 +141,98 @@ void BodyLink::disconnect() {
 // poll_percept — non-blocking receive on SUB
 // ---------------------------------------------------------------------------
 std::optional<Percept> BodyLink::poll_percept() {
-    if (!impl_->connected) return std::nullopt;
+    Percept p;
+    if (!poll_percept(p)) return std::nullopt;
+    return p;
+}
 
-#if HAS_ZMQ
-    zmq_msg_t msg;
-    zmq_msg_init(&msg);
-    int rc = zmq_msg_recv(&msg, impl_->zmq_sub, ZMQ_DONTWAIT);
-    if (rc == -1) {
-        zmq_msg_close(&msg);
-        return std::nullopt;
-    }
+bool BodyLink::poll_percept(Percept& out) {
+    if (!impl_->connected) return false;
+    TraceSpan span("poll_percept");
 
-    std::string data(static_cast<char*>(zmq_msg_data(&msg)),
-                     zmq_msg_size(&msg));
-    zmq_msg_close(&msg);
-
-    // Parse JSON into Percept
-    try {
-        auto j = nlohmann::json::parse(data);
-
-        Percept p;
-        p.raw_json       = data;
-        p.health         = j.value("health", 20.0f);
-        p.hunger         = j.value("food", 20.0f);
-        p.hostile_nearby = false;
-
-        if (j.contains("nearby_entities") && j["nearby_entities"].is_array()) {
-            for (auto& ent : j["nearby_entities"]) {
-                if (ent.value("hostile", false)) {
-                    p.hostile_nearby = true;
-                    break;
-                }
+#if HAS_ZMQ
+    // Drain what has queued (bounded, so a flood cannot stall the
+    // lizard) and report only the newest state. Messages land in a
+    // fixed receive buffer; raw_json reuses the caller's capacity.
+    constexpr int  kMaxDrain = 64;
+    constexpr auto kResyncEvery = std::chrono::milliseconds(250);
+    auto& m = body_metrics();
+    bool changed = false;
+    for (int i = 0; i < kMaxDrain; ++i) {
+        int rc = zmq_recv(impl_->zmq_sub, impl_->rx.data(), impl_->rx.size(), ZMQ_DONTWAIT);
+        if (rc == -1) break;
+        m.bytes.inc(static_cast<uint64_t>(rc));
+        if (static_cast<size_t>(rc) > impl_->rx.size()) {
+            m.errors.inc();
+            PROMETHEUS_LOG_EVERY(1000, Warn, "[BODY] Percept message of {} bytes truncated; dropped.", rc);
+            continue;
+        }
+        std::string_view data(impl_->rx.data(), static_cast<size_t>(rc));
+
+        uint64_t expected = impl_->world.seq() + 1;
+        const auto applied = impl_->world.apply(data);
+        switch (applied) {
+        case WorldState::Applied::Keyframe:
+            m.keyframes.inc();
+            out.raw_json.assign(data);
+            changed = true;
+            break;
+        case WorldState::Applied::Delta:
+            m.deltas.inc();
+            out.raw_json.assign(data);
+            changed = true;
+            break;
+        case WorldState::Applied::Gap:
+            m.gaps.inc();
+            PROMETHEUS_LOG_EVERY(250, Warn, "[BODY] Percept gap (expected seq {}) — requesting keyframe.",
+                                 expected);
+            changed = false;
+            [[fallthrough]];
+        case WorldState::Applied::Dropped: {
+            if (applied == WorldState::Applied::Dropped) m.dropped.inc();
+            auto now = std::chrono::steady_clock::now();
+            if (now - impl_->last_resync >= kResyncEvery) {
+                impl_->last_resync = now;
+                m.resyncs.inc();
+                constexpr std::string_view kResync = R"({"action":"resync"})";
+                zmq_send(impl_->zmq_push, kResync.data(), kResync.size(), ZMQ_DONTWAIT);
             }
+            break;
+        }
+        case WorldState::Applied::Error:
+            m.errors.inc();
+            PROMETHEUS_LOG_EVERY(1000, Warn, "[BODY] Unreadable percept message ({} bytes).", data.size());
+            break;
         }
-
-        return p;
-    } catch (const nlohmann::json::exception& e) {
-        std::cerr << "[BODY] JSON parse error: " << e.what() << "\n";
-        return std::nullopt;
     }
+
+    if (!changed || !impl_->world.synced()) return false;
+    impl_->world.percept(out);
+    span.set_flow(out.seq);
+    return true;
 #else
-    return std::nullopt; // stub
+    (void)out;
+    return false; // stub
 #endif
 }
 
+WorldState::Stats BodyLink::stream_stats() const {
+    return impl_->world.stats();
+}
+
 // ---------------------------------------------------------------------------
 // send_action
 // ---------------------------------------------------------------------------
-void BodyLink::send_action(const std::string& action_json) {
+void BodyLink::send_action(std::string_view action_json) {
     if (!impl_->connected) return;
+    body_metrics().actions.inc();
 
 #if HAS_ZMQ
     zmq_send(impl_->zmq_push, action_json.data(),
              action_json.size(), ZMQ_DONTWAIT);
 #endif
 
-    std::cout << "[BODY] >> " << action_json << "\n";
+    PROMETHEUS_LOG(Debug, "[BODY] >> {}", action_json);
 }
 
 } // namespace prometheus
@@ -1,10 +1,12 @@
 #pragma once
 
+#include "ipc/world_state.h"
 #include "lizard/lizard.h"   // for Percept
 
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 
 namespace prometheus {
 
@@ -12,6 +14,10 @@ namespace prometheus {
 // Uses a PUB/SUB + PUSH/PULL pattern:
 //   SUB: receives a stream of symbolic percepts (JSON) on sub_endpoint.
 //   PUSH: sends action commands (JSON) on push_endpoint.
+//
+// Percepts arrive as keyframes and deltas (see WorldState); the link
+// patches its world state with each one and asks the body for a keyframe
+// ({"action":"resync"}, at most every 250 ms) after a sequence gap.
 class BodyLink {
 public:
     // Two-endpoint constructor: explicit SUB and PUSH endpoints.
@@ -29,11 +35,20 @@ public:
     void connect();
     void disconnect();
 
-    // Non-blocking read of the latest percept. Returns nullopt if none ready.
+    // Non-blocking read of the latest percept. Applies every message
+    // queued since the last call and returns the resulting state, or
+    // nullopt if nothing new arrived or the state is waiting on a keyframe.
     std::optional<Percept> poll_percept();
 
+    // As above, refilling `out` in place; false if there is nothing new.
+    // The lizard loop uses this to keep one Percept's storage across ticks.
+    bool poll_percept(Percept& out);
+
+    // Keyframe/delta/gap counts for the percept stream.
+    WorldState::Stats stream_stats() const;
+
     // Send a JSON action string to the body.
-    void send_action(const std::string& action_json);
+    void send_action(std::string_view action_json);
 
 private:
     struct Impl;
@@ -0,0 +1,354 @@
+#include "ipc/world_state.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <functional>
+
+namespace prometheus {
+
+namespace {
+
+// ── In-place JSON scanner ───────────────────────────────────────
+// Walks one message without building a DOM or allocating: object() and
+// array() call back per member/element with the cursor on the value, and
+// the callback reads it (read()) or skips it. A value of the wrong type
+// is skipped, as nlohmann's value() would ignore it; malformed text sets
+// failed() and stops the walk.
+class Scanner {
+public:
+    explicit Scanner(std::string_view s) : s_(s) {}
+
+    bool failed() const { return failed_; }
+
+    template <typename F>
+    void object(F&& member) {
+        if (!enter('{')) return;
+        if (!eat('}')) {
+            do {
+                std::string_view key;
+                if (!raw_string(key) || !eat(':')) return fail();
+                member(key);
+            } while (!failed_ && eat(','));
+            if (!failed_ && !eat('}')) fail();
+        }
+        --depth_;
+    }
+
+    template <typename F>
+    void array(F&& element) {
+        if (!enter('[')) return;
+        if (!eat(']')) {
+            do element(); while (!failed_ && eat(','));
+            if (!failed_ && !eat(']')) fail();
+        }
+        --depth_;
+    }
+
+    char peek() {
+        while (pos_ < s_.size() && (s_[pos_] == ' ' || s_[pos_] == '\t' ||
+                                    s_[pos_] == '\n' || s_[pos_] == '\r')) ++pos_;
+        return pos_ < s_.size() ? s_[pos_] : '\0';
+    }
+
+    template <typename T>
+    void read(T& v) requires std::is_arithmetic_v<T> && (!std::is_same_v<T, bool>) {
+        double d = 0;
+        if (peek() == '-' || (peek() >= '0' && peek() <= '9')) {
+            if (number(d)) v = static_cast<T>(d);
+        } else {
+            skip();
+        }
+    }
+
+    void read(bool& v) {
+        if (literal("true")) v = true;
+        else if (literal("false")) v = false;
+        else skip();
+    }
+
+    // Unescaped strings are assigned straight from the message.
+    void read(std::string& v) {
+        if (peek() != '"') return skip();
+        std::string_view raw;
+        if (!raw_string(raw)) return;
+        if (raw.find('\\') == std::string_view::npos) {
+            v.assign(raw);
+        } else {
+            unescape(raw, v);
+        }
+    }
+
+    // The string's text as it appears in the message (escapes intact).
+    bool raw_string(std::string_view& out) {
+        if (!eat('"')) return fail(), false;
+        size_t start = pos_;
+        while (pos_ < s_.size() && s_[pos_] != '"') pos_ += s_[pos_] == '\\' ? 2 : 1;
+        if (pos_ >= s_.size()) return fail(), false;
+        out = s_.substr(start, pos_ - start);
+        ++pos_;
+        return true;
+    }
+
+    void skip() {
+        switch (peek()) {
+        case '{': object([&](std::string_view) { skip(); }); break;
+        case '[': array([&] { skip(); }); break;
+        case '"': { std::string_view s; raw_string(s); break; }
+        case 't': if (!literal("true"))  fail(); break;
+        case 'f': if (!literal("false")) fail(); break;
+        case 'n': if (!literal("null"))  fail(); break;
+        default:  { double d; number(d); }
+        }
+    }
+
+private:
+    static constexpr int kMaxDepth = 16;
+
+    void fail() { failed_ = true; }
+
+    bool eat(char c) {
+        if (peek() != c) return false;
+        ++pos_;
+        return true;
+    }
+
+    bool enter(char c) {
+        if (++depth_ > kMaxDepth || !eat(c)) {
+            --depth_;
+            fail();
+            return false;
+        }
+        return true;
+    }
+
+    bool literal(std::string_view word) {
+        peek();
+        if (s_.substr(pos_, word.size()) != word) return false;
+        pos_ += word.size();
+        return true;
+    }
+
+    bool number(double& v) {
+        peek();
+        size_t end = pos_;
+        while (end < s_.size() && (std::isdigit(static_cast<unsigned char>(s_[end])) ||
+                                   s_[end] == '-' || s_[end] == '+' || s_[end] == '.' ||
+                                   s_[end] == 'e' || s_[end] == 'E')) ++end;
+        auto [ptr, ec] = std::from_chars(s_.data() + pos_, s_.data() + end, v);
+        if (ec != std::errc{} || ptr == s_.data() + pos_) return fail(), false;
+        pos_ = static_cast<size_t>(ptr - s_.data());
+        return true;
+    }
+
+    static void unescape(std::string_view raw, std::string& out) {
+        out.clear();
+        for (size_t i = 0; i < raw.size(); ++i) {
+            if (raw[i] != '\\' || i + 1 >= raw.size()) {
+                out += raw[i];
+                continue;
+            }
+            switch (char c = raw[++i]) {
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                unsigned cp = 0;
+                if (i + 4 < raw.size()) std::from_chars(raw.data() + i + 1, raw.data() + i + 5, cp, 16);
+                i += 4;
+                // BMP only; names and biomes are ASCII in practice.
+                if (cp < 0x80) {
+                    out += static_cast<char>(cp);
+                } else if (cp < 0x800) {
+                    out += static_cast<char>(0xC0 | (cp >> 6));
+                    out += static_cast<char>(0x80 | (cp & 0x3F));
+                } else {
+                    out += static_cast<char>(0xE0 | (cp >> 12));
+                    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                    out += static_cast<char>(0x80 | (cp & 0x3F));
+                }
+                break;
+            }
+            default: out += c;      // \" \\ \/
+            }
+        }
+    }
+
+    std::string_view s_;
+    size_t           pos_{0};
+    int              depth_{0};
+    bool             failed_{false};
+};
+
+} // namespace
+
+WorldState::WorldState() {
+    entities_.reserve(16);      // the body sends at most 10
+    spare_names_.reserve(16);
+}
+
+WorldState::Applied WorldState::apply(std::string_view msg) {
+    stats_.bytes += msg.size();
+
+    // ── Header pass: type and seq, and validate the whole message ──
+    // Keys may come in any order, and a message that fails to parse
+    // must not leave the state half-patched.
+    std::string_view type;
+    uint64_t         seq = 0;
+    {
+        Scanner in(msg);
+        if (in.peek() != '{') {
+            ++stats_.errors;
+            return Applied::Error;
+        }
+        in.object([&](std::string_view key) {
+            if (key == "type" && in.peek() == '"') in.raw_string(type);
+            else if (key == "seq") in.read(seq);
+            else in.skip();
+        });
+        if (in.failed()) {
+            ++stats_.errors;
+            return Applied::Error;
+        }
+    }
+
+    // ── Sequencing ──────────────────────────────────────────────
+    const bool is_delta = type == "delta";
+    if (is_delta) {
+        if (!synced_) {
+            ++stats_.dropped;
+            return Applied::Dropped;
+        }
+        if (seq != seq_ + 1) {
+            synced_ = false;
+            ++stats_.gaps;
+            return Applied::Gap;
+        }
+        seq_ = seq;
+    } else if (type == "keyframe" || type == "percept") {
+        health_ = food_ = 20.0f;
+        x_ = y_ = z_ = 0.0f;
+        biome_.clear();
+        live_   = 0;
+        seq_    = seq;
+        synced_ = true;
+    } else {
+        ++stats_.errors;
+        return Applied::Error;
+    }
+
+    // ── Patch ───────────────────────────────────────────────────
+    // A keyframe is a delta against the empty state.
+    const auto live_end = [&] { return entities_.begin() + static_cast<std::ptrdiff_t>(live_); };
+    auto upsert = [&](std::string_view id) -> NearbyEntity& {
+        auto it = std::find_if(entities_.begin(), live_end(),
+                               [&](const Entity& x) { return x.id == id; });
+        if (it != live_end()) return it->e;
+        if (live_ == entities_.size()) entities_.emplace_back();
+        auto& added = entities_[live_++];
+        added.id.assign(id);
+        added.e.name.clear();
+        added.e.distance = 0;
+        added.e.hostile  = false;
+        return added.e;
+    };
+    Scanner in(msg);
+    auto entity_fields = [&](NearbyEntity& e) {
+        in.object([&](std::string_view key) {
+            if (key == "name")          in.read(e.name);
+            else if (key == "distance") in.read(e.distance);
+            else if (key == "hostile")  in.read(e.hostile);
+            else in.skip();
+        });
+    };
+    in.object([&](std::string_view key) {
+        if (key == "health")     in.read(health_);
+        else if (key == "food")  in.read(food_);
+        else if (key == "biome") in.read(biome_);
+        else if (key == "position" && in.peek() == '{') {
+            in.object([&](std::string_view axis) {
+                if (axis == "x")      in.read(x_);
+                else if (axis == "y") in.read(y_);
+                else if (axis == "z") in.read(z_);
+                else in.skip();
+            });
+        } else if (key == "entities" && in.peek() == '{') {
+            in.object([&](std::string_view id) {
+                if (in.peek() == '{') entity_fields(upsert(id));
+                else in.skip();
+            });
+        } else if (key == "gone" && in.peek() == '[') {
+            in.array([&] {
+                std::string_view id;
+                if (in.peek() != '"') return in.skip();
+                in.raw_string(id);
+                auto it = std::find_if(entities_.begin(), live_end(),
+                                       [&](const Entity& x) { return x.id == id; });
+                if (it == live_end()) return;
+                std::rotate(it, it + 1, live_end());    // keeps its buffers for reuse
+                --live_;
+            });
+        } else if (key == "nearby_entities" && in.peek() == '[') {
+            // Legacy snapshot: entities as a list, nearest first.
+            int i = 0;
+            in.array([&] {
+                char id[16];
+                int  n = std::snprintf(id, sizeof id, "#%d", i++);
+                if (in.peek() == '{') entity_fields(upsert({id, static_cast<size_t>(n)}));
+                else in.skip();
+            });
+        } else {
+            in.skip();
+        }
+    });
+
+    if (is_delta) {
+        ++stats_.deltas;
+        return Applied::Delta;
+    }
+    ++stats_.keyframes;
+    return Applied::Keyframe;
+}
+
+void WorldState::percept(Percept& out) const {
+    out.health         = health_;
+    out.hunger         = food_;
+    out.x              = x_;
+    out.y              = y_;
+    out.z              = z_;
+    out.biome.assign(biome_);
+    out.hostile_nearby = false;
+    out.entity_sig     = 0;
+    // Entities leaving `out` give their name buffers to those joining.
+    for (size_t i = live_; i < out.entities.size(); ++i) {
+        if (spare_names_.size() == spare_names_.capacity()) break;
+        spare_names_.push_back(std::move(out.entities[i].name));
+    }
+    const size_t had = out.entities.size();
+    out.entities.resize(live_);
+    for (size_t i = had; i < live_ && !spare_names_.empty(); ++i) {
+        out.entities[i].name = std::move(spare_names_.back());
+        spare_names_.pop_back();
+    }
+    for (size_t i = 0; i < live_; ++i) {
+        const auto& e = entities_[i].e;
+        out.entities[i].name.assign(e.name);
+        out.entities[i].distance = e.distance;
+        out.entities[i].hostile  = e.hostile;
+        if (e.hostile) out.hostile_nearby = true;
+        // Sum of per-name hashes: insensitive to distance ordering.
+        out.entity_sig += std::hash<std::string>{}(e.name);
+    }
+    // Nearest first. Insertion sort: stable, in place, and n ≤ 10.
+    for (size_t i = 1; i < out.entities.size(); ++i) {
+        for (size_t j = i; j > 0 && out.entities[j].distance < out.entities[j - 1].distance; --j) {
+            std::swap(out.entities[j], out.entities[j - 1]);
+        }
+    }
+    out.entity_count = static_cast<int>(out.entities.size());
+    out.seq          = seq_;
+}
+
+} // namespace prometheus
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "lizard/lizard.h"   // for Percept
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace prometheus {
+
+// Head-side copy of the body's percept state, rebuilt from the percept
+// stream. The body sends a keyframe (the whole percept) every couple of
+// seconds and a delta every tick in between:
+//
+//   {"type":"keyframe","seq":41,"health":20,"food":18,"position":{...},
+//    "entities":{"812":{"name":"zombie","distance":7.5,"hostile":true}},
+//    "ground":"safe","biome":"plains"}
+//   {"type":"delta","seq":42,"position":{"x":10.3},
+//    "entities":{"812":{"distance":7.1}},"gone":["655"]}
+//
+// Deltas carry only changed fields; entities are keyed by the body's
+// entity id. A delta whose seq does not follow the last one applied is a
+// gap: the state is no longer trusted, deltas are discarded until the
+// next keyframe, and the caller should ask the body for one. Legacy
+// "percept" snapshots (no seq) are applied as standalone keyframes.
+//
+// Messages are read with a small in-place scanner rather than a JSON DOM,
+// and percept(out) refills the caller's Percept, so once the buffers are
+// warm a tick does not touch the heap — entities that leave hand their
+// string buffers to those that join, whatever the names' length.
+//
+// Not thread-safe; owned by BodyLink on the lizard thread.
+class WorldState {
+public:
+    enum class Applied {
+        Keyframe,
+        Delta,
+        Gap,        // out of sequence — now unsynced, request a keyframe
+        Dropped,    // delta while unsynced
+        Error,      // unparseable or unknown message
+    };
+
+    struct Stats {
+        uint64_t keyframes{0};
+        uint64_t deltas{0};
+        uint64_t gaps{0};
+        uint64_t dropped{0};
+        uint64_t errors{0};
+        uint64_t bytes{0};          // message bytes received
+    };
+
+    WorldState();
+
+    Applied apply(std::string_view msg);
+
+    bool     synced() const { return synced_; }
+    uint64_t seq() const { return seq_; }
+
+    // Materialise the current state into `out`, reusing its storage;
+    // entities nearest first. raw_json is left alone.
+    void percept(Percept& out) const;
+    Percept percept() const {
+        Percept p;
+        percept(p);
+        return p;
+    }
+
+    Stats stats() const { return stats_; }
+
+private:
+    struct Entity {
+        std::string  id;
+        NearbyEntity e;
+    };
+
+    bool     synced_{false};
+    uint64_t seq_{0};
+
+    float       health_{20.0f};
+    float       food_{20.0f};
+    float       x_{}, y_{}, z_{};
+    std::string biome_;
+    std::vector<Entity> entities_;  // ≤ 10 from the body; linear lookup
+    size_t              live_{0};   // entities_[0, live_) are present; the rest
+                                    // keep their buffers for reuse
+    mutable std::vector<std::string> spare_names_;   // see percept()
+
+    Stats stats_;
+};
+
+} // namespace prometheus
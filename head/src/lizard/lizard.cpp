@@ -1,25 +1,130 @@
 #include "lizard/lizard.h"
+#include "diag/trace.h"
+#include "log/log.h"
+#include "lizard/micro_model.h"
+#include "lizard/reflex_rules.h"
+#include "metrics/metrics.h"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <deque>
 #include <iostream>
+#include <mutex>
 #include <stdexcept>
+#include <unordered_set>
+#include <utility>
 
 // TODO: #include "llama.h" — uncomment once llama.cpp is linked
 // #include "llama.h"
 
 namespace prometheus {
 
+// ── Interned actions ────────────────────────────────────────────
+// A deque never moves its elements, so views stay valid as it grows.
+std::string_view intern_action(std::string_view json) {
+    static std::mutex                            mu;
+    static std::deque<std::string>               store;
+    static std::unordered_set<std::string_view>  index;
+    std::lock_guard lock(mu);
+    if (auto it = index.find(json); it != index.end()) return *it;
+    return *index.insert(store.emplace_back(json)).first;
+}
+
+// ── Metrics ─────────────────────────────────────────────────────
+// react() latency by the path that produced the reflex.
+namespace {
+struct ReactMetrics {
+    static constexpr const char* kName = "head_lizard_react_seconds";
+    static constexpr const char* kHelp = "Lizard::react latency, by the layer that decided.";
+    Histogram& critical = metrics().histogram(kName, kHelp, R"(path="critical_health")");
+    Histogram& hostile  = metrics().histogram(kName, kHelp, R"(path="hostile")");
+    Histogram& learned  = metrics().histogram(kName, kHelp, R"(path="learned")");
+    Histogram& hungry   = metrics().histogram(kName, kHelp, R"(path="hungry")");
+    Histogram& micro    = metrics().histogram(kName, kHelp, R"(path="micro_model")");
+    Histogram& llm      = metrics().histogram(kName, kHelp, R"(path="llm")");
+};
+
+ReactMetrics& react_metrics() {
+    static ReactMetrics m;
+    return m;
+}
+} // namespace
+
 // ── Pimpl ───────────────────────────────────────────────────────
 struct Lizard::Impl {
     // llama_model*   model   = nullptr;
     // llama_context* ctx     = nullptr;
     std::string model_path;
     bool        loaded{false};
+
+    std::atomic<std::shared_ptr<const RuleSet>> rules{std::make_shared<const RuleSet>()};
+    std::atomic<uint64_t> learned{0};
+
+    MicroModel               micro;
+    float                    min_confidence{1.0f};
+    std::vector<std::string_view> micro_actions;    // interned action JSON per class
+    float                    prev_health{20.0f};    // lizard thread only
+    Memory::MarkerId         near_death{0};         // [MEM:NEAR_DEATH], interned once
+    std::atomic<uint64_t>    micro_hits{0};
+    std::atomic<uint64_t>    llm_runs{0};
+
+    // Every kSampleEvery-th percept, in a ring of kSamples (~7 min at
+    // 20 Hz). Slots are overwritten in place and sized up front — the
+    // body's entity cap, names and biome up to kNameChars — so sampling
+    // never allocates. A slot's entities vector stays full size;
+    // sample_entities holds how many are in use.
+    static constexpr size_t kSampleEvery = 4;
+    static constexpr size_t kSamples     = 2048;
+    static constexpr size_t kMaxEntities = 10;
+    static constexpr size_t kNameChars   = 32;
+    mutable std::mutex   sample_mu;
+    std::vector<Percept> samples = [] {
+        std::vector<Percept> ring(kSamples);
+        for (auto& s : ring) {
+            s.entities.resize(kMaxEntities);
+            for (auto& e : s.entities) e.name.reserve(kNameChars);
+            s.biome.reserve(kNameChars);
+        }
+        return ring;
+    }();
+    std::vector<uint8_t> sample_entities = std::vector<uint8_t>(kSamples, 0);
+    size_t               sample_next{0};
+    size_t               sample_count{0};
+    uint64_t             seen{0};           // lizard thread only
+
+    void sample(const Percept& p) {
+        if (seen++ % kSampleEvery) return;
+        std::lock_guard lock(sample_mu);
+        Percept& s = samples[sample_next];
+        s.hostile_nearby = p.hostile_nearby;
+        s.health         = p.health;
+        s.hunger         = p.hunger;
+        s.x = p.x;
+        s.y = p.y;
+        s.z = p.z;
+        s.entity_count   = p.entity_count;
+        s.entity_sig     = p.entity_sig;
+        // Nearest first, so past the cap the farthest are left out.
+        const size_t n = std::min(p.entities.size(), kMaxEntities);
+        for (size_t i = 0; i < n; ++i) {
+            s.entities[i].name.assign(p.entities[i].name);
+            s.entities[i].distance = p.entities[i].distance;
+            s.entities[i].hostile  = p.entities[i].hostile;
+        }
+        sample_entities[sample_next] = static_cast<uint8_t>(n);
+        s.biome.assign(p.biome);
+        sample_next  = (sample_next + 1) % kSamples;
+        sample_count = std::min(sample_count + 1, kSamples);
+    }
 };
 
 Lizard::Lizard(Memory& mem)
     : impl_(std::make_unique<Impl>())
-    , memory_(mem) {}
+    , memory_(mem) {
+    react_metrics();        // register the series before the first scrape
+    impl_->near_death = memory_.marker_id("[MEM:NEAR_DEATH]");
+}
 
 Lizard::~Lizard() {
     // if (impl_->ctx)   llama_free(impl_->ctx);
@@ -45,11 +150,35 @@ void Lizard::load_model(const std::string& model_path) {
     std::cout << "[LIZARD] Model loaded (stub).\n";
 }
 
+bool Lizard::load_micro_model(const std::string& path, float min_confidence) {
+    std::string error;
+    if (!impl_->micro.load(path, &error)) {
+        std::cout << "[LIZARD] No micro-model at " << path << " (" << error
+                  << ") — Layer 1 uses the LLM path.\n";
+        return false;
+    }
+    impl_->min_confidence = min_confidence;
+    impl_->micro_actions.clear();
+    for (size_t c = 0; c < impl_->micro.classes(); ++c) {
+        impl_->micro_actions.push_back(intern_action(
+            R"({"action":")" + impl_->micro.class_name(static_cast<int>(c)) + R"(","reason":"micro_model"})"));
+    }
+    std::cout << "[LIZARD] Micro-model loaded: " << impl_->micro.trees() << " trees, "
+              << impl_->micro.classes() << " actions, " << impl_->micro.bytes() / 1024
+              << " KiB (confidence gate " << min_confidence << ").\n";
+    return true;
+}
+
 Reflex Lizard::react(const Percept& percept) {
-    auto t0 = std::chrono::steady_clock::now();
+    TraceSpan span("react", percept.seq);
+    auto& m = react_metrics();
+    ScopedTimer timer(&m.llm);      // retargeted by each early return
 
     Reflex reflex{};
-    reflex.layer = Reflex::Layer::Tactic;
+    reflex.layer       = Reflex::Layer::Tactic;
+    reflex.percept_seq = percept.seq;
+    impl_->sample(percept);
+    const float prev_health = std::exchange(impl_->prev_health, percept.health);
 
     // ── Layer 0: hard-coded survival reflexes (no LLM needed) ──
     if (percept.health < 4.0f) {
@@ -57,7 +186,8 @@ Reflex Lizard::react(const Percept& percept) {
         reflex.action_json = R"({"action":"flee","reason":"critical_health"})";
         reflex.urgency     = 1.0f;
         reflex.vetoes_soul = true;
-        memory_.tag("[MEM:NEAR_DEATH]");
+        memory_.tag(impl_->near_death);   // every tick while critical
+        timer.retarget(&m.critical);
         return reflex;
     }
 
@@ -66,16 +196,47 @@ Reflex Lizard::react(const Percept& percept) {
         reflex.action_json = R"({"action":"flee","reason":"hostile_nearby"})";
         reflex.urgency     = 0.9f;
         reflex.vetoes_soul = true;
+        timer.retarget(&m.hostile);
+        return reflex;
+    }
+
+    // ── Learned rules: compiled Teacher lessons ─────────────────
+    auto rules = impl_->rules.load(std::memory_order_acquire);
+    if (const ReflexRule* rule = rules->match(percept)) {
+        reflex.layer       = rule->layer;
+        reflex.action_json = rule->action_json;
+        reflex.urgency     = rule->urgency;
+        reflex.vetoes_soul = rule->vetoes_soul;
+        reflex.learned     = true;
+        impl_->learned.fetch_add(1, std::memory_order_relaxed);
+        timer.retarget(&m.learned);
         return reflex;
     }
 
     if (percept.hunger < 6.0f) {
         reflex.action_json = R"({"action":"eat","reason":"hungry"})";
         reflex.urgency     = 0.5f;
+        timer.retarget(&m.hungry);
         return reflex;
     }
 
+    // ── Layer 1: distilled micro-model ──────────────────────────
+    if (impl_->micro.loaded()) {
+        float x[MicroModel::kFeatures];
+        MicroModel::features(percept, prev_health, x);
+        auto pred = impl_->micro.predict(x);
+        if (pred.confidence >= impl_->min_confidence) {
+            reflex.action_json = impl_->micro_actions[static_cast<size_t>(pred.cls)];
+            reflex.urgency     = 0.3f;
+            impl_->micro_hits.fetch_add(1, std::memory_order_relaxed);
+            timer.retarget(&m.micro);
+            return reflex;
+        }
+    }
+
     // ── Layer 1: LLM-assisted tactical decision (stubbed) ──────
+    // Only when the micro-model is absent or unsure.
+    impl_->llm_runs.fetch_add(1, std::memory_order_relaxed);
     // Build prompt from percept.raw_json + recent memory markers,
     // tokenise, run inference, parse JSON action.
     //
@@ -86,13 +247,38 @@ Reflex Lizard::react(const Percept& percept) {
     reflex.action_json = R"({"action":"idle","reason":"no_threat"})";
     reflex.urgency     = 0.0f;
 
-    auto dt = std::chrono::steady_clock::now() - t0;
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(dt).count();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(timer.elapsed()).count();
     if (ms > 100) {
-        std::cerr << "[LIZARD] WARNING: react() took " << ms << " ms (target <100)\n";
+        PROMETHEUS_LOG_EVERY(1000, Warn, "[LIZARD] WARNING: react() took {} ms (target <100)", ms);
     }
 
     return reflex;
 }
 
+void Lizard::install_rules(std::shared_ptr<const RuleSet> rules) {
+    if (!rules) rules = std::make_shared<const RuleSet>();
+    impl_->rules.store(std::move(rules), std::memory_order_release);
+}
+
+std::shared_ptr<const RuleSet> Lizard::rules() const {
+    return impl_->rules.load(std::memory_order_acquire);
+}
+
+std::vector<Percept> Lizard::recent_percepts() const {
+    std::lock_guard lock(impl_->sample_mu);
+    std::vector<Percept> out(impl_->samples.begin(),
+                             impl_->samples.begin() + static_cast<std::ptrdiff_t>(impl_->sample_count));
+    for (size_t i = 0; i < out.size(); ++i) out[i].entities.resize(impl_->sample_entities[i]);
+    return out;
+}
+
+Lizard::Layer1Stats Lizard::layer1_stats() const {
+    return {impl_->micro_hits.load(std::memory_order_relaxed),
+            impl_->llm_runs.load(std::memory_order_relaxed)};
+}
+
+uint64_t Lizard::learned_reflexes() const {
+    return impl_->learned.load(std::memory_order_relaxed);
+}
+
 } // namespace prometheus
@@ -2,18 +2,36 @@
 
 #include "memory/memory.h"
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace prometheus {
 
+class RuleSet;
+
+// One entity near the body, as reported in the percept.
+struct NearbyEntity {
+    std::string name;
+    float       distance{};         // blocks
+    bool        hostile{};
+};
+
 // A symbolic percept streamed from the mineflayer body (JSON-decoded).
 struct Percept {
-    std::string raw_json;           // full JSON blob
+    std::string raw_json;           // last body message it was rebuilt from
     bool        hostile_nearby{};   // quick-check flag
     float       health{20.0f};
     float       hunger{20.0f};
+    float       x{}, y{}, z{};      // position (blocks)
+    int         entity_count{};     // nearby entities (capped by the body)
+    uint64_t    entity_sig{};       // order-independent hash of entity names
+    std::vector<NearbyEntity> entities;   // nearest first
+    std::string biome;              // biome at the body's feet, if reported
+    uint64_t    seq{};              // stream seq of raw_json (0: legacy snapshot)
 };
 
 // A reflex command produced by the Lizard.
@@ -23,12 +41,20 @@ struct Reflex {
         Tactic = 1,   // Layer 1 — pathfind / eat
     };
 
-    Layer       layer;
-    std::string action_json;        // serialised intent for the body
+    Layer            layer;
+    std::string_view action_json;   // serialised intent; a literal or intern_action()
     float       urgency{0.0f};      // 0.0 = low … 1.0 = critical
     bool        vetoes_soul{};      // true → override any Soul plan
+    bool        learned{};          // fired by a rule compiled from a lesson
+    uint64_t    percept_seq{};      // Percept::seq it reacted to (trace flow)
 };
 
+// Pre-serialised action payloads live for the whole process so reflexes
+// can carry a view instead of a fresh string per tick. Returns the stored
+// copy of `json`, adding it on first use. Thread-safe; call it when rules
+// or models are built, not per percept.
+std::string_view intern_action(std::string_view json);
+
 // System 1 — The Lizard Brain
 // Wraps an embedded Phi-3.5-mini via libllama for < 100 ms reflexes.
 class Lizard {
@@ -42,9 +68,35 @@ public:
     // Load the Phi-3.5 GGUF into VRAM/RAM.
     void load_model(const std::string& model_path = "models/phi-3.5-mini.gguf");
 
+    // Load the distilled Layer 1 micro-model (see MicroModel). While it
+    // is loaded, Layer 1 acts on its prediction when the confidence is at
+    // least `min_confidence`, and runs the LLM only otherwise.
+    bool load_micro_model(const std::string& path, float min_confidence);
+
     // Produce a reflex from a symbolic percept.
     Reflex react(const Percept& percept);
 
+    // Layer 1 decisions by who made them.
+    struct Layer1Stats {
+        uint64_t model{0};      // micro-model was confident
+        uint64_t llm{0};        // fell through to the LLM path
+    };
+    Layer1Stats layer1_stats() const;
+
+    // ── Learned rules ───────────────────────────────────────────
+    // Rules compiled from Teacher lessons run in react() after the
+    // built-in survival reflexes and before Layer 1. Installing swaps one
+    // pointer; a react() in progress finishes on the old set.
+    void install_rules(std::shared_ptr<const RuleSet> rules);
+    std::shared_ptr<const RuleSet> rules() const;
+
+    // A sample of recent percepts (raw JSON dropped), for replaying
+    // candidate rules before they are installed.
+    std::vector<Percept> recent_percepts() const;
+
+    // Reflexes fired by learned rules so far.
+    uint64_t learned_reflexes() const;
+
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
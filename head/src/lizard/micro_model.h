@@ -0,0 +1,163 @@
+#pragma once
+
+#include "lizard/lizard.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace prometheus {
+
+// Layer 1 micro-model: a boosted ensemble of oblivious trees distilled
+// from logged decisions by scripts/train_micro_model.py.
+//
+// Every node at one depth of an oblivious tree shares a split, so a tree
+// is `depth` branch-free comparisons that build a leaf index, and the
+// model is a few flat arrays — 48 depth-4 trees over four actions is
+// about 13 KB and stays cache-resident. Evaluation is a few hundred
+// nanoseconds; the per-class leaf accumulation is a contiguous loop the
+// compiler vectorises.
+//
+// .pmm layout (little-endian):
+//   "PMM1" | u16 features | u16 classes | u16 trees | u8 depth | u8 0
+//   f32 base[classes] | char names[classes][16]
+//   u8 feature[trees][depth] | f32 threshold[trees][depth]
+//   f32 leaf[trees][1 << depth][classes]
+class MicroModel {
+public:
+    // Feature layout; train_micro_model.py's FEATURES must match.
+    enum Feature : uint8_t {
+        Health, Food, Y, Hostile, EntityCount, NearestHostile, Nearest, HealthDelta,
+        kFeatures,
+    };
+    static constexpr float  kFar        = 32.0f;   // nothing within the body's range
+    static constexpr size_t kMaxClasses = 16;
+    static constexpr size_t kMaxDepth   = 8;
+
+    struct Prediction {
+        int   cls{-1};
+        float confidence{0.0f};     // softmax probability of `cls`
+    };
+
+    static void features(const Percept& p, float prev_health, float out[kFeatures]) {
+        float nearest = kFar, nearest_hostile = kFar;
+        for (auto& e : p.entities) {
+            nearest = std::min(nearest, e.distance);
+            if (e.hostile) nearest_hostile = std::min(nearest_hostile, e.distance);
+        }
+        out[Health]         = p.health;
+        out[Food]           = p.hunger;
+        out[Y]              = p.y;
+        out[Hostile]        = p.hostile_nearby ? 1.0f : 0.0f;
+        out[EntityCount]    = static_cast<float>(p.entity_count);
+        out[NearestHostile] = nearest_hostile;
+        out[Nearest]        = nearest;
+        out[HealthDelta]    = p.health - prev_health;
+    }
+
+    // Returns false (with `error` set) on a missing, truncated or
+    // mismatched file; the model stays unloaded.
+    bool load(const std::string& path, std::string* error = nullptr) {
+        auto fail = [&](const char* why) {
+            if (error) *error = why;
+            trees_ = 0;
+            return false;
+        };
+
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return fail("cannot open");
+        std::string buf((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+        size_t off = 0;
+        auto take = [&](void* dst, size_t n) {
+            if (off + n > buf.size()) return false;
+            std::memcpy(dst, buf.data() + off, n);
+            off += n;
+            return true;
+        };
+
+        char     magic[4];
+        uint16_t nfeat = 0, ncls = 0, ntrees = 0;
+        uint8_t  depth = 0, reserved = 0;
+        if (!take(magic, 4) || std::memcmp(magic, "PMM1", 4) != 0) return fail("bad magic");
+        if (!take(&nfeat, 2) || !take(&ncls, 2) || !take(&ntrees, 2) ||
+            !take(&depth, 1) || !take(&reserved, 1)) return fail("truncated header");
+        if (nfeat != kFeatures) return fail("feature count mismatch");
+        if (ncls == 0 || ncls > kMaxClasses) return fail("bad class count");
+        if (depth == 0 || depth > kMaxDepth) return fail("bad depth");
+
+        base_.resize(ncls);
+        names_.assign(ncls, {});
+        feat_.resize(size_t{ntrees} * depth);
+        thr_.resize(feat_.size());
+        leaf_.resize(size_t{ntrees} * (size_t{1} << depth) * ncls);
+
+        if (!take(base_.data(), base_.size() * sizeof(float))) return fail("truncated");
+        for (auto& name : names_) {
+            char raw[16];
+            if (!take(raw, sizeof raw)) return fail("truncated");
+            name.assign(raw, strnlen(raw, sizeof raw));
+        }
+        if (!take(feat_.data(), feat_.size()) ||
+            !take(thr_.data(), thr_.size() * sizeof(float)) ||
+            !take(leaf_.data(), leaf_.size() * sizeof(float))) return fail("truncated");
+        if (off != buf.size()) return fail("trailing bytes");
+        if (std::any_of(feat_.begin(), feat_.end(), [](uint8_t f) { return f >= kFeatures; })) {
+            return fail("feature index out of range");
+        }
+
+        classes_ = ncls;
+        depth_   = depth;
+        trees_   = ntrees;
+        return true;
+    }
+
+    bool loaded() const { return trees_ > 0; }
+
+    Prediction predict(const float x[kFeatures]) const {
+        float z[kMaxClasses];
+        std::copy(base_.begin(), base_.end(), z);
+
+        const uint8_t* f   = feat_.data();
+        const float*   thr = thr_.data();
+        const float*   lv  = leaf_.data();
+        const size_t   stride = (size_t{1} << depth_) * classes_;
+        for (uint32_t t = 0; t < trees_; ++t, f += depth_, thr += depth_, lv += stride) {
+            uint32_t idx = 0;
+            for (uint32_t d = 0; d < depth_; ++d) {
+                idx |= static_cast<uint32_t>(x[f[d]] > thr[d]) << d;
+            }
+            const float* leaf = lv + idx * classes_;
+            for (uint32_t c = 0; c < classes_; ++c) z[c] += leaf[c];
+        }
+
+        // Softmax probability of the argmax only.
+        uint32_t best = 0;
+        for (uint32_t c = 1; c < classes_; ++c) if (z[c] > z[best]) best = c;
+        float sum = 0.0f;
+        for (uint32_t c = 0; c < classes_; ++c) sum += std::exp(z[c] - z[best]);
+        return {static_cast<int>(best), 1.0f / sum};
+    }
+
+    const std::string& class_name(int cls) const { return names_[static_cast<size_t>(cls)]; }
+    size_t classes() const { return classes_; }
+    size_t trees()   const { return trees_; }
+    size_t bytes()   const {
+        return base_.size() * 4 + feat_.size() + thr_.size() * 4 + leaf_.size() * 4;
+    }
+
+private:
+    uint32_t trees_{0}, depth_{0}, classes_{0};
+    std::vector<float>       base_;
+    std::vector<std::string> names_;
+    std::vector<uint8_t>     feat_;
+    std::vector<float>       thr_;
+    std::vector<float>       leaf_;
+};
+
+} // namespace prometheus
@@ -0,0 +1,150 @@
+#include "lizard/novelty.h"
+#include "diag/trace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string_view>
+
+namespace prometheus {
+
+namespace {
+
+constexpr double kCountAlpha   = 0.01;    // ~10 s of percepts at 10 Hz
+constexpr size_t kMaxReasons   = 240;     // chars carried into the prompt
+
+void add_reason(std::string& reasons, std::string_view r) {
+    if (reasons.find(r) != std::string::npos) return;
+    if (reasons.size() + r.size() + 2 > kMaxReasons) return;
+    if (!reasons.empty()) reasons += "; ";
+    reasons += r;
+}
+
+// True (and refreshed) when `key` was seen within `window`.
+bool familiar(std::unordered_map<std::string, NoveltyDetector::Clock::time_point>& seen,
+              const std::string& key, NoveltyDetector::Clock::time_point now,
+              std::chrono::seconds window) {
+    auto [it, inserted] = seen.try_emplace(key, now);
+    bool known = !inserted && now - it->second <= window;
+    it->second = now;
+    return known;
+}
+
+} // namespace
+
+NoveltyDetector::NoveltyDetector() : NoveltyDetector(Config{}) {}
+
+NoveltyDetector::NoveltyDetector(Config cfg)
+    : cfg_(cfg), tokens_(cfg.burst) {
+    reasons_.reserve(kMaxReasons);
+}
+
+double NoveltyDetector::score(const Percept& p, Clock::time_point now, std::string& reasons) {
+    double s = 0;
+
+    // ── New entity types ────────────────────────────────────────
+    for (size_t i = 0; i < p.entities.size(); ++i) {
+        const auto& e = p.entities[i];
+        if (e.name.empty()) continue;
+        bool dup = std::any_of(p.entities.begin(), p.entities.begin() + static_cast<long>(i),
+                               [&](const NearbyEntity& o) { return o.name == e.name; });
+        if (dup || familiar(seen_entities_, e.name, now, cfg_.familiar)) continue;
+        if (!seeded_) continue;
+        s += e.hostile ? 1.0 : 0.5;
+        add_reason(reasons, (e.hostile ? "hostile " : "") + e.name + " appeared");
+    }
+
+    // ── New biome ───────────────────────────────────────────────
+    if (!p.biome.empty() && !familiar(seen_biomes_, p.biome, now, cfg_.familiar) && seeded_) {
+        s += 1.0;
+        add_reason(reasons, "entered " + p.biome);
+    }
+
+    // ── Sharp health drop ───────────────────────────────────────
+    auto pop_health = [&] {
+        health_head_ = (health_head_ + 1) % kHealthRing;
+        --health_size_;
+    };
+    while (health_size_ && now - health_[health_head_].first > cfg_.drop_window) pop_health();
+    if (health_size_ == kHealthRing) pop_health();
+    health_[(health_head_ + health_size_++) % kHealthRing] = {now, p.health};
+    float peak = 0;
+    for (size_t i = 0; i < health_size_; ++i) {
+        peak = std::max(peak, health_[(health_head_ + i) % kHealthRing].second);
+    }
+    float drop = peak - p.health;
+    if (drop >= cfg_.health_drop) {
+        s += drop / cfg_.health_drop;
+        char buf[64];
+        std::snprintf(buf, sizeof buf, "health fell %.0f in %.0f s", drop,
+                      std::chrono::duration<double>(now - health_[health_head_].first).count());
+        add_reason(reasons, buf);
+    }
+
+    // ── Entity count surge ──────────────────────────────────────
+    const double n = p.entity_count;
+    if (seeded_) {
+        double z = (n - count_mean_) / std::sqrt(count_var_ + 1.0);
+        if (z >= cfg_.surge_sigma) {
+            s += 0.5 * z / cfg_.surge_sigma;
+            char buf[64];
+            std::snprintf(buf, sizeof buf, "%d entities around (usually %.0f)", p.entity_count,
+                          count_mean_);
+            add_reason(reasons, buf);
+        }
+        double d = n - count_mean_;
+        count_mean_ += kCountAlpha * d;
+        count_var_   = (1 - kCountAlpha) * (count_var_ + kCountAlpha * d * d);
+    } else {
+        count_mean_ = n;
+    }
+
+    seeded_ = true;
+    return s;
+}
+
+std::optional<NoveltyDetector::Novelty> NoveltyDetector::observe(const Percept& p,
+                                                                 Clock::time_point now) {
+    TraceSpan span("novelty", p.seq);
+    ++stats_.percepts;
+    reasons_.clear();
+    double s = score(p, now, reasons_);
+    stats_.max_score = std::max(stats_.max_score, s);
+
+    // Hysteresis: one crossing per excursion above fire_at.
+    if (s >= cfg_.fire_at && armed_) {
+        armed_ = false;
+        if (!pending_) {
+            pending_       = true;
+            pending_since_ = now;
+            pending_score_ = 0;
+            pending_reasons_.clear();
+        }
+        pending_score_ = std::max(pending_score_, s);
+        add_reason(pending_reasons_, reasons_);
+    } else if (s < cfg_.rearm_below) {
+        armed_ = true;
+    }
+    if (!pending_) return std::nullopt;
+
+    // Rate limit: token bucket plus a minimum gap.
+    if (last_refill_ == Clock::time_point{}) last_refill_ = now;
+    double refill = std::chrono::duration<double>(now - last_refill_).count() /
+                    std::chrono::duration<double>(cfg_.refill).count();
+    tokens_      = std::min<double>(cfg_.burst, tokens_ + refill);
+    last_refill_ = now;
+    if (tokens_ < 1.0 || (fired_once_ && now - last_fire_ < cfg_.min_gap)) {
+        if (now == pending_since_) ++stats_.rate_limited;
+        return std::nullopt;
+    }
+
+    tokens_    -= 1.0;
+    last_fire_  = now;
+    fired_once_ = true;
+    pending_    = false;
+    ++stats_.fired;
+    stats_.total_lag_ms += std::chrono::duration<double, std::milli>(now - pending_since_).count();
+    return Novelty{pending_score_, std::move(pending_reasons_), pending_since_};
+}
+
+} // namespace prometheus
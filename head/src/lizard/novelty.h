@@ -0,0 +1,98 @@
+#pragma once
+
+#include "lizard/lizard.h"   // for Percept
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace prometheus {
+
+// Change detection for Soul escalation.
+// Runs on the lizard thread next to react() and scores each percept
+// against recent history:
+//   new entity type (not seen within `familiar`)   0.5, hostile 1.0
+//   new biome                                       1.0
+//   health drop of `health_drop` within `drop_window`  drop / health_drop
+//   entity count `surge_sigma` above its running mean  0.5 × z / surge_sigma
+//
+// A score at `fire_at` triggers an escalation. Hysteresis: after that the
+// detector stays quiet until the score falls below `rearm_below`.
+// Escalations are rate limited — at least `min_gap` apart and at most
+// `burst` back to back, refilled one per `refill`. Novelty that arrives
+// while limited is held and merged, then fires as soon as it may.
+class NoveltyDetector {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Config {
+        double fire_at     = 1.0;
+        double rearm_below = 0.4;
+        std::chrono::milliseconds min_gap{5000};
+        int                       burst = 3;
+        std::chrono::seconds      refill{20};
+        std::chrono::seconds      familiar{120};
+        float                     health_drop = 4.0f;
+        std::chrono::milliseconds drop_window{2000};
+        double                    surge_sigma = 3.0;
+    };
+
+    struct Novelty {
+        double            score;
+        std::string       reasons;      // "zombie appeared; health fell 6 in 2 s"
+        Clock::time_point since;        // first percept that scored
+    };
+
+    struct Stats {
+        uint64_t percepts{0};
+        uint64_t fired{0};
+        uint64_t rate_limited{0};       // novelties held back by the limiter
+        double   max_score{0};
+        double   total_lag_ms{0};       // since → fire, summed
+
+        double mean_lag_ms() const { return fired ? total_lag_ms / static_cast<double>(fired) : 0.0; }
+    };
+
+    NoveltyDetector();
+    explicit NoveltyDetector(Config cfg);
+
+    // Score one percept; returns a novelty when it is time to escalate.
+    std::optional<Novelty> observe(const Percept& p, Clock::time_point now);
+    std::optional<Novelty> observe(const Percept& p) { return observe(p, Clock::now()); }
+
+    Stats stats() const { return stats_; }
+
+private:
+    double score(const Percept& p, Clock::time_point now, std::string& reasons);
+
+    Config cfg_;
+    bool   seeded_{false};              // first percept only sets the baseline
+    bool   armed_{true};
+
+    std::unordered_map<std::string, Clock::time_point> seen_entities_;
+    std::unordered_map<std::string, Clock::time_point> seen_biomes_;
+    // Health over the last drop_window, as a fixed ring (no allocation
+    // per percept); past kHealthRing samples only the newest count.
+    static constexpr size_t kHealthRing = 256;
+    std::array<std::pair<Clock::time_point, float>, kHealthRing> health_{};
+    size_t health_head_{0}, health_size_{0};
+    double count_mean_{0}, count_var_{0};
+    std::string reasons_;               // this percept's; keeps its capacity
+
+    bool              pending_{false};
+    double            pending_score_{0};
+    std::string       pending_reasons_;
+    Clock::time_point pending_since_{};
+
+    double            tokens_;
+    Clock::time_point last_refill_{};
+    Clock::time_point last_fire_{};
+    bool              fired_once_{false};
+
+    Stats stats_;
+};
+
+} // namespace prometheus
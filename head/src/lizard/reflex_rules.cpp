@@ -0,0 +1,370 @@
+#include "lizard/reflex_rules.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+
+namespace prometheus {
+
+namespace {
+
+// ── Vocabulary ──────────────────────────────────────────────────
+
+// Mob names as mineflayer reports them.
+constexpr const char* kMobs[] = {
+    "zombie", "skeleton", "creeper", "spider", "cave_spider", "enderman",
+    "witch", "slime", "phantom", "drowned", "husk", "stray", "pillager",
+    "vindicator", "evoker", "ravager", "vex", "blaze", "ghast", "piglin",
+    "hoglin", "zombified_piglin", "magma_cube", "wither_skeleton",
+    "guardian", "silverfish", "endermite", "shulker", "warden",
+};
+
+constexpr const char* kGenericHostile[] = {
+    "hostile", "hostiles", "mob", "mobs", "monster", "monsters", "enemy", "enemies",
+};
+
+constexpr const char* kFleeWords[] = {"flee", "flees", "fleeing", "retreat", "retreating",
+                                      "escape", "avoid", "run"};
+constexpr const char* kEatWords[]  = {"eat", "eating", "eats"};
+constexpr const char* kNegations[] = {"not", "t", "never", "no", "dont"};
+constexpr const char* kUnits[]     = {"block", "blocks", "b", "m", "meter", "meters", "metres"};
+
+template <size_t N>
+bool in(const char* const (&words)[N], const std::string& w) {
+    return std::any_of(std::begin(words), std::end(words), [&](const char* x) { return w == x; });
+}
+
+// "creepers" → "creeper", "mobs" → "hostile"; empty when not a mob.
+std::string entity_of(const std::string& w) {
+    if (in(kGenericHostile, w)) return "hostile";
+    if (in(kMobs, w)) return w;
+    if (w == "endermen") return "enderman";
+    if (w.size() > 1 && w.back() == 's' && in(kMobs, w.substr(0, w.size() - 1))) {
+        return w.substr(0, w.size() - 1);
+    }
+    return {};
+}
+
+// Lower-case words and numbers; comparison operators become words
+// ("<=" → "le") so they survive the split.
+std::vector<std::string> tokenize(const std::string& text) {
+    std::string s;
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = static_cast<char>(std::tolower(static_cast<unsigned char>(text[i])));
+        bool eq = i + 1 < text.size() && text[i + 1] == '=';
+        if (c == '<' || c == '>') {
+            s += c == '<' ? (eq ? " le " : " lt ") : (eq ? " ge " : " gt ");
+            if (eq) ++i;
+        } else {
+            s += c;
+        }
+    }
+
+    std::vector<std::string> out;
+    std::string cur;
+    for (size_t i = 0; i < s.size(); ++i) {
+        char c = s[i];
+        bool decimal = c == '.' && !cur.empty() && std::isdigit(static_cast<unsigned char>(cur.back())) &&
+                       i + 1 < s.size() && std::isdigit(static_cast<unsigned char>(s[i + 1]));
+        if (std::isalnum(static_cast<unsigned char>(c)) || c == '_' || decimal) {
+            cur += c;
+        } else if (!cur.empty()) {
+            out.push_back(std::move(cur));
+            cur.clear();
+        }
+    }
+    if (!cur.empty()) out.push_back(std::move(cur));
+    return out;
+}
+
+std::optional<float> number_of(const std::string& w) {
+    if (w.empty() || !std::isdigit(static_cast<unsigned char>(w[0]))) return std::nullopt;
+    char* end = nullptr;
+    float v = std::strtof(w.c_str(), &end);
+    if (*end != '\0') return std::nullopt;
+    return v;
+}
+
+using Op = ReflexRule::Op;
+using Field = ReflexRule::Field;
+
+// The comparison a word introduces, if any.
+std::optional<Op> op_of(const std::string& w) {
+    if (w == "lt" || w == "under" || w == "below" || w == "beneath" || w == "less" ||
+        w == "fewer" || w == "lower" || w == "closer" || w == "nearer") return Op::Lt;
+    if (w == "le" || w == "within" || w == "most" || w == "to" || w == "reaches" ||
+        w == "hits" || w == "at") return Op::Le;
+    if (w == "gt" || w == "over" || w == "above" || w == "beyond" || w == "more" ||
+        w == "higher" || w == "farther" || w == "further") return Op::Gt;
+    if (w == "ge" || w == "least") return Op::Ge;
+    return std::nullopt;
+}
+
+std::optional<Field> field_of(const std::string& w) {
+    if (w == "health" || w == "hp" || w == "heart" || w == "hearts") return Field::Health;
+    if (w == "food" || w == "hunger" || w == "saturation") return Field::Food;
+    return std::nullopt;
+}
+
+const char* op_str(Op op) {
+    switch (op) {
+    case Op::Lt: return "<";
+    case Op::Le: return "<=";
+    case Op::Gt: return ">";
+    case Op::Ge: return ">=";
+    }
+    return "?";
+}
+
+bool compare(float x, Op op, float v) {
+    switch (op) {
+    case Op::Lt: return x <  v;
+    case Op::Le: return x <= v;
+    case Op::Gt: return x >  v;
+    case Op::Ge: return x >= v;
+    }
+    return false;
+}
+
+std::string describe(const ReflexRule::Condition& c) {
+    char num[16];
+    std::snprintf(num, sizeof num, "%g", c.value);
+    std::string subject = c.field == Field::Health ? "health"
+                        : c.field == Field::Food   ? "food"
+                                                   : c.entity;
+    return subject + op_str(c.op) + num;
+}
+
+// Health and food live in [0, 20]: a threshold at either end can make a
+// condition vacuous.
+bool never_holds(Op op, float v)  {
+    return (op == Op::Lt && v <= 0) || (op == Op::Le && v < 0) ||
+           (op == Op::Gt && v >= 20) || (op == Op::Ge && v > 20);
+}
+bool always_holds(Op op, float v) {
+    return (op == Op::Lt && v > 20) || (op == Op::Le && v >= 20) ||
+           (op == Op::Gt && v < 0) || (op == Op::Ge && v <= 0);
+}
+
+} // namespace
+
+// ── ReflexRule ──────────────────────────────────────────────────
+
+bool ReflexRule::matches(const Percept& p) const {
+    for (auto& c : when) {
+        switch (c.field) {
+        case Field::Health:
+            if (!compare(p.health, c.op, c.value)) return false;
+            break;
+        case Field::Food:
+            if (!compare(p.hunger, c.op, c.value)) return false;
+            break;
+        case Field::Distance: {
+            // Entities arrive nearest first, so the first match is the one.
+            bool any = c.entity == "hostile";
+            auto it = std::find_if(p.entities.begin(), p.entities.end(), [&](const NearbyEntity& e) {
+                return any ? e.hostile : e.name == c.entity;
+            });
+            if (it == p.entities.end() || !compare(it->distance, c.op, c.value)) return false;
+            break;
+        }
+        }
+    }
+    return true;
+}
+
+// ── RuleSet ─────────────────────────────────────────────────────
+
+RuleSet::RuleSet(std::vector<ReflexRule> rules) : rules_(std::move(rules)) {
+    by_urgency_.resize(rules_.size());
+    for (size_t i = 0; i < rules_.size(); ++i) by_urgency_[i] = i;
+    // Newer rules first among equals: a fresh lesson refines an old one.
+    std::stable_sort(by_urgency_.begin(), by_urgency_.end(), [&](size_t a, size_t b) {
+        if (rules_[a].urgency != rules_[b].urgency) return rules_[a].urgency > rules_[b].urgency;
+        return a > b;
+    });
+}
+
+const ReflexRule* RuleSet::match(const Percept& p) const {
+    for (size_t i : by_urgency_) {
+        if (rules_[i].matches(p)) return &rules_[i];
+    }
+    return nullptr;
+}
+
+RuleSet RuleSet::merged(const std::vector<ReflexRule>& more, size_t max_rules) const {
+    std::vector<ReflexRule> out = rules_;
+    for (auto& r : more) {
+        out.erase(std::remove_if(out.begin(), out.end(),
+                                 [&](const ReflexRule& o) { return o.id == r.id; }),
+                  out.end());
+        out.push_back(r);
+    }
+    if (out.size() > max_rules) out.erase(out.begin(), out.end() - static_cast<long>(max_rules));
+    return RuleSet(std::move(out));
+}
+
+// ── LessonCompiler ──────────────────────────────────────────────
+
+LessonCompiler::LessonCompiler() : LessonCompiler(Config{}) {}
+
+LessonCompiler::LessonCompiler(Config cfg) : cfg_(cfg) {}
+
+std::optional<ReflexRule> LessonCompiler::compile(const std::string& lesson, std::string* why) const {
+    auto fail = [&](const char* reason) -> std::optional<ReflexRule> {
+        if (why) *why = reason;
+        return std::nullopt;
+    };
+
+    auto words = tokenize(lesson);
+
+    // ── Action: exactly one, not negated ────────────────────────
+    std::string action;
+    for (size_t i = 0; i < words.size(); ++i) {
+        std::string a = in(kFleeWords, words[i]) ? "flee" : in(kEatWords, words[i]) ? "eat" : "";
+        if (a.empty()) continue;
+        // "run" only as in "run from" / "run away".
+        if (words[i] == "run" && (i + 1 >= words.size() ||
+                                  (words[i + 1] != "from" && words[i + 1] != "away"))) continue;
+        if (i > 0 && in(kNegations, words[i - 1])) return fail("negated action");
+        if (!action.empty() && action != a) return fail("more than one action");
+        action = a;
+    }
+    if (action.empty()) return fail("no body action");
+
+    // ── Conditions: one per number ──────────────────────────────
+    ReflexRule rule;
+    for (size_t i = 0; i < words.size(); ++i) {
+        auto value = number_of(words[i]);
+        if (!value) continue;
+
+        ReflexRule::Condition c{Field::Health, Op::Le, *value, {}};
+        const size_t lo = i >= 4 ? i - 4 : 0;
+        bool has_unit = i + 1 < words.size() && in(kUnits, words[i + 1]);
+
+        // Nearest comparison word before the number, not crossing an
+        // earlier number.
+        std::optional<Op> op;
+        std::string op_word;
+        for (size_t j = i; j-- > lo && !number_of(words[j]);) {
+            if ((op = op_of(words[j]))) {
+                op_word = words[j];
+                break;
+            }
+        }
+        // "... 6 blocks or less"
+        size_t k = i + (has_unit ? 2 : 1);
+        if (k + 1 < words.size() && words[k] == "or") {
+            const auto& w = words[k + 1];
+            if (w == "less" || w == "fewer" || w == "lower" || w == "below") op = Op::Le;
+            if (w == "more" || w == "higher" || w == "above") op = Op::Ge;
+        }
+
+        // "6 blocks", "3 hearts", "food below 10", "within 6 of a creeper".
+        std::optional<Field> field;
+        std::string field_word;
+        if (has_unit) {
+            field = Field::Distance;
+        } else if (i + 1 < words.size() && (field = field_of(words[i + 1]))) {
+            field_word = words[i + 1];
+        } else {
+            for (size_t j = i; j-- > lo && !field && !number_of(words[j]);) {
+                if ((field = field_of(words[j]))) field_word = words[j];
+            }
+            if (!field && op_word == "within") field = Field::Distance;
+        }
+        if (field_word == "heart" || field_word == "hearts") c.value *= 2;   // 1 heart = 2 hp
+        if (!field) return fail("number without a field");
+        if (!op) return fail("threshold without a comparison");
+        c.field = *field;
+        c.op    = *op;
+
+        if (c.field == Field::Distance) {
+            // The mob named nearest to the number, either side.
+            for (size_t d = 1; d < words.size() && c.entity.empty(); ++d) {
+                if (d <= i) c.entity = entity_of(words[i - d]);
+                if (c.entity.empty() && i + d < words.size()) c.entity = entity_of(words[i + d]);
+            }
+            if (c.entity.empty()) return fail("distance without a mob");
+        }
+        rule.when.push_back(std::move(c));
+    }
+    if (rule.when.empty()) return fail("no threshold");
+
+    rule.lesson = lesson;
+    rule.action = action;
+    std::string conds;
+    for (auto& c : rule.when) conds += (conds.empty() ? "" : "&") + describe(c);
+    rule.id = action + ":" + conds;
+    if (action == "flee") {
+        rule.layer       = Reflex::Layer::Avoid;
+        rule.urgency     = 0.8f;    // below the built-in Layer 0 reflexes
+        rule.vetoes_soul = true;
+    } else {
+        rule.layer       = Reflex::Layer::Tactic;
+        rule.urgency     = 0.6f;    // above the built-in hunger reflex
+    }
+    rule.action_json = intern_action(R"({"action":")" + action + R"(","reason":"lesson:)" + conds + R"("})");
+    return rule;
+}
+
+bool LessonCompiler::validate(const ReflexRule& rule, const std::vector<Percept>& samples,
+                              std::string* why) const {
+    auto fail = [&](std::string reason) {
+        if (why) *why = std::move(reason);
+        return false;
+    };
+
+    bool vital = false, distance = false, food = false;
+    for (auto& c : rule.when) {
+        if (c.field == Field::Distance) {
+            if (c.op == Op::Gt || c.op == Op::Ge) return fail("only 'closer than' distances compile");
+            if (c.value <= 0 || c.value > cfg_.max_distance) return fail("distance out of range");
+            distance = true;
+        } else {
+            if (c.value < 0 || c.value > 20) return fail("threshold outside 0–20");
+            if (never_holds(c.op, c.value))  return fail("condition can never hold");
+            if (always_holds(c.op, c.value)) return fail("condition always holds");
+            (c.field == Field::Health ? vital : food) = true;
+        }
+    }
+    if (rule.action == "flee" && !vital && !distance) return fail("flee needs a health or distance condition");
+    if (rule.action == "eat" && !vital && !food)      return fail("eat needs a food or health condition");
+
+    // Replay against recent percepts: a rule that would have fired most
+    // of the time is a standing policy, which is the Soul's business.
+    if (samples.size() >= cfg_.min_samples) {
+        size_t fired = static_cast<size_t>(std::count_if(samples.begin(), samples.end(),
+            [&](const Percept& p) { return rule.matches(p); }));
+        float rate = static_cast<float>(fired) / static_cast<float>(samples.size());
+        if (rate > cfg_.max_fire_rate) {
+            return fail("fires on " + std::to_string(static_cast<int>(rate * 100)) +
+                        "% of recent percepts");
+        }
+    }
+    return true;
+}
+
+LessonCompiler::Result LessonCompiler::compile_all(const std::vector<std::string>& lessons,
+                                                   const std::vector<Percept>& samples) const {
+    Result out;
+    for (auto& lesson : lessons) {
+        std::string why;
+        auto rule = compile(lesson, &why);
+        if (!rule) {
+            out.uncompiled.push_back(lesson);
+            continue;
+        }
+        if (!validate(*rule, samples, &why)) {
+            out.rejected.push_back({lesson, std::move(why)});
+            continue;
+        }
+        bool dup = std::any_of(out.rules.begin(), out.rules.end(),
+                               [&](const ReflexRule& r) { return r.id == rule->id; });
+        if (!dup) out.rules.push_back(std::move(*rule));
+    }
+    return out;
+}
+
+} // namespace prometheus
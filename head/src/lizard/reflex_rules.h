@@ -0,0 +1,110 @@
+#pragma once
+
+#include "lizard/lizard.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace prometheus {
+
+// A Teacher lesson compiled into a Lizard fast-path rule: a conjunction of
+// conditions over percept fields and the reflex to fire when they hold.
+//   "flee creepers at under 6 blocks"  →  creeper<6         → flee
+//   "eat at food < 10"                 →  food<10           → eat
+struct ReflexRule {
+    enum class Field : uint8_t {
+        Health,
+        Food,
+        Distance,        // to the nearest `entity` ("hostile" = any hostile)
+    };
+    enum class Op : uint8_t { Lt, Le, Gt, Ge };
+
+    struct Condition {
+        Field       field;
+        Op          op;
+        float       value;
+        std::string entity;     // Distance only
+    };
+
+    std::string            id;        // canonical form, e.g. "flee:creeper<6"
+    std::string            lesson;    // source text
+    std::vector<Condition> when;      // all must hold
+    std::string            action;    // "flee" | "eat"
+    Reflex::Layer          layer{Reflex::Layer::Tactic};
+    float                  urgency{0.0f};
+    bool                   vetoes_soul{};
+    std::string_view       action_json;   // interned
+
+    bool matches(const Percept& p) const;
+};
+
+// An immutable set of compiled rules, most urgent first. The Lizard holds
+// the current set behind an atomic pointer; installing a new one never
+// blocks react().
+class RuleSet {
+public:
+    RuleSet() = default;
+    explicit RuleSet(std::vector<ReflexRule> rules);
+
+    // The most urgent rule whose conditions hold, or nullptr.
+    const ReflexRule* match(const Percept& p) const;
+
+    // This set plus `more`. A rule with an existing id replaces the old
+    // one; past `max_rules` the oldest are dropped.
+    RuleSet merged(const std::vector<ReflexRule>& more, size_t max_rules) const;
+
+    const std::vector<ReflexRule>& rules() const { return rules_; }
+    size_t size() const { return rules_.size(); }
+
+private:
+    std::vector<ReflexRule> rules_;         // oldest first
+    std::vector<size_t>     by_urgency_;    // indices into rules_
+};
+
+// Turns lesson text into validated ReflexRules.
+//
+// Only one shape compiles: a body action (flee, eat) plus thresholds on
+// health, food or distance to a named mob. A candidate is rejected when a
+// threshold is out of range, when a condition can never or will always
+// hold, or when it would have fired on more than max_fire_rate of the
+// sampled percepts — a rule that broad is a policy, not a reflex. Anything
+// that does not compile stays with the Soul as prompt context.
+class LessonCompiler {
+public:
+    struct Config {
+        float  max_fire_rate = 0.3f;    // of sampled percepts
+        size_t min_samples   = 50;      // fewer → skip the replay check
+        float  max_distance  = 32.0f;   // the body reports entities within 32 blocks
+    };
+
+    struct Rejection {
+        std::string lesson;
+        std::string reason;
+    };
+
+    struct Result {
+        std::vector<ReflexRule>  rules;
+        std::vector<std::string> uncompiled;    // not a rule; stays prompt context
+        std::vector<Rejection>   rejected;      // failed validation; also prompt context
+    };
+
+    LessonCompiler();
+    explicit LessonCompiler(Config cfg);
+
+    // Parse one lesson. On failure returns nullopt and sets `why`.
+    std::optional<ReflexRule> compile(const std::string& lesson, std::string* why = nullptr) const;
+
+    // Compile and validate a day's lessons against recent percepts.
+    Result compile_all(const std::vector<std::string>& lessons,
+                       const std::vector<Percept>& samples) const;
+
+private:
+    bool validate(const ReflexRule& rule, const std::vector<Percept>& samples,
+                  std::string* why) const;
+
+    Config cfg_;
+};
+
+} // namespace prometheus
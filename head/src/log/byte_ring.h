@@ -0,0 +1,78 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace prometheus {
+
+// Single-producer single-consumer byte ring. The EventLog and the Logger
+// give each producer thread its own and drain them from a writer thread.
+//
+// Frames are u32 length + record. The producer owns head_, the writer
+// owns tail_; neither side takes a lock.
+class ByteRing {
+public:
+    explicit ByteRing(size_t bytes) {
+        size_t cap = 1024;
+        while (cap < bytes) cap <<= 1;
+        buf_.resize(cap);
+        mask_ = cap - 1;
+    }
+
+    bool push(std::string_view rec) {
+        const uint64_t need = 4 + rec.size();
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        const uint64_t tail = tail_.load(std::memory_order_acquire);
+        if (buf_.size() - (head - tail) < need) return false;
+
+        auto n = static_cast<uint32_t>(rec.size());
+        copy_in(head, &n, 4);
+        copy_in(head + 4, rec.data(), rec.size());
+        head_.store(head + need, std::memory_order_release);
+        return true;
+    }
+
+    template <typename F>
+    void drain(F&& f) {
+        uint64_t       tail = tail_.load(std::memory_order_relaxed);
+        const uint64_t head = head_.load(std::memory_order_acquire);
+        std::string rec;
+        while (tail < head) {
+            uint32_t n = 0;
+            copy_out(tail, &n, 4);
+            rec.resize(n);
+            copy_out(tail + 4, rec.data(), n);
+            f(rec);
+            tail += 4 + n;
+        }
+        tail_.store(tail, std::memory_order_release);
+    }
+
+    std::atomic<bool> orphaned{false};    // producer thread has exited
+
+private:
+    void copy_in(uint64_t pos, const void* src, size_t n) {
+        size_t off   = pos & mask_;
+        size_t first = std::min(n, buf_.size() - off);
+        std::memcpy(&buf_[off], src, first);
+        std::memcpy(&buf_[0], static_cast<const char*>(src) + first, n - first);
+    }
+    void copy_out(uint64_t pos, void* dst, size_t n) const {
+        size_t off   = pos & mask_;
+        size_t first = std::min(n, buf_.size() - off);
+        std::memcpy(dst, &buf_[off], first);
+        std::memcpy(static_cast<char*>(dst) + first, &buf_[0], n - first);
+    }
+
+    std::vector<char> buf_;
+    size_t            mask_{0};
+    alignas(64) std::atomic<uint64_t> head_{0};
+    alignas(64) std::atomic<uint64_t> tail_{0};
+};
+
+} // namespace prometheus
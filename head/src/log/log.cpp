@@ -0,0 +1,378 @@
+#include "log/log.h"
+#include "log/byte_ring.h"
+#include "metrics/metrics.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace prometheus {
+
+namespace {
+
+// ── Metrics ─────────────────────────────────────────────────────
+struct LogMetrics {
+    Counter& lines;
+    Counter& dropped;
+    Counter& suppressed;
+
+    LogMetrics()
+        : lines(metrics().counter("head_log_lines_total", "Log lines written.")),
+          dropped(metrics().counter("head_log_dropped_total",
+                                    "Log lines dropped because a thread's ring was full.")),
+          suppressed(metrics().counter("head_log_suppressed_total",
+                                       "Log lines skipped by a per-site rate limit.")) {}
+};
+
+LogMetrics& log_metrics() {
+    static LogMetrics m;
+    return m;
+}
+
+constexpr const char* kLevelNames[] = {"DEBUG", "INFO ", "WARN ", "ERROR"};
+
+// ── State ───────────────────────────────────────────────────────
+struct State {
+    Logger::Config cfg;
+    std::atomic<bool> running{false};
+
+    std::mutex                             rings_mu;
+    std::vector<std::shared_ptr<ByteRing>> rings;
+
+    // write_mu: one consumer for the rings, one writer for the sinks.
+    std::mutex  write_mu;
+    std::FILE*  file{nullptr};
+    size_t      file_size{0};
+    std::string line;           // formatting scratch
+    struct Pending {
+        uint64_t    t_ns;
+        std::string rec;
+    };
+    std::vector<Pending> pending;
+
+    std::atomic<uint64_t> lines{0}, dropped{0}, suppressed{0}, rotations{0};
+    uint64_t              dropped_reported{0};
+
+    std::thread             writer;
+    std::mutex              cv_mu;
+    std::condition_variable cv;
+    bool                    stop{false};
+};
+
+State& state() {
+    static State s;
+    return s;
+}
+
+// This thread's ring, registered on first use; marked orphaned when the
+// thread exits so the writer can let it go once drained.
+struct ThreadRing {
+    std::shared_ptr<ByteRing> ring;
+    ~ThreadRing() {
+        if (ring) ring->orphaned.store(true);
+    }
+};
+thread_local ThreadRing t_ring;
+
+ByteRing* this_ring() {
+    if (!t_ring.ring) {
+        auto& s = state();
+        t_ring.ring = std::make_shared<ByteRing>(s.cfg.ring_bytes);
+        std::lock_guard lock(s.rings_mu);
+        s.rings.push_back(t_ring.ring);
+    }
+    return t_ring.ring.get();
+}
+
+// ── Decoding ────────────────────────────────────────────────────
+
+template <typename T>
+bool take(std::string_view& in, T& v) {
+    if (in.size() < sizeof v) return false;
+    std::memcpy(&v, in.data(), sizeof v);
+    in.remove_prefix(sizeof v);
+    return true;
+}
+
+struct Header {
+    const LogSite* site{nullptr};
+    uint64_t       t_ns{0};
+    uint32_t       suppressed{0};
+    uint8_t        nargs{0};
+};
+
+bool take_header(std::string_view& in, Header& h) {
+    return take(in, h.site) && take(in, h.t_ns) && take(in, h.suppressed) && take(in, h.nargs);
+}
+
+// Format one argument onto `out`; false at the end of the record.
+bool format_arg(std::string_view& in, std::string& out) {
+    detail::ArgTag tag{};
+    if (!take(in, tag)) return false;
+    char num[32];
+    switch (tag) {
+    case detail::ArgTag::I64: {
+        int64_t v = 0;
+        if (!take(in, v)) return false;
+        std::snprintf(num, sizeof num, "%lld", static_cast<long long>(v));
+        out += num;
+        return true;
+    }
+    case detail::ArgTag::U64: {
+        uint64_t v = 0;
+        if (!take(in, v)) return false;
+        std::snprintf(num, sizeof num, "%llu", static_cast<unsigned long long>(v));
+        out += num;
+        return true;
+    }
+    case detail::ArgTag::F64: {
+        double v = 0;
+        if (!take(in, v)) return false;
+        std::snprintf(num, sizeof num, "%g", v);
+        out += num;
+        return true;
+    }
+    case detail::ArgTag::Bool: {
+        uint8_t v = 0;
+        if (!take(in, v)) return false;
+        out += v ? "true" : "false";
+        return true;
+    }
+    case detail::ArgTag::Char: {
+        char v = 0;
+        if (!take(in, v)) return false;
+        out += v;
+        return true;
+    }
+    case detail::ArgTag::Str: {
+        uint32_t full = 0;
+        uint16_t stored = 0;
+        if (!take(in, full) || !take(in, stored) || in.size() < stored) return false;
+        out.append(in.data(), stored);
+        in.remove_prefix(stored);
+        if (full > stored) {
+            std::snprintf(num, sizeof num, "…(+%u bytes)", full - stored);
+            out += num;
+        }
+        return true;
+    }
+    }
+    return false;
+}
+
+// The message text: the site's format with each {} replaced in turn.
+void format_message(const Header& h, std::string_view args, std::string& out) {
+    std::string_view fmt = h.site->fmt;
+    for (size_t pos; (pos = fmt.find("{}")) != std::string_view::npos;) {
+        out.append(fmt.data(), pos);
+        fmt.remove_prefix(pos + 2);
+        if (!format_arg(args, out)) out += "{}";
+    }
+    out += fmt;
+    if (h.suppressed) {
+        char note[48];
+        std::snprintf(note, sizeof note, " (%u similar suppressed)", h.suppressed);
+        out += note;
+    }
+}
+
+// ── Sinks ───────────────────────────────────────────────────────
+
+bool open_file(State& s) {
+    if (s.cfg.path.empty()) return true;
+    std::error_code ec;
+    if (auto dir = std::filesystem::path(s.cfg.path).parent_path(); !dir.empty()) {
+        std::filesystem::create_directories(dir, ec);
+    }
+    s.file = std::fopen(s.cfg.path.c_str(), "a");
+    if (!s.file) return false;
+    s.file_size = static_cast<size_t>(std::ftell(s.file));
+    return true;
+}
+
+// head.log → head.log.1 → … → head.log.<keep_files>, oldest deleted.
+void rotate(State& s) {
+    std::fclose(s.file);
+    s.file = nullptr;
+    std::error_code ec;
+    const std::string& base = s.cfg.path;
+    for (int i = s.cfg.keep_files; i >= 1; --i) {
+        auto from = i == 1 ? base : base + "." + std::to_string(i - 1);
+        std::filesystem::rename(from, base + "." + std::to_string(i), ec);
+    }
+    if (s.cfg.keep_files <= 0) std::filesystem::remove(base, ec);
+    s.rotations.fetch_add(1, std::memory_order_relaxed);
+    s.file      = std::fopen(base.c_str(), "w");
+    s.file_size = 0;
+}
+
+// Format and write one record. write_mu held.
+void emit_locked(State& s, std::string_view rec, int64_t wall_offset_ns) {
+    Header h;
+    if (!take_header(rec, h) || !h.site) return;
+
+    s.line.clear();
+    format_message(h, rec, s.line);
+    s.line += '\n';
+
+    if (s.cfg.console) {
+        std::FILE* out = h.site->level >= LogLevel::Warn ? stderr : stdout;
+        std::fwrite(s.line.data(), 1, s.line.size(), out);
+    }
+    if (s.file) {
+        const auto wall = static_cast<int64_t>(h.t_ns) + wall_offset_ns;
+        std::time_t secs = static_cast<std::time_t>(wall / 1000000000);
+        std::tm tm{};
+        localtime_r(&secs, &tm);
+        char stamp[48];
+        int n = std::snprintf(stamp, sizeof stamp, "%04d-%02d-%02d %02d:%02d:%02d.%03d %s ",
+                              tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min,
+                              tm.tm_sec, static_cast<int>(wall / 1000000 % 1000),
+                              kLevelNames[static_cast<int>(h.site->level)]);
+        std::fwrite(stamp, 1, static_cast<size_t>(n), s.file);
+        std::fwrite(s.line.data(), 1, s.line.size(), s.file);
+        s.file_size += static_cast<size_t>(n) + s.line.size();
+        if (s.file_size >= s.cfg.file_bytes) rotate(s);
+    }
+    s.lines.fetch_add(1, std::memory_order_relaxed);
+    s.suppressed.fetch_add(h.suppressed, std::memory_order_relaxed);
+    log_metrics().lines.inc();
+    if (h.suppressed) log_metrics().suppressed.inc(h.suppressed);
+}
+
+int64_t wall_offset_ns() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count() -
+           duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Drain every ring and write the lines in time order. write_mu held.
+void drain_locked(State& s) {
+    std::vector<std::shared_ptr<ByteRing>> snapshot;
+    {
+        std::lock_guard lock(s.rings_mu);
+        snapshot = s.rings;
+    }
+    s.pending.clear();
+    for (auto& r : snapshot) {
+        bool gone = r->orphaned.load();
+        r->drain([&](const std::string& rec) {
+            Header h;
+            std::string_view in = rec;
+            if (take_header(in, h)) s.pending.push_back({h.t_ns, rec});
+        });
+        if (gone) {
+            std::lock_guard lock(s.rings_mu);
+            std::erase(s.rings, r);
+        }
+    }
+    std::stable_sort(s.pending.begin(), s.pending.end(),
+                     [](const State::Pending& a, const State::Pending& b) { return a.t_ns < b.t_ns; });
+    const int64_t offset = wall_offset_ns();
+    for (auto& p : s.pending) emit_locked(s, p.rec, offset);
+
+    if (uint64_t d = s.dropped.load(std::memory_order_relaxed); d != s.dropped_reported) {
+        std::fprintf(stderr, "[LOG] %llu lines dropped (ring full).\n",
+                     static_cast<unsigned long long>(d - s.dropped_reported));
+        s.dropped_reported = d;
+    }
+    if (s.cfg.console && !s.pending.empty()) {
+        std::fflush(stdout);
+        std::fflush(stderr);
+    }
+    if (s.file) std::fflush(s.file);
+}
+
+void writer_loop(State& s) {
+    std::unique_lock lk(s.cv_mu);
+    while (!s.stop) {
+        s.cv.wait_for(lk, s.cfg.flush_interval, [&] { return s.stop; });
+        lk.unlock();
+        {
+            std::lock_guard lock(s.write_mu);
+            drain_locked(s);
+        }
+        lk.lock();
+    }
+}
+
+} // namespace
+
+std::optional<LogLevel> parse_log_level(std::string_view name) {
+    if (name == "debug") return LogLevel::Debug;
+    if (name == "info")  return LogLevel::Info;
+    if (name == "warn")  return LogLevel::Warn;
+    if (name == "error") return LogLevel::Error;
+    return std::nullopt;
+}
+
+// ── Logger ──────────────────────────────────────────────────────
+
+bool Logger::start(const Config& cfg) {
+    auto& s = state();
+    if (s.running.load()) return true;
+    log_metrics();
+    bool ok = true;
+    {
+        std::lock_guard lock(s.write_mu);
+        s.cfg = cfg;
+        if (!open_file(s)) {
+            std::cerr << "[LOG] Cannot open " << cfg.path << "; logging to the console only.\n";
+            ok = false;
+        }
+    }
+    set_level(cfg.level);
+    s.stop = false;
+    s.writer = std::thread([&s] { writer_loop(s); });
+    s.running.store(true, std::memory_order_release);
+    return ok;
+}
+
+void Logger::stop() {
+    auto& s = state();
+    if (!s.running.exchange(false)) return;
+    {
+        std::lock_guard lk(s.cv_mu);
+        s.stop = true;
+    }
+    s.cv.notify_all();
+    s.writer.join();
+    std::lock_guard lock(s.write_mu);
+    drain_locked(s);
+    if (s.file) std::fclose(s.file);
+    s.file = nullptr;
+}
+
+void Logger::flush() {
+    auto& s = state();
+    std::lock_guard lock(s.write_mu);
+    drain_locked(s);
+}
+
+Logger::Stats Logger::stats() {
+    auto& s = state();
+    return {s.lines.load(), s.dropped.load(), s.suppressed.load(), s.rotations.load()};
+}
+
+void Logger::submit(std::string_view rec) {
+    auto& s = state();
+    if (!s.running.load(std::memory_order_acquire)) {
+        std::lock_guard lock(s.write_mu);
+        emit_locked(s, rec, wall_offset_ns());
+        std::fflush(stdout);
+        return;
+    }
+    if (!this_ring()->push(rec)) {
+        s.dropped.fetch_add(1, std::memory_order_relaxed);
+        log_metrics().dropped.inc();
+    }
+}
+
+} // namespace prometheus
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace prometheus {
+
+// Asynchronous logging for threads that must not wait on the terminal.
+//
+//     PROMETHEUS_LOG(Info, "[BODY] >> {}", action_json);
+//     PROMETHEUS_LOG_EVERY(1000, Warn, "[LIZARD] react() took {} ms", ms);
+//
+// A call encodes the site (format and level, fixed at compile time) and
+// its arguments as a binary record into this thread's ring — no
+// formatting, no lock, no allocation. A writer thread drains the rings
+// every flush_interval, formats the lines in time order and writes them
+// to the console (Warn and Error to stderr) and to a size-rotated file
+// with timestamps. A full ring drops the line and counts it rather than
+// block. Strings longer than fit in one record are cut short.
+//
+// Lines below the level are skipped before anything is encoded.
+// PROMETHEUS_LOG_EVERY writes a site at most once per interval; the next
+// line it writes says how many were suppressed.
+//
+// Before start() and after stop() a call is formatted and written on the
+// calling thread, so tools and benchmarks that never start the logger
+// still print.
+
+enum class LogLevel : uint8_t { Debug, Info, Warn, Error };
+
+// "debug", "info", "warn" or "error"; nullopt otherwise.
+std::optional<LogLevel> parse_log_level(std::string_view name);
+
+// One logging call site (a function-local static made by the macros).
+// Records carry its address as their format id.
+struct LogSite {
+    const char* fmt;
+    LogLevel    level;
+    uint32_t    min_interval_ms;            // 0: no rate limit
+    std::atomic<uint64_t> next_ns{0};       // rate limit: earliest next line
+    std::atomic<uint32_t> suppressed{0};    // lines skipped since the last one
+};
+
+namespace detail {
+
+inline constexpr size_t kMaxRecord = 2048;   // bytes per line, arguments included
+
+enum class ArgTag : uint8_t { I64, U64, F64, Bool, Char, Str };
+
+inline uint64_t log_now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Fills a record: LogSite* | u64 t_ns | u32 suppressed | u8 nargs | args.
+// Each argument is a tag and its value; strings are u32 full length,
+// u16 stored length and the stored bytes.
+struct RecordWriter {
+    char* p;
+    char* end;
+
+    void put(const void* v, size_t n) {
+        n = std::min(n, static_cast<size_t>(end - p));
+        std::memcpy(p, v, n);
+        p += n;
+    }
+    template <typename T>
+    void put_value(ArgTag tag, T v) {
+        if (static_cast<size_t>(end - p) < 1 + sizeof v) return;
+        put(&tag, 1);
+        put(&v, sizeof v);
+    }
+    void put_str(std::string_view s) {
+        constexpr size_t kHeader = 1 + 4 + 2;
+        if (static_cast<size_t>(end - p) < kHeader) return;
+        const auto full   = static_cast<uint32_t>(s.size());
+        const auto stored = static_cast<uint16_t>(
+            std::min({s.size(), static_cast<size_t>(end - p) - kHeader, size_t{UINT16_MAX}}));
+        const auto tag = ArgTag::Str;
+        put(&tag, 1);
+        put(&full, 4);
+        put(&stored, 2);
+        put(s.data(), stored);
+    }
+};
+
+template <typename T>
+void encode_arg(RecordWriter& w, const T& v) {
+    using D = std::decay_t<T>;
+    if constexpr (std::is_same_v<D, bool>) {
+        w.put_value(ArgTag::Bool, static_cast<uint8_t>(v));
+    } else if constexpr (std::is_same_v<D, char>) {
+        w.put_value(ArgTag::Char, v);
+    } else if constexpr (std::is_enum_v<D>) {
+        w.put_value(ArgTag::I64, static_cast<int64_t>(v));
+    } else if constexpr (std::is_integral_v<D> && std::is_signed_v<D>) {
+        w.put_value(ArgTag::I64, static_cast<int64_t>(v));
+    } else if constexpr (std::is_integral_v<D>) {
+        w.put_value(ArgTag::U64, static_cast<uint64_t>(v));
+    } else if constexpr (std::is_floating_point_v<D>) {
+        w.put_value(ArgTag::F64, static_cast<double>(v));
+    } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+        w.put_str(std::string_view(v));
+    } else {
+        static_assert(!sizeof(T), "PROMETHEUS_LOG: unsupported argument type");
+    }
+}
+
+} // namespace detail
+
+class Logger {
+public:
+    struct Config {
+        LogLevel    level      = LogLevel::Info;
+        bool        console    = true;
+        std::string path;                       // also append here ("" = console only)
+        size_t      file_bytes = 16 << 20;      // rotate to path.1 … past this
+        int         keep_files = 4;             // rotated files kept
+        size_t      ring_bytes = 64 * 1024;     // per producer thread
+        std::chrono::milliseconds flush_interval{20};
+    };
+
+    struct Stats {
+        uint64_t lines{0};          // written
+        uint64_t dropped{0};        // producer ring full
+        uint64_t suppressed{0};     // rate-limited, reported so far
+        uint64_t rotations{0};
+    };
+
+    // Start the writer thread. Returns false (and logs) if the file cannot
+    // be opened; the console still works.
+    static bool start(const Config& cfg);
+
+    // Write everything still queued and join the writer.
+    static void stop();
+
+    // Write everything logged so far before returning.
+    static void flush();
+
+    static void set_level(LogLevel level) { level_.store(level, std::memory_order_relaxed); }
+    static bool enabled(LogLevel level) {
+        return level >= level_.load(std::memory_order_relaxed);
+    }
+
+    static Stats stats();
+
+    template <typename... Args>
+    static void write(LogSite& site, const Args&... args) {
+        const uint64_t now = detail::log_now_ns();
+        uint32_t suppressed = 0;
+        if (site.min_interval_ms) {
+            if (now < site.next_ns.load(std::memory_order_relaxed)) {
+                site.suppressed.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            site.next_ns.store(now + uint64_t{site.min_interval_ms} * 1000000,
+                               std::memory_order_relaxed);
+            suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+        }
+        char buf[detail::kMaxRecord];
+        detail::RecordWriter w{buf, buf + sizeof buf};
+        const LogSite* id    = &site;
+        const auto     nargs = static_cast<uint8_t>(sizeof...(Args));
+        w.put(&id, sizeof id);
+        w.put(&now, sizeof now);
+        w.put(&suppressed, sizeof suppressed);
+        w.put(&nargs, 1);
+        (detail::encode_arg(w, args), ...);
+        submit(std::string_view(buf, static_cast<size_t>(w.p - buf)));
+    }
+
+private:
+    static void submit(std::string_view rec);
+
+    static inline std::atomic<LogLevel> level_{LogLevel::Info};
+};
+
+} // namespace prometheus
+
+#define PROMETHEUS_LOG_EVERY(interval_ms, lvl, fmt, ...)                                 \
+    do {                                                                                  \
+        if (::prometheus::Logger::enabled(::prometheus::LogLevel::lvl)) {                 \
+            static ::prometheus::LogSite prometheus_log_site_{                            \
+                fmt, ::prometheus::LogLevel::lvl, interval_ms};                           \
+            ::prometheus::Logger::write(prometheus_log_site_ __VA_OPT__(, ) __VA_ARGS__); \
+        }                                                                                 \
+    } while (0)
+
+#define PROMETHEUS_LOG(lvl, fmt, ...) \
+    PROMETHEUS_LOG_EVERY(0, lvl, fmt __VA_OPT__(, ) __VA_ARGS__)
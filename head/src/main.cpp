@@ -1,26 +1,59 @@
 #include "lizard/lizard.h"
+#include "lizard/novelty.h"
 #include "soul/soul.h"
+#include "soul/soul_scheduler.h"
 #include "arbiter/arbiter.h"
 #include "ipc/body_link.h"
 #include "memory/memory.h"
+#include "metrics/metrics_server.h"
 #include "circadian/circadian.h"
+#include "diag/trace.h"
+#include "log/log.h"
+#include "sched/scheduler.h"
+#include "sched/topology.h"
+#include "sched/watchdog.h"
 #include "teacher/teacher.h"
+#include "vision/frame_gate.h"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstdlib>
 #include <csignal>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <utility>
+
+#include <unistd.h>
 
 static std::atomic<bool> g_running{true};
+static std::atomic<prometheus::Scheduler*> g_scheduler{nullptr};
+static std::atomic<bool> g_trace_toggle{false};
+
+static void signal_handler(int) {
+    g_running.store(false);
+    if (auto* s = g_scheduler.load()) s->stop();
+}
+
+// SIGUSR1 flips span tracing; the file is written off the handler.
+static void trace_signal_handler(int) {
+    g_trace_toggle.store(true);
+}
 
-static void signal_handler(int) { g_running.store(false); }
+// Environment override with a fallback (an empty value counts as set).
+static std::string env_or(const char* name, const std::string& fallback) {
+    const char* v = std::getenv(name);
+    return v ? v : fallback;
+}
 
 // Take a screenshot of the bot's prismarine-viewer via playwright.
 // Falls back to a fixed path if the screenshot command fails.
 static std::string take_screenshot() {
+    prometheus::TraceSpan span("take_screenshot");
     std::string path = "/tmp/prometheus_vibe.png";
     // Use playwright (via venv) to capture the prismarine-viewer on port 3007
     (void)std::system(
@@ -34,105 +67,429 @@ int main(int argc, char* argv[]) {
 
     std::signal(SIGINT, signal_handler);
     std::signal(SIGTERM, signal_handler);
+    std::signal(SIGUSR1, trace_signal_handler);
+    prometheus::Trace::name_thread("main");
 
     std::cout << "[HEAD] Prometheus Backplane v0.1.0 starting...\n";
 
+    const std::string root = env_or("PROMETHEUS_ROOT", "/home/ben/prometheus");
+
+    // Span tracing: on from start-up with PROMETHEUS_TRACE=<file>, or
+    // toggled with SIGUSR1 (each stop writes a Chrome trace-event file).
+    const std::string trace_path = env_or("PROMETHEUS_TRACE", "");
+    int trace_files = 0;
+    auto trace_file = [&] {
+        return !trace_path.empty() ? trace_path
+             : "/tmp/prometheus-trace-" + std::to_string(::getpid()) + "-" +
+               std::to_string(++trace_files) + ".json";
+    };
+    if (!trace_path.empty()) prometheus::Trace::start();
+
+    // Thread topology: CPU mask, SCHED_FIFO and nice per thread role
+    // (sched/topology.h). This thread takes the background policy first,
+    // so every helper thread started from here inherits it; the Lizard,
+    // dispatch, Soul and worker threads apply their own.
+    prometheus::ThreadTopology topology;
+    if (std::string err; !topology.parse(env_or("PROMETHEUS_TOPOLOGY", ""), &err)) {
+        std::cerr << "[HEAD] Bad PROMETHEUS_TOPOLOGY (" << err << "); using the defaults.\n";
+    }
+    std::cout << "[HEAD] Thread topology: " << topology.describe() << "\n";
+    topology.apply(prometheus::ThreadRole::Background);
+
+    // Runtime lines go through the async logger: console plus a rotated
+    // file. PROMETHEUS_LOG_LEVEL=debug adds every action sent to the body.
+    {
+        prometheus::Logger::Config log_cfg;
+        log_cfg.path = env_or("PROMETHEUS_LOG_FILE", root + "/head.log");
+        const std::string level = env_or("PROMETHEUS_LOG_LEVEL", "info");
+        if (auto l = prometheus::parse_log_level(level)) {
+            log_cfg.level = *l;
+        } else {
+            std::cerr << "[HEAD] Unknown PROMETHEUS_LOG_LEVEL '" << level << "'; using info.\n";
+        }
+        prometheus::Logger::start(log_cfg);
+    }
+
+    // Teacher grading: per-window results persist so re-grading is incremental.
+    prometheus::Teacher::Config teacher_cfg;
+    teacher_cfg.cache_path = env_or("PROMETHEUS_TEACHER_CACHE", root + "/teacher-cache.jsonl");
+
+    // Body SUB endpoint (PUSH is the next port) and llama-server port.
+    const std::string body_endpoint = env_or("PROMETHEUS_BODY_ENDPOINT", "tcp://127.0.0.1:5555");
+    const int         soul_port     = std::atoi(env_or("PROMETHEUS_SOUL_PORT", "8081").c_str());
+
     // ── Subsystems ──────────────────────────────────────────────
+    prometheus::EventLog  event_log;
     prometheus::Memory    memory;
-    prometheus::BodyLink  body("tcp://127.0.0.1:5555");
+    prometheus::BodyLink  body(body_endpoint);
     prometheus::Lizard    lizard(memory);
-    prometheus::Soul      soul("http://127.0.0.1:8081", memory);
+    prometheus::Soul      soul("http://127.0.0.1:" + std::to_string(soul_port), memory);
     prometheus::Arbiter   arbiter(lizard, soul, body);
-    prometheus::Teacher   teacher("https://generativelanguage.googleapis.com");
-    prometheus::Circadian circadian(memory, teacher);
+    prometheus::Teacher   teacher(env_or("PROMETHEUS_TEACHER_URL",
+                                         "https://generativelanguage.googleapis.com"),
+                                  teacher_cfg);
+    prometheus::Circadian circadian(memory, teacher, event_log);
+    prometheus::FrameGate frame_gate;
+    prometheus::Scheduler::Config sched_cfg;
+    sched_cfg.on_worker_start = [&] { topology.apply(prometheus::ThreadRole::Worker); };
+    prometheus::Scheduler scheduler(sched_cfg);     // all periodic work; runs on this thread
+    g_scheduler.store(&scheduler);
 
     // ── Boot ────────────────────────────────────────────────────
-    memory.init();
-    body.connect();
-    lizard.load_model();
-
-    // Spawn llama-server and wait for it to be ready
-    soul.spawn_server(
-        "/home/ben/prometheus/models/Qwen2.5-VL-32B-Instruct-Q8_0.gguf",
-        "/home/ben/prometheus/models/mmproj-Qwen2.5-VL-32B-Instruct-Q8_0.gguf",
-        40,    // gpu layers
-        4096,  // context size
-        8081   // port
-    );
-    soul.connect();
-
-    std::cout << "[HEAD] All subsystems initialised.\n";
+    // Stage 0: Event log and Memory (everything else records into them).
+    // Stage 1: BodyLink + Lizard in parallel → reflex loop starts.
+    // Alongside: the Soul supervisor brings llama-server up as a
+    // scheduled task. The Soul stays degraded (Lizard-only) until it is
+    // healthy.
+    using clock = std::chrono::steady_clock;
+    const auto boot_start = clock::now();
+    auto ms_since_boot = [&] {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            clock::now() - boot_start).count();
+    };
+
+    prometheus::Soul::ServerConfig soul_cfg;
+    soul_cfg.server_bin  = env_or("LLAMA_SERVER_BIN",     // set empty for an external server
+                                  root + "/llama.cpp/build/bin/llama-server");
+    soul_cfg.model_path  = root + "/models/Qwen2.5-VL-32B-Instruct-Q8_0.gguf";
+    soul_cfg.mmproj_path = root + "/models/mmproj-Qwen2.5-VL-32B-Instruct-Q8_0.gguf";
+    soul_cfg.log_path    = root + "/llama-server.log";
+    soul_cfg.gpu_layers  = 40;
+    soul_cfg.ctx_size    = 4096;
+    soul_cfg.port        = soul_port;
+
+    // Concurrent deliberations, plus one slot kept free for vibe-check observe.
+    const int soul_slots = std::max(1, std::atoi(env_or("PROMETHEUS_SOUL_SLOTS", "2").c_str()));
+    soul_cfg.parallel    = soul_slots + 1;
+
+    // Optional small text model for routine queries (OpenAI-compatible).
+    if (auto fast_url = env_or("PROMETHEUS_FAST_SOUL_URL", ""); !fast_url.empty()) {
+        soul.add_backend({"fast", fast_url, /*vision=*/false, /*tier=*/0,
+                          /*slots=*/2, /*prior_latency_ms=*/1000});
+    }
+
+    // Response cache; PROMETHEUS_SOUL_CACHE names an optional file that
+    // persists it across restarts.
+    {
+        prometheus::ResponseCache::Config cache_cfg;
+        cache_cfg.persist_path = env_or("PROMETHEUS_SOUL_CACHE", "");
+        soul.enable_cache(cache_cfg);
+    }
+
+    event_log.open(env_or("PROMETHEUS_EVENT_LOG", root + "/events"));
+    memory.attach_event_log(&event_log);
+    arbiter.set_event_log(&event_log);
+    circadian.attach_lizard(&lizard);   // compiled lessons → reflex fast path
+
+    memory.init(env_or("PROMETHEUS_MEMORY_DIR", root + "/memory"),
+                env_or("PROMETHEUS_EMBED_MODEL", root + "/models/bge-small-en-v1.5-q8_0.gguf"));
+
+    // Each supervisor step says when the next one is due.
+    std::function<void()> supervise = [&] {
+        scheduler.after("soul.supervise", soul.supervise_step(soul_cfg), supervise);
+    };
+    scheduler.after("soul.supervise", std::chrono::milliseconds(0), supervise);
+
+    auto body_ready   = std::async(std::launch::async, [&] { body.connect(); });
+    auto lizard_ready = std::async(std::launch::async, [&] {
+        lizard.load_model();
+        // Layer 1 micro-model distilled by scripts/train_micro_model.py.
+        lizard.load_micro_model(
+            env_or("PROMETHEUS_MICRO_MODEL", root + "/models/lizard-micro.pmm"),
+            std::stof(env_or("PROMETHEUS_MICRO_CONFIDENCE", "0.8")));
+    });
 
     // ── Threads ─────────────────────────────────────────────────
-    // Lizard: tight reflex loop (targets < 100 ms per tick)
+    // Lizard: tight reflex loop (targets < 100 ms per tick), started once
+    // the body is connected and the model is loaded.
+    // Background consolidation holds off while the Lizard is handling a
+    // percept, and for a moment after any Layer 0 (Avoid) reflex.
+    std::atomic<bool>    lizard_busy{false};
+    std::atomic<int64_t> threat_until_ms{0};
+    circadian.set_busy_probe([&] {
+        return lizard_busy.load(std::memory_order_relaxed) ||
+               static_cast<int64_t>(ms_since_boot()) < threat_until_ms.load(std::memory_order_relaxed);
+    });
+
+    // Vibe Check. Novelty from the detector on the lizard thread is
+    // escalated at once with its reasons (topic "vibe"); the scene
+    // observation — screenshot → observe → escalate (topic "vibe.scene")
+    // — follows. Observations also run without a reason at start-up and
+    // after kQuietVibe with nothing novel; the frame gate skips vision
+    // inference and the scene escalation while the scene is unchanged. One
+    // observation at a time: reasons that arrive while one runs are merged
+    // and observed when it finishes. Both escalations skip the Soul's
+    // response cache — each describes one event in free text, and a plan
+    // cached for another event would answer the wrong question.
+    constexpr auto kQuietVibe = std::chrono::milliseconds(120000);
+    constexpr const char* kVibeAsk =
+        "\nDescribe the current situation and suggest what we should do next.";
+    std::mutex            vibe_mu;
+    bool                  vibe_running = false;     // guarded by vibe_mu
+    std::string           vibe_pending;             // reasons for the next observation
+    std::atomic<int64_t>  last_vibe_ms{0};
+    std::atomic<uint64_t> vibe_novel{0}, vibe_quiet{0}, vibe_merged{0};
+    auto vibe_check = [&](std::string why) {
+        prometheus::TraceSpan span("vibe_check");
+        if (!why.empty()) {
+            vibe_novel.fetch_add(1);
+            arbiter.escalate("Something changed: " + why + kVibeAsk, std::nullopt, "vibe",
+                             prometheus::QueryClass::Routine, /*cacheable=*/false);
+        }
+        {
+            std::lock_guard lock(vibe_mu);
+            if (vibe_running) {
+                if (!why.empty()) {
+                    vibe_pending += (vibe_pending.empty() ? "" : "; ") + why;
+                    vibe_merged.fetch_add(1);
+                }
+                return;
+            }
+            vibe_running = true;
+        }
+        if (why.empty()) vibe_quiet.fetch_add(1);
+
+        for (;;) {
+            std::string screenshot = take_screenshot();
+
+            std::string description;
+            bool        fresh = false;
+            if (auto cached = frame_gate.check(screenshot)) {
+                description = std::move(*cached);
+                auto st = frame_gate.stats();
+                PROMETHEUS_LOG(Info,
+                               "[VIBE CHECK] Scene unchanged — reusing observation "
+                               "({}/{} skipped, {}%, ~{} s GPU saved).",
+                               st.skipped, st.frames, static_cast<long>(st.skip_ratio() * 100),
+                               static_cast<long>(st.gpu_ms_saved / 1000));
+            } else {
+                auto t0 = std::chrono::steady_clock::now();
+                description = soul.observe(screenshot);
+                frame_gate.record_observation(description,
+                    std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - t0));
+                PROMETHEUS_LOG(Info, "[VIBE CHECK] {}", description);
+                fresh = true;
+            }
+
+            // Escalate the new scene for deeper reasoning; what changed
+            // went ahead already.
+            if (fresh) {
+                arbiter.escalate((why.empty() ? "Vibe check" : "After: " + why) +
+                                 " — the scene currently shows: " + description + kVibeAsk,
+                                 std::nullopt, "vibe.scene", prometheus::QueryClass::Routine,
+                                 /*cacheable=*/false);
+            }
+            last_vibe_ms.store(ms_since_boot());
+
+            std::lock_guard lock(vibe_mu);
+            if (vibe_pending.empty()) {
+                vibe_running = false;
+                break;
+            }
+            why = std::exchange(vibe_pending, {});
+        }
+    };
+
+    // Novelty detection runs beside react() on the lizard thread.
+    prometheus::NoveltyDetector novelty;
+
+    // Flags Lizard ticks (percept in hand → reflex submitted) that run past
+    // the budget, and which thread had the CPU meanwhile.
+    prometheus::ReflexWatchdog::Config watchdog_cfg;
+    watchdog_cfg.budget = std::chrono::milliseconds(
+        std::atoi(env_or("PROMETHEUS_TICK_BUDGET_MS", "20").c_str()));
+    prometheus::ReflexWatchdog watchdog(watchdog_cfg);
+    watchdog.start();
+
     std::thread lizard_thread([&] {
+        prometheus::Trace::name_thread("lizard");
+        topology.apply(prometheus::ThreadRole::Lizard);
+        body_ready.get();
+        lizard_ready.get();
+        PROMETHEUS_LOG(Info, "[HEAD] Reflex path ready after {} ms (Soul {}).", ms_since_boot(),
+                       soul.healthy() ? "healthy" : "degraded");
+
+        // One Percept reused across ticks: with interned reflex payloads
+        // and the event log's scratch buffers, a steady-state tick does
+        // not allocate (bench: hot_loop_alloc).
+        prometheus::Percept percept;
+        bool first_reflex = true;
         while (g_running.load()) {
-            auto percept = body.poll_percept();
-            if (!percept) {
+            if (!body.poll_percept(percept)) {
                 std::this_thread::sleep_for(std::chrono::milliseconds(5));
                 continue;
             }
 
-            auto reflex = lizard.react(*percept);
+            lizard_busy.store(true, std::memory_order_relaxed);
+            watchdog.begin(percept.seq);
+            event_log.percept(percept);
+            frame_gate.note_percept(percept);
+            arbiter.note_situation(prometheus::situation_signature(percept));
+            auto reflex = lizard.react(percept);
+            event_log.reflex(reflex);
+            if (auto n = novelty.observe(percept)) {
+                PROMETHEUS_LOG(Info, "[NOVELTY] {} (score {}).", n->reasons, n->score);
+                scheduler.after("vibe", std::chrono::milliseconds(0),
+                                [&, why = std::move(n->reasons)] { vibe_check(why); });
+            }
+            if (reflex.layer == prometheus::Reflex::Layer::Avoid) {
+                threat_until_ms.store(static_cast<int64_t>(ms_since_boot()) + 2000,
+                                      std::memory_order_relaxed);
+            }
             arbiter.submit_reflex(std::move(reflex));
-        }
-    });
+            watchdog.end();
+            lizard_busy.store(false, std::memory_order_relaxed);
 
-    // Soul: deliberative loop (2–5 s per query)
-    std::thread soul_thread([&] {
-        while (g_running.load()) {
-            auto query = arbiter.next_soul_query();
-            if (!query) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(50));
-                continue;
+            if (first_reflex) {
+                first_reflex = false;
+                PROMETHEUS_LOG(Info, "[HEAD] Time to first reflex: {} ms.", ms_since_boot());
             }
-
-            auto plan = soul.deliberate(*query);
-            arbiter.submit_plan(std::move(plan));
         }
     });
 
-    // Circadian: background clock
-    std::thread circadian_thread([&] {
-        circadian.run(g_running);
-    });
+    // Soul: deliberative workers (2–5 s per query), one per llama-server
+    // slot. Queries stay queued while the backend is degraded.
+    std::atomic<bool> first_plan{true};
+    prometheus::SoulScheduler soul_scheduler(
+        soul, soul_slots,
+        [&] { return arbiter.next_soul_query(); },
+        [&](prometheus::SoulPlan plan) {
+            if (!plan.cancelled && first_plan.exchange(false)) {
+                PROMETHEUS_LOG(Info, "[HEAD] Time to first deliberation: {} ms.", ms_since_boot());
+            }
+            arbiter.submit_plan(std::move(plan));
+        });
+    soul_scheduler.start(g_running, [&] { topology.apply(prometheus::ThreadRole::Soul); });
 
-    // Vibe Check: take a screenshot every 10 seconds and observe via Soul
-    std::thread vibe_thread([&] {
-        // Wait a bit for everything to settle
-        std::this_thread::sleep_for(std::chrono::seconds(5));
+    // Metrics for a local Prometheus scrape; an empty address disables.
+    prometheus::MetricsServer metrics_server(prometheus::metrics());
+    if (auto addr = env_or("PROMETHEUS_METRICS_ADDR", "127.0.0.1:9464"); !addr.empty()) {
+        metrics_server.start(addr);
+    }
 
-        while (g_running.load()) {
-            std::string screenshot = take_screenshot();
-            std::string description = soul.observe(screenshot);
-            std::cout << "[VIBE CHECK] " << description << "\n";
+    // ── Scheduled work ──────────────────────────────────────────
+    // Trace toggle: a worker, so writing the file never delays dispatch.
+    scheduler.every("trace.toggle", std::chrono::milliseconds(250), [&] {
+        if (!g_trace_toggle.exchange(false)) return;
+        if (prometheus::Trace::enabled()) prometheus::Trace::stop_and_write(trace_file());
+        else                              prometheus::Trace::start();
+    });
 
-            // Also escalate to the soul for deeper reasoning
-            arbiter.escalate("Vibe check — describe the current situation and suggest "
-                             "what we should do next.",
-                             soul.observe(screenshot));
+    // Circadian: phase timers and incremental consolidation.
+    circadian.start(scheduler);
 
-            // Sleep 10 seconds (in 100ms increments so we can exit promptly)
-            for (int i = 0; i < 100 && g_running.load(); ++i) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            }
-        }
+    // Vibe check: once at start-up, then on novelty (from the lizard
+    // thread) or when things have been quiet for kQuietVibe.
+    scheduler.after("vibe", std::chrono::seconds(5), [&] { vibe_check(""); });
+    scheduler.every("vibe.quiet", std::chrono::seconds(30), [&] {
+        if (ms_since_boot() - last_vibe_ms.load() >= kQuietVibe.count()) vibe_check("");
     });
 
-    // ── Main loop: arbiter dispatches winning actions ───────────
-    while (g_running.load()) {
-        arbiter.dispatch_tick();
-        std::this_thread::sleep_for(std::chrono::milliseconds(16)); // ~60 Hz
+    // Arbiter dispatches winning actions at ~60 Hz. The tick only swaps
+    // out pending candidates and sends, so it runs on the timer thread.
+    {
+        prometheus::Scheduler::Options opts;
+        opts.on_timer_thread = true;
+        scheduler.every("arbiter.dispatch", std::chrono::milliseconds(16),
+                        [&] { arbiter.dispatch_tick(); }, opts);
     }
 
+    // Timer loop until SIGINT/SIGTERM. This thread runs the dispatch tick.
+    topology.apply(prometheus::ThreadRole::Dispatch);
+    scheduler.run();
+
     // ── Shutdown ────────────────────────────────────────────────
     std::cout << "[HEAD] Shutting down...\n";
     g_running.store(false);
+    arbiter.cancel_soul_queries("shutdown");   // unblock the soul thread
 
     lizard_thread.join();
-    soul_thread.join();
-    circadian_thread.join();
-    vibe_thread.join();
+    watchdog.stop();
+    soul_scheduler.join();
+    if (prometheus::Trace::enabled()) prometheus::Trace::stop_and_write(trace_file());
+    prometheus::Logger::stop();   // the summary below is written directly
+
+    auto soul_stats  = soul.stats();
+    auto sched_stats = soul_scheduler.stats();
+    std::cout << "[HEAD] Deliberations: " << soul_stats.completed
+              << " completed, " << soul_stats.cancelled << " cancelled ("
+              << soul_stats.cancelled_backend_s << " s backend time on cancelled queries).\n"
+              << "[HEAD] Soul scheduler: " << soul_scheduler.slots() << " slots, peak "
+              << sched_stats.peak_in_flight << " in flight, mean queue delay "
+              << sched_stats.mean_queue_delay_ms() << " ms, "
+              << sched_stats.completion_tokens << " tokens generated.\n";
+    if (auto cs = soul.cache_stats()) {
+        std::cout << "[HEAD] Response cache: " << cs->hits << " hits, " << cs->misses
+                  << " misses (" << static_cast<long>(cs->hit_rate() * 100) << "%), "
+                  << cs->audit_agree << "/" << cs->audits
+                  << " audited hits matched a fresh plan.\n";
+    }
+    if (auto ps = memory.prefetch_stats()) {
+        std::cout << "[HEAD] Recall prefetch: " << ps->completed << " recalls, "
+                  << ps->hits << " hits / " << ps->misses << " misses ("
+                  << static_cast<long>(ps->hit_rate() * 100) << "%), "
+                  << ps->wasted << " wasted, " << ps->dropped << " dropped.\n";
+    }
+    for (auto& b : soul.backend_stats()) {
+        std::cout << "[HEAD] Backend '" << b.name << "': " << b.requests
+                  << " requests, " << b.errors << " errors, rolling "
+                  << static_cast<long>(b.ewma_ms) << " ms, hedge wins "
+                  << b.hedge_wins << "/" << b.hedges << ".\n";
+    }
+
+    auto ss = body.stream_stats();
+    std::cout << "[HEAD] Percept stream: " << ss.keyframes << " keyframes, " << ss.deltas
+              << " deltas, " << ss.gaps << " gaps (" << ss.dropped << " deltas dropped awaiting "
+              << "a keyframe), " << ss.errors << " unreadable, " << ss.bytes / 1024 << " KiB.\n";
+
+    auto dec = arbiter.decisions();
+    std::cout << "[HEAD] Decisions: " << dec.reflex << " built-in reflex, " << dec.learned
+              << " learned reflex, " << dec.soul << " Soul ("
+              << static_cast<long>(dec.moved_to_lizard() * 100)
+              << "% moved from Soul to Lizard; " << lizard.learned_reflexes()
+              << " learned-rule hits).\n";
+    auto nv = novelty.stats();
+    const double hours = static_cast<double>(ms_since_boot()) / 3.6e6;
+    std::cout << "[HEAD] Novelty: " << nv.fired << " escalations ("
+              << static_cast<long>(static_cast<double>(nv.fired) / std::max(hours, 1e-9))
+              << "/h), " << nv.rate_limited << " held by the rate limit, mean hold "
+              << static_cast<long>(nv.mean_lag_ms()) << " ms; vibe checks: " << vibe_novel.load()
+              << " novel, " << vibe_quiet.load() << " quiet, " << vibe_merged.load()
+              << " merged into a running one.\n";
+    auto l1 = lizard.layer1_stats();
+    std::cout << "[HEAD] Layer 1: " << l1.model << " micro-model, " << l1.llm << " LLM path.\n";
+
+    auto sched = scheduler.stats();
+    std::cout << "[HEAD] Scheduler: " << sched.wakeups << " wakeups ("
+              << static_cast<long>(sched.wakeups_per_s()) << "/s), "
+              << sched.fired << " runs fired.\n";
+    for (auto& [name, t] : sched.tasks) {
+        std::cout << "[HEAD]   " << name << ": " << t.runs << " runs, " << t.late
+                  << " late (max " << static_cast<long>(t.max_late_ms) << " ms), "
+                  << t.missed << " missed, " << t.overlapped << " overlapped.\n";
+    }
+
+    event_log.close();
+    auto ev = event_log.stats();
+    std::cout << "[HEAD] Event log: " << ev.records << " records in " << ev.segments
+              << " segments (" << ev.stored_bytes / 1024 << " KiB on disk, "
+              << ev.raw_bytes / 1024 << " KiB raw), " << ev.dropped << " dropped.\n";
+
+    auto wd = watchdog.stats();
+    std::cout << "[HEAD] Reflex watchdog: " << wd.ticks << " ticks, " << wd.overruns
+              << " over the " << watchdog_cfg.budget.count() << " ms budget";
+    if (!wd.recent.empty()) {
+        auto& last = wd.recent.back();
+        std::cout << " (last: " << last.verdict << ", most CPU "
+                  << (last.holder.empty() ? "none" : last.holder) << ")";
+    }
+    std::cout << ".\n";
+
+    auto lg = prometheus::Logger::stats();
+    std::cout << "[HEAD] Log: " << lg.lines << " lines, " << lg.suppressed
+              << " suppressed by rate limits, " << lg.dropped << " dropped, "
+              << lg.rotations << " file rotations.\n";
 
     body.disconnect();
     std::cout << "[HEAD] Goodbye.\n";
@@ -0,0 +1,95 @@
+#include "memory/embed_pipeline.h"
+#include "memory/vector_index.h"   // content_hash
+
+#include <chrono>
+
+namespace prometheus {
+
+EmbeddingPipeline::EmbeddingPipeline(TextEmbedder& embedder, Config cfg)
+    : embedder_(embedder), cfg_(cfg) {
+    if (cfg_.batch_size == 0) cfg_.batch_size = 1;
+}
+
+const std::vector<float>* EmbeddingPipeline::cached(uint64_t hash) {
+    auto it = cache_.find(hash);
+    if (it == cache_.end()) return nullptr;
+    lru_.splice(lru_.begin(), lru_, it->second.lru);
+    return &it->second.vec;
+}
+
+void EmbeddingPipeline::remember(uint64_t hash, std::vector<float> v) {
+    if (cfg_.cache_entries == 0 || cache_.count(hash)) return;
+    lru_.push_front(hash);
+    cache_.emplace(hash, Entry{std::move(v), lru_.begin()});
+    while (cache_.size() > cfg_.cache_entries) {
+        cache_.erase(lru_.back());
+        lru_.pop_back();
+    }
+}
+
+std::vector<std::vector<float>> EmbeddingPipeline::embed(
+        const std::vector<std::string_view>& passages) {
+    std::vector<std::vector<float>> out(passages.size());
+
+    // Resolve from the cache; collect each distinct miss once.
+    std::vector<uint64_t> hashes(passages.size());
+    std::unordered_map<uint64_t, std::vector<size_t>> waiting;   // hash → output slots
+    std::vector<std::string_view> todo;
+    std::vector<uint64_t>         todo_hash;
+    {
+        std::lock_guard lock(mu_);
+        stats_.passages += passages.size();
+        for (size_t i = 0; i < passages.size(); ++i) {
+            hashes[i] = content_hash(passages[i]);
+            if (auto* v = cached(hashes[i])) {
+                out[i] = *v;
+                stats_.cache_hits += 1;
+                continue;
+            }
+            auto& slots = waiting[hashes[i]];
+            if (slots.empty()) {
+                todo.push_back(passages[i]);
+                todo_hash.push_back(hashes[i]);
+            } else {
+                stats_.duplicates += 1;
+            }
+            slots.push_back(i);
+        }
+    }
+
+    // Embed the misses in fixed-size batches so memory stays bounded. The
+    // embedder lock is taken per batch, so another caller's miss waits for
+    // one batch at most.
+    for (size_t b = 0; b < todo.size(); b += cfg_.batch_size) {
+        size_t e = std::min(todo.size(), b + cfg_.batch_size);
+        std::vector<std::string_view> batch(todo.begin() + b, todo.begin() + e);
+
+        std::vector<std::vector<float>> vecs;
+        double secs = 0;
+        {
+            std::lock_guard embed_lock(embed_mu_);
+            auto t0 = std::chrono::steady_clock::now();
+            vecs = embedder_.embed_batch(batch);
+            secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        }
+
+        std::lock_guard lock(mu_);
+        stats_.embed_s  += secs;
+        stats_.embedded += batch.size();
+        stats_.batches  += 1;
+
+        for (size_t j = 0; j < vecs.size() && b + j < e; ++j) {
+            uint64_t h = todo_hash[b + j];
+            for (size_t slot : waiting[h]) out[slot] = vecs[j];
+            remember(h, std::move(vecs[j]));
+        }
+    }
+    return out;
+}
+
+EmbeddingPipeline::Stats EmbeddingPipeline::stats() const {
+    std::lock_guard lock(mu_);
+    return stats_;
+}
+
+} // namespace prometheus
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "memory/embedder.h"
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace prometheus {
+
+// Batched front end to a TextEmbedder.
+// Duplicate passages (by content hash) are embedded once per call, and
+// recently embedded text is served from a bounded LRU cache, so repeated
+// markers and log lines cost nothing after the first time. Batches are
+// serialised — the embedder is never entered from two threads — but the
+// cache is locked separately, so a call served from it never waits
+// behind another call's batch.
+class EmbeddingPipeline {
+public:
+    struct Config {
+        size_t batch_size    = 32;     // passages per embed_batch call
+        size_t cache_entries = 4096;   // vectors kept (≈ dim × 4 bytes each)
+    };
+
+    struct Stats {
+        uint64_t passages{0};      // requested
+        uint64_t duplicates{0};    // repeats within a call
+        uint64_t cache_hits{0};
+        uint64_t embedded{0};      // sent to the embedder
+        uint64_t batches{0};
+        double   embed_s{0};       // time inside the embedder
+
+        double passages_per_s() const { return embed_s > 0 ? embedded / embed_s : 0.0; }
+    };
+
+    EmbeddingPipeline(TextEmbedder& embedder, Config cfg);
+
+    // One vector per passage, same order.
+    std::vector<std::vector<float>> embed(const std::vector<std::string_view>& passages);
+
+    Stats stats() const;
+    const TextEmbedder& embedder() const { return embedder_; }
+
+private:
+    struct Entry {
+        std::vector<float>            vec;
+        std::list<uint64_t>::iterator lru;
+    };
+
+    const std::vector<float>* cached(uint64_t hash);     // mu_ held
+    void remember(uint64_t hash, std::vector<float> v);  // mu_ held
+
+    TextEmbedder& embedder_;
+    Config        cfg_;
+
+    std::mutex embed_mu_;               // held across embed_batch
+
+    mutable std::mutex mu_;             // cache, LRU and stats
+    std::unordered_map<uint64_t, Entry> cache_;
+    std::list<uint64_t> lru_;           // front = most recent
+    Stats               stats_;
+};
+
+} // namespace prometheus
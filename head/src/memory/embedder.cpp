@@ -0,0 +1,230 @@
+#include "memory/embedder.h"
+#include "log/log.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cmath>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+#ifdef HAS_LLAMA
+#include "llama.h"
+#endif
+
+namespace prometheus {
+
+// FNV-1a; stable across runs, unlike std::hash.
+static uint64_t fnv1a(std::string_view s, uint64_t seed = 0xcbf29ce484222325ull) {
+    uint64_t h = seed;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+std::vector<float> HashEmbedder::embed(std::string_view text) const {
+    std::vector<float> v(static_cast<size_t>(dim_), 0.0f);
+
+    auto add = [&](std::string_view feature, float weight) {
+        uint64_t h = fnv1a(feature);
+        float sign = (h >> 63) ? -1.0f : 1.0f;
+        v[h % static_cast<uint64_t>(dim_)] += sign * weight;
+    };
+
+    // Words are alphanumeric runs, so "[MEM:LAVA_DEATH]" → lava, death.
+    std::string word;
+    auto flush = [&] {
+        if (word.empty()) return;
+        add(word, 1.0f);
+        std::string padded = " " + word + " ";
+        for (size_t i = 0; i + 3 <= padded.size(); ++i) {
+            add(std::string_view(padded).substr(i, 3), 0.5f);
+        }
+        word.clear();
+    };
+    for (unsigned char c : text) {
+        if (std::isalnum(c)) word += static_cast<char>(std::tolower(c));
+        else                 flush();
+    }
+    flush();
+
+    double norm = 0;
+    for (float x : v) norm += static_cast<double>(x) * x;
+    if (norm > 0) {
+        float inv = static_cast<float>(1.0 / std::sqrt(norm));
+        for (float& x : v) x *= inv;
+    }
+    return v;
+}
+
+std::vector<std::vector<float>> HashEmbedder::embed_batch(
+        const std::vector<std::string_view>& texts) {
+    std::vector<std::vector<float>> out;
+    out.reserve(texts.size());
+    for (auto t : texts) out.push_back(embed(t));
+    return out;
+}
+
+// ── LlamaEmbedder ───────────────────────────────────────────────
+
+#ifdef HAS_LLAMA
+
+struct LlamaEmbedder::Impl {
+    static constexpr int kBatchTokens = 4096;   // tokens per decode
+    static constexpr int kMaxSeqs     = 16;     // passages per decode
+    static constexpr int kMaxTokens   = 512;    // longer passages are truncated
+
+    llama_model*       model = nullptr;
+    llama_context*     ctx   = nullptr;
+    const llama_vocab* vocab = nullptr;
+    std::string        name;
+    int                dim{0};
+
+    std::vector<llama_token> tokenize(std::string_view text) const {
+        std::vector<llama_token> toks(kMaxTokens);
+        int n = llama_tokenize(vocab, text.data(), static_cast<int32_t>(text.size()),
+                               toks.data(), kMaxTokens, /*add_special=*/true,
+                               /*parse_special=*/false);
+        if (n < 0) {
+            // Too long: tokenise fully, then keep the head.
+            toks.resize(static_cast<size_t>(-n));
+            n = llama_tokenize(vocab, text.data(), static_cast<int32_t>(text.size()),
+                               toks.data(), -n, true, false);
+        }
+        toks.resize(static_cast<size_t>(std::clamp(n, 0, kMaxTokens)));
+        return toks;
+    }
+
+    // Decode up to kMaxSeqs tokenised passages at once and read back one
+    // pooled vector per sequence.
+    void decode(const std::vector<std::vector<llama_token>>& seqs,
+                std::vector<std::vector<float>>& out) {
+        llama_batch batch = llama_batch_init(kBatchTokens, 0, kMaxSeqs);
+        for (size_t s = 0; s < seqs.size(); ++s) {
+            for (size_t p = 0; p < seqs[s].size(); ++p) {
+                int i = batch.n_tokens++;
+                batch.token[i]     = seqs[s][p];
+                batch.pos[i]       = static_cast<llama_pos>(p);
+                batch.n_seq_id[i]  = 1;
+                batch.seq_id[i][0] = static_cast<llama_seq_id>(s);
+                batch.logits[i]    = true;
+            }
+        }
+
+        llama_memory_clear(llama_get_memory(ctx), true);
+        int rc = (llama_model_has_encoder(model) && !llama_model_has_decoder(model))
+                     ? llama_encode(ctx, batch)
+                     : llama_decode(ctx, batch);
+        for (size_t s = 0; s < seqs.size(); ++s) {
+            const float* e = rc == 0 ? llama_get_embeddings_seq(ctx, static_cast<llama_seq_id>(s))
+                                     : nullptr;
+            std::vector<float> v(static_cast<size_t>(dim), 0.0f);
+            if (e) {
+                double norm = 0;
+                for (int d = 0; d < dim; ++d) norm += static_cast<double>(e[d]) * e[d];
+                float inv = norm > 0 ? static_cast<float>(1.0 / std::sqrt(norm)) : 0.0f;
+                for (int d = 0; d < dim; ++d) v[d] = e[d] * inv;
+            }
+            out.push_back(std::move(v));
+        }
+        llama_batch_free(batch);
+        if (rc != 0) PROMETHEUS_LOG(Warn, "[MEMORY] Embedding decode failed ({}).", rc);
+    }
+};
+
+LlamaEmbedder::LlamaEmbedder() : impl_(std::make_unique<Impl>()) {}
+
+LlamaEmbedder::~LlamaEmbedder() {
+    if (impl_->ctx)   llama_free(impl_->ctx);
+    if (impl_->model) llama_model_free(impl_->model);
+}
+
+bool LlamaEmbedder::load(const std::string& model_path, int threads) {
+    llama_backend_init();
+
+    auto mparams = llama_model_default_params();
+    mparams.n_gpu_layers = 0;           // CPU: the GPU belongs to the Soul
+    impl_->model = llama_model_load_from_file(model_path.c_str(), mparams);
+    if (!impl_->model) {
+        PROMETHEUS_LOG(Error, "[MEMORY] Cannot load embedding model {}", model_path);
+        return false;
+    }
+
+    if (threads <= 0) threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency() / 2));
+    auto cparams = llama_context_default_params();
+    cparams.embeddings      = true;
+    cparams.pooling_type    = LLAMA_POOLING_TYPE_MEAN;
+    cparams.n_ctx           = Impl::kBatchTokens;
+    cparams.n_batch         = Impl::kBatchTokens;
+    cparams.n_ubatch        = Impl::kBatchTokens;   // non-causal models need whole sequences
+    cparams.n_seq_max       = Impl::kMaxSeqs;
+    cparams.n_threads       = threads;
+    cparams.n_threads_batch = threads;
+    impl_->ctx = llama_init_from_model(impl_->model, cparams);
+    if (!impl_->ctx) {
+        PROMETHEUS_LOG(Error, "[MEMORY] Cannot create embedding context.");
+        return false;
+    }
+
+    impl_->vocab = llama_model_get_vocab(impl_->model);
+    impl_->dim   = llama_model_n_embd(impl_->model);
+    impl_->name  = std::filesystem::path(model_path).stem().string();
+    PROMETHEUS_LOG(Info, "[MEMORY] Embedding model {} loaded (dim {}, {} threads).", impl_->name,
+                   impl_->dim, threads);
+    return true;
+}
+
+int LlamaEmbedder::dim() const { return impl_->dim; }
+
+std::string LlamaEmbedder::name() const { return impl_->name; }
+
+std::vector<std::vector<float>> LlamaEmbedder::embed_batch(
+        const std::vector<std::string_view>& texts) {
+    std::vector<std::vector<float>> out;
+    out.reserve(texts.size());
+
+    std::vector<std::vector<llama_token>> seqs;
+    int tokens = 0;
+    for (auto t : texts) {
+        auto toks = impl_->tokenize(t);
+        if (!seqs.empty() && (seqs.size() == Impl::kMaxSeqs ||
+                              tokens + static_cast<int>(toks.size()) > Impl::kBatchTokens)) {
+            impl_->decode(seqs, out);
+            seqs.clear();
+            tokens = 0;
+        }
+        tokens += static_cast<int>(toks.size());
+        seqs.push_back(std::move(toks));
+    }
+    if (!seqs.empty()) impl_->decode(seqs, out);
+    return out;
+}
+
+#else
+
+struct LlamaEmbedder::Impl {};
+
+LlamaEmbedder::LlamaEmbedder() : impl_(std::make_unique<Impl>()) {}
+LlamaEmbedder::~LlamaEmbedder() = default;
+
+bool LlamaEmbedder::load(const std::string& model_path, int threads) {
+    (void)threads;
+    PROMETHEUS_LOG(Warn, "[MEMORY] llama.cpp not linked — cannot load {}.", model_path);
+    return false;
+}
+
+int LlamaEmbedder::dim() const { return 0; }
+
+std::string LlamaEmbedder::name() const { return {}; }
+
+std::vector<std::vector<float>> LlamaEmbedder::embed_batch(
+        const std::vector<std::string_view>& texts) {
+    return std::vector<std::vector<float>>(texts.size());
+}
+
+#endif // HAS_LLAMA
+
+} // namespace prometheus
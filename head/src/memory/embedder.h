@@ -0,0 +1,67 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace prometheus {
+
+// Turns passages into unit vectors for the long-term index.
+// Implementations need not be thread-safe; EmbeddingPipeline serialises
+// access.
+class TextEmbedder {
+public:
+    virtual ~TextEmbedder() = default;
+
+    virtual int dim() const = 0;
+
+    // Names the vector space. Indexes built by different embedders are
+    // kept apart by this name.
+    virtual std::string name() const = 0;
+
+    // One vector per text, same order.
+    virtual std::vector<std::vector<float>> embed_batch(
+        const std::vector<std::string_view>& texts) = 0;
+};
+
+// Feature-hashing text embedder.
+// Lower-cased word tokens and their character trigrams are hashed into
+// signed buckets and L2-normalised. No model to load; good enough to
+// match markers like [MEM:LAVA_DEATH] to passages mentioning lava.
+class HashEmbedder : public TextEmbedder {
+public:
+    explicit HashEmbedder(int dim = 256) : dim_(dim) {}
+
+    std::vector<float> embed(std::string_view text) const;
+
+    int dim() const override { return dim_; }
+    std::string name() const override { return "hash-" + std::to_string(dim_); }
+    std::vector<std::vector<float>> embed_batch(
+        const std::vector<std::string_view>& texts) override;
+
+private:
+    int dim_;
+};
+
+// GGUF embedding model run in-process on the CPU through llama.cpp
+// (mean pooling, several passages per decode). Without HAS_LLAMA,
+// load() fails and callers fall back to HashEmbedder.
+class LlamaEmbedder : public TextEmbedder {
+public:
+    LlamaEmbedder();
+    ~LlamaEmbedder() override;
+
+    bool load(const std::string& model_path, int threads = 0);
+
+    int dim() const override;
+    std::string name() const override;
+    std::vector<std::vector<float>> embed_batch(
+        const std::vector<std::string_view>& texts) override;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace prometheus
@@ -0,0 +1,676 @@
+#include "memory/event_log.h"
+#include "log/byte_ring.h"
+#include "lizard/lizard.h"
+#include "soul/soul.h"
+
+#ifdef HAS_ZLIB
+#include <zlib.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace prometheus {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// ── On-disk format ──────────────────────────────────────────────
+// A segment is a sequence of blocks: BlockHeader, then stored_len bytes
+// of (possibly zlib-compressed) records. A record is
+//   u64 t_us | u8 kind | varint len | payload[len]
+
+constexpr uint32_t kBlockMagic = 0x31425645;   // "EVB1"
+
+struct BlockHeader {
+    uint32_t magic;
+    uint32_t raw_len;
+    uint32_t stored_len;
+    uint32_t count;
+    uint64_t t_min;
+    uint64_t t_max;
+    uint8_t  codec;        // 0 = raw, 1 = zlib
+    uint8_t  pad[7];
+};
+static_assert(sizeof(BlockHeader) == 40);
+
+template <typename T>
+void put(std::string& out, const T& v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof v);
+}
+
+template <typename T>
+bool get(std::string_view& in, T& v) {
+    if (in.size() < sizeof v) return false;
+    std::memcpy(&v, in.data(), sizeof v);
+    in.remove_prefix(sizeof v);
+    return true;
+}
+
+void put_varint(std::string& out, uint64_t v) {
+    while (v >= 0x80) {
+        out += static_cast<char>(v | 0x80);
+        v >>= 7;
+    }
+    out += static_cast<char>(v);
+}
+
+bool get_varint(std::string_view& in, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64 && !in.empty(); shift += 7) {
+        auto b = static_cast<uint8_t>(in.front());
+        in.remove_prefix(1);
+        v |= static_cast<uint64_t>(b & 0x7f) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+void encode_record(std::string& out, uint64_t t_us, EventKind kind, std::string_view payload) {
+    put(out, t_us);
+    put(out, static_cast<uint8_t>(kind));
+    put_varint(out, payload.size());
+    out.append(payload);
+}
+
+bool decode_record(std::string_view& in, Event& e) {
+    uint8_t  kind = 0;
+    uint64_t len  = 0;
+    if (!get(in, e.t_us) || !get(in, kind) || !get_varint(in, len) || in.size() < len) {
+        return false;
+    }
+    e.kind = static_cast<EventKind>(kind);
+    e.payload.assign(in.substr(0, len));
+    in.remove_prefix(len);
+    return true;
+}
+
+// Per-thread payload buffer for the producers; keeps its capacity, so
+// logging a percept or reflex does not allocate once warm.
+std::string& scratch() {
+    thread_local std::string buf;
+    buf.clear();
+    return buf;
+}
+
+uint64_t peek_time(std::string_view rec) {
+    uint64_t t = 0;
+    get(rec, t);
+    return t;
+}
+
+std::atomic<uint64_t> g_next_log_id{1};
+
+// Rings this thread produces into, one per EventLog instance.
+struct ThreadRings {
+    std::vector<std::pair<uint64_t, std::shared_ptr<ByteRing>>> rings;
+    ~ThreadRings() {
+        for (auto& r : rings) r.second->orphaned.store(true);
+    }
+};
+thread_local ThreadRings t_rings;
+
+std::string format_time(uint64_t t_us) {
+    std::time_t secs = static_cast<std::time_t>(t_us / 1000000);
+    std::tm tm{};
+    localtime_r(&secs, &tm);
+    char buf[32];
+    std::snprintf(buf, sizeof buf, "%02d:%02d:%02d.%03d", tm.tm_hour, tm.tm_min, tm.tm_sec,
+                  static_cast<int>(t_us / 1000 % 1000));
+    return buf;
+}
+
+} // namespace
+
+// ── Event ───────────────────────────────────────────────────────
+
+std::string Event::describe() const {
+    std::string_view in = payload;
+    std::string out = format_time(t_us) + " ";
+    char buf[160];
+
+    switch (kind) {
+    case EventKind::Percept: {
+        float hp = 0, food = 0, x = 0, y = 0, z = 0;
+        uint8_t hostile = 0;
+        uint16_t entities = 0;
+        get(in, hp); get(in, food); get(in, x); get(in, y); get(in, z);
+        get(in, hostile); get(in, entities);
+        std::snprintf(buf, sizeof buf,
+                      "PERCEPT hp=%.1f food=%.1f pos=(%.1f,%.1f,%.1f) hostile=%d entities=%d",
+                      hp, food, x, y, z, hostile, entities);
+        out += buf;
+        break;
+    }
+    case EventKind::Reflex: {
+        uint8_t layer = 0, veto = 0;
+        float urgency = 0;
+        get(in, layer); get(in, veto); get(in, urgency);
+        std::snprintf(buf, sizeof buf, "REFLEX L%d urgency=%.2f%s ", layer, urgency,
+                      veto ? " veto" : "");
+        out += buf;
+        out += in;
+        break;
+    }
+    case EventKind::Action: {
+        uint8_t source = 0;
+        get(in, source);
+        static const char* kSources[] = {"reflex", "plan", "override"};
+        out += "ACTION ";
+        out += source < 3 ? kSources[source] : "?";
+        out += ' ';
+        out += in;
+        break;
+    }
+    case EventKind::Plan: {
+        uint64_t id = 0;
+        uint8_t flags = 0;
+        uint32_t json_len = 0;
+        get(in, id); get(in, flags); get(in, json_len);
+        json_len = std::min<uint32_t>(json_len, static_cast<uint32_t>(in.size()));
+        out += "PLAN #" + std::to_string(id);
+        if (flags & 2) out += " [cached]";
+        if (flags & 1) out += " [override]";
+        out += ' ';
+        out += in.substr(0, json_len);
+        if (in.size() > json_len) {
+            out += " — ";
+            out += in.substr(json_len);
+        }
+        break;
+    }
+    case EventKind::Marker:
+        out += "MARKER ";
+        out += in;
+        break;
+    }
+    return out;
+}
+
+// ── Impl ────────────────────────────────────────────────────────
+
+struct EventLog::Impl {
+    struct BlockRef {
+        uint32_t segment;
+        uint64_t offset;
+        uint64_t t_min;
+        uint64_t t_max;
+    };
+
+    Config        cfg;
+    const uint64_t id = g_next_log_id.fetch_add(1);
+    std::string   dir;
+    std::atomic<bool> opened{false};
+
+    // Producers
+    std::mutex                         rings_mu;
+    std::vector<std::shared_ptr<ByteRing>> rings;
+    std::atomic<uint64_t>              dropped{0};
+
+    // Writer state
+    std::mutex    write_mu;
+    std::string   block;
+    uint32_t      block_count{0};
+    uint64_t      block_t_min{0};
+    uint64_t      block_t_max{0};
+    std::chrono::steady_clock::time_point block_started;
+    std::ofstream seg;
+    uint32_t      seg_no{0};
+    uint64_t      seg_size{0};
+
+    // Time index and stats
+    mutable std::mutex            index_mu;
+    std::vector<BlockRef>         blocks;
+    std::vector<std::pair<uint32_t, uint64_t>> segments;   // (number, bytes), oldest first
+    Stats                         stats;
+
+    std::thread             writer;
+    std::mutex              cv_mu;
+    std::condition_variable cv;
+    bool                    stop{false};
+
+    std::string segment_path(uint32_t n) const {
+        char name[32];
+        std::snprintf(name, sizeof name, "events-%06u.evl", n);
+        return dir + "/" + name;
+    }
+
+    ByteRing* ring() {
+        for (auto& [owner, r] : t_rings.rings) {
+            if (owner == id) return r.get();
+        }
+        auto r = std::make_shared<ByteRing>(cfg.ring_bytes);
+        {
+            std::lock_guard lock(rings_mu);
+            rings.push_back(r);
+        }
+        t_rings.rings.emplace_back(id, r);
+        return r.get();
+    }
+
+    void emit(EventKind kind, std::string_view payload) {
+        if (!opened.load(std::memory_order_relaxed)) return;
+        thread_local std::string rec;
+        rec.clear();
+        encode_record(rec, now_us(), kind, payload);
+        if (!ring()->push(rec)) dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Move everything in the producer rings into the current block,
+    // in time order. write_mu held.
+    void drain_locked() {
+        std::vector<std::shared_ptr<ByteRing>> snapshot;
+        {
+            std::lock_guard lock(rings_mu);
+            snapshot = rings;
+        }
+
+        std::vector<std::string> recs;
+        for (auto& r : snapshot) {
+            bool gone = r->orphaned.load();
+            r->drain([&](const std::string& rec) { recs.push_back(rec); });
+            if (gone) {
+                std::lock_guard lock(rings_mu);
+                rings.erase(std::remove(rings.begin(), rings.end(), r), rings.end());
+            }
+        }
+
+        std::stable_sort(recs.begin(), recs.end(),
+                         [](const std::string& a, const std::string& b) {
+                             return peek_time(a) < peek_time(b);
+                         });
+        for (auto& rec : recs) {
+            uint64_t t = peek_time(rec);
+            if (block_count == 0) {
+                block_started = std::chrono::steady_clock::now();
+                block_t_min = block_t_max = t;
+            }
+            block_t_min = std::min(block_t_min, t);
+            block_t_max = std::max(block_t_max, t);
+            block += rec;
+            block_count += 1;
+            if (block.size() >= cfg.block_bytes) write_block_locked();
+        }
+    }
+
+    void write_block_locked() {
+        if (block_count == 0 || !seg.is_open()) return;
+
+        BlockHeader h{};
+        h.magic   = kBlockMagic;
+        h.raw_len = static_cast<uint32_t>(block.size());
+        h.count   = block_count;
+        h.t_min   = block_t_min;
+        h.t_max   = block_t_max;
+
+        const std::string* body = &block;
+        std::string packed;
+#ifdef HAS_ZLIB
+        uLongf packed_len = compressBound(static_cast<uLong>(block.size()));
+        packed.resize(packed_len);
+        if (compress2(reinterpret_cast<Bytef*>(packed.data()), &packed_len,
+                      reinterpret_cast<const Bytef*>(block.data()),
+                      static_cast<uLong>(block.size()), Z_BEST_SPEED) == Z_OK &&
+            packed_len < block.size()) {
+            packed.resize(packed_len);
+            body    = &packed;
+            h.codec = 1;
+        }
+#endif
+        h.stored_len = static_cast<uint32_t>(body->size());
+
+        seg.write(reinterpret_cast<const char*>(&h), sizeof h);
+        seg.write(body->data(), static_cast<std::streamsize>(body->size()));
+        seg.flush();
+
+        {
+            std::lock_guard lock(index_mu);
+            blocks.push_back({seg_no, seg_size, h.t_min, h.t_max});
+            segments.back().second += sizeof h + body->size();
+            stats.records      += block_count;
+            stats.blocks       += 1;
+            stats.raw_bytes    += block.size();
+            stats.stored_bytes += body->size();
+        }
+        seg_size += sizeof h + body->size();
+        block.clear();
+        block_count = 0;
+
+        if (seg_size >= cfg.segment_bytes) {
+            seg.close();
+            open_segment_locked(seg_no + 1);
+            enforce_retention_locked();
+        }
+    }
+
+    void open_segment_locked(uint32_t n) {
+        seg_no   = n;
+        seg_size = 0;
+        seg.open(segment_path(n), std::ios::binary | std::ios::trunc);
+        std::lock_guard lock(index_mu);
+        segments.emplace_back(n, 0);
+        stats.segments = segments.size();
+    }
+
+    // Delete the oldest segments once the log outgrows max_bytes.
+    void enforce_retention_locked() {
+        std::lock_guard lock(index_mu);
+        uint64_t total = 0;
+        for (auto& s : segments) total += s.second;
+        while (total > cfg.max_bytes && segments.size() > 1) {
+            auto [n, bytes] = segments.front();
+            std::error_code ec;
+            fs::remove(segment_path(n), ec);
+            segments.erase(segments.begin());
+            blocks.erase(std::remove_if(blocks.begin(), blocks.end(),
+                                        [n = n](const BlockRef& b) { return b.segment == n; }),
+                         blocks.end());
+            total -= bytes;
+        }
+        stats.segments = segments.size();
+    }
+
+    // Index the blocks of an existing segment from their headers. A torn
+    // trailing block (crash mid-write) ends the scan.
+    void index_segment(uint32_t n) {
+        std::ifstream in(segment_path(n), std::ios::binary);
+        std::error_code ec;
+        const uint64_t size = fs::file_size(segment_path(n), ec);
+        uint64_t off = 0;
+        BlockHeader h{};
+        while (off + sizeof h <= size &&
+               in.read(reinterpret_cast<char*>(&h), sizeof h) &&
+               h.magic == kBlockMagic && off + sizeof h + h.stored_len <= size) {
+            blocks.push_back({n, off, h.t_min, h.t_max});
+            stats.records      += h.count;
+            stats.blocks       += 1;
+            stats.raw_bytes    += h.raw_len;
+            stats.stored_bytes += h.stored_len;
+            off += sizeof h + h.stored_len;
+            in.seekg(static_cast<std::streamoff>(off));
+        }
+        segments.emplace_back(n, size);
+    }
+
+    bool read_block(const BlockRef& b, std::vector<Event>& out,
+                    uint32_t kinds, uint64_t from, uint64_t to) const {
+        std::ifstream in(segment_path(b.segment), std::ios::binary);
+        BlockHeader h{};
+        if (!in.seekg(static_cast<std::streamoff>(b.offset)) ||
+            !in.read(reinterpret_cast<char*>(&h), sizeof h) || h.magic != kBlockMagic) {
+            return false;
+        }
+        std::string stored(h.stored_len, '\0');
+        if (!in.read(stored.data(), h.stored_len)) return false;
+
+        std::string raw;
+        if (h.codec == 0) {
+            raw = std::move(stored);
+        } else {
+#ifdef HAS_ZLIB
+            raw.resize(h.raw_len);
+            uLongf raw_len = h.raw_len;
+            if (uncompress(reinterpret_cast<Bytef*>(raw.data()), &raw_len,
+                           reinterpret_cast<const Bytef*>(stored.data()),
+                           h.stored_len) != Z_OK) {
+                return false;
+            }
+#else
+            return false;   // written by a build with zlib
+#endif
+        }
+
+        std::string_view in_view = raw;
+        Event e;
+        while (!in_view.empty() && decode_record(in_view, e)) {
+            if ((kinds & event_bit(e.kind)) && e.t_us >= from && e.t_us < to) {
+                out.push_back(e);
+            }
+        }
+        return true;
+    }
+
+    std::vector<BlockRef> overlapping(uint64_t from, uint64_t to) const {
+        std::lock_guard lock(index_mu);
+        std::vector<BlockRef> out;
+        for (auto& b : blocks) {
+            if (b.t_max >= from && b.t_min < to) out.push_back(b);
+        }
+        return out;
+    }
+
+    // What a reader sees: the sealed blocks overlapping [from, to) and, in
+    // `tail`, the matching records still in the open block. Taken together
+    // under write_mu, so a block sealed meanwhile is neither missed nor
+    // read twice. The open block stays open: sealing it early would leave
+    // small, poorly compressed blocks behind every query.
+    std::vector<BlockRef> snapshot(std::vector<Event>& tail, uint32_t kinds,
+                                   uint64_t from, uint64_t to) {
+        std::lock_guard lock(write_mu);
+        if (opened.load()) drain_locked();
+        if (block_count && block_t_max >= from && block_t_min < to) {
+            std::string_view in = block;
+            Event e;
+            while (!in.empty() && decode_record(in, e)) {
+                if ((kinds & event_bit(e.kind)) && e.t_us >= from && e.t_us < to) {
+                    tail.push_back(e);
+                }
+            }
+        }
+        return overlapping(from, to);
+    }
+
+    void writer_loop() {
+        const auto tick = std::max(std::chrono::milliseconds(10), cfg.flush_interval / 4);
+        std::unique_lock lk(cv_mu);
+        while (!stop) {
+            cv.wait_for(lk, tick, [&] { return stop; });
+            lk.unlock();
+            {
+                std::lock_guard lock(write_mu);
+                drain_locked();
+                if (block_count &&
+                    std::chrono::steady_clock::now() - block_started >= cfg.flush_interval) {
+                    write_block_locked();
+                }
+            }
+            lk.lock();
+        }
+    }
+};
+
+// ── EventLog ────────────────────────────────────────────────────
+
+EventLog::EventLog() : EventLog(Config{}) {}
+
+EventLog::EventLog(Config cfg) : impl_(std::make_unique<Impl>()) {
+    impl_->cfg = cfg;
+}
+
+EventLog::~EventLog() {
+    close();
+}
+
+uint64_t EventLog::now_us() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+bool EventLog::open(const std::string& dir) {
+    auto& m = *impl_;
+    if (m.opened.load()) return true;
+
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (!fs::is_directory(dir, ec)) {
+        std::cerr << "[EVENTS] Cannot create " << dir << "\n";
+        return false;
+    }
+    m.dir = dir;
+
+    // Existing segments, oldest first.
+    std::vector<uint32_t> existing;
+    for (auto& entry : fs::directory_iterator(dir, ec)) {
+        unsigned n = 0;
+        if (std::sscanf(entry.path().filename().c_str(), "events-%u.evl", &n) == 1) {
+            existing.push_back(n);
+        }
+    }
+    std::sort(existing.begin(), existing.end());
+
+    std::lock_guard wlock(m.write_mu);
+    {
+        std::lock_guard lock(m.index_mu);
+        for (uint32_t n : existing) m.index_segment(n);
+    }
+    // Always start a fresh segment; a torn tail in the last one stays put.
+    m.open_segment_locked(existing.empty() ? 1 : existing.back() + 1);
+    if (!m.seg.is_open()) {
+        std::cerr << "[EVENTS] Cannot open " << m.segment_path(m.seg_no) << "\n";
+        return false;
+    }
+    m.enforce_retention_locked();
+
+    m.stop = false;
+    m.opened.store(true);
+    m.writer = std::thread([&m] { m.writer_loop(); });
+
+    auto st = stats();
+    std::cout << "[EVENTS] Log open at " << dir << " (" << st.records << " records in "
+              << st.segments << " segments).\n";
+    return true;
+}
+
+void EventLog::close() {
+    auto& m = *impl_;
+    if (!m.opened.exchange(false)) return;
+    {
+        std::lock_guard lk(m.cv_mu);
+        m.stop = true;
+    }
+    m.cv.notify_all();
+    if (m.writer.joinable()) m.writer.join();
+
+    std::lock_guard lock(m.write_mu);
+    m.drain_locked();
+    m.write_block_locked();
+    m.seg.close();
+}
+
+// ── Producers ───────────────────────────────────────────────────
+
+void EventLog::percept(const Percept& p) {
+    std::string& payload = scratch();
+    put(payload, p.health);
+    put(payload, p.hunger);
+    put(payload, p.x);
+    put(payload, p.y);
+    put(payload, p.z);
+    put(payload, static_cast<uint8_t>(p.hostile_nearby));
+    put(payload, static_cast<uint16_t>(std::clamp(p.entity_count, 0, 65535)));
+    // Nearest hostile / nearest entity, for distilling Layer 1 offline
+    // (scripts/train_micro_model.py). Older records end before these.
+    float nearest = 32.0f, nearest_hostile = 32.0f;
+    for (auto& e : p.entities) {
+        nearest = std::min(nearest, e.distance);
+        if (e.hostile) nearest_hostile = std::min(nearest_hostile, e.distance);
+    }
+    put(payload, nearest_hostile);
+    put(payload, nearest);
+    impl_->emit(EventKind::Percept, payload);
+}
+
+void EventLog::reflex(const Reflex& r) {
+    std::string& payload = scratch();
+    put(payload, static_cast<uint8_t>(r.layer));
+    put(payload, static_cast<uint8_t>(r.vetoes_soul));
+    put(payload, r.urgency);
+    payload += r.action_json;
+    impl_->emit(EventKind::Reflex, payload);
+}
+
+void EventLog::action(std::string_view action_json, ActionSource source) {
+    std::string& payload = scratch();
+    put(payload, static_cast<uint8_t>(source));
+    payload += action_json;
+    impl_->emit(EventKind::Action, payload);
+}
+
+void EventLog::plan(const SoulPlan& plan) {
+    std::string payload;
+    put(payload, plan.query_id);
+    put(payload, static_cast<uint8_t>((plan.override_safety ? 1 : 0) | (plan.cached ? 2 : 0)));
+    put(payload, static_cast<uint32_t>(plan.action_json.size()));
+    payload += plan.action_json;
+    payload += plan.reasoning;
+    impl_->emit(EventKind::Plan, payload);
+}
+
+void EventLog::marker(std::string_view marker) {
+    impl_->emit(EventKind::Marker, marker);
+}
+
+// ── Readers ─────────────────────────────────────────────────────
+
+void EventLog::flush() {
+    auto& m = *impl_;
+    if (!m.opened.load()) return;
+    std::lock_guard lock(m.write_mu);
+    m.drain_locked();
+    m.write_block_locked();
+}
+
+std::vector<Event> EventLog::query(uint64_t from_us, uint64_t to_us, uint32_t kinds) {
+    std::vector<Event> tail;
+    auto refs = impl_->snapshot(tail, kinds, from_us, to_us);
+
+    std::vector<Event> out;
+    for (auto& b : refs) impl_->read_block(b, out, kinds, from_us, to_us);
+    out.insert(out.end(), std::make_move_iterator(tail.begin()),
+               std::make_move_iterator(tail.end()));
+    std::stable_sort(out.begin(), out.end(),
+                     [](const Event& a, const Event& b) { return a.t_us < b.t_us; });
+    return out;
+}
+
+std::optional<Event> EventLog::last(EventKind kind, std::string_view needle,
+                                    uint64_t before_us) {
+    std::vector<Event> events;
+    auto refs = impl_->snapshot(events, event_bit(kind), 0, before_us);
+
+    // The open block holds the newest records; then sealed blocks, newest first.
+    std::optional<Event> best;
+    auto scan = [&] {
+        for (auto e = events.rbegin(); e != events.rend(); ++e) {
+            if (best && e->t_us <= best->t_us) continue;
+            if (e->describe().find(needle) != std::string::npos) best = std::move(*e);
+        }
+    };
+    scan();
+    for (auto it = refs.rbegin(); it != refs.rend(); ++it) {
+        if (best && it->t_max <= best->t_us) continue;   // can't beat what we have
+        events.clear();
+        impl_->read_block(*it, events, event_bit(kind), 0, before_us);
+        scan();
+    }
+    return best;
+}
+
+EventLog::Stats EventLog::stats() const {
+    std::lock_guard lock(impl_->index_mu);
+    Stats s   = impl_->stats;
+    s.dropped = impl_->dropped.load();
+    return s;
+}
+
+} // namespace prometheus
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace prometheus {
+
+struct Percept;
+struct Reflex;
+struct SoulPlan;
+
+enum class EventKind : uint8_t {
+    Percept = 1,
+    Reflex  = 2,
+    Action  = 3,    // dispatched to the body
+    Plan    = 4,    // Soul plan accepted by the Arbiter
+    Marker  = 5,
+};
+
+// Which deliberation layer produced a dispatched action.
+enum class ActionSource : uint8_t {
+    Reflex   = 0,
+    Plan     = 1,
+    Override = 2,   // Soul plan that overrode a Layer 0 veto
+};
+
+constexpr uint32_t event_bit(EventKind k) { return 1u << static_cast<uint8_t>(k); }
+inline constexpr uint32_t kAllEvents = ~0u;
+
+// One decoded record. `payload` is the kind-specific binary encoding;
+// describe() renders it as a single line of text.
+struct Event {
+    uint64_t    t_us{0};        // wall clock, µs since the epoch
+    EventKind   kind{EventKind::Marker};
+    std::string payload;
+
+    std::string describe() const;
+};
+
+// Append-only session event log — the day's record of percepts, reflexes,
+// dispatched actions, Soul plans and markers.
+//
+// Producers write compact binary records into a per-thread SPSC ring and
+// never block; a full ring drops the record and counts it. A background
+// writer drains the rings, orders records by time and appends them as
+// zlib-compressed blocks to size-rotated segment files. Block headers
+// carry their time range and are indexed in memory, so range queries
+// decompress only the blocks they overlap.
+class EventLog {
+public:
+    struct Config {
+        size_t ring_bytes    = 256 * 1024;        // per producer thread
+        size_t block_bytes   = 64 * 1024;         // raw bytes per compressed block
+        size_t segment_bytes = 8 * 1024 * 1024;   // rotate after this much
+        size_t max_bytes     = 1024ull << 20;     // oldest segments deleted beyond this
+        std::chrono::milliseconds flush_interval{1000};  // max age of unwritten records
+    };
+
+    struct Stats {
+        uint64_t records{0};        // written to segments
+        uint64_t dropped{0};        // producer ring full
+        uint64_t blocks{0};
+        uint64_t raw_bytes{0};
+        uint64_t stored_bytes{0};   // after compression
+        uint64_t segments{0};
+    };
+
+    EventLog();
+    explicit EventLog(Config cfg);
+    ~EventLog();
+
+    EventLog(const EventLog&)            = delete;
+    EventLog& operator=(const EventLog&) = delete;
+
+    // Open (or create) the log directory, index existing segments and
+    // start the writer. Returns false if the directory is unusable.
+    bool open(const std::string& dir);
+
+    // Stop the writer and write everything still buffered.
+    void close();
+
+    // ── Producers (any thread, lock-free) ───────────────────────
+    void percept(const Percept& p);
+    void reflex(const Reflex& r);
+    void action(std::string_view action_json, ActionSource source);
+    void plan(const SoulPlan& plan);
+    void marker(std::string_view marker);
+
+    // ── Readers ─────────────────────────────────────────────────
+    // Write out everything buffered so far.
+    void flush();
+
+    // Events with from_us <= t < to_us whose kind is in `kinds`, in time
+    // order. Includes records not yet written out, without sealing the
+    // block being filled.
+    std::vector<Event> query(uint64_t from_us, uint64_t to_us, uint32_t kinds = kAllEvents);
+
+    // The newest event of `kind` before `before_us` whose description
+    // contains `needle` — e.g. last(Marker, "NEAR_DEATH"). Searches
+    // newest blocks first.
+    std::optional<Event> last(EventKind kind, std::string_view needle,
+                              uint64_t before_us = UINT64_MAX);
+
+    Stats stats() const;
+
+    static uint64_t now_us();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace prometheus
@@ -1,59 +1,249 @@
 #include "memory/memory.h"
+#include "log/log.h"
+#include "metrics/metrics.h"
 
 #include <algorithm>
-#include <iostream>
-#include <sstream>
+#include <chrono>
+#include <string_view>
 
 namespace prometheus {
 
-static constexpr size_t kMaxMarkers = 64;
+// ── Metrics ─────────────────────────────────────────────────────
+namespace {
+struct MemoryMetrics {
+    Counter&   tags         = metrics().counter("head_memory_tags_total",
+                                                "Short-term markers tagged (consecutive repeats excluded).");
+    Gauge&     markers      = metrics().gauge("head_memory_markers",
+                                              "Short-term markers in the rolling context.");
+    Histogram& recall       = metrics().histogram("head_memory_recall_seconds",
+                                                  "Long-term recall (embed + index search) latency.");
+    Histogram& consolidate  = metrics().histogram("head_memory_consolidate_seconds",
+                                                  "Memory::consolidate latency per call.");
+    Counter&   consolidated = metrics().counter("head_memory_passages_added_total",
+                                                "Passages added to the long-term index.");
+    Counter&   add_failed   = metrics().counter("head_memory_passages_failed_total",
+                                                "Passages the long-term index could not store.");
+};
 
-void Memory::init() {
-    std::cout << "[MEMORY] Initialised (short-term: in-process, "
-                 "long-term: ChromaDB stub).\n";
+MemoryMetrics& memory_metrics() {
+    static MemoryMetrics m;
+    return m;
 }
+} // namespace
 
-void Memory::tag(const std::string& marker) {
+Memory::Memory()
+    : rendered_(std::make_shared<const Snapshot>()) {
+    memory_metrics();       // register the series before the first scrape
+}
+
+Memory::~Memory() = default;
+
+void Memory::init(const std::string& store_dir, const std::string& embed_model) {
+    if (!embed_model.empty()) {
+        auto llama = std::make_unique<LlamaEmbedder>();
+        if (llama->load(embed_model)) embedder_ = std::move(llama);
+    }
+    if (!embedder_) embedder_ = std::make_unique<HashEmbedder>();
+    pipeline_ = std::make_unique<EmbeddingPipeline>(*embedder_, EmbeddingPipeline::Config{});
+
+    if (!store_dir.empty()) {
+        VectorIndex::Config cfg;
+        cfg.dim = embedder_->dim();
+        index_  = std::make_unique<VectorIndex>(cfg);
+        if (!index_->open(store_dir + "/" + embedder_->name())) index_.reset();
+    }
+    if (!index_) {
+        PROMETHEUS_LOG(Info, "[MEMORY] Initialised (short-term only, no long-term store).");
+        return;
+    }
+    prefetch_ = std::make_unique<RecallPrefetcher>(
+        [this](const std::string& marker) { return recall(marker); },
+        RecallPrefetcher::Config{});
+    PROMETHEUS_LOG(Info, "[MEMORY] Initialised (short-term: in-process, long-term: {} passages, {}).",
+                   index_->size(), embedder_->name());
+}
+
+uint32_t Memory::intern(const std::string& marker) {
+    auto [it, inserted] = ids_.try_emplace(marker, static_cast<uint32_t>(names_.size()));
+    if (inserted) names_.push_back(marker);
+    return it->second;
+}
+
+void Memory::publish() {
+    auto snap = std::make_shared<Snapshot>();
+    snap->generation = ++generation_;
+
+    size_t len = 0;
+    for (size_t i = 0; i < count_; ++i) {
+        len += names_[ring_[(head_ + i) % kMaxMarkers]].size() + 1;
+    }
+    snap->text.reserve(len);
+    for (size_t i = 0; i < count_; ++i) {
+        if (i) snap->text += ' ';
+        snap->text += names_[ring_[(head_ + i) % kMaxMarkers]];
+    }
+
+    rendered_.store(std::move(snap), std::memory_order_release);
+}
+
+Memory::MarkerId Memory::marker_id(const std::string& marker) {
     std::lock_guard lock(mu_);
+    return intern(marker);
+}
+
+bool Memory::push(uint32_t id) {
     // Deduplicate consecutive identical markers.
-    if (!markers_.empty() && markers_.back() == marker) return;
+    if (count_ && ring_[(head_ + count_ - 1) % kMaxMarkers] == id) return false;
 
-    markers_.push_back(marker);
+    // Sliding window — overwrite the oldest when full.
+    if (count_ < kMaxMarkers) {
+        ring_[(head_ + count_) % kMaxMarkers] = id;
+        ++count_;
+    } else {
+        ring_[head_] = id;
+        head_ = (head_ + 1) % kMaxMarkers;
+    }
+    publish();
+    memory_metrics().markers.set(static_cast<double>(count_));
+    return true;
+}
 
-    // Sliding window — drop oldest when limit exceeded.
-    if (markers_.size() > kMaxMarkers) {
-        markers_.erase(markers_.begin());
+void Memory::tag(const std::string& marker) {
+    {
+        std::lock_guard lock(mu_);
+        if (!push(intern(marker))) return;
     }
+    tagged(marker);
 }
 
-std::string Memory::active_markers() const {
-    std::lock_guard lock(mu_);
-    std::ostringstream ss;
-    for (size_t i = 0; i < markers_.size(); ++i) {
-        if (i) ss << ' ';
-        ss << markers_[i];
+void Memory::tag(MarkerId id) {
+    std::string marker;
+    {
+        std::lock_guard lock(mu_);
+        if (id >= names_.size() || !push(id)) return;
+        marker = names_[id];
     }
-    return ss.str();
+    tagged(marker);
+}
+
+void Memory::tagged(const std::string& marker) {
+    memory_metrics().tags.inc();
+
+    if (auto* log = event_log_.load()) log->marker(marker);
+
+    // Start fetching related passages before anyone asks for them.
+    if (prefetch_) prefetch_->request(marker);
+}
+
+std::string Memory::active_markers() const {
+    return snapshot()->text;
+}
+
+std::shared_ptr<const Memory::Snapshot> Memory::snapshot() const {
+    return rendered_.load(std::memory_order_acquire);
 }
 
 std::vector<std::string> Memory::recall(const std::string& marker) const {
-    (void)marker;
-    // TODO: Query ChromaDB via HTTP.
-    // curl POST http://localhost:8000/api/v1/collections/<id>/query
-    // { "query_texts": [marker], "n_results": 3 }
-    return {};
+    if (!index_) return {};
+    ScopedTimer timer(&memory_metrics().recall);
+    std::vector<std::string> out;
+    auto query = pipeline_->embed({marker});
+    for (auto& hit : index_->search(query.front(), kRecallK)) {
+        if (hit.distance > kMaxRecallDist) break;
+        out.push_back(std::move(hit.text));
+    }
+    return out;
+}
+
+std::vector<std::string> Memory::prefetched(const std::string& marker) const {
+    if (!prefetch_) return {};
+    return prefetch_->ready(marker).value_or(std::vector<std::string>{});
+}
+
+std::optional<RecallPrefetcher::Stats> Memory::prefetch_stats() const {
+    if (!prefetch_) return std::nullopt;
+    return prefetch_->stats();
+}
+
+// Split a log into passages: one per line, with lines longer than
+// `max` broken at whitespace.
+static std::vector<std::string_view> split_passages(std::string_view log, size_t max) {
+    std::vector<std::string_view> out;
+    while (!log.empty()) {
+        size_t len = std::min(log.find('\n'), log.size());
+        if (len > max) {
+            len = log.rfind(' ', max);
+            if (len == std::string_view::npos || len == 0) len = max;
+        }
+        auto p = log.substr(0, len);
+        log.remove_prefix(std::min(log.size(), len + 1));
+        if (p.find_first_not_of(" \t") != std::string_view::npos) out.push_back(p);
+    }
+    return out;
+}
+
+size_t Memory::consolidate(std::string_view text) {
+    if (!index_) return 0;
+    ScopedTimer timer(&memory_metrics().consolidate);
+
+    // Passages already in the index are skipped before embedding; repeats
+    // within the text are embedded once by the pipeline and stored once.
+    auto passages = split_passages(text, kPassageChars);
+    size_t added = 0, failed = 0;
+    for (size_t b = 0; b < passages.size(); b += kConsolidateChunk) {
+        std::vector<std::string_view> chunk;
+        for (size_t i = b; i < std::min(passages.size(), b + kConsolidateChunk); ++i) {
+            if (!index_->contains(passages[i])) chunk.push_back(passages[i]);
+        }
+        auto vecs = pipeline_->embed(chunk);
+        for (size_t i = 0; i < chunk.size(); ++i) {
+            if (index_->contains(chunk[i])) continue;
+            if (index_->add(vecs[i], chunk[i]) == VectorIndex::kNone) ++failed;
+            else                                                      ++added;
+        }
+    }
+    memory_metrics().consolidated.inc(added);
+    if (failed) {
+        memory_metrics().add_failed.inc(failed);
+        PROMETHEUS_LOG(Warn, "[MEMORY] {} of {} passages could not be added to the long-term index.",
+                       failed, added + failed);
+    }
+    return added;
+}
+
+void Memory::sync_long_term() {
+    if (index_) index_->sync();
 }
 
 void Memory::flush_log(const std::string& log_text) {
-    (void)log_text;
-    // TODO: Write to disk + upsert into ChromaDB for long-term recall.
-    std::cout << "[MEMORY] Log flushed (" << log_text.size() << " bytes).\n";
+    if (!index_) {
+        PROMETHEUS_LOG(Info, "[MEMORY] Log flushed ({} bytes, no long-term store).", log_text.size());
+        return;
+    }
+    auto t0     = std::chrono::steady_clock::now();
+    auto before = pipeline_->stats();
+
+    size_t added = consolidate(log_text);
+    sync_long_term();
+
+    auto after = pipeline_->stats();
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    uint64_t embedded = after.embedded - before.embedded;
+    double   embed_s  = after.embed_s - before.embed_s;
+    PROMETHEUS_LOG(Info, "[MEMORY] Log flushed ({} bytes, {} new passages, {} embedded at {} "
+                   "passages/s, {} ms; {} total).",
+                   log_text.size(), added, embedded,
+                   static_cast<int>(embed_s > 0 ? embedded / embed_s : 0.0),
+                   static_cast<int>(wall * 1000), index_->size());
 }
 
 void Memory::clear_short_term() {
     std::lock_guard lock(mu_);
-    markers_.clear();
-    std::cout << "[MEMORY] Short-term markers cleared.\n";
+    head_  = 0;
+    count_ = 0;
+    publish();
+    memory_metrics().markers.set(0);
+    PROMETHEUS_LOG(Info, "[MEMORY] Short-term markers cleared.");
 }
 
 } // namespace prometheus
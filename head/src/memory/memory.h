@@ -1,37 +1,122 @@
 #pragma once
 
+#include "memory/embed_pipeline.h"
+#include "memory/embedder.h"
+#include "memory/event_log.h"
+#include "memory/recall_prefetcher.h"
+#include "memory/vector_index.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace prometheus {
 
 // Memory subsystem — two tiers:
 //   Short-term: in-context "Memory Markers" (e.g. [MEM:LAVA_DEATH]).
-//   Long-term:  vector DB (ChromaDB) for full-text retrieval on marker hit.
+//   Long-term:  embedded HNSW index of past session passages, searched
+//               on marker hit (see VectorIndex).
+//
+// Short-term markers are interned to small integer IDs and kept in a
+// fixed ring. Every change bumps a generation counter and republishes the
+// rendered marker string through an atomic shared_ptr, so readers never
+// take the lock.
 class Memory {
 public:
-    void init();
+    static constexpr size_t kMaxMarkers = 64;
+
+    // Rendered short-term context at one generation.
+    struct Snapshot {
+        uint64_t    generation{0};
+        std::string text;           // markers separated by single spaces
+    };
+
+    static constexpr size_t kRecallK          = 3;
+    static constexpr size_t kPassageChars     = 512;
+    static constexpr size_t kConsolidateChunk = 256;   // passages per embed/insert round
+    static constexpr float  kMaxRecallDist    = 0.85f; // 1 − cosine; beyond is noise
+
+    Memory();
+    ~Memory();
 
-    // Add a short-term marker to the rolling context.
+    // Open the long-term store in `store_dir`; empty keeps it disabled.
+    // `embed_model` names a GGUF embedding model; if it is empty or fails
+    // to load, passages are embedded with HashEmbedder. Each embedder gets
+    // its own index under store_dir, since their vector spaces differ.
+    void init(const std::string& store_dir = "", const std::string& embed_model = "");
+
+    // Record new markers in the session event log as well.
+    void attach_event_log(EventLog* log) { event_log_.store(log); }
+
+    // Add a short-term marker to the rolling context. With a long-term
+    // store, a new marker also queues a speculative recall.
     void tag(const std::string& marker);
 
+    // Hot paths intern their marker once and tag by ID: re-tagging the
+    // newest marker then costs a lock and a compare, with no string built
+    // or hashed. IDs stay valid for the Memory's lifetime.
+    using MarkerId = uint32_t;
+    MarkerId marker_id(const std::string& marker);
+    void     tag(MarkerId id);
+
     // Return all active markers as a single string for prompt injection.
     std::string active_markers() const;
 
-    // Search the long-term store for entries matching a marker.
-    // Returns full text passages (ChromaDB query, stubbed).
+    // Lock-free access to the current rendering (no string copy).
+    std::shared_ptr<const Snapshot> snapshot() const;
+
+    // Search the long-term store for passages matching a marker.
+    // Returns up to kRecallK passages, closest first.
     std::vector<std::string> recall(const std::string& marker) const;
 
-    // Persist the current session log (called during Sleep Cycle).
+    // Passages a speculative recall has already staged for `marker`;
+    // empty if none are ready. Never searches the index itself.
+    std::vector<std::string> prefetched(const std::string& marker) const;
+    std::optional<RecallPrefetcher::Stats> prefetch_stats() const;
+
+    // Split text into passages and add the new ones to the long-term
+    // index. Returns the number added; call sync_long_term() to persist.
+    size_t consolidate(std::string_view text);
+    void   sync_long_term();
+
+    // Persist a whole session log in one go: consolidate, sync and report.
     void flush_log(const std::string& log_text);
 
     // Clear short-term markers (called on wake).
     void clear_short_term();
 
 private:
+    uint32_t intern(const std::string& marker);   // mu_ held
+    bool     push(uint32_t id);                   // mu_ held; false if a repeat
+    void     publish();                           // mu_ held
+    void     tagged(const std::string& marker);   // after a new marker, unlocked
+
     mutable std::mutex mu_;
-    std::vector<std::string> markers_;
+
+    // Interned marker strings; IDs are indices into names_.
+    std::unordered_map<std::string, uint32_t> ids_;
+    std::vector<std::string>                  names_;
+
+    // Ring of marker IDs, oldest at head_.
+    std::array<uint32_t, kMaxMarkers> ring_{};
+    size_t   head_{0};
+    size_t   count_{0};
+    uint64_t generation_{0};
+
+    std::atomic<std::shared_ptr<const Snapshot>> rendered_;
+    std::atomic<EventLog*>                       event_log_{nullptr};
+
+    std::unique_ptr<TextEmbedder>      embedder_;
+    std::unique_ptr<EmbeddingPipeline> pipeline_;
+    std::unique_ptr<VectorIndex>       index_;   // null without a store
+    std::unique_ptr<RecallPrefetcher>  prefetch_; // declared last: stops first
 };
 
 } // namespace prometheus
@@ -0,0 +1,111 @@
+#include "memory/recall_prefetcher.h"
+
+#include <algorithm>
+
+namespace prometheus {
+
+RecallPrefetcher::RecallPrefetcher(RecallFn recall, Config cfg)
+    : recall_(std::move(recall)), cfg_(cfg) {
+    worker_ = std::thread([this] { run(); });
+}
+
+RecallPrefetcher::~RecallPrefetcher() {
+    {
+        std::lock_guard lock(mu_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+}
+
+bool RecallPrefetcher::request(const std::string& marker) {
+    std::unique_lock lock(mu_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        contended_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    stats_.requested += 1;
+
+    auto now = std::chrono::steady_clock::now();
+    if (auto it = ready_.find(marker); it != ready_.end() && now - it->second.staged_at < cfg_.ttl) {
+        stats_.deduped += 1;
+        return true;
+    }
+    if (std::find(queue_.begin(), queue_.end(), marker) != queue_.end()) {
+        stats_.deduped += 1;
+        return true;
+    }
+
+    // Newest tags matter most: make room by dropping the oldest request.
+    if (queue_.size() >= cfg_.queue_capacity) {
+        queue_.pop_front();
+        stats_.dropped += 1;
+    }
+    queue_.push_back(marker);
+    lock.unlock();
+    cv_.notify_one();
+    return true;
+}
+
+std::optional<std::vector<std::string>> RecallPrefetcher::ready(const std::string& marker) {
+    std::lock_guard lock(mu_);
+    auto it = ready_.find(marker);
+    if (it == ready_.end() ||
+        std::chrono::steady_clock::now() - it->second.staged_at >= cfg_.ttl) {
+        stats_.misses += 1;
+        return std::nullopt;
+    }
+    stats_.hits += 1;
+    it->second.used = true;
+    return it->second.passages;
+}
+
+void RecallPrefetcher::evict_locked() {
+    auto now = std::chrono::steady_clock::now();
+    for (auto it = ready_.begin(); it != ready_.end();) {
+        if (now - it->second.staged_at >= cfg_.ttl) {
+            if (!it->second.used) stats_.wasted += 1;
+            it = ready_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    while (ready_.size() > cfg_.ready_entries) {
+        auto oldest = std::min_element(ready_.begin(), ready_.end(),
+            [](const auto& a, const auto& b) { return a.second.staged_at < b.second.staged_at; });
+        if (!oldest->second.used) stats_.wasted += 1;
+        ready_.erase(oldest);
+    }
+}
+
+void RecallPrefetcher::run() {
+    std::unique_lock lock(mu_);
+    while (true) {
+        cv_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+        if (stop_) return;
+
+        std::string marker = std::move(queue_.front());
+        queue_.pop_front();
+
+        lock.unlock();
+        auto passages = recall_(marker);
+        lock.lock();
+
+        stats_.completed += 1;
+        auto& e = ready_[marker];
+        if (!e.passages.empty() && !e.used) stats_.wasted += 1;   // superseded unused
+        e.passages  = std::move(passages);
+        e.staged_at = std::chrono::steady_clock::now();
+        e.used      = false;
+        evict_locked();
+    }
+}
+
+RecallPrefetcher::Stats RecallPrefetcher::stats() const {
+    std::lock_guard lock(mu_);
+    Stats s = stats_;
+    s.dropped += contended_.load(std::memory_order_relaxed);
+    return s;
+}
+
+} // namespace prometheus
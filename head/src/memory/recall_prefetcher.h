@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace prometheus {
+
+// Speculative long-term recall.
+// Memory::tag requests a recall for each new marker; a background worker
+// runs it and stages the passages in a small ready-cache, so the Soul's
+// prompt builder can attach them without waiting on the index.
+//
+// request() never blocks: if the queue lock is contended or the queue is
+// full, the request (or the oldest queued one) is dropped and counted.
+class RecallPrefetcher {
+public:
+    using RecallFn = std::function<std::vector<std::string>(const std::string&)>;
+
+    struct Config {
+        size_t               queue_capacity = 16;
+        size_t               ready_entries  = 32;
+        std::chrono::seconds ttl{120};          // staged results go stale after this
+    };
+
+    struct Stats {
+        uint64_t requested{0};
+        uint64_t dropped{0};     // queue full or contended
+        uint64_t deduped{0};     // already queued or staged
+        uint64_t completed{0};   // recalls run
+        uint64_t hits{0};        // ready() found staged passages
+        uint64_t misses{0};
+        uint64_t wasted{0};      // staged, then evicted or expired unused
+
+        double hit_rate() const {
+            uint64_t n = hits + misses;
+            return n ? static_cast<double>(hits) / n : 0.0;
+        }
+        double waste_rate() const {
+            return completed ? static_cast<double>(wasted) / completed : 0.0;
+        }
+    };
+
+    RecallPrefetcher(RecallFn recall, Config cfg);
+    ~RecallPrefetcher();
+
+    RecallPrefetcher(const RecallPrefetcher&)            = delete;
+    RecallPrefetcher& operator=(const RecallPrefetcher&) = delete;
+
+    // Queue a recall for `marker`. Returns false if it was dropped.
+    bool request(const std::string& marker);
+
+    // Staged passages for `marker`, if its recall has finished and is
+    // still fresh. Never runs a recall itself.
+    std::optional<std::vector<std::string>> ready(const std::string& marker);
+
+    Stats stats() const;
+
+private:
+    struct Entry {
+        std::vector<std::string>              passages;
+        std::chrono::steady_clock::time_point staged_at;
+        bool                                  used{false};
+    };
+
+    void run();
+    void evict_locked();     // mu_ held
+
+    RecallFn recall_;
+    Config   cfg_;
+
+    mutable std::mutex      mu_;
+    std::condition_variable cv_;
+    std::deque<std::string> queue_;
+    std::unordered_map<std::string, Entry> ready_;
+    Stats                   stats_;
+    bool                    stop_{false};
+
+    std::atomic<uint64_t>   contended_{0};   // counted outside mu_
+    std::thread             worker_;
+};
+
+} // namespace prometheus
@@ -0,0 +1,495 @@
+#include "memory/vector_index.h"
+#include "log/log.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <queue>
+#include <shared_mutex>
+#include <unordered_set>
+
+namespace prometheus {
+
+namespace {
+
+constexpr char     kMagic[8]    = {'P', 'R', 'M', 'H', 'N', 'S', 'W', '1'};
+constexpr uint32_t kVersion     = 2;
+constexpr size_t   kHeaderBytes = 4096;
+constexpr int      kMaxLevel    = 16;
+
+struct Header {
+    char     magic[8];
+    uint32_t version;
+    uint32_t dim;
+    uint32_t M;
+    uint32_t M0;
+    uint32_t ef_construction;
+    uint32_t count;            // published nodes; written last on insert
+    uint32_t entry;
+    int32_t  max_level;
+    uint32_t link_blocks;
+    uint64_t text_used;
+    uint64_t rng;
+};
+static_assert(sizeof(Header) <= kHeaderBytes);
+
+// Followed by uint32 links0[M0] and float vec[dim].
+struct NodeHead {
+    uint32_t level;
+    uint32_t upper;            // first link block (levels 1..level)
+    uint64_t text_off;
+    uint32_t text_len;
+    uint32_t n0;               // level-0 link count
+    uint64_t text_hash;
+};
+
+// A file mapped read-write, grown by doubling. A failed grow leaves the
+// current mapping in place.
+class MappedFile {
+public:
+    ~MappedFile() { close(); }
+
+    bool open(const std::string& path, size_t min_size) {
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ < 0) return false;
+        struct stat st{};
+        if (::fstat(fd_, &st) != 0) return false;
+        return map(std::max(static_cast<size_t>(st.st_size), min_size));
+    }
+
+    bool reserve(size_t bytes) {
+        if (bytes <= size_) return true;
+        return map(std::max(bytes, size_ * 2));
+    }
+
+    void sync() {
+        if (base_) ::msync(base_, size_, MS_SYNC);
+    }
+
+    void close() {
+        if (base_) ::munmap(base_, size_);
+        if (fd_ >= 0) ::close(fd_);
+        base_ = nullptr;
+        fd_   = -1;
+        size_ = 0;
+    }
+
+    char* data() const { return base_; }
+
+private:
+    // Map the (grown) file, then drop the old mapping. Growing the file
+    // does not disturb the old mapping, so it stays usable on failure.
+    bool map(size_t bytes) {
+        bytes = (bytes + 4095) & ~size_t{4095};
+        if (::ftruncate(fd_, static_cast<off_t>(bytes)) != 0) return false;
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) return false;
+        if (base_) ::munmap(base_, size_);
+        base_ = static_cast<char*>(p);
+        size_ = bytes;
+        return true;
+    }
+
+    int    fd_{-1};
+    char*  base_{nullptr};
+    size_t size_{0};
+};
+
+// Per-thread visited set, reset in O(1) by bumping an epoch.
+class Visited {
+public:
+    void reset(size_t n) {
+        if (marks_.size() < n) marks_.resize(n, 0);
+        if (++epoch_ == 0) {
+            std::fill(marks_.begin(), marks_.end(), 0);
+            epoch_ = 1;
+        }
+    }
+    bool test_and_mark(uint32_t i) {
+        if (marks_[i] == epoch_) return true;
+        marks_[i] = epoch_;
+        return false;
+    }
+
+private:
+    std::vector<uint32_t> marks_;
+    uint32_t              epoch_{0};
+};
+
+thread_local Visited t_visited;
+
+using Cand = std::pair<float, uint32_t>;   // (distance, id)
+
+void normalise(std::vector<float>& v) {
+    double norm = 0;
+    for (float x : v) norm += static_cast<double>(x) * x;
+    if (norm <= 0) return;
+    float inv = static_cast<float>(1.0 / std::sqrt(norm));
+    for (float& x : v) x *= inv;
+}
+
+} // namespace
+
+uint64_t content_hash(std::string_view text) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (unsigned char c : text) {
+        h ^= c;
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+// ── Impl ────────────────────────────────────────────────────────
+
+struct VectorIndex::Impl {
+    Config     cfg;
+    MappedFile nodes, links, text;
+    size_t     record_bytes{0};
+    size_t     block_bytes{0};
+    bool       opened{false};
+    mutable std::shared_mutex mu;
+
+    // Content hashes of stored passages, built on first use.
+    mutable std::mutex                   hashes_mu;
+    mutable std::unordered_set<uint64_t> hashes;
+    mutable bool                         hashes_built{false};
+
+    Header& hdr() const { return *reinterpret_cast<Header*>(nodes.data()); }
+
+    NodeHead& node(uint32_t i) const {
+        return *reinterpret_cast<NodeHead*>(nodes.data() + kHeaderBytes + i * record_bytes);
+    }
+    uint32_t* links0(uint32_t i) const {
+        return reinterpret_cast<uint32_t*>(&node(i) + 1);
+    }
+    float* vec(uint32_t i) const {
+        return reinterpret_cast<float*>(links0(i) + hdr().M0);
+    }
+
+    // (count, links) of node i at a level; upper blocks are {n, links[M]}.
+    std::pair<uint32_t*, uint32_t*> neighbours(uint32_t i, int level) const {
+        if (level == 0) return {&node(i).n0, links0(i)};
+        auto* b = reinterpret_cast<uint32_t*>(
+            links.data() + (static_cast<size_t>(node(i).upper) + level - 1) * block_bytes);
+        return {b, b + 1};
+    }
+    uint32_t max_links(int level) const { return level == 0 ? hdr().M0 : hdr().M; }
+
+    float distance(const float* a, const float* b) const {
+        float dot = 0;
+        for (uint32_t d = 0, n = hdr().dim; d < n; ++d) dot += a[d] * b[d];
+        return 1.0f - dot;
+    }
+
+    int random_level() {
+        // splitmix64, state kept in the header so levels stay reproducible.
+        uint64_t z = (hdr().rng += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        z ^= z >> 31;
+        double u = (static_cast<double>(z >> 11) + 1.0) / 9007199254740993.0;
+        double ml = 1.0 / std::log(static_cast<double>(hdr().M));
+        return std::min(kMaxLevel, static_cast<int>(-std::log(u) * ml));
+    }
+
+    // Greedy descent to the closest node at one level.
+    Cand greedy(const float* q, Cand cur, int level, uint32_t limit) const {
+        for (bool changed = true; changed;) {
+            changed = false;
+            auto [n, ln] = neighbours(cur.second, level);
+            for (uint32_t j = 0, cnt = std::min(*n, max_links(level)); j < cnt; ++j) {
+                if (ln[j] >= limit) continue;
+                float d = distance(q, vec(ln[j]));
+                if (d < cur.first) {
+                    cur     = {d, ln[j]};
+                    changed = true;
+                }
+            }
+        }
+        return cur;
+    }
+
+    // Beam search of width ef at one level. Returns closest first.
+    std::vector<Cand> search_layer(const float* q, const std::vector<Cand>& entry,
+                                   size_t ef, int level, uint32_t limit) const {
+        t_visited.reset(limit);
+        std::priority_queue<Cand, std::vector<Cand>, std::greater<>> frontier;
+        std::priority_queue<Cand> best;
+        for (auto& e : entry) {
+            if (t_visited.test_and_mark(e.second)) continue;
+            frontier.push(e);
+            best.push(e);
+        }
+        while (best.size() > ef) best.pop();
+
+        while (!frontier.empty()) {
+            auto [d, c] = frontier.top();
+            if (best.size() >= ef && d > best.top().first) break;
+            frontier.pop();
+
+            auto [n, ln] = neighbours(c, level);
+            for (uint32_t j = 0, cnt = std::min(*n, max_links(level)); j < cnt; ++j) {
+                uint32_t nb = ln[j];
+                if (nb >= limit || t_visited.test_and_mark(nb)) continue;
+                float dn = distance(q, vec(nb));
+                if (best.size() < ef || dn < best.top().first) {
+                    frontier.push({dn, nb});
+                    best.push({dn, nb});
+                    if (best.size() > ef) best.pop();
+                }
+            }
+        }
+
+        std::vector<Cand> out(best.size());
+        for (size_t i = out.size(); i-- > 0; best.pop()) out[i] = best.top();
+        return out;
+    }
+
+    // HNSW neighbour heuristic: keep a candidate only if it is closer to
+    // the base than to every neighbour already kept. `sorted` is closest first.
+    std::vector<uint32_t> select(const std::vector<Cand>& sorted, size_t m) const {
+        std::vector<uint32_t> out;
+        for (auto& [d, c] : sorted) {
+            if (out.size() >= m) break;
+            bool keep = true;
+            for (uint32_t r : out) {
+                if (distance(vec(c), vec(r)) < d) {
+                    keep = false;
+                    break;
+                }
+            }
+            if (keep) out.push_back(c);
+        }
+        return out;
+    }
+
+    // Add a back-link from s to id, pruning s's list if it is full.
+    void connect(uint32_t s, uint32_t id, int level) {
+        auto [n, ln] = neighbours(s, level);
+        uint32_t cap = max_links(level);
+        if (*n < cap) {
+            ln[(*n)++] = id;
+            return;
+        }
+        const float* sv = vec(s);
+        std::vector<Cand> c;
+        c.reserve(cap + 1);
+        for (uint32_t j = 0; j < cap; ++j) c.push_back({distance(sv, vec(ln[j])), ln[j]});
+        c.push_back({distance(sv, vec(id)), id});
+        std::sort(c.begin(), c.end());
+        auto keep = select(c, cap);
+        std::copy(keep.begin(), keep.end(), ln);
+        *n = static_cast<uint32_t>(keep.size());
+    }
+
+    Hit make_hit(const Cand& c) const {
+        auto& nd = node(c.second);
+        return {c.second, c.first, std::string(text.data() + nd.text_off, nd.text_len)};
+    }
+};
+
+// ── VectorIndex ─────────────────────────────────────────────────
+
+VectorIndex::VectorIndex() : VectorIndex(Config{}) {}
+
+VectorIndex::VectorIndex(Config cfg) : impl_(std::make_unique<Impl>()) {
+    impl_->cfg = cfg;
+}
+
+VectorIndex::~VectorIndex() {
+    if (impl_->opened) sync();
+}
+
+bool VectorIndex::open(const std::string& dir) {
+    auto& m = *impl_;
+    std::unique_lock lock(m.mu);
+
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (!m.nodes.open(dir + "/index.hnsw", kHeaderBytes)) {
+        PROMETHEUS_LOG(Error, "[MEMORY] Cannot map {}/index.hnsw", dir);
+        return false;
+    }
+
+    auto& h = m.hdr();
+    static const char zero[8] = {};
+    if (std::memcmp(h.magic, zero, sizeof zero) == 0) {
+        std::memcpy(h.magic, kMagic, sizeof kMagic);
+        h.version         = kVersion;
+        h.dim             = static_cast<uint32_t>(m.cfg.dim);
+        h.M               = static_cast<uint32_t>(std::max(2, m.cfg.M));
+        h.M0              = 2 * h.M;
+        h.ef_construction = static_cast<uint32_t>(m.cfg.ef_construction);
+        h.count           = 0;
+        h.entry           = kNone;
+        h.max_level       = -1;
+        h.link_blocks     = 0;
+        h.text_used       = 0;
+        h.rng             = 0x5eed;
+    } else if (std::memcmp(h.magic, kMagic, sizeof kMagic) != 0 || h.version != kVersion) {
+        PROMETHEUS_LOG(Error, "[MEMORY] {}/index.hnsw is not a v{} index.", dir, kVersion);
+        m.nodes.close();
+        return false;
+    } else if (static_cast<int>(h.dim) != m.cfg.dim) {
+        PROMETHEUS_LOG(Warn, "[MEMORY] Index dim {} overrides configured {}.", h.dim, m.cfg.dim);
+    }
+    m.cfg.dim = static_cast<int>(h.dim);
+    m.cfg.M   = static_cast<int>(h.M);
+
+    m.record_bytes = (sizeof(NodeHead) + 4 * (h.M0 + h.dim) + 7) & ~size_t{7};
+    m.block_bytes  = 4 * (h.M + 1);
+
+    if (!m.links.open(dir + "/links.bin", 4096) || !m.text.open(dir + "/text.bin", 4096)) {
+        PROMETHEUS_LOG(Error, "[MEMORY] Cannot map index files in {}", dir);
+        m.nodes.close();
+        return false;
+    }
+    m.opened = true;
+    PROMETHEUS_LOG(Info, "[MEMORY] Vector index: {} passages, dim {} ({}).", h.count, h.dim, dir);
+    return true;
+}
+
+bool VectorIndex::is_open() const {
+    std::shared_lock lock(impl_->mu);
+    return impl_->opened;
+}
+
+uint32_t VectorIndex::add(const std::vector<float>& v, std::string_view passage) {
+    auto& m = *impl_;
+    std::unique_lock lock(m.mu);
+    if (!m.opened || v.size() != m.hdr().dim) return kNone;
+
+    std::vector<float> unit = v;
+    normalise(unit);
+
+    const uint32_t id    = m.hdr().count;
+    const int      level = m.random_level();
+    const uint32_t first_block = m.hdr().link_blocks;
+
+    if (!m.nodes.reserve(kHeaderBytes + (id + 1) * m.record_bytes) ||
+        !m.links.reserve((first_block + level) * m.block_bytes) ||
+        !m.text.reserve(m.hdr().text_used + passage.size())) {
+        PROMETHEUS_LOG(Error, "[MEMORY] Vector index full (cannot grow files).");
+        return kNone;
+    }
+    auto& h = m.hdr();      // remapped — take the reference afterwards
+
+    std::memcpy(m.text.data() + h.text_used, passage.data(), passage.size());
+    auto& nd     = m.node(id);
+    nd.level     = static_cast<uint32_t>(level);
+    nd.upper     = level > 0 ? first_block : kNone;
+    nd.text_off  = h.text_used;
+    nd.text_len  = static_cast<uint32_t>(passage.size());
+    nd.n0        = 0;
+    nd.text_hash = content_hash(passage);
+    std::memcpy(m.vec(id), unit.data(), unit.size() * sizeof(float));
+    for (int l = 1; l <= level; ++l) *m.neighbours(id, l).first = 0;
+    h.text_used   += passage.size();
+    h.link_blocks += static_cast<uint32_t>(level);
+
+    if (h.entry != kNone) {
+        const float* q = m.vec(id);
+        Cand ep{m.distance(q, m.vec(h.entry)), h.entry};
+        for (int l = h.max_level; l > level; --l) ep = m.greedy(q, ep, l, id);
+
+        std::vector<Cand> eps{ep};
+        for (int l = std::min(level, h.max_level); l >= 0; --l) {
+            auto found = m.search_layer(q, eps, h.ef_construction, l, id);
+            auto sel   = m.select(found, h.M);
+            auto [n, ln] = m.neighbours(id, l);
+            std::copy(sel.begin(), sel.end(), ln);
+            *n = static_cast<uint32_t>(sel.size());
+            for (uint32_t s : sel) m.connect(s, id, l);
+            eps = std::move(found);
+        }
+    }
+
+    if (level > h.max_level) {
+        h.max_level = level;
+        h.entry     = id;
+    }
+    h.count = id + 1;       // publish last: a torn insert stays invisible
+
+    std::lock_guard hl(m.hashes_mu);
+    if (m.hashes_built) m.hashes.insert(nd.text_hash);
+    return id;
+}
+
+bool VectorIndex::contains(std::string_view text) const {
+    auto& m = *impl_;
+    std::shared_lock lock(m.mu);
+    if (!m.opened) return false;
+
+    std::lock_guard hl(m.hashes_mu);
+    if (!m.hashes_built) {
+        m.hashes.reserve(m.hdr().count);
+        for (uint32_t i = 0; i < m.hdr().count; ++i) m.hashes.insert(m.node(i).text_hash);
+        m.hashes_built = true;
+    }
+    return m.hashes.count(content_hash(text)) > 0;
+}
+
+std::vector<VectorIndex::Hit> VectorIndex::search(const std::vector<float>& query,
+                                                  size_t k, int ef) const {
+    auto& m = *impl_;
+    std::shared_lock lock(m.mu);
+    if (!m.opened || m.hdr().count == 0 || query.size() != m.hdr().dim) return {};
+
+    std::vector<float> q = query;
+    normalise(q);
+
+    const auto& h = m.hdr();
+    Cand ep{m.distance(q.data(), m.vec(h.entry)), h.entry};
+    for (int l = h.max_level; l > 0; --l) ep = m.greedy(q.data(), ep, l, h.count);
+
+    size_t width = std::max<size_t>(k, ef > 0 ? ef : m.cfg.ef_search);
+    auto found = m.search_layer(q.data(), {ep}, width, 0, h.count);
+
+    std::vector<Hit> out;
+    for (size_t i = 0; i < found.size() && i < k; ++i) out.push_back(m.make_hit(found[i]));
+    return out;
+}
+
+std::vector<VectorIndex::Hit> VectorIndex::search_exact(const std::vector<float>& query,
+                                                        size_t k) const {
+    auto& m = *impl_;
+    std::shared_lock lock(m.mu);
+    if (!m.opened || query.size() != m.hdr().dim) return {};
+
+    std::vector<float> q = query;
+    normalise(q);
+
+    std::vector<Cand> all(m.hdr().count);
+    for (uint32_t i = 0; i < all.size(); ++i) all[i] = {m.distance(q.data(), m.vec(i)), i};
+    k = std::min(k, all.size());
+    std::partial_sort(all.begin(), all.begin() + k, all.end());
+
+    std::vector<Hit> out;
+    for (size_t i = 0; i < k; ++i) out.push_back(m.make_hit(all[i]));
+    return out;
+}
+
+size_t VectorIndex::size() const {
+    std::shared_lock lock(impl_->mu);
+    return impl_->opened ? impl_->hdr().count : 0;
+}
+
+int VectorIndex::dim() const {
+    return impl_->cfg.dim;
+}
+
+void VectorIndex::sync() {
+    std::unique_lock lock(impl_->mu);
+    impl_->text.sync();
+    impl_->links.sync();
+    impl_->nodes.sync();    // header last
+}
+
+} // namespace prometheus
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace prometheus {
+
+// 64-bit content hash (FNV-1a) the index and the embedding pipeline use
+// to recognise passages they have already seen.
+uint64_t content_hash(std::string_view text);
+
+// Persistent approximate-nearest-neighbour index (HNSW) over unit vectors.
+//
+// Lives in a directory of three memory-mapped files:
+//   index.hnsw  header + fixed-size node records (level-0 links, vector)
+//   links.bin   upper-level link blocks
+//   text.bin    passage text
+// Opening maps the files as they are, so a cold start costs the same
+// whatever the index size. Inserts are incremental; searches run
+// concurrently with each other and serialise against inserts.
+class VectorIndex {
+public:
+    struct Config {
+        int dim             = 256;
+        int M               = 16;    // links per node per level (2M at level 0)
+        int ef_construction = 100;
+        int ef_search       = 64;
+    };
+
+    struct Hit {
+        uint32_t    id{0};
+        float       distance{0};     // 1 − cosine similarity
+        std::string text;
+    };
+
+    VectorIndex();
+    explicit VectorIndex(Config cfg);
+    ~VectorIndex();
+
+    VectorIndex(const VectorIndex&)            = delete;
+    VectorIndex& operator=(const VectorIndex&) = delete;
+
+    // Open or create the index in `dir`. An existing index keeps its own
+    // dim and M. Returns false on I/O error or an incompatible file.
+    bool open(const std::string& dir);
+    bool is_open() const;
+
+    // add() result when nothing was stored: wrong dimension, or the
+    // files could not grow.
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    // Add a vector (normalised here) with its passage. Returns its id, or
+    // kNone.
+    uint32_t add(const std::vector<float>& vec, std::string_view text);
+
+    // True if a passage with the same content hash is already stored.
+    // The first call builds the hash set from the node records.
+    bool contains(std::string_view text) const;
+
+    // k nearest passages, closest first. ef = 0 uses Config::ef_search.
+    std::vector<Hit> search(const std::vector<float>& query, size_t k, int ef = 0) const;
+
+    // Exact linear scan — the ground truth for recall measurements.
+    std::vector<Hit> search_exact(const std::vector<float>& query, size_t k) const;
+
+    size_t size() const;
+    int    dim() const;
+
+    // Flush mapped pages to disk.
+    void sync();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace prometheus
@@ -0,0 +1,204 @@
+#include "metrics/metrics.h"
+
+#include <bit>
+#include <cstdio>
+#include <stdexcept>
+
+namespace prometheus {
+
+namespace detail {
+
+// Bit i set: exclusive shard i is leased by a live thread.
+static std::atomic<uint32_t> g_leased{0};
+static_assert(kSharedShard < 32);
+
+ShardLease::ShardLease() {
+    constexpr uint32_t kAll = (uint32_t{1} << kSharedShard) - 1;
+    uint32_t cur = g_leased.load(std::memory_order_acquire);
+    while (uint32_t free = ~cur & kAll) {
+        uint32_t bit = free & (~free + 1);
+        if (g_leased.compare_exchange_weak(cur, cur | bit, std::memory_order_acquire)) {
+            index     = static_cast<size_t>(std::countr_zero(bit));
+            exclusive = true;
+            return;
+        }
+    }
+}
+
+// Release publishes this thread's last writes to the next owner.
+ShardLease::~ShardLease() {
+    if (exclusive) g_leased.fetch_and(~(uint32_t{1} << index), std::memory_order_release);
+}
+
+} // namespace detail
+
+// ── Counter / Histogram ─────────────────────────────────────────
+
+uint64_t Counter::value() const {
+    uint64_t v = 0;
+    for (auto& s : shards_) v += s.v.load(std::memory_order_relaxed);
+    return v;
+}
+
+uint64_t Histogram::lower_bound(size_t b) {
+    if (b < kSubBuckets) return b;
+    const size_t e   = b / kSubBuckets + kSubBits - 1;
+    const size_t sub = b % kSubBuckets;
+    return (uint64_t{1} << e) + (uint64_t{sub} << (e - kSubBits));
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+    Snapshot out;
+    for (auto& s : shards_) {
+        for (size_t b = 0; b < kBuckets; ++b) {
+            uint64_t n = s.counts[b].load(std::memory_order_relaxed);
+            out.counts[b] += n;
+            out.count     += n;
+        }
+        out.sum_ns += s.sum.load(std::memory_order_relaxed);
+    }
+    return out;
+}
+
+uint64_t Histogram::Snapshot::quantile(double q) const {
+    if (!count) return 0;
+    const auto rank = static_cast<uint64_t>(q * static_cast<double>(count - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t b = 0; b < kBuckets; ++b) {
+        seen += counts[b];
+        if (seen >= rank) return b + 1 < kBuckets ? lower_bound(b + 1) - 1 : UINT64_MAX;
+    }
+    return UINT64_MAX;
+}
+
+// ── Registry ────────────────────────────────────────────────────
+
+MetricsRegistry::Series& MetricsRegistry::series(std::string_view name, std::string_view help,
+                                                 std::string_view labels, Type type) {
+    std::lock_guard lock(mu_);
+    Family* family = nullptr;
+    for (auto& f : families_) {
+        if (f.name == name) {
+            family = &f;
+            break;
+        }
+    }
+    if (!family) {
+        family = &families_.emplace_back();
+        family->name.assign(name);
+        family->help.assign(help);
+        family->type = type;
+    } else if (family->type != type) {
+        throw std::logic_error("metric " + std::string(name) + " registered with two types");
+    }
+    for (auto& s : family->series) {
+        if (s.labels == labels) return s;
+    }
+    auto& s = family->series.emplace_back();
+    s.labels.assign(labels);
+    switch (type) {
+    case Type::Counter:   s.counter   = std::make_unique<Counter>();   break;
+    case Type::Gauge:     s.gauge     = std::make_unique<Gauge>();     break;
+    case Type::Histogram: s.histogram = std::make_unique<Histogram>(); break;
+    }
+    return s;
+}
+
+Counter& MetricsRegistry::counter(std::string_view name, std::string_view help,
+                                  std::string_view labels) {
+    return *series(name, help, labels, Type::Counter).counter;
+}
+
+Gauge& MetricsRegistry::gauge(std::string_view name, std::string_view help,
+                              std::string_view labels) {
+    return *series(name, help, labels, Type::Gauge).gauge;
+}
+
+Histogram& MetricsRegistry::histogram(std::string_view name, std::string_view help,
+                                      std::string_view labels) {
+    return *series(name, help, labels, Type::Histogram).histogram;
+}
+
+// ── Exposition ──────────────────────────────────────────────────
+
+namespace {
+
+// `name{labels,extra} value`, leaving out empty parts.
+void sample(std::string& out, const std::string& name, std::string_view suffix,
+            const std::string& labels, std::string_view extra, const char* value) {
+    out += name;
+    out += suffix;
+    if (!labels.empty() || !extra.empty()) {
+        out += '{';
+        out += labels;
+        if (!labels.empty() && !extra.empty()) out += ',';
+        out += extra;
+        out += '}';
+    }
+    out += ' ';
+    out += value;
+    out += '\n';
+}
+
+} // namespace
+
+std::string MetricsRegistry::render() const {
+    // Exported `le` bounds: 2^10 ns (~1 µs) to 2^36 ns (~69 s).
+    constexpr int kMinPow = 10, kMaxPow = 36;
+
+    std::string out;
+    out.reserve(16 * 1024);
+    char value[32], le[48];
+    std::lock_guard lock(mu_);
+    for (auto& f : families_) {
+        static constexpr const char* kTypes[] = {"counter", "gauge", "histogram"};
+        out += "# HELP " + f.name + ' ' + f.help + '\n';
+        out += "# TYPE " + f.name + ' ' + kTypes[static_cast<int>(f.type)] + '\n';
+        for (auto& s : f.series) {
+            switch (f.type) {
+            case Type::Counter:
+                std::snprintf(value, sizeof value, "%llu",
+                              static_cast<unsigned long long>(s.counter->value()));
+                sample(out, f.name, "", s.labels, "", value);
+                break;
+            case Type::Gauge:
+                std::snprintf(value, sizeof value, "%.10g", s.gauge->value());
+                sample(out, f.name, "", s.labels, "", value);
+                break;
+            case Type::Histogram: {
+                // Buckets below 2^k ns are exactly the values under 2^k.
+                auto snap = s.histogram->snapshot();
+                uint64_t cumulative = 0;
+                size_t   b = 0;
+                for (int k = kMinPow; k <= kMaxPow; ++k) {
+                    for (size_t end = Histogram::bucket(uint64_t{1} << k); b < end; ++b) {
+                        cumulative += snap.counts[b];
+                    }
+                    std::snprintf(le, sizeof le, "le=\"%.6g\"",
+                                  static_cast<double>(uint64_t{1} << k) * 1e-9);
+                    std::snprintf(value, sizeof value, "%llu",
+                                  static_cast<unsigned long long>(cumulative));
+                    sample(out, f.name, "_bucket", s.labels, le, value);
+                }
+                std::snprintf(value, sizeof value, "%llu",
+                              static_cast<unsigned long long>(snap.count));
+                sample(out, f.name, "_bucket", s.labels, "le=\"+Inf\"", value);
+                std::snprintf(value, sizeof value, "%.9g", static_cast<double>(snap.sum_ns) * 1e-9);
+                sample(out, f.name, "_sum", s.labels, "", value);
+                std::snprintf(value, sizeof value, "%llu",
+                              static_cast<unsigned long long>(snap.count));
+                sample(out, f.name, "_count", s.labels, "", value);
+                break;
+            }
+            }
+        }
+    }
+    return out;
+}
+
+MetricsRegistry& metrics() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+} // namespace prometheus
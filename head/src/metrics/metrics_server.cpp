@@ -0,0 +1,117 @@
+#include "metrics/metrics_server.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+
+namespace prometheus {
+
+static constexpr int    kPollMs     = 200;     // stop() latency
+static constexpr int    kClientMs   = 1000;    // per-client read budget
+static constexpr size_t kMaxRequest = 4096;
+
+MetricsServer::MetricsServer(MetricsRegistry& registry) : registry_(registry) {}
+
+MetricsServer::~MetricsServer() { stop(); }
+
+bool MetricsServer::start(const std::string& addr) {
+    if (running_.load()) return true;
+
+    auto colon = addr.rfind(':');
+    if (colon == std::string::npos) {
+        std::cerr << "[METRICS] Bad listen address '" << addr << "' (want host:port).\n";
+        return false;
+    }
+    std::string host = addr.substr(0, colon);
+    if (host.empty() || host == "localhost") host = "127.0.0.1";
+    sockaddr_in sa{};
+    sa.sin_family = AF_INET;
+    int port = std::atoi(addr.c_str() + colon + 1);
+    if (port < 0 || port > 65535 || inet_pton(AF_INET, host.c_str(), &sa.sin_addr) != 1) {
+        std::cerr << "[METRICS] Bad listen address '" << addr << "' (want host:port).\n";
+        return false;
+    }
+    sa.sin_port = htons(static_cast<uint16_t>(port));
+
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int one = 1;
+    if (listen_fd_ < 0 ||
+        ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof one) != 0 ||
+        ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&sa), sizeof sa) != 0 ||
+        ::listen(listen_fd_, 8) != 0) {
+        std::cerr << "[METRICS] Cannot listen on " << addr << ": " << std::strerror(errno) << "\n";
+        if (listen_fd_ >= 0) ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    socklen_t len = sizeof sa;
+    ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&sa), &len);
+    port_ = ntohs(sa.sin_port);
+
+    running_.store(true);
+    thread_ = std::thread([this] { run(); });
+    std::cout << "[METRICS] Serving http://" << host << ":" << port_ << "/metrics\n";
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (!running_.exchange(false)) return;
+    if (thread_.joinable()) thread_.join();
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    port_      = 0;
+}
+
+void MetricsServer::run() {
+    while (running_.load()) {
+        pollfd p{listen_fd_, POLLIN, 0};
+        if (::poll(&p, 1, kPollMs) <= 0) continue;
+        int client = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) continue;
+        serve(client);
+        ::close(client);
+    }
+}
+
+void MetricsServer::serve(int client) {
+    // Read up to the end of the headers; only the request line matters.
+    char   buf[kMaxRequest];
+    size_t got = 0;
+    while (got < sizeof buf) {
+        pollfd p{client, POLLIN, 0};
+        if (::poll(&p, 1, kClientMs) <= 0) return;
+        ssize_t n = ::recv(client, buf + got, sizeof buf - got, 0);
+        if (n <= 0) return;
+        got += static_cast<size_t>(n);
+        if (std::string_view(buf, got).find("\r\n\r\n") != std::string_view::npos) break;
+    }
+    std::string_view req(buf, got);
+    std::string_view line = req.substr(0, req.find("\r\n"));
+
+    std::string body, status = "200 OK", type = "text/plain; version=0.0.4; charset=utf-8";
+    if (line.starts_with("GET /metrics ") || line.starts_with("GET /metrics?")) {
+        body = registry_.render();
+    } else {
+        status = "404 Not Found";
+        type   = "text/plain; charset=utf-8";
+        body   = "Try /metrics\n";
+    }
+    std::string resp = "HTTP/1.1 " + status + "\r\nContent-Type: " + type +
+                       "\r\nContent-Length: " + std::to_string(body.size()) +
+                       "\r\nConnection: close\r\n\r\n" + body;
+    for (size_t sent = 0; sent < resp.size();) {
+        ssize_t n = ::send(client, resp.data() + sent, resp.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return;
+        sent += static_cast<size_t>(n);
+    }
+}
+
+} // namespace prometheus
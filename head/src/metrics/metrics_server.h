@@ -0,0 +1,46 @@
+#pragma once
+
+#include "metrics/metrics.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+namespace prometheus {
+
+// Serves the metrics registry for Prometheus to scrape:
+//
+//   GET /metrics  →  200, text/plain; version=0.0.4
+//   anything else →  404
+//
+// One background thread, one request per connection. Meant for a local
+// scraper: it binds to loopback by default and reads at most 4 KiB of
+// request, with a short timeout per client.
+class MetricsServer {
+public:
+    explicit MetricsServer(MetricsRegistry& registry);
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&)            = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    // Listen on "host:port" (IPv4; port 0 picks a free one). Returns
+    // false and logs if the address is bad or cannot be bound.
+    bool start(const std::string& addr);
+    void stop();
+
+    // Bound port, 0 if not listening.
+    int port() const { return port_; }
+
+private:
+    void run();
+    void serve(int client);
+
+    MetricsRegistry&  registry_;
+    int               listen_fd_{-1};
+    int               port_{0};
+    std::atomic<bool> running_{false};
+    std::thread       thread_;
+};
+
+} // namespace prometheus
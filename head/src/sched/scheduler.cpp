@@ -0,0 +1,392 @@
+#include "sched/scheduler.h"
+#include "diag/trace.h"
+#include "log/log.h"
+#include "metrics/metrics.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace prometheus {
+
+namespace {
+
+// Reset a readable timerfd/eventfd counter.
+void drain(int fd) {
+    uint64_t buf;
+    [[maybe_unused]] auto n = ::read(fd, &buf, sizeof buf);
+}
+
+} // namespace
+
+struct Scheduler::Entry {
+    TaskId      id{0};
+    std::string name;
+    Task        fn;
+    uint64_t    period{0};      // ticks; 0 → one-shot
+    uint64_t    base{0};        // tick of run 0
+    uint64_t    n{0};           // index of the next run
+    uint64_t    jitter{0};      // ticks
+    uint64_t    deadline{0};    // tick the wheel holds it for
+    uint64_t    due{0};         // deadline of the run in progress
+    bool        on_timer_thread{false};
+    bool        running{false};
+    Histogram*  late_hist{nullptr};   // head_sched_late_seconds{task=name}
+    bool        cancelled{false};
+};
+
+Scheduler::Scheduler() : Scheduler(Config{}) {}
+
+Scheduler::Scheduler(Config cfg)
+    : cfg_(cfg), epoch_(Clock::now()), rng_(static_cast<uint32_t>(epoch_.time_since_epoch().count())) {
+    if (cfg_.tick.count() < 1) cfg_.tick = Duration(1);
+    timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    wake_fd_  = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (timer_fd_ < 0 || wake_fd_ < 0) {
+        PROMETHEUS_LOG(Error, "[SCHED] timerfd/eventfd unavailable: {}", std::strerror(errno));
+    }
+}
+
+Scheduler::~Scheduler() {
+    if (timer_fd_ >= 0) ::close(timer_fd_);
+    if (wake_fd_ >= 0) ::close(wake_fd_);
+}
+
+uint64_t Scheduler::ticks(Clock::time_point t) const {
+    if (t <= epoch_) return 0;
+    return static_cast<uint64_t>((t - epoch_) / cfg_.tick);
+}
+
+uint64_t Scheduler::jittered(const Entry& e, uint64_t base) const {
+    if (!e.jitter) return base;
+    uint64_t span = rng_() % (2 * e.jitter + 1);
+    return base + span >= e.jitter ? base + span - e.jitter : 0;
+}
+
+// ── Registration ────────────────────────────────────────────────
+
+Scheduler::TaskId Scheduler::every(const std::string& name, Duration period, Task fn) {
+    return every(name, period, std::move(fn), Options{});
+}
+
+Scheduler::TaskId Scheduler::every(const std::string& name, Duration period, Task fn,
+                                   Options opts) {
+    Duration first = opts.initial_delay.count() < 0 ? period : opts.initial_delay;
+    return add(name, first, std::max(period, cfg_.tick), std::move(fn), opts);
+}
+
+Scheduler::TaskId Scheduler::after(const std::string& name, Duration delay, Task fn) {
+    return after(name, delay, std::move(fn), Options{});
+}
+
+Scheduler::TaskId Scheduler::after(const std::string& name, Duration delay, Task fn,
+                                   Options opts) {
+    return add(name, delay, Duration(0), std::move(fn), opts);
+}
+
+Scheduler::TaskId Scheduler::add(const std::string& name, Duration first, Duration period,
+                                 Task fn, const Options& opts) {
+    auto e = std::make_shared<Entry>();
+    e->name            = name;
+    e->fn              = std::move(fn);
+    e->period          = static_cast<uint64_t>(period / cfg_.tick);
+    e->jitter          = static_cast<uint64_t>(std::max(opts.jitter, Duration(0)) / cfg_.tick);
+    e->on_timer_thread = opts.on_timer_thread;
+    e->late_hist       = &metrics().histogram("head_sched_late_seconds",
+                                              "Scheduled run start past its due time (wake-up jitter).",
+                                              "task=\"" + name + "\"");
+
+    // Ceil so a task never runs early.
+    const uint64_t now   = ticks(Clock::now());
+    const uint64_t delay = (std::max(first, Duration(0)) + cfg_.tick - Duration(1)) / cfg_.tick;
+
+    bool earlier;
+    {
+        std::lock_guard lock(mu_);
+        e->id       = next_id_++;
+        e->base     = now + delay;
+        e->deadline = std::max(jittered(*e, e->base), cur_ + 1);
+        entries_.emplace(e->id, e);
+        stats_.tasks.try_emplace(name);
+        insert(e->id, e->deadline);
+        earlier = e->deadline < armed_;
+    }
+    if (earlier) wake();
+    return e->id;
+}
+
+bool Scheduler::cancel(TaskId id) {
+    std::lock_guard lock(mu_);
+    auto it = entries_.find(id);
+    if (it == entries_.end()) return false;
+    it->second->cancelled = true;
+    entries_.erase(it);     // its wheel slot entry goes stale
+    return true;
+}
+
+// ── Wheel ───────────────────────────────────────────────────────
+// Level l holds deadlines 256^l … 256^(l+1) ticks ahead of cur_, in the
+// slot named by the deadline's l-th base-256 digit. When the clock reaches
+// the start of a slot's span, the slot cascades down a level.
+
+void Scheduler::insert(uint64_t id, uint64_t deadline) {
+    uint64_t delta = deadline > cur_ ? deadline - cur_ : 0;
+    int level = 0;
+    while (level + 1 < kLevels && delta >= (uint64_t{1} << (kSlotBits * (level + 1)))) ++level;
+    if (level == kLevels - 1) {
+        deadline = std::min(deadline, cur_ + (uint64_t{1} << (kSlotBits * kLevels)) - 1);
+    }
+    wheel_[level][(deadline >> (kSlotBits * level)) & kSlotMask].push_back(id);
+}
+
+uint64_t Scheduler::next_event() const {
+    uint64_t best = UINT64_MAX;
+    for (int l = 0; l < kLevels; ++l) {
+        const int      shift = kSlotBits * l;
+        const uint64_t span  = uint64_t{1} << (shift + kSlotBits);
+        const uint64_t floor = cur_ & ~(span - 1);
+        for (uint64_t s = 0; s < kSlots; ++s) {
+            if (wheel_[l][s].empty()) continue;
+            uint64_t t = floor | (s << shift);
+            if (t <= cur_) t += span;
+            best = std::min(best, t);
+        }
+    }
+    return best;
+}
+
+void Scheduler::cascade(int level, uint64_t slot) {
+    auto ids = std::move(wheel_[level][slot]);
+    wheel_[level][slot].clear();
+    ++stats_.cascades;
+    for (uint64_t id : ids) {
+        auto it = entries_.find(id);
+        if (it != entries_.end()) insert(id, it->second->deadline);
+    }
+}
+
+void Scheduler::advance(uint64_t to, std::vector<EntryPtr>& due) {
+    for (;;) {
+        uint64_t t = next_event();
+        if (t > to) break;
+        cur_ = t;
+
+        // Highest level first, so a deadline landing exactly on t falls
+        // all the way into the level-0 slot expired below.
+        for (int l = kLevels - 1; l >= 1; --l) {
+            const int shift = kSlotBits * l;
+            if ((t & ((uint64_t{1} << shift) - 1)) == 0) {
+                uint64_t slot = (t >> shift) & kSlotMask;
+                if (!wheel_[l][slot].empty()) cascade(l, slot);
+            }
+        }
+
+        auto ids = std::move(wheel_[0][t & kSlotMask]);
+        wheel_[0][t & kSlotMask].clear();
+        for (uint64_t id : ids) {
+            auto it = entries_.find(id);
+            if (it == entries_.end()) continue;         // cancelled
+            if (it->second->deadline > t) insert(id, it->second->deadline);
+            else due.push_back(it->second);
+        }
+    }
+    cur_ = std::max(cur_, to);
+}
+
+// ── Firing ──────────────────────────────────────────────────────
+
+void Scheduler::fire(const EntryPtr& e, uint64_t now_tick, std::vector<EntryPtr>& runs) {
+    ++stats_.fired;
+    auto& ts = stats_.tasks[e->name];
+    if (e->running) {
+        ++ts.overlapped;
+    } else {
+        e->running = true;
+        e->due     = e->deadline;
+        runs.push_back(e);
+    }
+
+    if (!e->period) {
+        entries_.erase(e->id);
+        return;
+    }
+    // Fixed rate: the next run is anchored to base, not to now. Periods
+    // that have already gone by are skipped rather than run back to back.
+    ++e->n;
+    uint64_t next = e->base + e->n * e->period;
+    if (next <= now_tick) {
+        uint64_t skipped = (now_tick - next) / e->period + 1;
+        ts.missed += skipped;
+        e->n      += skipped;
+        next      += skipped * e->period;
+    }
+    e->deadline = std::max(jittered(*e, next), cur_ + 1);
+    insert(e->id, e->deadline);
+}
+
+void Scheduler::execute(const EntryPtr& e) {
+    const auto start = Clock::now();
+    uint64_t due;
+    {
+        std::lock_guard lock(mu_);
+        if (e->cancelled) {
+            e->running = false;
+            return;
+        }
+        due = e->due;
+    }
+
+    try {
+        e->fn();
+    } catch (const std::exception& ex) {
+        PROMETHEUS_LOG(Error, "[SCHED] Task {} threw: {}", e->name, ex.what());
+    }
+
+    const auto end = Clock::now();
+    e->late_hist->record(start - (epoch_ + due * cfg_.tick));
+    double late_ms = std::chrono::duration<double, std::milli>(
+        start - (epoch_ + due * cfg_.tick)).count();
+    double run_ms  = std::chrono::duration<double, std::milli>(end - start).count();
+    late_ms = std::max(0.0, late_ms);
+
+    std::lock_guard lock(mu_);
+    e->running = false;
+    auto& ts = stats_.tasks[e->name];
+    ++ts.runs;
+    if (late_ms > static_cast<double>(cfg_.late_after.count())) ++ts.late;
+    ts.max_late_ms   = std::max(ts.max_late_ms, late_ms);
+    ts.total_late_ms += late_ms;
+    ts.max_run_ms    = std::max(ts.max_run_ms, run_ms);
+}
+
+void Scheduler::worker() {
+    Trace::name_thread("sched.worker");
+    if (cfg_.on_worker_start) cfg_.on_worker_start();
+    for (;;) {
+        EntryPtr e;
+        {
+            std::unique_lock lock(queue_mu_);
+            queue_cv_.wait(lock, [&] { return draining_ || !queue_.empty(); });
+            if (queue_.empty()) return;
+            e = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        execute(e);
+    }
+}
+
+// ── Timer thread ────────────────────────────────────────────────
+
+void Scheduler::arm(uint64_t tick) {
+    armed_ = tick;
+    itimerspec spec{};
+    if (tick != UINT64_MAX) {
+        auto at = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            (epoch_ + tick * cfg_.tick).time_since_epoch()).count();
+        spec.it_value.tv_sec  = at / 1000000000;
+        spec.it_value.tv_nsec = at % 1000000000;
+        if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) spec.it_value.tv_nsec = 1;
+    }
+    timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+}
+
+void Scheduler::wake() {
+    uint64_t one = 1;
+    [[maybe_unused]] auto n = ::write(wake_fd_, &one, sizeof one);
+}
+
+void Scheduler::stop() {
+    stopping_.store(true);
+    wake();
+}
+
+void Scheduler::run() {
+    if (timer_fd_ < 0 || wake_fd_ < 0) return;
+
+    for (size_t i = 0; i < std::max<size_t>(1, cfg_.workers); ++i) {
+        workers_.emplace_back([this] { worker(); });
+    }
+    PROMETHEUS_LOG(Info, "[SCHED] Running ({} ms tick, {} workers).", cfg_.tick.count(),
+                   workers_.size());
+
+    std::vector<EntryPtr> due, runs;
+    while (!stopping_.load()) {
+        {
+            std::lock_guard lock(mu_);
+            arm(next_event());
+        }
+
+        pollfd fds[2] = {{timer_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+        if (::poll(fds, 2, -1) < 0 && errno != EINTR) {
+            PROMETHEUS_LOG(Error, "[SCHED] poll failed: {}", std::strerror(errno));
+            break;
+        }
+        if (fds[0].revents & POLLIN) drain(timer_fd_);
+        if (fds[1].revents & POLLIN) drain(wake_fd_);
+        if (stopping_.load()) break;
+
+        due.clear();
+        runs.clear();
+        {
+            std::lock_guard lock(mu_);
+            ++stats_.wakeups;
+            const uint64_t now = ticks(Clock::now());
+            advance(now, due);
+            for (auto& e : due) fire(e, now, runs);
+        }
+
+        size_t queued = 0;
+        {
+            std::lock_guard lock(queue_mu_);
+            for (auto& e : runs) {
+                if (!e->on_timer_thread) {
+                    queue_.push_back(e);
+                    ++queued;
+                }
+            }
+        }
+        if (queued == 1) queue_cv_.notify_one();
+        else if (queued) queue_cv_.notify_all();
+        for (auto& e : runs) {
+            if (e->on_timer_thread) execute(e);
+        }
+    }
+
+    // ── Shutdown: cancel everything, let running tasks finish ───
+    {
+        std::lock_guard lock(mu_);
+        for (auto& [id, e] : entries_) e->cancelled = true;
+        entries_.clear();
+        for (auto& level : wheel_) {
+            for (auto& slot : level) slot.clear();
+        }
+        arm(UINT64_MAX);
+    }
+    size_t dropped;
+    {
+        std::lock_guard lock(queue_mu_);
+        dropped   = queue_.size();
+        draining_ = true;
+        queue_.clear();
+    }
+    queue_cv_.notify_all();
+    for (auto& t : workers_) t.join();
+    workers_.clear();
+
+    std::lock_guard lock(mu_);
+    stats_.dropped += dropped;
+    PROMETHEUS_LOG(Info, "[SCHED] Stopped ({} queued runs dropped).", dropped);
+}
+
+Scheduler::Stats Scheduler::stats() const {
+    std::lock_guard lock(mu_);
+    Stats s = stats_;
+    s.uptime_s = std::chrono::duration<double>(Clock::now() - epoch_).count();
+    return s;
+}
+
+} // namespace prometheus
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace prometheus {
+
+// One timer thread for all periodic and one-shot work in the Head.
+//
+// Timers live in a hierarchical timing wheel (4 levels × 256 slots, so
+// 1 ms ticks reach ~49 days). The timer thread sleeps on a timerfd armed
+// for the next non-empty slot or cascade, so an idle Head wakes only when
+// something is due. Due tasks run on a small worker pool, or on the timer
+// thread itself for short non-blocking ones (the dispatch tick).
+//
+// Periodic tasks are fixed-rate: the n-th run is due at start + n·period
+// (± optional jitter to keep tasks from waking in lockstep), so a slow
+// run does not drift later ones. A run that is still going when the next
+// is due is not overlapped — the next is skipped and counted — and
+// periods that passed entirely (a stalled host) are counted as missed.
+class Scheduler {
+public:
+    using Clock    = std::chrono::steady_clock;
+    using Duration = std::chrono::milliseconds;
+    using Task     = std::function<void()>;
+    using TaskId   = uint64_t;
+
+    struct Config {
+        Duration tick{1};
+        size_t   workers     = 2;
+        Duration late_after{5};     // runs starting later than this count as late
+        std::function<void()> on_worker_start;   // first thing on each worker (e.g. pin it)
+    };
+
+    struct Options {
+        Duration initial_delay{-1};    // first run; negative → one period
+        Duration jitter{0};            // each run shifted by up to ± jitter
+        bool     on_timer_thread = false;
+    };
+
+    // Per task name; re-registered one-shots (e.g. a self-rescheduling
+    // chain) accumulate under the same name.
+    struct TaskStats {
+        uint64_t runs{0};
+        uint64_t late{0};         // started > late_after past the deadline
+        uint64_t missed{0};       // whole periods skipped after a stall
+        uint64_t overlapped{0};   // due while the previous run was still going
+        double   max_late_ms{0};
+        double   total_late_ms{0};
+        double   max_run_ms{0};
+
+        double mean_late_ms() const { return runs ? total_late_ms / runs : 0.0; }
+    };
+
+    struct Stats {
+        uint64_t wakeups{0};      // timer thread wakeups
+        uint64_t cascades{0};     // wheel slots redistributed
+        uint64_t fired{0};
+        uint64_t dropped{0};      // queued but never run (shutdown)
+        double   uptime_s{0};
+        std::map<std::string, TaskStats> tasks;
+
+        double wakeups_per_s() const { return uptime_s > 0 ? wakeups / uptime_s : 0.0; }
+    };
+
+    Scheduler();
+    explicit Scheduler(Config cfg);
+    ~Scheduler();
+
+    Scheduler(const Scheduler&)            = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    // Run `fn` every `period`. Safe from any thread, including tasks.
+    TaskId every(const std::string& name, Duration period, Task fn);
+    TaskId every(const std::string& name, Duration period, Task fn, Options opts);
+
+    // Run `fn` once after `delay`.
+    TaskId after(const std::string& name, Duration delay, Task fn);
+    TaskId after(const std::string& name, Duration delay, Task fn, Options opts);
+
+    // Stop future runs of `id`. A run already in progress completes.
+    // Returns false if the task is unknown or already finished.
+    bool cancel(TaskId id);
+
+    // Timer loop — blocks the calling thread until stop(). On return all
+    // tasks are cancelled and the worker pool has drained and joined.
+    void run();
+
+    // Ask run() to return. Async-signal-safe.
+    void stop();
+
+    Stats stats() const;
+
+private:
+    struct Entry;
+    using EntryPtr = std::shared_ptr<Entry>;
+
+    static constexpr int      kLevels    = 4;
+    static constexpr int      kSlotBits  = 8;
+    static constexpr uint64_t kSlots     = 1u << kSlotBits;
+    static constexpr uint64_t kSlotMask  = kSlots - 1;
+
+    TaskId   add(const std::string& name, Duration first, Duration period, Task fn,
+                 const Options& opts);
+    uint64_t ticks(Clock::time_point t) const;
+    uint64_t jittered(const Entry& e, uint64_t base) const;
+
+    // Wheel — all under mu_.
+    void     insert(uint64_t id, uint64_t deadline);
+    uint64_t next_event() const;            // UINT64_MAX if the wheel is empty
+    void     advance(uint64_t to, std::vector<EntryPtr>& due);
+    void     cascade(int level, uint64_t slot);
+
+    void fire(const EntryPtr& e, uint64_t now_tick, std::vector<EntryPtr>& inline_runs);
+    void execute(const EntryPtr& e);
+    void worker();
+    void arm(uint64_t tick);
+    void wake();
+
+    Config cfg_;
+    Clock::time_point epoch_;
+
+    mutable std::mutex mu_;
+    std::vector<uint64_t> wheel_[kLevels][kSlots];   // task ids, stale ones skipped
+    uint64_t cur_{0};                                 // last processed tick
+    uint64_t armed_{UINT64_MAX};
+    std::unordered_map<TaskId, EntryPtr> entries_;
+    TaskId   next_id_{1};
+    mutable std::minstd_rand rng_;
+    Stats    stats_;
+
+    std::mutex              queue_mu_;
+    std::condition_variable queue_cv_;
+    std::deque<EntryPtr>    queue_;
+    bool                    draining_{false};
+    std::vector<std::thread> workers_;
+
+    int timer_fd_{-1};
+    int wake_fd_{-1};
+    std::atomic<bool> stopping_{false};
+};
+
+} // namespace prometheus
@@ -0,0 +1,192 @@
+#include "sched/topology.h"
+#include "log/log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <optional>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace prometheus {
+
+namespace {
+
+constexpr const char* kRoleNames[kThreadRoles] = {"lizard", "dispatch", "soul", "worker",
+                                                  "background"};
+
+std::optional<ThreadRole> parse_role(std::string_view name) {
+    for (size_t i = 0; i < kThreadRoles; ++i) {
+        if (name == kRoleNames[i]) return static_cast<ThreadRole>(i);
+    }
+    return std::nullopt;
+}
+
+std::optional<int> parse_int(std::string_view s) {
+    int v = 0;
+    auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+    if (ec != std::errc() || end != s.data() + s.size()) return std::nullopt;
+    return v;
+}
+
+// "cpu3" or "cpu2-5" onto `cpus`.
+bool parse_cpus(std::string_view item, std::vector<int>& cpus) {
+    item.remove_prefix(3);
+    auto dash = item.find('-');
+    auto lo   = parse_int(item.substr(0, dash));
+    auto hi   = dash == std::string_view::npos ? lo : parse_int(item.substr(dash + 1));
+    if (!lo || !hi || *lo < 0 || *hi < *lo || *hi >= CPU_SETSIZE) return false;
+    for (int c = *lo; c <= *hi; ++c) cpus.push_back(c);
+    return true;
+}
+
+// Warn once per role and setting; apply() runs on every new thread.
+std::atomic<uint32_t> g_warned{0};
+
+bool warn_once(ThreadRole role, int what) {
+    const uint32_t bit = 1u << (static_cast<int>(role) * 3 + what);
+    return !(g_warned.fetch_or(bit) & bit);
+}
+
+} // namespace
+
+const char* role_name(ThreadRole role) {
+    return kRoleNames[static_cast<size_t>(role)];
+}
+
+ThreadTopology::ThreadTopology() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof set, &set) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; ++c) {
+            if (CPU_ISSET(c, &set)) cpus_.push_back(c);
+        }
+    }
+    policies_[static_cast<size_t>(ThreadRole::Soul)].nice   = 5;
+    policies_[static_cast<size_t>(ThreadRole::Worker)].nice = 10;
+}
+
+bool ThreadTopology::parse(std::string_view spec, std::string* error) {
+    auto fail = [&](std::string why) {
+        if (error) *error = std::move(why);
+        return false;
+    };
+
+    auto parsed = policies_;
+    while (!spec.empty()) {
+        auto comma = spec.find(',');
+        auto entry = spec.substr(0, comma);
+        spec       = comma == std::string_view::npos ? std::string_view{} : spec.substr(comma + 1);
+        if (entry.empty()) continue;
+
+        auto eq = entry.find('=');
+        if (eq == std::string_view::npos) return fail("expected role=…, got '" + std::string(entry) + "'");
+        auto role = parse_role(entry.substr(0, eq));
+        if (!role) return fail("unknown role '" + std::string(entry.substr(0, eq)) + "'");
+
+        ThreadPolicy p;
+        for (auto items = entry.substr(eq + 1); !items.empty();) {
+            auto colon = items.find(':');
+            auto item  = items.substr(0, colon);
+            items      = colon == std::string_view::npos ? std::string_view{} : items.substr(colon + 1);
+
+            std::optional<int> v;
+            if (item.rfind("cpu", 0) == 0) {
+                if (!parse_cpus(item, p.cpus)) return fail("bad CPU range '" + std::string(item) + "'");
+            } else if (item.rfind("fifo", 0) == 0 && (v = parse_int(item.substr(4))) && *v >= 1 &&
+                       *v <= 99) {
+                p.fifo_priority = *v;
+            } else if (item.rfind("nice", 0) == 0 && (v = parse_int(item.substr(4))) && *v >= -20 &&
+                       *v <= 19) {
+                p.nice = *v;
+            } else {
+                return fail("bad setting '" + std::string(item) + "' (cpuN[-M], fifo1-99, nice-20-19)");
+            }
+        }
+        std::sort(p.cpus.begin(), p.cpus.end());
+        p.cpus.erase(std::unique(p.cpus.begin(), p.cpus.end()), p.cpus.end());
+        parsed[static_cast<size_t>(*role)] = std::move(p);
+    }
+    policies_ = std::move(parsed);
+    return true;
+}
+
+void ThreadTopology::set(ThreadRole role, ThreadPolicy policy) {
+    policies_[static_cast<size_t>(role)] = std::move(policy);
+}
+
+const ThreadPolicy& ThreadTopology::policy(ThreadRole role) const {
+    return policies_[static_cast<size_t>(role)];
+}
+
+bool ThreadTopology::apply(ThreadRole role) const {
+    const auto& p  = policy(role);
+    bool        ok = true;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : p.cpus.empty() ? cpus_ : p.cpus) CPU_SET(c, &set);
+    if (int rc = pthread_setaffinity_np(pthread_self(), sizeof set, &set); rc != 0) {
+        ok = false;
+        if (warn_once(role, 0)) {
+            PROMETHEUS_LOG(Warn, "[TOPOLOGY] Cannot pin {} threads: {}", role_name(role),
+                           std::strerror(rc));
+        }
+    }
+
+    // SCHED_RESET_ON_FORK: threads and processes this one starts do not
+    // inherit real-time priority.
+    sched_param sp{};
+    sp.sched_priority = p.fifo_priority;
+    const int policy  = p.fifo_priority > 0 ? SCHED_FIFO | SCHED_RESET_ON_FORK : SCHED_OTHER;
+    if (sched_setscheduler(0, policy, &sp) != 0) {
+        ok = false;
+        if (warn_once(role, 1)) {
+            PROMETHEUS_LOG(Warn, "[TOPOLOGY] SCHED_FIFO refused for {} threads ({}); needs "
+                           "CAP_SYS_NICE or RLIMIT_RTPRIO. Using normal scheduling.",
+                           role_name(role), std::strerror(errno));
+        }
+    }
+
+    // Linux nice values are per thread.
+    if (setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)), p.nice) != 0) {
+        ok = false;
+        if (warn_once(role, 2)) {
+            PROMETHEUS_LOG(Warn, "[TOPOLOGY] Cannot set nice {} for {} threads: {}", p.nice,
+                           role_name(role), std::strerror(errno));
+        }
+    }
+    return ok;
+}
+
+std::string ThreadTopology::describe() const {
+    std::string out;
+    for (size_t i = 0; i < kThreadRoles; ++i) {
+        const auto& p = policies_[i];
+        if (i) out += ", ";
+        out += kRoleNames[i];
+        if (p.cpus.empty()) {
+            out += " all";
+        } else {
+            // Runs of consecutive CPUs as cpuA-B.
+            for (size_t j = 0; j < p.cpus.size(); ++j) {
+                size_t k = j;
+                while (k + 1 < p.cpus.size() && p.cpus[k + 1] == p.cpus[k] + 1) ++k;
+                out += " cpu" + std::to_string(p.cpus[j]);
+                if (k > j) out += "-" + std::to_string(p.cpus[k]);
+                j = k;
+            }
+        }
+        if (p.fifo_priority) out += " fifo" + std::to_string(p.fifo_priority);
+        if (p.nice) out += " nice" + std::to_string(p.nice);
+    }
+    return out;
+}
+
+} // namespace prometheus
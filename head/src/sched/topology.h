@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace prometheus {
+
+// Which CPUs each kind of Head thread may run on, and how it is scheduled.
+//
+//     lizard      the reflex loop (poll → react → submit)
+//     dispatch    the scheduler's timer thread, which runs the arbiter tick
+//     soul        SoulScheduler workers (HTTP, big JSON responses)
+//     worker      scheduler workers: vibe checks (and the screenshot
+//                 processes they spawn), circadian work, Soul supervision
+//     background  everything else — event log, logger, metrics, embedding
+//
+// Each thread calls apply() for its role when it starts. A policy sets the
+// thread's CPU mask (empty: every CPU the process started with), SCHED_FIFO
+// at a priority (0: normal scheduling) and its nice value, so leaving a
+// role at the defaults also undoes whatever it inherited from its creator.
+// Child processes inherit the mask and nice value but not SCHED_FIFO.
+//
+// Defaults keep the reflex threads at nice 0 and lower the heavy work:
+// soul nice 5, worker nice 10. A spec overrides the roles it names:
+//
+//     lizard=cpu2:fifo20,dispatch=cpu3:fifo10,soul=cpu4-7:nice5,worker=cpu4-7:nice10
+//
+// SCHED_FIFO needs CAP_SYS_NICE (or an RLIMIT_RTPRIO); without it apply()
+// logs once and carries on with normal scheduling.
+enum class ThreadRole : uint8_t { Lizard, Dispatch, Soul, Worker, Background };
+
+inline constexpr size_t kThreadRoles = 5;
+
+const char* role_name(ThreadRole role);
+
+struct ThreadPolicy {
+    std::vector<int> cpus;              // empty: all CPUs the process started with
+    int              fifo_priority = 0; // 1–99: SCHED_FIFO; 0: SCHED_OTHER
+    int              nice          = 0;
+};
+
+class ThreadTopology {
+public:
+    // Captures the process's CPU mask; construct before any thread is pinned.
+    ThreadTopology();
+
+    // Apply a spec on top of the current policies. On a malformed spec
+    // nothing changes and `error` says why.
+    bool parse(std::string_view spec, std::string* error = nullptr);
+
+    void                set(ThreadRole role, ThreadPolicy policy);
+    const ThreadPolicy& policy(ThreadRole role) const;
+
+    // Apply the role's policy to the calling thread. False if any part was
+    // refused (logged); the rest still applies.
+    bool apply(ThreadRole role) const;
+
+    // "lizard cpu2 fifo20, dispatch all, …" for the start-up log.
+    std::string describe() const;
+
+    // CPUs available when the topology was built.
+    const std::vector<int>& cpus() const { return cpus_; }
+
+private:
+    std::array<ThreadPolicy, kThreadRoles> policies_;
+    std::vector<int>                       cpus_;
+};
+
+} // namespace prometheus
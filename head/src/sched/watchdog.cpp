@@ -0,0 +1,282 @@
+#include "sched/watchdog.h"
+#include "diag/trace.h"
+#include "log/log.h"
+#include "metrics/metrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include <dirent.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace prometheus {
+
+namespace {
+
+// ── Metrics ─────────────────────────────────────────────────────
+struct WatchdogMetrics {
+    Histogram& tick = metrics().histogram("head_reflex_tick_seconds",
+                                          "Lizard tick duration, percept received to reflex submitted.");
+    Counter& overruns = metrics().counter("head_reflex_overruns_total",
+                                          "Lizard ticks that ran past the watchdog budget.");
+};
+
+WatchdogMetrics& watchdog_metrics() {
+    static WatchdogMetrics m;
+    return m;
+}
+
+uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// ── /proc sampling ──────────────────────────────────────────────
+struct ThreadSample {
+    std::string name;
+    uint64_t    ran_ns{0};      // schedstat: time on a CPU
+    uint64_t    waited_ns{0};   // schedstat: runnable, waiting for a CPU
+    int         cpu{-1};        // stat field 39: CPU last run on
+};
+
+using Sample = std::unordered_map<long, ThreadSample>;
+
+bool read_file(const std::string& path, char* buf, size_t size) {
+    std::FILE* f = std::fopen(path.c_str(), "r");
+    if (!f) return false;
+    size_t n = std::fread(buf, 1, size - 1, f);
+    std::fclose(f);
+    buf[n] = '\0';
+    return n > 0;
+}
+
+Sample sample_threads() {
+    Sample out;
+    DIR* dir = ::opendir("/proc/self/task");
+    if (!dir) return out;
+    char buf[1024];
+    while (dirent* d = ::readdir(dir)) {
+        if (d->d_name[0] == '.') continue;
+        const long        tid  = std::strtol(d->d_name, nullptr, 10);
+        const std::string base = std::string("/proc/self/task/") + d->d_name;
+
+        ThreadSample s;
+        unsigned long long ran = 0, waited = 0;
+        if (read_file(base + "/schedstat", buf, sizeof buf) &&
+            std::sscanf(buf, "%llu %llu", &ran, &waited) == 2) {
+            s.ran_ns    = ran;
+            s.waited_ns = waited;
+        }
+        // "tid (comm) state …": the name may hold spaces, so split at the
+        // last ')'; the processor is the 37th field after it.
+        if (read_file(base + "/stat", buf, sizeof buf)) {
+            std::string_view stat(buf);
+            auto open  = stat.find('(');
+            auto close = stat.rfind(')');
+            if (open != std::string_view::npos && close != std::string_view::npos && close > open) {
+                s.name = std::string(stat.substr(open + 1, close - open - 1));
+                const char* p = buf + close + 1;
+                for (int field = 0; field < 37 && *p; ++field) {
+                    while (*p == ' ') ++p;
+                    if (field == 36) s.cpu = std::atoi(p);
+                    while (*p && *p != ' ') ++p;
+                }
+            }
+        }
+        out.emplace(tid, std::move(s));
+    }
+    ::closedir(dir);
+    return out;
+}
+
+double ms(uint64_t ns) {
+    return std::round(static_cast<double>(ns) / 1e5) / 10.0;    // 0.1 ms
+}
+
+} // namespace
+
+struct ReflexWatchdog::Impl {
+    Config cfg;
+
+    // Tick in progress (written by the Lizard thread).
+    std::atomic<uint64_t> tick_start_ns{0};     // 0: between ticks
+    std::atomic<uint64_t> tick_seq{0};
+    std::atomic<long>     lizard_tid{0};
+    std::atomic<uint64_t> ticks{0};
+    std::atomic<uint32_t> wake{0};              // bumped by begin() and stop()
+
+    mutable std::mutex  stats_mu;
+    uint64_t            overruns{0};
+    std::deque<Overrun> recent;
+
+    std::thread             thread;
+    std::mutex              mu;
+    std::condition_variable cv;
+    std::atomic<bool>       stopping{false};
+
+    void run();
+    void examine(uint64_t seq, uint64_t start_ns);
+};
+
+ReflexWatchdog::ReflexWatchdog() : ReflexWatchdog(Config{}) {}
+
+ReflexWatchdog::ReflexWatchdog(Config cfg) : impl_(std::make_unique<Impl>()) {
+    if (cfg.budget.count() < 1) cfg.budget = std::chrono::milliseconds(1);
+    impl_->cfg = cfg;
+    watchdog_metrics();
+}
+
+ReflexWatchdog::~ReflexWatchdog() { stop(); }
+
+void ReflexWatchdog::start() {
+    if (impl_->thread.joinable()) return;
+    impl_->stopping = false;
+    impl_->thread   = std::thread([this] { impl_->run(); });
+}
+
+void ReflexWatchdog::stop() {
+    {
+        std::lock_guard lock(impl_->mu);
+        impl_->stopping = true;
+    }
+    impl_->cv.notify_all();
+    impl_->wake.fetch_add(1, std::memory_order_release);
+    impl_->wake.notify_all();
+    if (impl_->thread.joinable()) impl_->thread.join();
+}
+
+void ReflexWatchdog::begin(uint64_t seq) {
+    if (!impl_->lizard_tid.load(std::memory_order_relaxed)) {
+        impl_->lizard_tid.store(static_cast<long>(::syscall(SYS_gettid)));
+    }
+    impl_->tick_seq.store(seq, std::memory_order_relaxed);
+    impl_->tick_start_ns.store(now_ns(), std::memory_order_release);
+    impl_->wake.fetch_add(1, std::memory_order_release);
+    impl_->wake.notify_one();
+}
+
+void ReflexWatchdog::end() {
+    const uint64_t start = impl_->tick_start_ns.exchange(0, std::memory_order_acq_rel);
+    if (!start) return;
+    watchdog_metrics().tick.record(now_ns() - start);
+    impl_->ticks.fetch_add(1, std::memory_order_relaxed);
+}
+
+ReflexWatchdog::Stats ReflexWatchdog::stats() const {
+    Stats s;
+    s.ticks = impl_->ticks.load();
+    std::lock_guard lock(impl_->stats_mu);
+    s.overruns = impl_->overruns;
+    s.recent.assign(impl_->recent.begin(), impl_->recent.end());
+    return s;
+}
+
+// ── Watchdog thread ─────────────────────────────────────────────
+
+void ReflexWatchdog::Impl::run() {
+    Trace::name_thread("watchdog");
+    const uint64_t budget_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(cfg.budget).count());
+
+    uint64_t flagged_start = 0;     // the tick already reported
+    uint32_t seen = wake.load(std::memory_order_acquire);
+    while (!stopping.load()) {
+        const uint64_t start = tick_start_ns.load(std::memory_order_acquire);
+        if (!start || start == flagged_start) {
+            // Between ticks: until the next begin() (or stop()).
+            wake.wait(seen, std::memory_order_acquire);
+            seen = wake.load(std::memory_order_acquire);
+            continue;
+        }
+
+        // A tick is running: look again when its budget is spent.
+        const std::chrono::steady_clock::time_point deadline{
+            std::chrono::nanoseconds(start + budget_ns)};
+        {
+            std::unique_lock lk(mu);
+            cv.wait_until(lk, deadline, [&] { return stopping.load(); });
+        }
+        if (stopping.load()) break;
+        if (tick_start_ns.load(std::memory_order_acquire) != start) continue;   // ended in time
+        flagged_start = start;
+        examine(tick_seq.load(std::memory_order_relaxed), start);
+    }
+}
+
+// Sample across budget/4 of an overrunning tick (less if it ends first)
+// and record who ran.
+void ReflexWatchdog::Impl::examine(uint64_t seq, uint64_t start_ns) {
+    TraceSpan span("watchdog.examine", seq);
+    const long self   = static_cast<long>(::syscall(SYS_gettid));
+    const long lizard = lizard_tid.load();
+    const auto window = std::max(std::chrono::milliseconds(1), cfg.budget / 4);
+
+    const uint64_t t0     = now_ns();
+    Sample         before = sample_threads();
+    const auto     until  = std::chrono::steady_clock::now() + window;
+    while (std::chrono::steady_clock::now() < until &&
+           tick_start_ns.load(std::memory_order_acquire) == start_ns) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    Sample         after = sample_threads();
+    const uint64_t t1    = now_ns();
+
+    Overrun o;
+    o.seq       = seq;
+    o.tick_ms   = ms(t1 - start_ns);
+    o.window_ms = ms(t1 - t0);
+
+    uint64_t ran = 0, waited = 0;
+    if (auto a = after.find(lizard), b = before.find(lizard); a != after.end() && b != before.end()) {
+        ran    = a->second.ran_ns - b->second.ran_ns;
+        waited = a->second.waited_ns - b->second.waited_ns;
+        o.cpu  = a->second.cpu;
+    }
+    o.lizard_ran_ms    = ms(ran);
+    o.lizard_waited_ms = ms(waited);
+    const uint64_t span_ns = std::max<uint64_t>(t1 - t0, 1);
+    o.verdict = ran * 2 >= span_ns ? "slow" : waited * 4 >= span_ns ? "preempted" : "blocked";
+
+    // Most CPU in the window, threads on the Lizard's CPU first.
+    uint64_t best_ran = 0;
+    bool     best_same_cpu = false;
+    for (auto& [tid, a] : after) {
+        if (tid == lizard || tid == self) continue;
+        auto b = before.find(tid);
+        if (b == before.end() || a.ran_ns <= b->second.ran_ns) continue;
+        const uint64_t d        = a.ran_ns - b->second.ran_ns;
+        const bool     same_cpu = o.cpu >= 0 && a.cpu == o.cpu;
+        if (std::pair(same_cpu, d) > std::pair(best_same_cpu, best_ran)) {
+            best_ran      = d;
+            best_same_cpu = same_cpu;
+            o.holder      = a.name;
+            o.holder_tid  = tid;
+        }
+    }
+    o.holder_ms = ms(best_ran);
+    if (o.holder.empty() && o.verdict == "preempted") o.holder = "another process";
+
+    watchdog_metrics().overruns.inc();
+    PROMETHEUS_LOG_EVERY(1000, Warn,
+                         "[WATCHDOG] Reflex tick {} over budget: {} ms ({} ms allowed), {} — "
+                         "lizard ran {} ms and waited {} ms of {} ms on cpu {}; most CPU: {} "
+                         "(tid {}, {} ms).",
+                         seq, o.tick_ms, static_cast<long>(cfg.budget.count()), o.verdict,
+                         o.lizard_ran_ms, o.lizard_waited_ms, o.window_ms, o.cpu,
+                         o.holder.empty() ? "none" : o.holder, o.holder_tid, o.holder_ms);
+
+    std::lock_guard lock(stats_mu);
+    ++overruns;
+    recent.push_back(std::move(o));
+    while (recent.size() > cfg.keep) recent.pop_front();
+}
+
+} // namespace prometheus
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace prometheus {
+
+// Flags reflex ticks that overrun their budget, and what had the CPU.
+//
+// The Lizard brackets each tick with begin(seq) / end(): two clock reads
+// and an update of head_reflex_tick_seconds, the tick-duration (jitter)
+// histogram. begin() also wakes the watchdog thread, which sleeps until
+// that tick's budget runs out and looks again; between ticks it sleeps
+// with no timeout, so an idle Head costs it no wake-ups. If the tick has
+// run past the budget it samples every Head thread's scheduler counters
+// (/proc/self/task/*/schedstat: time on a CPU, time runnable but
+// waiting) across the next budget/4, while the stall
+// is still going on, and names the thread that ran most — preferring
+// threads last seen on the Lizard's CPU. The Lizard's own share gives the
+// verdict: "slow" (it was running), "preempted" (it was runnable but
+// waiting) or "blocked" (neither: a lock, I/O or sleep).
+//
+// Thread names are the OS names Trace::name_thread sets.
+class ReflexWatchdog {
+public:
+    struct Config {
+        std::chrono::milliseconds budget{20};
+        size_t                    keep = 16;     // recent overruns kept for stats()
+    };
+
+    struct Overrun {
+        uint64_t    seq{0};
+        double      tick_ms{0};            // when sampled; the tick may have run on
+        double      window_ms{0};          // the sample window
+        double      lizard_ran_ms{0};      // in the window
+        double      lizard_waited_ms{0};   // runnable, not running
+        int         cpu{-1};               // the Lizard's last CPU
+        std::string verdict;               // "slow", "preempted" or "blocked"
+        std::string holder;                // thread that ran most ("" if none)
+        long        holder_tid{0};
+        double      holder_ms{0};
+    };
+
+    struct Stats {
+        uint64_t             ticks{0};
+        uint64_t             overruns{0};
+        std::vector<Overrun> recent;       // oldest first
+    };
+
+    ReflexWatchdog();
+    explicit ReflexWatchdog(Config cfg);
+    ~ReflexWatchdog();
+
+    ReflexWatchdog(const ReflexWatchdog&)            = delete;
+    ReflexWatchdog& operator=(const ReflexWatchdog&) = delete;
+
+    // Start / stop the watchdog thread.
+    void start();
+    void stop();
+
+    // Lizard thread: bracket one tick.
+    void begin(uint64_t seq);
+    void end();
+
+    Stats stats() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace prometheus
@@ -0,0 +1,238 @@
+#include "soul/prompt.h"
+#include "soul/soul.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace prometheus {
+
+static const char* kCouncilSystemPrompt =
+    "You are the Soul of Prometheus, a digital citizen of Minecraft.\n"
+    "Evaluate the following situation using the Council workflow:\n"
+    "  1. Safety Officer: identify any physical or ethical risks.\n"
+    "  2. Ethicist: weigh moral dimensions (Temporal Morality vectors).\n"
+    "  3. Strategist: propose an optimal plan.\n"
+    "  4. Synthesis: reconcile the above into a single action.\n"
+    "Respond in JSON: {\"action\": ..., \"reasoning\": ..., "
+    "\"override_safety\": false}";
+
+// ── TokenEstimator ──────────────────────────────────────────────
+
+int TokenEstimator::estimate(std::string_view text) const {
+    double letters = 0, digits = 0, punct = 0, multibyte = 0;
+    for (unsigned char c : text) {
+        if (c >= 0x80)                                 multibyte += 1;
+        else if (std::isalpha(c))                      letters   += 1;
+        else if (std::isdigit(c))                      digits    += 1;
+        else if (!std::isspace(c))                     punct     += 1;
+    }
+    double raw = letters / 4.0 + digits / 2.0 + punct + multibyte / 2.0;
+    return static_cast<int>(std::ceil(raw * scale()));
+}
+
+void TokenEstimator::calibrate(int estimated_text, int actual, int template_tokens) {
+    if (estimated_text <= 0 || actual <= template_tokens) return;
+    std::lock_guard lock(mu_);
+    double observed = static_cast<double>(actual - template_tokens)
+                    / (estimated_text / scale_);   // back to the unscaled count
+    scale_ += 0.1 * (std::clamp(observed, 0.5, 2.0) - scale_);
+}
+
+double TokenEstimator::scale() const {
+    std::lock_guard lock(mu_);
+    return scale_;
+}
+
+// ── Marker compaction ───────────────────────────────────────────
+
+std::vector<std::string> split_markers(const std::string& s) {
+    std::vector<std::string> out;
+    int depth = 0;
+    size_t start = 0;
+    for (size_t i = 0; i < s.size(); ++i) {
+        if (s[i] == '[') {
+            if (depth++ == 0) start = i;
+        } else if (s[i] == ']' && depth > 0) {
+            if (--depth == 0) out.push_back(s.substr(start, i - start + 1));
+        }
+    }
+    return out;
+}
+
+struct CompactMarker {
+    std::string text;
+    int         count{0};
+    size_t      last_seen{0};   // index of the newest occurrence
+};
+
+static std::vector<CompactMarker> compact_markers(const std::vector<std::string>& markers) {
+    std::unordered_map<std::string, size_t> index;
+    std::vector<CompactMarker> out;
+    for (size_t i = 0; i < markers.size(); ++i) {
+        auto [it, inserted] = index.try_emplace(markers[i], out.size());
+        if (inserted) out.push_back({markers[i], 0, 0});
+        auto& m = out[it->second];
+        m.count    += 1;
+        m.last_seen = i;
+    }
+    // Oldest first, so the newest context sits next to the query.
+    std::sort(out.begin(), out.end(),
+              [](const CompactMarker& a, const CompactMarker& b) {
+                  return a.last_seen < b.last_seen;
+              });
+    return out;
+}
+
+static std::string render(const CompactMarker& m) {
+    return m.count > 1 ? m.text + "×" + std::to_string(m.count) : m.text;
+}
+
+// ── Assembly ────────────────────────────────────────────────────
+
+AssembledPrompt build_council_messages(const SoulQuery& query,
+                                       const std::string& markers,
+                                       const PromptBudget& budget,
+                                       const TokenEstimator& estimator,
+                                       const std::vector<std::string>& recalled) {
+    AssembledPrompt out;
+
+    const int limit = std::min(budget.target_tokens,
+                               budget.ctx_tokens - budget.reserve_completion);
+
+    // 1. Fixed sections.
+    out.system_tokens = estimator.estimate(kCouncilSystemPrompt) + kTokensPerMessage;
+    out.image_tokens  = query.image_b64 ? budget.image_tokens : 0;
+    int used = out.system_tokens + out.image_tokens + kTokensPerMessage;
+
+    // 2. Query text. Only truncated if it cannot fit on its own.
+    std::string prompt = query.prompt;
+    out.query_tokens = estimator.estimate(prompt);
+    if (used + out.query_tokens > limit && out.query_tokens > 0) {
+        double keep = static_cast<double>(std::max(0, limit - used)) / out.query_tokens;
+        // Cut on a code-point boundary: a split UTF-8 sequence makes the
+        // JSON encoder throw.
+        size_t cut = static_cast<size_t>(prompt.size() * keep);
+        while (cut > 0 && (static_cast<unsigned char>(prompt[cut]) & 0xC0) == 0x80) --cut;
+        prompt.resize(cut);
+        out.query_tokens    = estimator.estimate(prompt);
+        out.query_truncated = true;
+    }
+    used += out.query_tokens;
+
+    // 3. Markers, newest first, until the marker budget runs out.
+    auto all = split_markers(markers);
+    auto compact = compact_markers(all);
+    out.markers_total = static_cast<int>(all.size());
+
+    int marker_budget = std::min(budget.max_marker_tokens,
+                                 limit - used - kTokensPerMessage);
+    std::vector<std::string> kept;
+    int marker_tokens = estimator.estimate("[MEMORY] ");
+    for (auto it = compact.rbegin(); it != compact.rend(); ++it) {
+        std::string r = render(*it);
+        int t = estimator.estimate(r);
+        if (marker_tokens + t > marker_budget) break;
+        marker_tokens += t;
+        kept.push_back(std::move(r));
+    }
+    std::reverse(kept.begin(), kept.end());
+    if (!kept.empty()) used += marker_tokens + kTokensPerMessage;
+
+    // 4. Recalled passages, in the order given, while they fit whole.
+    int recall_budget = std::min(budget.max_recall_tokens,
+                                 limit - used - kTokensPerMessage);
+    std::vector<const std::string*> passages;
+    int recall_tokens = estimator.estimate("[RECALL] ");
+    for (auto& p : recalled) {
+        int t = estimator.estimate(p);
+        if (recall_tokens + t > recall_budget) continue;
+        recall_tokens += t;
+        passages.push_back(&p);
+    }
+
+    // ── Messages ────────────────────────────────────────────────
+    out.messages.push_back({
+        {"role", "system"},
+        {"content", kCouncilSystemPrompt}
+    });
+
+    if (!kept.empty()) {
+        std::string section = "[MEMORY]";
+        for (auto& k : kept) section += ' ' + k;
+        out.messages.push_back({
+            {"role", "user"},
+            {"content", section}
+        });
+        out.marker_tokens = marker_tokens + kTokensPerMessage;
+        out.markers_kept  = static_cast<int>(kept.size());
+    }
+
+    if (!passages.empty()) {
+        std::string section = "[RECALL]";
+        for (auto* p : passages) section += '\n' + *p;
+        out.messages.push_back({
+            {"role", "user"},
+            {"content", section}
+        });
+        out.recall_tokens = recall_tokens + kTokensPerMessage;
+        out.passages_kept = static_cast<int>(passages.size());
+    }
+
+    if (query.image_b64) {
+        out.messages.push_back({
+            {"role", "user"},
+            {"content", {
+                {{"type", "image_url"},
+                 {"image_url", {{"url", "data:image/png;base64," + *query.image_b64}}}},
+                {{"type", "text"},
+                 {"text", prompt}}
+            }}
+        });
+    } else {
+        out.messages.push_back({
+            {"role", "user"},
+            {"content", prompt}
+        });
+    }
+
+    out.est_tokens = out.system_tokens + out.marker_tokens + out.recall_tokens
+                   + out.query_tokens + kTokensPerMessage + out.image_tokens;
+    return out;
+}
+
+// ── Images ──────────────────────────────────────────────────────
+
+std::string file_to_base64(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("Soul: cannot open " + path);
+
+    std::ostringstream ss;
+    ss << file.rdbuf();
+    std::string raw = ss.str();
+
+    static const char table[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    std::string b64;
+    b64.reserve(((raw.size() + 2) / 3) * 4);
+
+    for (size_t i = 0; i < raw.size(); i += 3) {
+        unsigned int n = (static_cast<unsigned char>(raw[i]) << 16);
+        if (i + 1 < raw.size()) n |= (static_cast<unsigned char>(raw[i + 1]) << 8);
+        if (i + 2 < raw.size()) n |= static_cast<unsigned char>(raw[i + 2]);
+
+        b64 += table[(n >> 18) & 0x3F];
+        b64 += table[(n >> 12) & 0x3F];
+        b64 += (i + 1 < raw.size()) ? table[(n >> 6) & 0x3F] : '=';
+        b64 += (i + 2 < raw.size()) ? table[n & 0x3F] : '=';
+    }
+    return b64;
+}
+
+} // namespace prometheus
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace prometheus {
+
+struct SoulQuery;
+
+// Token budget for one Soul request (per llama-server slot).
+struct PromptBudget {
+    int ctx_tokens         = 4096;  // slot context size
+    int reserve_completion = 512;   // kept free for the reply (max_tokens)
+    int target_tokens      = 2048;  // aim below ctx to keep prompt-eval cheap
+    int max_marker_tokens  = 384;   // cap on the [MEMORY] section
+    int max_recall_tokens  = 256;   // cap on the [RECALL] section
+    int image_tokens       = 1200;  // Qwen2.5-VL, 1280×720 frame
+};
+
+// Calibrated token estimator.
+// Counts by character class (letters ≈ 4/token, digits ≈ 2/token,
+// punctuation 1 each, multi-byte UTF-8 ≈ 2 bytes/token), then scales by
+// a factor learnt from the prompt_tokens llama-server reports back.
+class TokenEstimator {
+public:
+    int estimate(std::string_view text) const;
+
+    // Feed back a real count for a text-only request. `template_tokens`
+    // covers chat-template overhead not visible in the text.
+    void calibrate(int estimated_text, int actual, int template_tokens = 0);
+
+    double scale() const;
+
+private:
+    mutable std::mutex mu_;
+    double scale_{1.0};
+};
+
+// Result of assembling a Council prompt within a PromptBudget.
+struct AssembledPrompt {
+    nlohmann::json messages = nlohmann::json::array();
+    int est_tokens{0};        // whole prompt incl. template overhead
+    int system_tokens{0};
+    int marker_tokens{0};
+    int query_tokens{0};
+    int image_tokens{0};
+    int markers_kept{0};      // distinct markers after compaction
+    int markers_total{0};     // markers before compaction
+    int recall_tokens{0};
+    int passages_kept{0};     // recalled passages attached
+    bool query_truncated{false};
+};
+
+// Build the Council messages for a query. Sections in priority order:
+//   1. system prompt and image  — always sent
+//   2. query text               — truncated only if it alone overflows
+//   3. memory markers           — repeats collapsed to "×N", then the
+//                                 oldest dropped until the budget fits
+//   4. recalled passages        — most relevant first, whole passages only
+AssembledPrompt build_council_messages(const SoulQuery& query,
+                                       const std::string& markers,
+                                       const PromptBudget& budget,
+                                       const TokenEstimator& estimator,
+                                       const std::vector<std::string>& recalled = {});
+
+// Split "[MEM:A] [MEM:B x] [MEM:A]" into bracketed markers, oldest first.
+// Markers may contain spaces, so this splits on bracket depth.
+std::vector<std::string> split_markers(const std::string& markers);
+
+// Base64 of a file's contents — screenshots for the vision model.
+// Throws std::runtime_error if the file cannot be read.
+std::string file_to_base64(const std::string& path);
+
+// Chat-template overhead per message (role tags, separators).
+inline constexpr int kTokensPerMessage = 4;
+
+} // namespace prometheus
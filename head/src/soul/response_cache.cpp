@@ -0,0 +1,224 @@
+#include "soul/response_cache.h"
+#include "soul/prompt.h"
+#include "soul/soul.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+namespace prometheus {
+
+// ── Helpers ─────────────────────────────────────────────────────
+
+static uint64_t mix(uint64_t h, uint64_t v) {
+    // boost::hash_combine, widened to 64 bits.
+    return h ^ (v + 0x9e3779b97f4a7c15ull + (h << 12) + (h >> 4));
+}
+
+uint64_t situation_signature(const Percept& p) {
+    auto bucket = [](int n) { return n == 0 ? 0 : n == 1 ? 1 : n <= 3 ? 2 : 3; };
+    uint64_t h = 0;
+    h = mix(h, static_cast<uint64_t>(std::clamp(p.health, 0.0f, 20.0f)) / 4);
+    h = mix(h, static_cast<uint64_t>(std::clamp(p.hunger, 0.0f, 20.0f)) / 4);
+    h = mix(h, p.hostile_nearby ? 1 : 0);
+    h = mix(h, static_cast<uint64_t>(bucket(p.entity_count)));
+    h = mix(h, p.entity_sig);
+    return h;
+}
+
+// Compare the intent of two plans: the "action" field if both parse,
+// the raw JSON otherwise.
+static bool same_action(const std::string& a, const std::string& b) {
+    auto ja = nlohmann::json::parse(a, nullptr, false);
+    auto jb = nlohmann::json::parse(b, nullptr, false);
+    if (!ja.is_discarded() && !jb.is_discarded() &&
+        ja.contains("action") && jb.contains("action")) {
+        return ja["action"] == jb["action"];
+    }
+    return a == b;
+}
+
+// One JSON-lines record of the persistent tier.
+static std::string to_record(uint64_t key, const std::string& action_json,
+                             const std::string& reasoning,
+                             std::chrono::system_clock::time_point created) {
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(key));
+    return nlohmann::json{
+        {"key",             hex},
+        {"action_json",     action_json},
+        {"reasoning",       reasoning},
+        {"created",         std::chrono::duration_cast<std::chrono::seconds>(
+                                created.time_since_epoch()).count()},
+    }.dump();
+}
+
+// ── ResponseCache ───────────────────────────────────────────────
+
+ResponseCache::ResponseCache(Config cfg) : cfg_(std::move(cfg)) {
+    if (!cfg_.persist_path.empty()) {
+        load();
+        compact_file();
+    }
+}
+
+uint64_t ResponseCache::key(const SoulQuery& query, const std::string& markers) {
+    // Marker *set*: order and repetition don't change the situation.
+    auto list = split_markers(markers);
+    std::sort(list.begin(), list.end());
+    list.erase(std::unique(list.begin(), list.end()), list.end());
+
+    std::hash<std::string> hs;
+    uint64_t h = mix(0, query.situation);
+    for (auto& m : list) h = mix(h, hs(m));
+    h = mix(h, static_cast<uint64_t>(query.cls));
+    // The topic only says which queries supersede each other; queries on
+    // one topic can ask different things, so the text is keyed too.
+    h = mix(h, hs(query.topic));
+    h = mix(h, hs(query.prompt));
+    return h;
+}
+
+std::optional<SoulPlan> ResponseCache::lookup(uint64_t key) {
+    std::lock_guard lock(mu_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        stats_.misses += 1;
+        return std::nullopt;
+    }
+    if (std::chrono::steady_clock::now() >= it->second.expires) {
+        lru_.erase(it->second.lru);
+        entries_.erase(it);
+        stats_.expired += 1;
+        stats_.misses  += 1;
+        return std::nullopt;
+    }
+
+    lru_.splice(lru_.begin(), lru_, it->second.lru);
+    stats_.hits += 1;
+
+    SoulPlan plan;
+    plan.action_json     = it->second.action_json;
+    plan.reasoning       = it->second.reasoning;
+    plan.cached          = true;
+    return plan;
+}
+
+void ResponseCache::insert(uint64_t key, const SoulPlan& plan) {
+    // A replayed override would overrule a Layer 0 veto without anyone
+    // deliberating on the threat at hand.
+    if (plan.override_safety) return;
+
+    Entry e;
+    e.action_json = plan.action_json;
+    e.reasoning   = plan.reasoning;
+    e.created     = std::chrono::system_clock::now();
+    e.expires     = std::chrono::steady_clock::now() + cfg_.ttl;
+
+    std::lock_guard lock(mu_);
+    insert_locked(key, e);
+    append(key, e);     // after insert: append may compact the file
+}
+
+void ResponseCache::insert_locked(uint64_t key, Entry e) {
+    if (auto it = entries_.find(key); it != entries_.end()) {
+        lru_.erase(it->second.lru);
+        entries_.erase(it);
+    }
+    lru_.push_front(key);
+    e.lru = lru_.begin();
+    entries_.emplace(key, std::move(e));
+
+    while (entries_.size() > cfg_.max_entries) {
+        entries_.erase(lru_.back());
+        lru_.pop_back();
+        stats_.evictions += 1;
+    }
+}
+
+bool ResponseCache::should_audit() {
+    if (cfg_.audit_rate <= 0) return false;
+    std::lock_guard lock(mu_);
+    // Deterministic sampling: every 1/audit_rate-th hit.
+    auto every = static_cast<uint64_t>(1.0 / std::min(cfg_.audit_rate, 1.0));
+    return ++audit_counter_ % every == 0;
+}
+
+void ResponseCache::record_audit(const SoulPlan& cached, const SoulPlan& fresh) {
+    bool agree = same_action(cached.action_json, fresh.action_json);
+    std::lock_guard lock(mu_);
+    stats_.audits += 1;
+    if (agree) stats_.audit_agree += 1;
+}
+
+ResponseCache::Stats ResponseCache::stats() const {
+    std::lock_guard lock(mu_);
+    return stats_;
+}
+
+// ── Persistent tier ─────────────────────────────────────────────
+
+void ResponseCache::load() {
+    std::ifstream in(cfg_.persist_path);
+    if (!in) return;
+
+    auto now = std::chrono::system_clock::now();
+    size_t loaded = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        auto j = nlohmann::json::parse(line, nullptr, false);
+        if (j.is_discarded() || !j.contains("key")) continue;
+
+        Entry e;
+        e.created = std::chrono::system_clock::time_point(
+            std::chrono::seconds(j.value("created", int64_t{0})));
+        if (now - e.created > cfg_.persist_ttl) continue;
+        // Older files may hold override plans; those are never replayed.
+        if (j.value("override_safety", false)) continue;
+
+        e.action_json = j.value("action_json", "");
+        e.reasoning   = j.value("reasoning", "");
+        // Reloaded entries get a fresh in-memory lease.
+        e.expires     = std::chrono::steady_clock::now() + cfg_.ttl;
+        try {
+            insert_locked(std::stoull(j.value("key", ""), nullptr, 16), std::move(e));
+            ++loaded;
+        } catch (const std::exception&) {
+            // Malformed key — skip the record.
+        }
+    }
+    stats_.evictions = 0;   // overflow while reloading isn't a runtime eviction
+    std::cout << "[SOUL] Response cache: " << loaded << " entries loaded from "
+              << cfg_.persist_path << " (" << entries_.size() << " kept).\n";
+}
+
+void ResponseCache::append(uint64_t key, const Entry& e) {
+    if (!file_.is_open()) return;
+
+    file_ << to_record(key, e.action_json, e.reasoning, e.created)
+          << '\n' << std::flush;
+
+    // Superseded and evicted records pile up; rewrite once they dominate.
+    if (++file_records_ > 2 * cfg_.max_entries) compact_file();
+}
+
+void ResponseCache::compact_file() {
+    // Rewrite the file with just the live entries, oldest first.
+    file_.close();
+    {
+        std::ofstream out(cfg_.persist_path, std::ios::trunc);
+        for (auto it = lru_.rbegin(); it != lru_.rend(); ++it) {
+            auto& e = entries_.at(*it);
+            out << to_record(*it, e.action_json, e.reasoning, e.created)
+                << '\n';
+        }
+    }
+    file_records_ = entries_.size();
+    file_.open(cfg_.persist_path, std::ios::app);
+}
+
+} // namespace prometheus
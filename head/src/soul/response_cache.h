@@ -0,0 +1,98 @@
+#pragma once
+
+#include "lizard/lizard.h"   // for Percept
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace prometheus {
+
+struct SoulQuery;
+struct SoulPlan;
+
+// Normalised situation signature of a percept: health and food in
+// 4-point buckets, hostile flag, entity count bucket and the set of
+// nearby entity types. Position is deliberately excluded so the same
+// situation in a different place maps to the same key.
+uint64_t situation_signature(const Percept& percept);
+
+// Response cache in front of Soul::deliberate.
+// Keyed on (situation signature, active marker set, query class, topic,
+// prompt text). Entries expire after a TTL and the in-memory tier is
+// LRU-bounded. An optional JSON-lines file persists entries across
+// restarts.
+//
+// Plans that override a Layer 0 veto ([OVERRIDE: IGNORE_SAFETY]) are never
+// cached: each override needs a fresh deliberation.
+class ResponseCache {
+public:
+    struct Config {
+        size_t               max_entries = 256;
+        std::chrono::seconds ttl{600};
+        std::chrono::seconds persist_ttl{24 * 3600};  // on-disk entries older than
+                                                      // this are not reloaded
+        std::string          persist_path;            // empty → memory only
+        double               audit_rate = 0.05;       // hits re-deliberated
+    };
+
+    struct Stats {
+        uint64_t hits{0};
+        uint64_t misses{0};
+        uint64_t expired{0};
+        uint64_t evictions{0};
+        uint64_t audits{0};          // hits also run fresh for comparison
+        uint64_t audit_agree{0};     // ... where the action matched
+
+        double hit_rate() const {
+            uint64_t n = hits + misses;
+            return n ? static_cast<double>(hits) / n : 0.0;
+        }
+    };
+
+    explicit ResponseCache(Config cfg);
+
+    // Key for a query given the markers that would go into its prompt.
+    static uint64_t key(const SoulQuery& query, const std::string& markers);
+
+    std::optional<SoulPlan> lookup(uint64_t key);
+    void insert(uint64_t key, const SoulPlan& plan);    // ignores override plans
+
+    // Decide whether this hit should be audited against a fresh plan,
+    // and record the outcome afterwards.
+    bool should_audit();
+    void record_audit(const SoulPlan& cached, const SoulPlan& fresh);
+
+    Stats stats() const;
+
+private:
+    struct Entry {
+        std::string action_json;
+        std::string reasoning;
+        std::chrono::system_clock::time_point created;
+        std::chrono::steady_clock::time_point expires;
+        std::list<uint64_t>::iterator lru;
+    };
+
+    void load();
+    void append(uint64_t key, const Entry& e);
+    void compact_file();
+    void insert_locked(uint64_t key, Entry e);
+
+    Config cfg_;
+
+    mutable std::mutex mu_;
+    std::unordered_map<uint64_t, Entry> entries_;
+    std::list<uint64_t> lru_;              // front = most recent
+    std::ofstream       file_;
+    size_t              file_records_{0};
+    Stats               stats_;
+    uint64_t            audit_counter_{0};
+};
+
+} // namespace prometheus
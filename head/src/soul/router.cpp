@@ -0,0 +1,143 @@
+#include "soul/router.h"
+#include "soul/soul.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace prometheus {
+
+size_t SoulRouter::add(const BackendConfig& cfg) {
+    std::lock_guard lock(mu_);
+    State s;
+    s.cfg           = cfg;
+    s.cfg.slots     = std::max(1, cfg.slots);
+    s.stats.name    = cfg.name;
+    s.stats.ewma_ms = cfg.prior_latency_ms;
+    backends_.push_back(std::move(s));
+    return backends_.size() - 1;
+}
+
+size_t SoulRouter::size() const {
+    std::lock_guard lock(mu_);
+    return backends_.size();
+}
+
+BackendConfig SoulRouter::backend(size_t i) const {
+    std::lock_guard lock(mu_);
+    return backends_.at(i).cfg;
+}
+
+void SoulRouter::set_slots(size_t i, int slots) {
+    std::lock_guard lock(mu_);
+    backends_.at(i).cfg.slots = std::max(1, slots);
+}
+
+double SoulRouter::expected_ms(const State& s) const {
+    // Requests beyond the slot count queue behind the ones in flight.
+    double queue = static_cast<double>(s.stats.in_flight) / s.cfg.slots;
+    return s.stats.ewma_ms * (1.0 + queue);
+}
+
+std::optional<SoulRouter::Choice> SoulRouter::route(const SoulQuery& query) const {
+    using clock = std::chrono::steady_clock;
+    std::lock_guard lock(mu_);
+
+    auto now = clock::now();
+    double remaining_ms = std::numeric_limits<double>::infinity();
+    if (query.deadline != clock::time_point{}) {
+        remaining_ms = std::chrono::duration<double, std::milli>(query.deadline - now).count();
+    }
+
+    std::vector<size_t> candidates;
+    for (size_t i = 0; i < backends_.size(); ++i) {
+        const auto& b = backends_[i];
+        if (now < b.down_until)              continue;
+        if (query.image_b64 && !b.cfg.vision) continue;
+        candidates.push_back(i);
+    }
+    if (candidates.empty()) return std::nullopt;
+
+    auto fastest = *std::min_element(candidates.begin(), candidates.end(),
+        [&](size_t a, size_t b) {
+            double ea = expected_ms(backends_[a]), eb = expected_ms(backends_[b]);
+            if (ea != eb) return ea < eb;
+            return backends_[a].cfg.tier < backends_[b].cfg.tier;
+        });
+
+    Choice c{};
+    c.primary = fastest;
+
+    if (query.cls == QueryClass::Council) {
+        // Quality matters: the largest model that can still make the deadline.
+        int best_tier = -1;
+        for (size_t i : candidates) {
+            const auto& b = backends_[i];
+            if (expected_ms(b) <= remaining_ms && b.cfg.tier > best_tier) {
+                best_tier = b.cfg.tier;
+                c.primary = i;
+            }
+        }
+    }
+    c.expected_ms = expected_ms(backends_[c.primary]);
+
+    // Hedge onto the best alternative. Council queries hedge only onto a
+    // faster backend, and only late enough to still save the deadline;
+    // routine queries hedge once the primary runs past 1.5× its usual.
+    std::optional<size_t> alt;
+    for (size_t i : candidates) {
+        if (i == c.primary) continue;
+        if (!alt || expected_ms(backends_[i]) < expected_ms(backends_[*alt])) alt = i;
+    }
+    if (alt) {
+        double hedge_ms = expected_ms(backends_[*alt]);
+        double slack_ms = remaining_ms - hedge_ms;        // latest useful start
+        double after_ms = std::numeric_limits<double>::infinity();
+        if (query.cls == QueryClass::Council) {
+            if (hedge_ms < c.expected_ms) after_ms = slack_ms;
+        } else {
+            after_ms = std::min(1.5 * c.expected_ms, slack_ms);
+        }
+        if (after_ms < std::numeric_limits<double>::infinity()) {
+            c.hedge       = alt;
+            c.hedge_after = std::chrono::milliseconds(
+                static_cast<long>(std::max(0.0, after_ms)));
+        }
+    }
+    return c;
+}
+
+void SoulRouter::begin(size_t i, bool as_hedge) {
+    std::lock_guard lock(mu_);
+    auto& s = backends_.at(i).stats;
+    s.in_flight += 1;
+    s.requests  += 1;
+    if (as_hedge) s.hedges += 1;
+}
+
+void SoulRouter::finish(size_t i, double latency_ms, bool ok, bool sample) {
+    std::lock_guard lock(mu_);
+    auto& b = backends_.at(i);
+    b.stats.in_flight = std::max(0, b.stats.in_flight - 1);
+    if (!ok) {
+        b.stats.errors += 1;
+        b.down_until = std::chrono::steady_clock::now() + cool_off;
+        return;
+    }
+    if (sample) {
+        b.stats.ewma_ms += ewma_alpha * (latency_ms - b.stats.ewma_ms);
+    }
+}
+
+void SoulRouter::hedge_won(size_t i) {
+    std::lock_guard lock(mu_);
+    backends_.at(i).stats.hedge_wins += 1;
+}
+
+std::vector<SoulRouter::BackendStats> SoulRouter::stats() const {
+    std::lock_guard lock(mu_);
+    std::vector<BackendStats> out;
+    for (auto& b : backends_) out.push_back(b.stats);
+    return out;
+}
+
+} // namespace prometheus
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace prometheus {
+
+struct SoulQuery;
+
+// An OpenAI-compatible completion endpoint the Soul can deliberate on.
+struct BackendConfig {
+    std::string name;                 // for logs, e.g. "qwen-vl-32b"
+    std::string url;                  // e.g. http://127.0.0.1:8081
+    bool        vision{false};        // accepts image_url content
+    int         tier{0};              // model quality: higher = larger model
+    int         slots{1};             // concurrent decode slots
+    double      prior_latency_ms{5000}; // latency assumed before any samples
+};
+
+// Latency-aware router across Soul backends.
+// Tracks each backend's rolling (EWMA) request latency, in-flight count
+// and recent failures, and picks a backend per query:
+//   - image attached → vision-capable backends only
+//   - Council        → highest tier that can meet the deadline
+//   - Routine        → lowest expected completion time
+// Expected time is the rolling latency scaled by queue depth per slot.
+// When a faster backend exists, the choice includes a hedge: if the
+// primary hasn't answered by hedge_after, the same request is sent there.
+class SoulRouter {
+public:
+    struct Choice {
+        size_t                    primary;
+        std::optional<size_t>     hedge;
+        std::chrono::milliseconds hedge_after{0};
+        double                    expected_ms{0};
+    };
+
+    struct BackendStats {
+        std::string name;
+        double      ewma_ms{0};
+        int         in_flight{0};
+        uint64_t    requests{0};
+        uint64_t    errors{0};
+        uint64_t    hedges{0};        // times used as a hedge
+        uint64_t    hedge_wins{0};    // hedges that answered first
+    };
+
+    // Returns the backend index.
+    size_t add(const BackendConfig& cfg);
+
+    size_t               size() const;
+    BackendConfig        backend(size_t i) const;
+    void                 set_slots(size_t i, int slots);
+
+    // Pick a backend (and optional hedge) for a query. nullopt if no
+    // healthy backend can serve it.
+    std::optional<Choice> route(const SoulQuery& query) const;
+
+    // Request accounting. begin() before sending; finish() when the
+    // request ends. A failed request takes the backend out of rotation
+    // for a short cool-off.
+    void begin(size_t i, bool as_hedge = false);
+    void finish(size_t i, double latency_ms, bool ok, bool sample = true);
+    void hedge_won(size_t i);
+
+    std::vector<BackendStats> stats() const;
+
+    double ewma_alpha = 0.2;
+    std::chrono::seconds cool_off{10};
+
+private:
+    struct State {
+        BackendConfig cfg;
+        BackendStats  stats;
+        std::chrono::steady_clock::time_point down_until{};
+    };
+
+    double expected_ms(const State& s) const;
+
+    mutable std::mutex mu_;
+    std::vector<State> backends_;
+};
+
+} // namespace prometheus
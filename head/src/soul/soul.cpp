@@ -1,7 +1,12 @@
 #include "soul/soul.h"
+#include "diag/trace.h"
+#include "log/log.h"
+#include "metrics/metrics.h"
 
-#include <iostream>
+#include <algorithm>
+#include <future>
 #include <fstream>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <thread>
@@ -12,13 +17,49 @@
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include <nlohmann/json.hpp>
+
 #ifdef HAS_CURL
 #include <curl/curl.h>
-#include <nlohmann/json.hpp>
 #endif
 
 namespace prometheus {
 
+// Newest distinct markers whose prefetched passages go into a prompt.
+static constexpr size_t kRecallMarkers = 4;
+
+// ── Metrics ─────────────────────────────────────────────────────
+namespace {
+struct SoulMetrics {
+    static constexpr const char* kHttp     = "head_soul_http_seconds";
+    static constexpr const char* kHttpHelp = "Chat completion round trips per backend attempt, by outcome.";
+    static constexpr const char* kDone     = "head_soul_deliberations_total";
+    static constexpr const char* kDoneHelp = "Deliberations finished, by outcome.";
+    static constexpr const char* kErr      = "head_soul_errors_total";
+    static constexpr const char* kErrHelp  = "Deliberations that could not produce a plan, by cause.";
+    static constexpr const char* kTok      = "head_soul_tokens_total";
+    static constexpr const char* kTokHelp  = "Tokens reported by the backend.";
+    Histogram& http_ok           = metrics().histogram(kHttp, kHttpHelp, R"(outcome="ok")");
+    Histogram& http_error        = metrics().histogram(kHttp, kHttpHelp, R"(outcome="error")");
+    Histogram& deliberation      = metrics().histogram("head_soul_deliberation_seconds",
+                                                       "Query to plan for deliberations that completed.");
+    Counter&   completed         = metrics().counter(kDone, kDoneHelp, R"(outcome="completed")");
+    Counter&   cache_hits        = metrics().counter(kDone, kDoneHelp, R"(outcome="cache_hit")");
+    Counter&   cancelled         = metrics().counter(kDone, kDoneHelp, R"(outcome="cancelled")");
+    Counter&   no_backend        = metrics().counter(kErr, kErrHelp, R"(cause="no_backend")");
+    Counter&   not_connected     = metrics().counter(kErr, kErrHelp, R"(cause="not_connected")");
+    Counter&   http_errors       = metrics().counter(kErr, kErrHelp, R"(cause="http")");
+    Counter&   bad_response      = metrics().counter(kErr, kErrHelp, R"(cause="bad_response")");
+    Counter&   prompt_tokens     = metrics().counter(kTok, kTokHelp, R"(kind="prompt")");
+    Counter&   completion_tokens = metrics().counter(kTok, kTokHelp, R"(kind="completion")");
+};
+
+SoulMetrics& soul_metrics() {
+    static SoulMetrics m;
+    return m;
+}
+} // namespace
+
 // ── Helpers ─────────────────────────────────────────────────────
 
 #ifdef HAS_CURL
@@ -28,9 +69,23 @@ static size_t write_callback(char* ptr, size_t size, size_t nmemb, void* userdat
     return size * nmemb;
 }
 
+// Thrown by http_post when the caller's CancelToken fires mid-transfer.
+struct HttpCancelled : std::runtime_error {
+    HttpCancelled() : std::runtime_error("cancelled") {}
+};
+
+// Progress callback: a non-zero return aborts the transfer, closing the
+// connection so llama-server drops the task and frees its slot.
+static int cancel_callback(void* clientp, curl_off_t, curl_off_t,
+                           curl_off_t, curl_off_t) {
+    auto* token = static_cast<const CancelToken*>(clientp);
+    return token && token->cancelled() ? 1 : 0;
+}
+
 static std::string http_post(const std::string& url,
                              const std::string& json_body,
-                             long timeout_seconds = 120) {
+                             long timeout_seconds = 120,
+                             const CancelToken* cancel = nullptr) {
     CURL* curl = curl_easy_init();
     if (!curl) throw std::runtime_error("Soul: curl_easy_init failed");
 
@@ -44,11 +99,17 @@ static std::string http_post(const std::string& url,
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
     curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout_seconds);
+    if (cancel) {
+        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+        curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, cancel_callback);
+        curl_easy_setopt(curl, CURLOPT_XFERINFODATA, cancel);
+    }
 
     CURLcode res = curl_easy_perform(curl);
     curl_slist_free_all(headers);
     curl_easy_cleanup(curl);
 
+    if (res == CURLE_ABORTED_BY_CALLBACK) throw HttpCancelled();
     if (res != CURLE_OK) {
         throw std::runtime_error(std::string("Soul HTTP POST failed: ") +
                                  curl_easy_strerror(res));
@@ -76,62 +137,161 @@ static std::string http_get(const std::string& url, long timeout_seconds = 5) {
     return response;
 }
 
-// Base64-encode a file's contents (for sending images to the API).
-static std::string file_to_base64(const std::string& path) {
-    std::ifstream file(path, std::ios::binary);
-    if (!file) throw std::runtime_error("Soul: cannot open " + path);
-
-    std::ostringstream ss;
-    ss << file.rdbuf();
-    std::string raw = ss.str();
-
-    static const char table[] =
-        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-
-    std::string b64;
-    b64.reserve(((raw.size() + 2) / 3) * 4);
-
-    for (size_t i = 0; i < raw.size(); i += 3) {
-        unsigned int n = (static_cast<unsigned char>(raw[i]) << 16);
-        if (i + 1 < raw.size()) n |= (static_cast<unsigned char>(raw[i + 1]) << 8);
-        if (i + 2 < raw.size()) n |= static_cast<unsigned char>(raw[i + 2]);
-
-        b64 += table[(n >> 18) & 0x3F];
-        b64 += table[(n >> 12) & 0x3F];
-        b64 += (i + 1 < raw.size()) ? table[(n >> 6) & 0x3F] : '=';
-        b64 += (i + 2 < raw.size()) ? table[n & 0x3F] : '=';
-    }
-    return b64;
-}
 #endif // HAS_CURL
 
 // ── Pimpl ───────────────────────────────────────────────────────
 
 struct Soul::Impl {
     std::string server_url;       // e.g. http://127.0.0.1:8080
-    bool        connected{false};
+    std::atomic<bool> connected{false};   // healthy and warmed up
     pid_t       server_pid{0};    // PID of managed llama-server process
+
+    std::mutex  stats_mu;
+    Soul::Stats stats;
+
+    SoulRouter  router;
+    size_t      primary{0};       // router index of server_url
+
+    std::mutex     budget_mu;
+    PromptBudget   budget;
+    TokenEstimator estimator;
+
+    std::unique_ptr<ResponseCache> cache;   // set once by enable_cache()
+
+    // supervise_step() state, touched only by the step in progress.
+    struct Supervisor {
+        int  failed_probes{0};
+        int  restarts{0};
+        std::chrono::seconds backoff{1};
+        std::chrono::steady_clock::time_point started{};
+    } supervisor;
+
+    // Cancelled losing attempts of hedged requests, still unwinding.
+    std::mutex  straggler_mu;
+    std::vector<std::future<std::string>> stragglers;
+
+#ifdef HAS_CURL
+    std::string routed_post(const SoulRouter::Choice& choice,
+                            const std::string& body,
+                            const CancelToken* cancel,
+                            size_t& answered_by);
+#endif
 };
 
+#ifdef HAS_CURL
+// Send a chat completion to the routed backend. If the choice carries a
+// hedge, the same request also goes to the hedge backend once hedge_after
+// elapses (or immediately if the primary fails); the first good answer
+// wins and the other attempt is cancelled.
+std::string Soul::Impl::routed_post(const SoulRouter::Choice& choice,
+                                    const std::string& body,
+                                    const CancelToken* cancel,
+                                    size_t& answered_by) {
+    using clock = std::chrono::steady_clock;
+
+    struct Attempt {
+        size_t backend;
+        bool   hedge;
+        std::shared_ptr<CancelToken> token;
+        clock::time_point t0;
+        std::future<std::string> result;
+        bool   done{false};
+    };
+
+    {
+        std::lock_guard lock(straggler_mu);
+        std::erase_if(stragglers, [](auto& f) {
+            return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        });
+    }
+
+    std::vector<Attempt> attempts;
+    auto launch = [&](size_t b, bool hedge) {
+        auto token = std::make_shared<CancelToken>();
+        auto url   = router.backend(b).url + "/v1/chat/completions";
+        router.begin(b, hedge);
+        attempts.push_back({b, hedge, token, clock::now(),
+            std::async(std::launch::async, [url, body, token] {
+                return http_post(url, body, 300, token.get());
+            })});
+    };
+    auto abandon = [&](Attempt& a) {
+        a.done = true;
+        a.token->cancel();
+        router.finish(a.backend, 0, true, /*sample=*/false);
+        std::lock_guard lock(straggler_mu);
+        stragglers.push_back(std::move(a.result));
+    };
+
+    launch(choice.primary, false);
+    std::exception_ptr last_error;
+    const auto start = clock::now();
+
+    while (true) {
+        if (cancel && cancel->cancelled()) {
+            for (auto& a : attempts) if (!a.done) abandon(a);
+            throw HttpCancelled();
+        }
+
+        for (size_t i = 0; i < attempts.size(); ++i) {
+            auto& a = attempts[i];
+            if (a.done || a.result.wait_for(std::chrono::milliseconds(10))
+                              != std::future_status::ready) {
+                continue;
+            }
+            a.done = true;
+            double ms = std::chrono::duration<double, std::milli>(clock::now() - a.t0).count();
+            try {
+                std::string resp = a.result.get();
+                router.finish(a.backend, ms, true);
+                soul_metrics().http_ok.record(clock::now() - a.t0);
+                if (a.hedge) router.hedge_won(a.backend);
+                for (auto& other : attempts) if (!other.done) abandon(other);
+                answered_by = a.backend;
+                return resp;
+            } catch (...) {
+                router.finish(a.backend, ms, false);
+                soul_metrics().http_error.record(clock::now() - a.t0);
+                last_error = std::current_exception();
+            }
+        }
+
+        bool pending = std::any_of(attempts.begin(), attempts.end(),
+                                   [](const Attempt& a) { return !a.done; });
+        if (choice.hedge && attempts.size() == 1 &&
+            (!pending || clock::now() - start >= choice.hedge_after)) {
+            launch(*choice.hedge, true);
+        } else if (!pending) {
+            std::rethrow_exception(last_error);
+        }
+    }
+}
+#endif // HAS_CURL
+
 Soul::Soul(const std::string& server_url, Memory& mem)
     : impl_(std::make_unique<Impl>())
     , memory_(mem)
 {
+    soul_metrics();         // register the series before the first scrape
     impl_->server_url = server_url;
+    impl_->primary    = impl_->router.add({"primary", server_url, /*vision=*/true,
+                                           /*tier=*/1, /*slots=*/1, 5000});
 #ifdef HAS_CURL
     curl_global_init(CURL_GLOBAL_DEFAULT);
 #endif
 }
 
 Soul::~Soul() {
+    // Let cancelled hedge attempts unwind before curl is torn down.
+    impl_->stragglers.clear();
+
     // Kill the managed llama-server if we spawned it.
     if (impl_->server_pid > 0) {
-        std::cout << "[SOUL] Stopping llama-server (pid "
-                  << impl_->server_pid << ")...\n";
+        PROMETHEUS_LOG(Info, "[SOUL] Stopping llama-server (pid {})...", impl_->server_pid);
         kill(impl_->server_pid, SIGTERM);
         int status = 0;
         waitpid(impl_->server_pid, &status, 0);
-        std::cout << "[SOUL] llama-server stopped.\n";
+        PROMETHEUS_LOG(Info, "[SOUL] llama-server stopped.");
     }
 #ifdef HAS_CURL
     curl_global_cleanup();
@@ -140,20 +300,20 @@ Soul::~Soul() {
 
 // ── Server Process Management ───────────────────────────────────
 
-void Soul::spawn_server(const std::string& model_path,
-                        const std::string& mmproj_path,
-                        int gpu_layers, int ctx_size, int port) {
+void Soul::spawn_server(const ServerConfig& cfg) {
     if (impl_->server_pid > 0) {
-        std::cout << "[SOUL] llama-server already running (pid "
-                  << impl_->server_pid << ")\n";
+        PROMETHEUS_LOG(Info, "[SOUL] llama-server already running (pid {})", impl_->server_pid);
         return;
     }
 
-    std::string port_str    = std::to_string(port);
-    std::string layers_str  = std::to_string(gpu_layers);
-    std::string ctx_str     = std::to_string(ctx_size);
+    std::string port_str    = std::to_string(cfg.port);
+    std::string layers_str  = std::to_string(cfg.gpu_layers);
+    // llama-server splits -c evenly across slots.
+    std::string ctx_str     = std::to_string(cfg.ctx_size * cfg.parallel);
+    std::string slots_str   = std::to_string(cfg.parallel);
 
-    std::cout << "[SOUL] Spawning llama-server on port " << port << "...\n";
+    PROMETHEUS_LOG(Info, "[SOUL] Spawning llama-server on port {} ({} slots)...", cfg.port,
+                   cfg.parallel);
 
     pid_t pid = fork();
     if (pid < 0) {
@@ -163,23 +323,22 @@ void Soul::spawn_server(const std::string& model_path,
     if (pid == 0) {
         // Child — exec llama-server
         // Redirect stdout/stderr to a log file
-        std::string log_path = "/home/ben/prometheus/llama-server.log";
-        FILE* log = fopen(log_path.c_str(), "w");
+        FILE* log = fopen(cfg.log_path.c_str(), "a");
         if (log) {
             dup2(fileno(log), STDOUT_FILENO);
             dup2(fileno(log), STDERR_FILENO);
             fclose(log);
         }
 
-        std::string server_bin = "/home/ben/prometheus/llama.cpp/build/bin/llama-server";
-
-        execlp(server_bin.c_str(), "llama-server",
-               "-m", model_path.c_str(),
-               "--mmproj", mmproj_path.c_str(),
+        execlp(cfg.server_bin.c_str(), "llama-server",
+               "-m", cfg.model_path.c_str(),
+               "--mmproj", cfg.mmproj_path.c_str(),
                "-c", ctx_str.c_str(),
                "--host", "0.0.0.0",
                "--port", port_str.c_str(),
                "-ngl", layers_str.c_str(),
+               "--parallel", slots_str.c_str(),
+               "--cont-batching",
                nullptr);
 
         // If exec fails
@@ -189,50 +348,155 @@ void Soul::spawn_server(const std::string& model_path,
 
     // Parent
     impl_->server_pid = pid;
-    std::cout << "[SOUL] llama-server spawned (pid " << pid << ")\n";
+    impl_->router.set_slots(impl_->primary, cfg.parallel);
+    {
+        std::lock_guard lock(impl_->budget_mu);
+        impl_->budget.ctx_tokens = cfg.ctx_size;
+    }
+    PROMETHEUS_LOG(Info, "[SOUL] llama-server spawned (pid {})", pid);
 }
 
 // ── Connection (health-check with retries) ──────────────────────
 
-void Soul::connect() {
-    std::cout << "[SOUL] Connecting to llama-server at "
-              << impl_->server_url << "...\n";
+#ifdef HAS_CURL
+// Single /health probe. Returns the reported status ("" if unreachable).
+static std::string probe_health(const std::string& server_url) {
+    try {
+        auto json = nlohmann::json::parse(
+            http_get(server_url + "/health", 2), nullptr, false);
+        if (!json.is_discarded() && json.contains("status")) {
+            return json["status"].get<std::string>();
+        }
+    } catch (...) {
+        // Server not ready yet
+    }
+    return "";
+}
+#endif
+
+bool Soul::connect(int attempts) {
+    PROMETHEUS_LOG(Info, "[SOUL] Connecting to llama-server at {}...", impl_->server_url);
+
+#ifdef HAS_CURL
+    for (int attempt = 0; attempt < attempts; ++attempt) {
+        std::string status = probe_health(impl_->server_url);
+        if (status == "ok") {
+            impl_->connected = true;
+            PROMETHEUS_LOG(Info, "[SOUL] Connected to llama-server.");
+            return true;
+        }
+        if (!status.empty()) {
+            PROMETHEUS_LOG(Info, "[SOUL] Server status: {} (attempt {}/{})", status, attempt + 1,
+                           attempts);
+        }
+        if (attempt + 1 < attempts) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        }
+    }
+
+    return false;
+#else
+    (void)attempts;
+    impl_->connected = true;
+    PROMETHEUS_LOG(Info, "[SOUL] Connected (stub — no libcurl).");
+    return true;
+#endif
+}
+
+bool Soul::healthy() const {
+    return impl_->connected.load();
+}
 
+// ── Supervisor ──────────────────────────────────────────────────
+
+// One-token completion so the first real query doesn't pay for
+// weight paging and CUDA graph capture.
+static void warm_up(const std::string& server_url) {
 #ifdef HAS_CURL
-    std::string health_url = impl_->server_url + "/health";
+    nlohmann::json payload = {
+        {"messages", {{{"role", "user"}, {"content", "Ready?"}}}},
+        {"max_tokens", 1},
+    };
+    try {
+        http_post(server_url + "/v1/chat/completions", payload.dump(), 120);
+    } catch (const std::exception& e) {
+        PROMETHEUS_LOG(Warn, "[SOUL] Warm-up failed: {}", e.what());
+    }
+#else
+    (void)server_url;
+#endif
+}
+
+std::chrono::milliseconds Soul::supervise_step(const ServerConfig& cfg) {
+    using clock = std::chrono::steady_clock;
+    using std::chrono::milliseconds;
+
+    auto& sv = impl_->supervisor;
+    const bool managed = !cfg.server_bin.empty();
+    if (sv.started == clock::time_point{}) sv.started = clock::now();
+
+    // ── Reap a crashed child ────────────────────────────────────
+    if (managed && impl_->server_pid > 0) {
+        int status = 0;
+        if (waitpid(impl_->server_pid, &status, WNOHANG) == impl_->server_pid) {
+            PROMETHEUS_LOG(Error, "[SOUL] llama-server (pid {}) {} {} — Soul degraded, restarting in {} s.",
+                           impl_->server_pid,
+                           WIFSIGNALED(status) ? "killed by signal" : "exited with status",
+                           WIFSIGNALED(status) ? WTERMSIG(status) : WEXITSTATUS(status),
+                           sv.backoff.count());
+            impl_->server_pid = 0;
+            impl_->connected  = false;
+            auto wait = sv.backoff;
+            sv.backoff = std::min(sv.backoff * 2, std::chrono::seconds(60));
+            ++sv.restarts;
+            return wait;
+        }
+    }
 
-    for (int attempt = 0; attempt < 60; ++attempt) {
+    if (managed && impl_->server_pid == 0) {
         try {
-            std::string resp = http_get(health_url, 2);
-            auto json = nlohmann::json::parse(resp, nullptr, false);
-            if (!json.is_discarded() && json.contains("status")) {
-                std::string status = json["status"];
-                if (status == "ok") {
-                    impl_->connected = true;
-                    std::cout << "[SOUL] Connected to llama-server.\n";
-                    return;
-                }
-                std::cout << "[SOUL] Server status: " << status
-                          << " (attempt " << attempt + 1 << "/60)\n";
-            }
-        } catch (...) {
-            // Server not ready yet
+            spawn_server(cfg);
+            sv.started = clock::now();
+        } catch (const std::exception& e) {
+            PROMETHEUS_LOG(Error, "[SOUL] {}", e.what());
+            return sv.backoff;
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
     }
 
-    std::cerr << "[SOUL] WARNING: Could not connect to llama-server after 30s. "
-              << "Deliberation will fail until server is ready.\n";
+    // ── Health ──────────────────────────────────────────────────
+#ifdef HAS_CURL
+    bool ok = probe_health(impl_->server_url) == "ok";
 #else
-    impl_->connected = true;
-    std::cout << "[SOUL] Connected (stub — no libcurl).\n";
+    bool ok = true;
 #endif
+    if (!impl_->connected) {
+        if (ok) {
+            warm_up(impl_->server_url);
+            impl_->connected = true;
+            sv.backoff       = std::chrono::seconds(1);
+            sv.failed_probes = 0;
+            PROMETHEUS_LOG(Info, "[SOUL] Healthy after {} s (restarts: {}).",
+                           std::chrono::duration<double>(clock::now() - sv.started).count(),
+                           sv.restarts);
+        }
+        return milliseconds(500);
+    }
+
+    sv.failed_probes = ok ? 0 : sv.failed_probes + 1;
+    if (sv.failed_probes >= 3) {
+        PROMETHEUS_LOG(Error, "[SOUL] Health checks failing — Soul degraded.");
+        impl_->connected = false;
+        // A hung managed server is killed; the reaper above restarts it.
+        if (managed && impl_->server_pid > 0) kill(impl_->server_pid, SIGTERM);
+    }
+    return std::chrono::seconds(5);
 }
 
 // ── Vision: Observe a Screenshot ────────────────────────────────
 
 std::string Soul::observe(const std::string& screenshot_path) {
-    std::cout << "[SOUL] Observing: " << screenshot_path << "\n";
+    TraceSpan span("observe");
+    PROMETHEUS_LOG(Info, "[SOUL] Observing: {}", screenshot_path);
 
 #ifdef HAS_CURL
     if (!impl_->connected) {
@@ -271,7 +535,7 @@ std::string Soul::observe(const std::string& screenshot_path) {
         if (!json.is_discarded() && json.contains("choices")) {
             std::string desc = json["choices"][0]["message"]["content"];
             memory_.tag("[MEM:VIBE_CHECK]");
-            std::cout << "[SOUL] Observation: " << desc << "\n";
+            PROMETHEUS_LOG(Info, "[SOUL] Observation: {}", desc);
             return desc;
         }
         return "[observe: unexpected response format]";
@@ -284,77 +548,141 @@ std::string Soul::observe(const std::string& screenshot_path) {
 #endif
 }
 
-// ── Council Prompt Builder ──────────────────────────────────────
-
-static nlohmann::json build_council_messages(const SoulQuery& query) {
-    nlohmann::json messages = nlohmann::json::array();
-
-    messages.push_back({
-        {"role", "system"},
-        {"content", "You are the Soul of Prometheus, a digital citizen of Minecraft.\n"
-                    "Evaluate the following situation using the Council workflow:\n"
-                    "  1. Safety Officer: identify any physical or ethical risks.\n"
-                    "  2. Ethicist: weigh moral dimensions (Temporal Morality vectors).\n"
-                    "  3. Strategist: propose an optimal plan.\n"
-                    "  4. Synthesis: reconcile the above into a single action.\n"
-                    "Respond in JSON: {\"action\": ..., \"reasoning\": ..., "
-                    "\"override_safety\": false}"}
-    });
-
-    if (!query.context_markers.empty()) {
-        messages.push_back({
-            {"role", "user"},
-            {"content", "[MEMORY] " + query.context_markers}
-        });
-    }
-
-    if (query.image_b64) {
-        messages.push_back({
-            {"role", "user"},
-            {"content", {
-                {{"type", "image_url"},
-                 {"image_url", {{"url", "data:image/png;base64," + *query.image_b64}}}},
-                {{"type", "text"},
-                 {"text", query.prompt}}
-            }}
-        });
-    } else {
-        messages.push_back({
-            {"role", "user"},
-            {"content", query.prompt}
-        });
-    }
-
-    return messages;
-}
-
 // ── Deliberation ────────────────────────────────────────────────
 
 SoulPlan Soul::deliberate(const SoulQuery& query) {
-    std::cout << "[SOUL] Deliberating...\n";
+    using clock = std::chrono::steady_clock;
+    TraceSpan span("deliberate");
+
+    auto cancelled_plan = [&](clock::time_point t0) {
+        double spent = std::chrono::duration<double>(clock::now() - t0).count();
+        Stats st;
+        {
+            std::lock_guard lock(impl_->stats_mu);
+            impl_->stats.cancelled += 1;
+            impl_->stats.cancelled_backend_s += spent;
+            st = impl_->stats;
+        }
+        soul_metrics().cancelled.inc();
+        PROMETHEUS_LOG(Info, "[SOUL] Deliberation {} cancelled after {} s (cancelled {} / completed {}).",
+                       query.id, spent, st.cancelled, st.completed);
+        SoulPlan plan;
+        plan.query_id  = query.id;
+        plan.cancelled = true;
+        return plan;
+    };
+
+    auto t0 = clock::now();
+    if (query.cancel && query.cancel->cancelled()) return cancelled_plan(t0);
+
+    const std::string markers =
+        query.context_markers.empty() ? memory_.active_markers() : query.context_markers;
+
+    // ── Response cache ──────────────────────────────────────────
+    // A sampled fraction of hits is deliberated anyway so cached and
+    // fresh plans can be compared.
+    ResponseCache* cache = query.cacheable ? impl_->cache.get() : nullptr;
+    uint64_t cache_key = 0;
+    std::optional<SoulPlan> cached;
+    if (cache) {
+        cache_key = ResponseCache::key(query, markers);
+        cached    = cache->lookup(cache_key);
+        if (cached && !cache->should_audit()) {
+            cached->query_id = query.id;
+            cached->backend  = "cache";
+            soul_metrics().cache_hits.inc();
+            PROMETHEUS_LOG(Info, "[SOUL] Cache hit — plan served in {} us.",
+                           std::chrono::duration_cast<std::chrono::microseconds>(
+                               clock::now() - t0).count());
+            return *cached;
+        }
+    }
+    auto remember = [&](const SoulPlan& plan) {
+        if (!cache) return;
+        if (cached) cache->record_audit(*cached, plan);
+        cache->insert(cache_key, plan);
+    };
 
-    auto messages = build_council_messages(query);
+    auto choice = impl_->router.route(query);
+    if (!choice) {
+        soul_metrics().no_backend.inc();
+        SoulPlan plan;
+        plan.query_id    = query.id;
+        plan.action_json = R"({"action":"idle","reason":"no_soul_backend"})";
+        plan.reasoning   = "No healthy backend can serve this query.";
+        return plan;
+    }
+    PROMETHEUS_LOG(Info, "[SOUL] Deliberating on {} (expected {} ms{})...",
+                   impl_->router.backend(choice->primary).name,
+                   static_cast<long>(choice->expected_ms), choice->hedge ? ", hedged" : "");
+
+    PromptBudget budget;
+    {
+        std::lock_guard lock(impl_->budget_mu);
+        budget = impl_->budget;
+    }
+    // Long-term passages already staged for the newest markers. Only what
+    // the prefetcher has ready is used; recall never runs on this path.
+    std::vector<std::string> recalled;
+    {
+        auto list = split_markers(markers);
+        std::vector<std::string> seen;
+        for (auto it = list.rbegin(); it != list.rend() && seen.size() < kRecallMarkers; ++it) {
+            if (std::find(seen.begin(), seen.end(), *it) != seen.end()) continue;
+            seen.push_back(*it);
+            for (auto& p : memory_.prefetched(*it)) {
+                if (std::find(recalled.begin(), recalled.end(), p) == recalled.end()) {
+                    recalled.push_back(std::move(p));
+                }
+            }
+        }
+    }
+    auto prompt = build_council_messages(query, markers, budget, impl_->estimator, recalled);
+    const int template_tokens = static_cast<int>(prompt.messages.size()) * kTokensPerMessage;
 
 #ifdef HAS_CURL
     if (!impl_->connected) {
+        soul_metrics().not_connected.inc();
         SoulPlan plan;
+        plan.query_id    = query.id;
         plan.action_json = R"({"action":"idle","reason":"soul_not_connected"})";
         plan.reasoning   = "Cannot deliberate — llama-server not connected.";
         return plan;
     }
 
     nlohmann::json payload = {
-        {"messages",    messages},
-        {"max_tokens",  512},
+        {"messages",    prompt.messages},
+        {"max_tokens",  budget.reserve_completion},
         {"temperature", 0.4},
     };
 
     try {
-        std::string resp = http_post(impl_->server_url + "/v1/chat/completions",
-                                     payload.dump(), 300);
+        size_t answered_by = choice->primary;
+        std::string resp = impl_->routed_post(*choice, payload.dump(),
+                                              query.cancel.get(), answered_by);
         auto json = nlohmann::json::parse(resp, nullptr, false);
 
         SoulPlan plan;
+        plan.query_id = query.id;
+        plan.backend  = impl_->router.backend(answered_by).name;
+        int actual_prompt = -1;
+        if (!json.is_discarded() && json.contains("usage")) {
+            plan.completion_tokens = json["usage"].value("completion_tokens", 0u);
+            actual_prompt          = json["usage"].value("prompt_tokens", -1);
+            soul_metrics().completion_tokens.inc(plan.completion_tokens);
+            if (actual_prompt > 0) soul_metrics().prompt_tokens.inc(static_cast<uint64_t>(actual_prompt));
+        }
+        PROMETHEUS_LOG(Info,
+                       "[SOUL] Prompt tokens: est {}, actual {} (system {}, markers {} [{}/{} kept], "
+                       "recall {} [{}/{}], query {}{}, image {})",
+                       prompt.est_tokens, actual_prompt, prompt.system_tokens, prompt.marker_tokens,
+                       prompt.markers_kept, prompt.markers_total, prompt.recall_tokens,
+                       prompt.passages_kept, recalled.size(), prompt.query_tokens,
+                       prompt.query_truncated ? " truncated" : "", prompt.image_tokens);
+        if (actual_prompt > 0 && !query.image_b64) {
+            impl_->estimator.calibrate(prompt.est_tokens - template_tokens,
+                                       actual_prompt, template_tokens);
+        }
         if (!json.is_discarded() && json.contains("choices")) {
             std::string content = json["choices"][0]["message"]["content"];
 
@@ -364,35 +692,88 @@ SoulPlan Soul::deliberate(const SoulQuery& query) {
                 plan.action_json = content;
                 plan.reasoning   = inner.value("reasoning", content);
                 plan.override_safety = inner.value("override_safety", false);
+                remember(plan);
             } else {
                 plan.action_json = R"({"action":"explore","reason":"freeform_response"})";
                 plan.reasoning   = content;
             }
         } else {
+            soul_metrics().bad_response.inc();
             plan.action_json = R"({"action":"idle","reason":"bad_response"})";
             plan.reasoning   = "Unexpected response from llama-server.";
         }
 
+        {
+            std::lock_guard lock(impl_->stats_mu);
+            impl_->stats.completed += 1;
+            impl_->stats.completion_tokens += plan.completion_tokens;
+        }
+        soul_metrics().completed.inc();
+        soul_metrics().deliberation.record(clock::now() - t0);
         memory_.tag("[MEM:SOUL_CONSULTED]");
-        std::cout << "[SOUL] Deliberation complete.\n";
+        PROMETHEUS_LOG(Info, "[SOUL] Deliberation complete.");
         return plan;
 
+    } catch (const HttpCancelled&) {
+        return cancelled_plan(t0);
     } catch (const std::exception& e) {
-        std::cerr << "[SOUL] Deliberation HTTP error: " << e.what() << "\n";
+        soul_metrics().http_errors.inc();
+        PROMETHEUS_LOG(Error, "[SOUL] Deliberation HTTP error: {}", e.what());
         SoulPlan plan;
+        plan.query_id    = query.id;
         plan.action_json = R"({"action":"idle","reason":"http_error"})";
         plan.reasoning   = std::string("HTTP error: ") + e.what();
         return plan;
     }
 #else
+    (void)template_tokens;
+    PROMETHEUS_LOG(Info, "[SOUL] Prompt tokens: est {}", prompt.est_tokens);
     SoulPlan plan;
+    plan.query_id       = query.id;
+    plan.backend        = impl_->router.backend(choice->primary).name;
     plan.action_json    = R"({"action":"explore","reason":"stub_deliberation"})";
     plan.reasoning      = "Council not yet implemented — stub response.";
     plan.override_safety = false;
+    remember(plan);
+    {
+        std::lock_guard lock(impl_->stats_mu);
+        impl_->stats.completed += 1;
+    }
+    soul_metrics().completed.inc();
+    soul_metrics().deliberation.record(clock::now() - t0);
     memory_.tag("[MEM:SOUL_CONSULTED]");
-    std::cout << "[SOUL] Deliberation complete (stub).\n";
+    PROMETHEUS_LOG(Info, "[SOUL] Deliberation complete (stub).");
     return plan;
 #endif
 }
 
+Soul::Stats Soul::stats() const {
+    std::lock_guard lock(impl_->stats_mu);
+    return impl_->stats;
+}
+
+void Soul::set_prompt_budget(const PromptBudget& budget) {
+    std::lock_guard lock(impl_->budget_mu);
+    impl_->budget = budget;
+}
+
+void Soul::enable_cache(const ResponseCache::Config& cfg) {
+    impl_->cache = std::make_unique<ResponseCache>(cfg);
+}
+
+std::optional<ResponseCache::Stats> Soul::cache_stats() const {
+    if (!impl_->cache) return std::nullopt;
+    return impl_->cache->stats();
+}
+
+void Soul::add_backend(const BackendConfig& cfg) {
+    impl_->router.add(cfg);
+    PROMETHEUS_LOG(Info, "[SOUL] Backend '{}' at {} (tier {}{})", cfg.name, cfg.url, cfg.tier,
+                   cfg.vision ? ", vision" : "");
+}
+
+std::vector<SoulRouter::BackendStats> Soul::backend_stats() const {
+    return impl_->router.stats();
+}
+
 } // namespace prometheus
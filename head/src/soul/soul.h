@@ -1,54 +1,141 @@
 #pragma once
 
 #include "memory/memory.h"
+#include "soul/prompt.h"
+#include "soul/response_cache.h"
+#include "soul/router.h"
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace prometheus {
 
+// Cancellation handle shared between the Arbiter and an in-flight
+// deliberation. Cancelling aborts the HTTP request, which frees the
+// llama-server slot.
+class CancelToken {
+public:
+    void cancel()          { cancelled_.store(true, std::memory_order_relaxed); }
+    bool cancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> cancelled_{false};
+};
+
+// How much a query needs the big model (see SoulRouter).
+enum class QueryClass : uint8_t {
+    Routine,    // "what next" — latency matters more than depth
+    Council,    // ethical / safety reasoning — stays on the largest model
+};
+
 // A high-level query escalated from the Arbiter to the Soul.
 struct SoulQuery {
+    uint64_t    id{0};                      // assigned by the Arbiter
+    std::string topic;                      // newer queries on a topic supersede older
+    QueryClass  cls{QueryClass::Council};
+    uint64_t    situation{0};               // situation_signature() at escalation
+    std::chrono::steady_clock::time_point deadline{};     // zero = none
     std::string prompt;                     // assembled prompt text
     std::optional<std::string> image_b64;   // screenshot for Qwen-VL vision
-    std::string context_markers;            // active memory markers
+    std::string context_markers;            // active memory markers (empty → Memory's)
+    bool        cacheable{true};            // false → always deliberated, never cached
+    std::shared_ptr<CancelToken> cancel;    // set by the Arbiter
+    std::chrono::steady_clock::time_point enqueued_at{};  // for queueing delay
 };
 
 // The Soul's response — a deliberated plan or ethical assessment.
 struct SoulPlan {
+    uint64_t    query_id{0};    // SoulQuery::id this plan answers
     std::string action_json;    // high-level intent for the body
     std::string reasoning;      // chain-of-thought / council trace
     bool        override_safety{false}; // [OVERRIDE: IGNORE_SAFETY] flag
+    bool        cancelled{false};       // query was cancelled; discard
+    uint32_t    completion_tokens{0};   // tokens generated (from usage)
+    std::string backend;                // name of the backend that answered
+    bool        cached{false};          // served from the ResponseCache
 };
 
 // System 2 — The Soul
 // Communicates with an external llama-server hosting Qwen 2.5-VL-32B
 // over async HTTP. Handles vision tokens and the Council workflow.
+// Additional OpenAI-compatible backends (e.g. a small text model) can be
+// registered; deliberations are then routed per query by SoulRouter.
 class Soul {
 public:
+    // Deliberation outcome counters.
+    struct Stats {
+        uint64_t completed{0};
+        uint64_t cancelled{0};
+        double   cancelled_backend_s{0};   // backend time spent before cancel
+        uint64_t completion_tokens{0};     // across completed deliberations
+    };
+
+    // server_url is the primary backend: the large vision model that
+    // spawn_server/supervise manage.
     Soul(const std::string& server_url, Memory& mem);
     ~Soul();
 
     Soul(const Soul&) = delete;
     Soul& operator=(const Soul&) = delete;
 
+    // How to launch a managed llama-server.
+    struct ServerConfig {
+        std::string server_bin;    // empty → external server, never spawned
+        std::string model_path;
+        std::string mmproj_path;
+        std::string log_path = "llama-server.log";
+        int gpu_layers = 99;
+        int ctx_size   = 4096;     // per slot
+        int port       = 8080;
+        int parallel   = 1;        // llama-server decode slots (--parallel)
+    };
+
     // Spawn the llama-server process (if not already running).
-    void spawn_server(const std::string& model_path,
-                      const std::string& mmproj_path,
-                      int gpu_layers = 99,
-                      int ctx_size   = 4096,
-                      int port       = 8080);
+    void spawn_server(const ServerConfig& cfg);
+
+    // Verify the llama-server is reachable (500 ms between attempts).
+    // Returns true once /health reports ok.
+    bool connect(int attempts = 60);
 
-    // Verify the llama-server is reachable (retries for up to ~30s).
-    void connect();
+    // One supervisor step; returns the delay until the next one, so the
+    // caller can schedule it (see Scheduler). Spawns llama-server (if
+    // managed), waits for health, runs a warm-up inference, then keeps
+    // probing; a crash or failed probes mark the Soul degraded and
+    // trigger a restart with exponential backoff.
+    std::chrono::milliseconds supervise_step(const ServerConfig& cfg);
+
+    // True once the backend is healthy and warmed up. While false the
+    // Soul is degraded and only the Lizard drives the body.
+    bool healthy() const;
 
     // Analyse a screenshot and return a textual scene description.
     std::string observe(const std::string& screenshot_path);
 
     // Synchronous deliberation (called from the soul thread).
+    // Returns early with plan.cancelled set if query.cancel fires.
     SoulPlan deliberate(const SoulQuery& query);
 
+    Stats stats() const;
+
+    // Token budget for deliberation prompts. spawn_server sets
+    // ctx_tokens from its per-slot context size.
+    void set_prompt_budget(const PromptBudget& budget);
+
+    // Put a response cache in front of deliberate().
+    void enable_cache(const ResponseCache::Config& cfg);
+    std::optional<ResponseCache::Stats> cache_stats() const;
+
+    // Register an additional deliberation backend.
+    void add_backend(const BackendConfig& cfg);
+
+    // Per-backend routing statistics.
+    std::vector<SoulRouter::BackendStats> backend_stats() const;
+
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
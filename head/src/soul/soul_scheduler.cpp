@@ -0,0 +1,78 @@
+#include "soul/soul_scheduler.h"
+#include "diag/trace.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace prometheus {
+
+SoulScheduler::SoulScheduler(Soul& soul, int slots, QuerySource next, PlanSink done)
+    : soul_(soul)
+    , slots_(std::max(1, slots))
+    , next_(std::move(next))
+    , done_(std::move(done)) {}
+
+SoulScheduler::~SoulScheduler() { join(); }
+
+void SoulScheduler::start(std::atomic<bool>& running, std::function<void()> on_start) {
+    for (int i = 0; i < slots_; ++i) {
+        workers_.emplace_back([this, &running, on_start] { worker(running, on_start); });
+    }
+}
+
+void SoulScheduler::join() {
+    for (auto& t : workers_) {
+        if (t.joinable()) t.join();
+    }
+    workers_.clear();
+}
+
+SoulScheduler::Stats SoulScheduler::stats() const {
+    std::lock_guard lock(stats_mu_);
+    return stats_;
+}
+
+void SoulScheduler::worker(std::atomic<bool>& running, const std::function<void()>& on_start) {
+    using clock = std::chrono::steady_clock;
+    Trace::name_thread("soul");
+    if (on_start) on_start();
+
+    while (running.load()) {
+        if (!soul_.healthy()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
+        }
+
+        auto query = next_();
+        if (!query) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            continue;
+        }
+
+        double delay_ms = 0;
+        if (query->enqueued_at != clock::time_point{}) {
+            delay_ms = std::chrono::duration<double, std::milli>(
+                clock::now() - query->enqueued_at).count();
+        }
+        int now_in_flight = in_flight_.fetch_add(1) + 1;
+        {
+            std::lock_guard lock(stats_mu_);
+            stats_.dispatched += 1;
+            stats_.queue_delay_ms_sum += delay_ms;
+            stats_.queue_delay_ms_max = std::max(stats_.queue_delay_ms_max, delay_ms);
+            stats_.peak_in_flight     = std::max(stats_.peak_in_flight, now_in_flight);
+        }
+
+        auto plan = soul_.deliberate(*query);
+        in_flight_.fetch_sub(1);
+
+        if (!plan.cancelled) {
+            std::lock_guard lock(stats_mu_);
+            stats_.completed += 1;
+            stats_.completion_tokens += plan.completion_tokens;
+        }
+        done_(std::move(plan));
+    }
+}
+
+} // namespace prometheus
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "soul/soul.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace prometheus {
+
+// Soul Scheduler — dispatches up to `slots` queued queries concurrently,
+// one worker per llama-server decode slot, so several deliberations share
+// a continuous batch instead of waiting in line. Plans are handed to the
+// sink as each one completes, in completion order.
+class SoulScheduler {
+public:
+    using QuerySource = std::function<std::optional<SoulQuery>()>;
+    using PlanSink    = std::function<void(SoulPlan)>;
+
+    struct Stats {
+        uint64_t dispatched{0};
+        uint64_t completed{0};            // non-cancelled plans
+        uint64_t completion_tokens{0};
+        double   queue_delay_ms_sum{0};   // enqueue → dispatch
+        double   queue_delay_ms_max{0};
+        int      peak_in_flight{0};
+
+        double mean_queue_delay_ms() const {
+            return dispatched ? queue_delay_ms_sum / dispatched : 0.0;
+        }
+    };
+
+    SoulScheduler(Soul& soul, int slots, QuerySource next, PlanSink done);
+    ~SoulScheduler();
+
+    SoulScheduler(const SoulScheduler&) = delete;
+    SoulScheduler& operator=(const SoulScheduler&) = delete;
+
+    // Start one worker per slot. Workers idle while the Soul is degraded
+    // and exit once `running` goes false. `on_start` runs first on each
+    // (e.g. to pin it).
+    void start(std::atomic<bool>& running, std::function<void()> on_start = {});
+    void join();
+
+    int   slots() const { return slots_; }
+    Stats stats() const;
+
+private:
+    void worker(std::atomic<bool>& running, const std::function<void()>& on_start);
+
+    Soul&       soul_;
+    int         slots_;
+    QuerySource next_;
+    PlanSink    done_;
+
+    std::vector<std::thread> workers_;
+    std::atomic<int>         in_flight_{0};
+
+    mutable std::mutex stats_mu_;
+    Stats              stats_;
+};
+
+} // namespace prometheus
@@ -1,58 +1,497 @@
 #include "teacher/teacher.h"
+#include "log/log.h"
 
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <deque>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 
-// TODO: #include <curl/curl.h>
-// TODO: #include <nlohmann/json.hpp>
+#include <nlohmann/json.hpp>
+
+#ifdef HAS_CURL
+#include <curl/curl.h>
+#endif
 
 namespace prometheus {
 
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double ms_since(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+// Bumped whenever the prompts change, so cached grades are not reused
+// for a different question.
+constexpr const char* kPromptVersion = "teacher-v1";
+
+constexpr const char* kMapPrompt =
+    "You are the Teacher of Prometheus, a Minecraft agent with fast reflexes "
+    "(the Lizard) and slow deliberation (the Soul). Below is one window of its "
+    "session log. Grade how well it behaved in this window and note what it "
+    "should learn.\n"
+    "Reply with JSON: {\"grade\": a letter A-F, \"summary\": one or two "
+    "sentences, \"lessons\": up to two short imperative lessons}.\n\n"
+    "Session window:\n";
+
+constexpr const char* kReducePrompt =
+    "You are the Teacher of Prometheus, a Minecraft agent. Below are graded "
+    "summaries of consecutive windows of one day. Distil them into the day's "
+    "lessons: short imperative sentences, most important first, no duplicates.\n"
+    "Reply with JSON: {\"lessons\": [...]} with at most ";
+
+uint64_t fnv1a(std::string_view s, uint64_t h = 1469598103934665603ull) {
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// Cut `s` to at most `max` bytes without splitting a UTF-8 sequence;
+// the request body is JSON and must stay valid UTF-8.
+void truncate_utf8(std::string& s, size_t max) {
+    if (s.size() <= max) return;
+    while (max > 0 && (static_cast<unsigned char>(s[max]) & 0xC0) == 0x80) --max;
+    s.resize(max);
+}
+
+// Seconds since midnight from a leading "HH:MM:SS", or -1.
+int line_time(std::string_view line) {
+    if (line.size() < 8 || line[2] != ':' || line[5] != ':') return -1;
+    auto d = [&](size_t i) { return line[i] >= '0' && line[i] <= '9' ? line[i] - '0' : -100; };
+    int t = (d(0) * 10 + d(1)) * 3600 + (d(3) * 10 + d(4)) * 60 + d(6) * 10 + d(7);
+    return t < 0 ? -1 : t;
+}
+
+// Cut the log into windows of `window_s` of log time, starting a new one
+// when time runs backwards (appended incident context) or a window grows
+// past max_chars. Untimed lines stay with the window they follow.
+std::vector<std::string> split_windows(std::string_view log, int window_s, size_t max_chars) {
+    std::vector<std::string> out;
+    std::string cur;
+    int start = -1;
+    auto flush = [&] {
+        if (cur.find_first_not_of(" \n\t") != std::string::npos) out.push_back(std::move(cur));
+        cur.clear();
+    };
+
+    while (!log.empty()) {
+        size_t n = std::min(log.find('\n'), log.size());
+        auto line = log.substr(0, std::min(n, max_chars));
+        log.remove_prefix(std::min(log.size(), n + 1));
+
+        int t = line_time(line);
+        if (t >= 0) {
+            if (start < 0) start = t;
+            else if (t < start || t - start >= window_s) {
+                flush();
+                start = t;
+            }
+        }
+        if (!cur.empty() && cur.size() + line.size() + 1 > max_chars) {
+            flush();
+            if (t >= 0) start = t;
+        }
+        cur.append(line);
+        cur += '\n';
+    }
+    flush();
+    return out;
+}
+
+Teacher::ChunkGrade from_json(const nlohmann::json& j) {
+    Teacher::ChunkGrade g;
+    if (j.contains("grade") && j["grade"].is_string()) g.grade = j["grade"];
+    if (j.contains("summary") && j["summary"].is_string()) g.summary = j["summary"];
+    if (j.contains("lessons") && j["lessons"].is_array()) {
+        for (auto& l : j["lessons"]) {
+            if (l.is_string()) g.lessons.push_back(l);
+        }
+    }
+    return g;
+}
+
+nlohmann::json to_json(const Teacher::ChunkGrade& g) {
+    return {{"grade", g.grade}, {"summary", g.summary}, {"lessons", g.lessons}};
+}
+
+// One line of the cache file.
+nlohmann::json cache_record(uint64_t key, const Teacher::ChunkGrade& g) {
+    char hex[17];
+    std::snprintf(hex, sizeof hex, "%016llx", static_cast<unsigned long long>(key));
+    auto j = to_json(g);
+    j["k"] = hex;
+    return j;
+}
+
+#ifdef HAS_CURL
+// The model's reply text as a grade. Non-JSON replies become the summary.
+Teacher::ChunkGrade parse_reply(const std::string& text) {
+    auto j = nlohmann::json::parse(text, nullptr, false);
+    if (!j.is_discarded() && j.is_object()) return from_json(j);
+    Teacher::ChunkGrade g;
+    g.summary = text;
+    return g;
+}
+
+size_t write_callback(char* ptr, size_t size, size_t nmemb, void* userdata) {
+    static_cast<std::string*>(userdata)->append(ptr, size * nmemb);
+    return size * nmemb;
+}
+
+struct HttpResult {
+    long        status{0};
+    std::string body;
+};
+
+HttpResult http_post(const std::string& url, const std::string& body,
+                     const std::string& api_key, long timeout_seconds) {
+    CURL* curl = curl_easy_init();
+    if (!curl) throw std::runtime_error("Teacher: curl_easy_init failed");
+
+    HttpResult r;
+    struct curl_slist* headers = nullptr;
+    headers = curl_slist_append(headers, "Content-Type: application/json");
+    headers = curl_slist_append(headers, ("x-goog-api-key: " + api_key).c_str());
+
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &r.body);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout_seconds);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+
+    CURLcode res = curl_easy_perform(curl);
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &r.status);
+    curl_slist_free_all(headers);
+    curl_easy_cleanup(curl);
+
+    if (res != CURLE_OK) {
+        throw std::runtime_error(std::string("Teacher HTTP POST failed: ") +
+                                 curl_easy_strerror(res));
+    }
+    return r;
+}
+#endif
+
+} // namespace
+
 struct Teacher::Impl {
     std::string api_base_url;
     std::string api_key;      // loaded from env GEMINI_API_KEY
-    // CURL* curl_handle = nullptr;
+    Config      cfg;
+
+    // Per-chunk (and per-reduce) results by content hash, bounded to
+    // cfg.cache_entries. The file is appended to and rewritten with just
+    // the kept entries at load and once stale records dominate it.
+    std::mutex cache_mu;
+    std::unordered_map<uint64_t, ChunkGrade> cache;
+    std::deque<uint64_t> cache_order;      // oldest first
+    size_t               file_records{0};
+
+    void load_cache();
+    void store(uint64_t key, const ChunkGrade& g);
+    std::optional<ChunkGrade> cached(uint64_t key);
+    void remember(uint64_t key, ChunkGrade g);       // cache_mu held
+    void rewrite_cache_file();                       // cache_mu held
+
+    uint64_t key_of(std::string_view kind, std::string_view text) const {
+        uint64_t h = fnv1a(kPromptVersion);
+        h = fnv1a(cfg.model, h);
+        h = fnv1a(kind, h);
+        return fnv1a(text, h);
+    }
+
+    // One model call with retry. Throws once retries are exhausted.
+    ChunkGrade ask(const std::string& prompt, std::atomic<uint64_t>& requests,
+                   std::atomic<uint64_t>& retries);
+
+    // Reduce summaries to lessons, in groups if they don't fit one request.
+    std::vector<std::string> reduce(std::vector<std::string> items,
+                                    std::atomic<uint64_t>& requests,
+                                    std::atomic<uint64_t>& retries);
 };
 
+void Teacher::Impl::load_cache() {
+    if (cfg.cache_path.empty()) return;
+    std::ifstream in(cfg.cache_path);
+    std::string line;
+    size_t records = 0;
+    while (std::getline(in, line)) {
+        ++records;
+        auto j = nlohmann::json::parse(line, nullptr, false);
+        if (j.is_discarded() || !j.contains("k")) continue;
+        try {
+            remember(std::stoull(j["k"].get<std::string>(), nullptr, 16), from_json(j));
+        } catch (const std::exception&) {
+            // malformed key — skip the record
+        }
+    }
+    in.close();
+    if (records > cache.size()) rewrite_cache_file();
+    file_records = cache.size();
+    if (!cache.empty()) {
+        PROMETHEUS_LOG(Info, "[TEACHER] Loaded {} cached grades from {}.", cache.size(),
+                       cfg.cache_path);
+    }
+}
+
+std::optional<Teacher::ChunkGrade> Teacher::Impl::cached(uint64_t key) {
+    std::lock_guard lock(cache_mu);
+    auto it = cache.find(key);
+    if (it == cache.end()) return std::nullopt;
+    return it->second;
+}
+
+void Teacher::Impl::remember(uint64_t key, ChunkGrade g) {
+    if (cache.insert_or_assign(key, std::move(g)).second) cache_order.push_back(key);
+    while (cache.size() > std::max<size_t>(1, cfg.cache_entries)) {
+        cache.erase(cache_order.front());
+        cache_order.pop_front();
+    }
+}
+
+void Teacher::Impl::rewrite_cache_file() {
+    std::ofstream out(cfg.cache_path, std::ios::trunc);
+    for (uint64_t key : cache_order) out << cache_record(key, cache.at(key)).dump() << '\n';
+    file_records = cache.size();
+}
+
+void Teacher::Impl::store(uint64_t key, const ChunkGrade& g) {
+    std::lock_guard lock(cache_mu);
+    remember(key, g);
+    if (cfg.cache_path.empty()) return;
+
+    std::ofstream(cfg.cache_path, std::ios::app) << cache_record(key, g).dump() << '\n';
+    // Evicted and re-stored records pile up; rewrite once they dominate.
+    if (++file_records > 2 * std::max<size_t>(1, cfg.cache_entries)) rewrite_cache_file();
+}
+
+Teacher::ChunkGrade Teacher::Impl::ask(const std::string& prompt,
+                                       std::atomic<uint64_t>& requests,
+                                       std::atomic<uint64_t>& retries) {
+#ifdef HAS_CURL
+    nlohmann::json payload = {
+        {"contents", {{{"role", "user"}, {"parts", {{{"text", prompt}}}}}}},
+        {"generationConfig", {{"responseMimeType", "application/json"},
+                              {"temperature", 0.2}}},
+    };
+    const std::string body = payload.dump();
+    const std::string url  = api_base_url + "/v1beta/models/" + cfg.model + ":generateContent";
+
+    thread_local std::minstd_rand rng(std::random_device{}());
+    std::string error;
+    for (int attempt = 0; attempt <= cfg.retries; ++attempt) {
+        if (attempt) {
+            ++retries;
+            auto base = cfg.backoff * (1 << (attempt - 1));
+            std::uniform_real_distribution<double> spread(0.75, 1.25);
+            std::this_thread::sleep_for(std::chrono::duration_cast<std::chrono::milliseconds>(
+                base * spread(rng)));
+        }
+        ++requests;
+        try {
+            auto r = http_post(url, body, api_key, cfg.timeout_s);
+            if (r.status == 429 || r.status >= 500) {
+                error = "HTTP " + std::to_string(r.status);
+                continue;
+            }
+            if (r.status != 200) {
+                throw std::runtime_error("HTTP " + std::to_string(r.status) + ": " +
+                                         r.body.substr(0, 200));
+            }
+            auto j = nlohmann::json::parse(r.body, nullptr, false);
+            if (j.is_discarded() || !j.contains("candidates") || j["candidates"].empty()) {
+                error = "unexpected response format";
+                continue;
+            }
+            return parse_reply(j["candidates"][0]["content"]["parts"][0]["text"]);
+        } catch (const nlohmann::json::exception& e) {
+            error = e.what();
+        } catch (const std::runtime_error& e) {
+            if (std::string_view(e.what()).starts_with("HTTP ")) throw;   // not retryable
+            error = e.what();
+        }
+    }
+    throw std::runtime_error(error + " after " + std::to_string(cfg.retries + 1) + " attempts");
+#else
+    (void)prompt;
+    (void)requests;
+    (void)retries;
+    throw std::runtime_error("built without libcurl");
+#endif
+}
+
+std::vector<std::string> Teacher::Impl::reduce(std::vector<std::string> items,
+                                               std::atomic<uint64_t>& requests,
+                                               std::atomic<uint64_t>& retries) {
+    const std::string head = kReducePrompt + std::to_string(cfg.max_lessons) +
+                             " lessons.\n\nWindow summaries:\n";
+
+    // Tree reduce: groups that fit one request are reduced to their
+    // lessons, which become the items of the next level. Items on every
+    // level are capped so each group holds several and each level shrinks.
+    const size_t max_item = cfg.max_chunk_chars / 4;
+    for (auto& item : items) truncate_utf8(item, max_item);
+    size_t prev_groups = SIZE_MAX;
+    for (;;) {
+        std::vector<std::string> groups(1);
+        for (auto& item : items) {
+            if (!groups.back().empty() && groups.back().size() + item.size() > cfg.max_chunk_chars) {
+                groups.emplace_back();
+            }
+            groups.back() += item + '\n';
+        }
+        // A level that doesn't shrink would repeat forever (its groups come
+        // back from the cache): reduce what fits in one request instead.
+        if (groups.size() > 1 && groups.size() >= prev_groups) {
+            std::string all;
+            for (auto& g : groups) all += g;
+            truncate_utf8(all, cfg.max_chunk_chars);
+            if (auto nl = all.rfind('\n'); nl != std::string::npos) all.resize(nl + 1);
+            groups.assign(1, std::move(all));
+        }
+        prev_groups = groups.size();
+
+        std::vector<std::string> next;
+        for (auto& g : groups) {
+            uint64_t key = key_of("reduce", g);
+            auto res = cached(key);
+            if (!res) {
+                res = ask(head + g, requests, retries);
+                store(key, *res);
+            }
+            if (groups.size() == 1) {
+                auto lessons = res->lessons;
+                if (lessons.empty() && !res->summary.empty()) lessons.push_back(res->summary);
+                if (lessons.size() > cfg.max_lessons) lessons.resize(cfg.max_lessons);
+                return lessons;
+            }
+            std::string joined;
+            for (auto& l : res->lessons) joined += (joined.empty() ? "" : "; ") + l;
+            next.push_back("- " + joined);
+            truncate_utf8(next.back(), max_item);
+        }
+        items = std::move(next);
+    }
+}
+
 Teacher::Teacher(const std::string& api_base_url)
+    : Teacher(api_base_url, Config{}) {}
+
+Teacher::Teacher(const std::string& api_base_url, Config cfg)
     : impl_(std::make_unique<Impl>())
 {
     impl_->api_base_url = api_base_url;
+    impl_->cfg          = std::move(cfg);
 
     // Read key from environment — never hard-coded.
     const char* key = std::getenv("GEMINI_API_KEY");
     if (key) impl_->api_key = key;
+
+    impl_->load_cache();
 }
 
 Teacher::~Teacher() = default;
 
-std::string Teacher::grade_log(const std::string& log) {
-    std::cout << "[TEACHER] Grading log (" << log.size() << " chars)...\n";
+Teacher::Report Teacher::grade(const std::string& log) {
+    Report report;
+    const auto t0 = Clock::now();
+    auto& cfg = impl_->cfg;
+    PROMETHEUS_LOG(Info, "[TEACHER] Grading log ({} chars)...", log.size());
 
     if (impl_->api_key.empty()) {
-        std::cerr << "[TEACHER] WARNING: GEMINI_API_KEY not set — skipping.\n";
-        return "";
+        PROMETHEUS_LOG(Warn, "[TEACHER] WARNING: GEMINI_API_KEY not set — skipping.");
+        return report;
     }
+#ifndef HAS_CURL
+    PROMETHEUS_LOG(Info, "[TEACHER] Grading complete (stub — no libcurl).");
+    report.lessons = {"Be patient when approaching new biomes."};
+    return report;
+#endif
+
+    // ── Map: grade each window ──────────────────────────────────
+    auto windows = split_windows(log, static_cast<int>(cfg.window.count()), cfg.max_chunk_chars);
+    report.chunks = windows.size();
 
-    // ── Gemini API call (stubbed) ───────────────────────────────
-    // nlohmann::json payload = {
-    //     {"contents", {{
-    //         {"parts", {{
-    //             {"text", "You are the Teacher of Prometheus. "
-    //                      "Grade the following daily log and produce "
-    //                      "a single concise lesson.\n\n" + log}
-    //         }}}
-    //     }}}
-    // };
-    //
-    // std::string url = impl_->api_base_url
-    //     + "/v1beta/models/gemini-3-pro:generateContent"
-    //     + "?key=" + impl_->api_key;
-    // std::string resp = http_post(url, payload.dump());
-    // auto j = nlohmann::json::parse(resp);
-    // return j["candidates"][0]["content"]["parts"][0]["text"];
-
-    std::cout << "[TEACHER] Grading complete (stub).\n";
-    return "Be patient when approaching new biomes.";
+    std::vector<std::optional<ChunkGrade>> grades(windows.size());
+    std::vector<size_t> todo;
+    for (size_t i = 0; i < windows.size(); ++i) {
+        grades[i] = impl_->cached(impl_->key_of("map", windows[i]));
+        if (grades[i]) ++report.cached;
+        else todo.push_back(i);
+    }
+
+    std::atomic<uint64_t> requests{0}, retries{0};
+    std::atomic<size_t>   next{0}, failed{0};
+    auto map_worker = [&] {
+        for (size_t n; (n = next.fetch_add(1)) < todo.size();) {
+            size_t i = todo[n];
+            try {
+                grades[i] = impl_->ask(kMapPrompt + windows[i], requests, retries);
+                impl_->store(impl_->key_of("map", windows[i]), *grades[i]);
+            } catch (const std::exception& e) {
+                ++failed;
+                PROMETHEUS_LOG(Warn, "[TEACHER] Window {}/{} failed: {}", i + 1, windows.size(),
+                               e.what());
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    size_t width = std::min<size_t>(std::max(1, cfg.max_parallel), todo.size());
+    for (size_t w = 0; w < width; ++w) pool.emplace_back(map_worker);
+    for (auto& t : pool) t.join();
+    report.failed = failed.load();
+    report.map_ms = ms_since(t0);
+
+    // ── Reduce: window summaries → the day's lessons ────────────
+    std::vector<std::string> items;
+    for (auto& g : grades) {
+        if (!g) continue;
+        std::string item = "[" + (g->grade.empty() ? "?" : g->grade) + "] " + g->summary;
+        for (size_t k = 0; k < g->lessons.size(); ++k) {
+            item += (k ? "; " : " | lessons: ") + g->lessons[k];
+        }
+        items.push_back(std::move(item));
+    }
+
+    const auto r0 = Clock::now();
+    if (!items.empty()) {
+        try {
+            report.lessons = impl_->reduce(std::move(items), requests, retries);
+        } catch (const std::exception& e) {
+            PROMETHEUS_LOG(Warn, "[TEACHER] Reduce failed: {}", e.what());
+        }
+    }
+    report.reduce_ms = ms_since(r0);
+    report.requests  = requests.load();
+    report.retries   = retries.load();
+    report.wall_ms   = ms_since(t0);
+
+    PROMETHEUS_LOG(Info, "[TEACHER] Graded {} windows ({} cached, {} failed; {} requests, "
+                   "{} retries): map {} ms, reduce {} ms, {} ms total → {} lessons.",
+                   report.chunks, report.cached, report.failed, report.requests, report.retries,
+                   static_cast<long>(report.map_ms), static_cast<long>(report.reduce_ms),
+                   static_cast<long>(report.wall_ms), report.lessons.size());
+    return report;
+}
+
+std::string Teacher::grade_log(const std::string& log) {
+    std::string out;
+    for (auto& l : grade(log).lessons) out += (out.empty() ? "" : "\n") + l;
+    return out;
 }
 
 std::string Teacher::request_calm() {
@@ -1,22 +1,68 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace prometheus {
 
 // Teacher interface — calls the Gemini API to grade daily logs
 // and produce "Lessons" that get injected into context on wake.
+//
+// Grading is map-reduce: the log is cut into time windows, each window is
+// graded and summarised by its own request (a bounded number in flight,
+// retried with backoff), and the window summaries are reduced into the
+// day's lessons. Window results are cached by content hash, so grading a
+// log that only grew since the last call re-sends just the new windows.
 class Teacher {
 public:
+    struct Config {
+        std::string model = "gemini-2.5-flash";
+        std::chrono::seconds window{300};      // log time per chunk
+        size_t   max_chunk_chars = 24000;      // split a busy window further
+        int      max_parallel    = 4;          // map requests in flight
+        int      retries         = 3;          // per request, after the first try
+        std::chrono::milliseconds backoff{500};   // doubled per retry, ± 25%
+        long     timeout_s       = 120;
+        size_t   max_lessons     = 3;
+        std::string cache_path;                // JSON lines; empty → memory only
+        size_t   cache_entries   = 4096;       // grades kept; oldest dropped first
+    };
+
+    // One graded window.
+    struct ChunkGrade {
+        std::string grade;       // letter grade
+        std::string summary;
+        std::vector<std::string> lessons;
+    };
+
+    // Outcome of one grading run (one sleep cycle).
+    struct Report {
+        std::vector<std::string> lessons;
+        size_t   chunks{0};
+        size_t   cached{0};       // served from the chunk cache
+        size_t   failed{0};       // gave up after retries; left out of the reduce
+        uint64_t requests{0};     // HTTP requests made, retries included
+        uint64_t retries{0};
+        double   map_ms{0};
+        double   reduce_ms{0};
+        double   wall_ms{0};
+    };
+
     explicit Teacher(const std::string& api_base_url);
+    Teacher(const std::string& api_base_url, Config cfg);
     ~Teacher();
 
     Teacher(const Teacher&) = delete;
     Teacher& operator=(const Teacher&) = delete;
 
-    // Send a session log to Gemini for evaluation.
-    // Returns a distilled "lesson" string.
+    // Grade a session log (lines starting with "HH:MM:SS.mmm", as written
+    // by EventLog/Consolidator) and reduce it to at most max_lessons.
+    Report grade(const std::string& log);
+
+    // grade(), with the lessons joined one per line.
     std::string grade_log(const std::string& log);
 
     // Request a "Walled Garden" calming passage (Mr. Rogers content).
@@ -0,0 +1,225 @@
+#include "vision/frame_gate.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#ifdef HAS_ZLIB
+#include <zlib.h>
+#endif
+
+namespace prometheus {
+
+// ── Helpers ─────────────────────────────────────────────────────
+
+static constexpr int kHashW = 9;   // dHash compares horizontal neighbours,
+static constexpr int kHashH = 8;   // so 9 columns yield 8 bits per row.
+
+static std::vector<unsigned char> read_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return {};
+    return {std::istreambuf_iterator<char>(file),
+            std::istreambuf_iterator<char>()};
+}
+
+static uint64_t fnv1a(const unsigned char* data, size_t n) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < n; ++i) {
+        h ^= data[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+#ifdef HAS_ZLIB
+static uint32_t be32(const unsigned char* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) |
+           (uint32_t(p[2]) << 8)  |  uint32_t(p[3]);
+}
+
+static unsigned char paeth(int a, int b, int c) {
+    int p  = a + b - c;
+    int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) return static_cast<unsigned char>(a);
+    if (pb <= pc)             return static_cast<unsigned char>(b);
+    return static_cast<unsigned char>(c);
+}
+
+// Decode an 8-bit, non-interlaced PNG (grey, RGB or RGBA — what the
+// playwright capture produces) and average it down to a kHashW×kHashH
+// luminance grid. Returns false for anything else.
+static bool png_to_grid(const std::vector<unsigned char>& png,
+                        std::array<float, kHashW * kHashH>& grid) {
+    static const unsigned char sig[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+    if (png.size() < 8 || !std::equal(sig, sig + 8, png.begin())) return false;
+
+    uint32_t width = 0, height = 0;
+    int channels = 0;
+    std::vector<unsigned char> idat;
+
+    for (size_t pos = 8; pos + 12 <= png.size();) {
+        uint32_t len = be32(&png[pos]);
+        const unsigned char* type = &png[pos + 4];
+        const unsigned char* data = &png[pos + 8];
+        if (pos + 12 + len > png.size()) return false;
+
+        if (std::equal(type, type + 4, "IHDR")) {
+            width  = be32(data);
+            height = be32(data + 4);
+            int depth = data[8], colour = data[9], interlace = data[12];
+            if (depth != 8 || interlace != 0) return false;
+            switch (colour) {
+            case 0: channels = 1; break;
+            case 2: channels = 3; break;
+            case 6: channels = 4; break;
+            default: return false;
+            }
+        } else if (std::equal(type, type + 4, "IDAT")) {
+            idat.insert(idat.end(), data, data + len);
+        } else if (std::equal(type, type + 4, "IEND")) {
+            break;
+        }
+        pos += 12 + len;
+    }
+    if (!width || !height || !channels || idat.empty()) return false;
+
+    size_t stride = size_t(width) * channels;
+    std::vector<unsigned char> raw((stride + 1) * height);
+    uLongf raw_len = raw.size();
+    if (uncompress(raw.data(), &raw_len, idat.data(), idat.size()) != Z_OK ||
+        raw_len != raw.size()) {
+        return false;
+    }
+
+    // Undo per-scanline filters in place, accumulating luminance per cell.
+    std::array<double, kHashW * kHashH> sum{};
+    std::array<uint32_t, kHashW * kHashH> count{};
+    std::vector<unsigned char> prev(stride, 0);
+
+    for (uint32_t y = 0; y < height; ++y) {
+        unsigned char  filter = raw[y * (stride + 1)];
+        unsigned char* line   = &raw[y * (stride + 1) + 1];
+
+        for (size_t i = 0; i < stride; ++i) {
+            int a = i >= size_t(channels) ? line[i - channels] : 0;
+            int b = prev[i];
+            int c = i >= size_t(channels) ? prev[i - channels] : 0;
+            switch (filter) {
+            case 0: break;
+            case 1: line[i] = static_cast<unsigned char>(line[i] + a); break;
+            case 2: line[i] = static_cast<unsigned char>(line[i] + b); break;
+            case 3: line[i] = static_cast<unsigned char>(line[i] + (a + b) / 2); break;
+            case 4: line[i] = static_cast<unsigned char>(line[i] + paeth(a, b, c)); break;
+            default: return false;
+            }
+        }
+
+        size_t gy = size_t(y) * kHashH / height;
+        for (uint32_t x = 0; x < width; ++x) {
+            const unsigned char* px = line + size_t(x) * channels;
+            float lum = channels == 1
+                ? px[0]
+                : 0.299f * px[0] + 0.587f * px[1] + 0.114f * px[2];
+            size_t cell = gy * kHashW + size_t(x) * kHashW / width;
+            sum[cell]   += lum;
+            count[cell] += 1;
+        }
+        std::copy(line, line + stride, prev.begin());
+    }
+
+    for (size_t i = 0; i < grid.size(); ++i) {
+        grid[i] = count[i] ? static_cast<float>(sum[i] / count[i]) : 0.0f;
+    }
+    return true;
+}
+#endif // HAS_ZLIB
+
+uint64_t frame_hash(const std::string& path) {
+    auto bytes = read_file(path);
+    if (bytes.empty()) return 0;
+
+#ifdef HAS_ZLIB
+    std::array<float, kHashW * kHashH> grid{};
+    if (png_to_grid(bytes, grid)) {
+        uint64_t h = 0;
+        for (int y = 0; y < kHashH; ++y) {
+            for (int x = 0; x < kHashW - 1; ++x) {
+                h <<= 1;
+                if (grid[y * kHashW + x] > grid[y * kHashW + x + 1]) h |= 1;
+            }
+        }
+        return h;
+    }
+#endif
+
+    return fnv1a(bytes.data(), bytes.size());
+}
+
+// ── FrameGate ───────────────────────────────────────────────────
+
+void FrameGate::note_percept(const Percept& percept) {
+    std::lock_guard lock(mu_);
+    latest_.x            = percept.x;
+    latest_.y            = percept.y;
+    latest_.z            = percept.z;
+    latest_.entity_count = percept.entity_count;
+    latest_.entity_sig   = percept.entity_sig;
+    latest_.valid        = true;
+}
+
+bool FrameGate::scene_moved(const Snapshot& then, const Snapshot& now) const {
+    if (!then.valid || !now.valid) return false;   // no percepts to compare
+    if (then.entity_count != now.entity_count ||
+        then.entity_sig   != now.entity_sig) {
+        return true;
+    }
+    float dx = now.x - then.x, dy = now.y - then.y, dz = now.z - then.z;
+    return std::sqrt(dx * dx + dy * dy + dz * dz) > max_position_delta;
+}
+
+std::optional<std::string> FrameGate::check(const std::string& frame_path) {
+    uint64_t hash = frame_hash(frame_path);   // file I/O outside the lock
+
+    std::lock_guard lock(mu_);
+    ++stats_.frames;
+    pending_hash_     = hash;
+    pending_snapshot_ = latest_;
+
+    if (!have_observation_ || hash == 0) return std::nullopt;
+
+    auto age = std::chrono::steady_clock::now() - observed_at_;
+    if (age > std::chrono::seconds(max_staleness_s))           return std::nullopt;
+    if (std::popcount(hash ^ observed_hash_) > max_hash_distance) return std::nullopt;
+    if (scene_moved(observed_snapshot_, pending_snapshot_))    return std::nullopt;
+
+    ++stats_.skipped;
+    stats_.gpu_ms_saved += mean_observe_ms_;
+    return observed_desc_;
+}
+
+void FrameGate::record_observation(const std::string& description,
+                                   std::chrono::milliseconds cost) {
+    std::lock_guard lock(mu_);
+    observed_hash_     = pending_hash_;
+    observed_snapshot_ = pending_snapshot_;
+    observed_desc_     = description;
+    observed_at_       = std::chrono::steady_clock::now();
+    have_observation_  = true;
+
+    // Running mean of the observe cost, used to estimate GPU time saved.
+    ++observations_;
+    mean_observe_ms_ += (static_cast<double>(cost.count()) - mean_observe_ms_)
+                        / static_cast<double>(observations_);
+}
+
+FrameGate::Stats FrameGate::stats() const {
+    std::lock_guard lock(mu_);
+    return stats_;
+}
+
+} // namespace prometheus
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "lizard/lizard.h"   // for Percept
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace prometheus {
+
+// Frame-similarity gate for the vibe check.
+// Combines a 64-bit perceptual hash (dHash over a 9x8 luminance grid) of
+// each captured frame with cheap percept deltas (position, entity set).
+// When neither has moved meaningfully since the last real observation,
+// the cached description is reused instead of running vision inference.
+class FrameGate {
+public:
+    struct Stats {
+        uint64_t frames{0};        // frames offered to the gate
+        uint64_t skipped{0};       // frames answered from cache
+        double   gpu_ms_saved{0};  // skipped × mean observe cost
+
+        double skip_ratio() const {
+            return frames ? static_cast<double>(skipped) / frames : 0.0;
+        }
+    };
+
+    // Called from the lizard thread with every percept.
+    void note_percept(const Percept& percept);
+
+    // Hash the frame and compare against the last observed scene.
+    // Returns the cached description if nothing meaningful changed,
+    // nullopt if the caller should run Soul::observe.
+    std::optional<std::string> check(const std::string& frame_path);
+
+    // Record a fresh observation for the frame passed to check().
+    void record_observation(const std::string& description,
+                            std::chrono::milliseconds cost);
+
+    Stats stats() const;
+
+    // Tunables.
+    int    max_hash_distance  = 6;     // Hamming bits (of 64)
+    float  max_position_delta = 2.0f;  // blocks
+    int    max_staleness_s    = 60;    // force a refresh after this long
+
+private:
+    // The slice of a Percept the gate compares (no raw JSON copy).
+    struct Snapshot {
+        float    x{}, y{}, z{};
+        int      entity_count{};
+        uint64_t entity_sig{};
+        bool     valid{false};
+    };
+
+    bool scene_moved(const Snapshot& then, const Snapshot& now) const;
+
+    mutable std::mutex mu_;
+
+    Snapshot latest_;               // most recent percept (lizard thread)
+    Snapshot pending_snapshot_;     // percept at the last check()
+
+    // Scene at the last real observation.
+    uint64_t observed_hash_{0};
+    Snapshot observed_snapshot_;
+    std::string observed_desc_;
+    std::chrono::steady_clock::time_point observed_at_{};
+    bool     have_observation_{false};
+
+    // Frame hashed by the most recent check() awaiting record_observation().
+    uint64_t pending_hash_{0};
+
+    Stats  stats_;
+    double mean_observe_ms_{0};
+    uint64_t observations_{0};
+};
+
+// Perceptual hash of an image file. PNG frames are decoded (requires
+// zlib) and reduced to a 64-bit dHash; other formats, or builds without
+// zlib, fall back to a content hash that only matches identical files.
+uint64_t frame_hash(const std::string& path);
+
+} // namespace prometheus